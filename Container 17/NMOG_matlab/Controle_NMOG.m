@@ -459,6 +459,8 @@ function executarControle(ch, limM, limA)
     
     tempM = 0; tempA = 0;
     lastLog = clock; lastReq = clock; startTime = now;
+    lastRxT = -Inf; % Último 0x510 recebido (push ou resposta a RTR)
+    lastCmd = [-1 -1]; % Último 0x402 enviado (só reenvia quando a máscara muda)
     histM = limM - 3; histA = limA - 5;
     
     try
@@ -477,7 +479,8 @@ function executarControle(ch, limM, limA)
             tNow = (now - startTime) * 86400;
             
             % --- LEITURA ---
-            if etime(clock, lastReq) > 0.2
+            % Módulo em push: só pede por RTR se o 0x510 não chegou sozinho
+            if etime(clock, lastReq) > 0.2 && (now - lastRxT)*86400 > 0.5
                 try, transmit(ch, canMessage(1296, false, 0, 'Remote', true)); catch, end
                 lastReq = clock;
             end
@@ -486,6 +489,7 @@ function executarControle(ch, limM, limA)
                 msgs = receive(ch, ch.MessagesAvailable);
                 for i=1:length(msgs)
                     if ~msgs(i).Remote && msgs(i).ID == 1296
+                        lastRxT = now;
                         d = uint16(msgs(i).Data);
                          rawBR = bitshift(bitand(d(7),240), -4) + bitshift(d(8),4);
                         rawTR = d(4) + bitshift(bitand(d(5), 15), 8);
@@ -529,11 +533,16 @@ function executarControle(ch, limM, limA)
                 b2 = bitor(b2, 4); 
                 if bomba == 0, b2 = bitor(b2, 1); end 
                 
-                try
-                    cmd = canMessage(1026, false, 8); 
-                    cmd.Data = [b1 b2 0 0 0 0 0 0];
-                    transmit(ch, cmd);
-                catch
+                % O nó só ecoa o 0x422 quando o estado muda: envia o
+                % 0x402 apenas quando a máscara calculada é diferente
+                if ~isequal([b1 b2], lastCmd)
+                    try
+                        cmd = canMessage(1026, false, 8); 
+                        cmd.Data = [b1 b2 0 0 0 0 0 0];
+                        transmit(ch, cmd);
+                        lastCmd = [b1 b2];
+                    catch
+                    end
                 end
                 
                 stB='OFF'; if bomba, stB='ON '; end
@@ -596,6 +605,8 @@ function filtragem_agua(ch)
     
     tempM = 0; tempA = 0;
     lastLog = clock; lastReq = clock; startTime = now;
+    lastRxT = -Inf; % Último 0x510 recebido (push ou resposta a RTR)
+    lastCmd = [-1 -1]; % Último 0x402 enviado (só reenvia quando a máscara muda)
     
     try
         while true
@@ -613,7 +624,8 @@ function filtragem_agua(ch)
             tNow = (now - startTime) * 86400;
             
             % --- LEITURA (Apenas para monitoramento) ---
-            if etime(clock, lastReq) > 0.2
+            % Módulo em push: só pede por RTR se o 0x510 não chegou sozinho
+            if etime(clock, lastReq) > 0.2 && (now - lastRxT)*86400 > 0.5
                 try, transmit(ch, canMessage(1296, false, 0, 'Remote', true)); catch, end
                 lastReq = clock;
             end
@@ -622,6 +634,7 @@ function filtragem_agua(ch)
                 msgs = receive(ch, ch.MessagesAvailable);
                 for i=1:length(msgs)
                     if ~msgs(i).Remote && msgs(i).ID == 1296
+                        lastRxT = now;
                         d = uint16(msgs(i).Data);
                         rawBR = bitshift(bitand(d(7),240), -4) + bitshift(d(8),4);
                         rawTR = d(4) + bitshift(bitand(d(5), 15), 8);
@@ -650,11 +663,16 @@ function filtragem_agua(ch)
                 % Como queremos LIGADA, NÃO fazemos o bitor com 1.
                 % Deixamos o bit 0 como '0'.
                 
-                try
-                    cmd = canMessage(1026, false, 8); 
-                    cmd.Data = [b1 b2 0 0 0 0 0 0];
-                    transmit(ch, cmd);
-                catch
+                % O nó só ecoa o 0x422 quando o estado muda: envia o
+                % 0x402 apenas quando a máscara calculada é diferente
+                if ~isequal([b1 b2], lastCmd)
+                    try
+                        cmd = canMessage(1026, false, 8); 
+                        cmd.Data = [b1 b2 0 0 0 0 0 0];
+                        transmit(ch, cmd);
+                        lastCmd = [b1 b2];
+                    catch
+                    end
                 end
                 clc;
                 fprintf('FILTRAGEM | Tempo: %6.1fs | Motor:%5.1f C | Agua:%5.1f C | BOMBA LIGADA\n', ...
@@ -708,6 +726,8 @@ function arrefecimento_func(ch)
     
     tempM = 0; tempA = 0;
     lastLog = clock; lastReq = clock; startTime = now;
+    lastRxT = -Inf; % Último 0x510 recebido (push ou resposta a RTR)
+    lastCmd = [-1 -1]; % Último 0x402 enviado (só reenvia quando a máscara muda)
     
     try
         while true
@@ -725,7 +745,8 @@ function arrefecimento_func(ch)
             tNow = (now - startTime) * 86400;
             
             % --- LEITURA ---
-            if etime(clock, lastReq) > 0.2
+            % Módulo em push: só pede por RTR se o 0x510 não chegou sozinho
+            if etime(clock, lastReq) > 0.2 && (now - lastRxT)*86400 > 0.5
                 try, transmit(ch, canMessage(1296, false, 0, 'Remote', true)); catch, end
                 lastReq = clock;
             end
@@ -734,6 +755,7 @@ function arrefecimento_func(ch)
                 msgs = receive(ch, ch.MessagesAvailable);
                 for i=1:length(msgs)
                     if ~msgs(i).Remote && msgs(i).ID == 1296
+                        lastRxT = now;
                         d = uint16(msgs(i).Data);
                         rawBR = bitshift(bitand(d(7),240), -4) + bitshift(d(8),4);
                         rawTR = d(4) + bitshift(bitand(d(5), 15), 8);
@@ -766,11 +788,16 @@ function arrefecimento_func(ch)
                 % BOMBA (Bit 0): LIGADA -> Manda 0 (Não faz nada)
                 % (Não adicionamos 1 aqui, deixando o bit em 0)
                 
-                try
-                    cmd = canMessage(1026, false, 8); 
-                    cmd.Data = [b1 b2 0 0 0 0 0 0];
-                    transmit(ch, cmd);
-                catch
+                % O nó só ecoa o 0x422 quando o estado muda: envia o
+                % 0x402 apenas quando a máscara calculada é diferente
+                if ~isequal([b1 b2], lastCmd)
+                    try
+                        cmd = canMessage(1026, false, 8); 
+                        cmd.Data = [b1 b2 0 0 0 0 0 0];
+                        transmit(ch, cmd);
+                        lastCmd = [b1 b2];
+                    catch
+                    end
                 end
                 clc;
                 fprintf('ARREFECIM.| Tempo:%6.1fs | Motor:%5.1f | Agua:%5.1f | BOMBA + V1 (NA1) ON\n', ...
@@ -824,6 +851,8 @@ function Descarte_func(ch)
     
     tempM = 0; tempA = 0;
     lastLog = clock; lastReq = clock; startTime = now;
+    lastRxT = -Inf; % Último 0x510 recebido (push ou resposta a RTR)
+    lastCmd = [-1 -1]; % Último 0x402 enviado (só reenvia quando a máscara muda)
     
     try
         while true
@@ -841,7 +870,8 @@ function Descarte_func(ch)
             tNow = (now - startTime) * 86400;
             
             % --- LEITURA ---
-            if etime(clock, lastReq) > 0.2
+            % Módulo em push: só pede por RTR se o 0x510 não chegou sozinho
+            if etime(clock, lastReq) > 0.2 && (now - lastRxT)*86400 > 0.5
                 try, transmit(ch, canMessage(1296, false, 0, 'Remote', true)); catch, end
                 lastReq = clock;
             end
@@ -850,6 +880,7 @@ function Descarte_func(ch)
                 msgs = receive(ch, ch.MessagesAvailable);
                 for i=1:length(msgs)
                     if ~msgs(i).Remote && msgs(i).ID == 1296
+                        lastRxT = now;
                         d = uint16(msgs(i).Data);
                         rawBR = bitshift(bitand(d(7),240), -4) + bitshift(d(8),4);
                         rawTR = d(4) + bitshift(bitand(d(5), 15), 8);
@@ -882,11 +913,16 @@ function Descarte_func(ch)
                 % BOMBA (Bit 0): Queremos ON (0).
                 % NÃO fazemos bitor. Deixa 0.
                 
-                try
-                    cmd = canMessage(1026, false, 8); 
-                    cmd.Data = [b1 b2 0 0 0 0 0 0];
-                    transmit(ch, cmd);
-                catch
+                % O nó só ecoa o 0x422 quando o estado muda: envia o
+                % 0x402 apenas quando a máscara calculada é diferente
+                if ~isequal([b1 b2], lastCmd)
+                    try
+                        cmd = canMessage(1026, false, 8); 
+                        cmd.Data = [b1 b2 0 0 0 0 0 0];
+                        transmit(ch, cmd);
+                        lastCmd = [b1 b2];
+                    catch
+                    end
                 end
                 clc;
                 fprintf('DESCARTE  | Tempo:%6.1fs | Motor:%5.1f | Agua:%5.1f | TUDO ABERTO (ON)\n', ...
@@ -1017,6 +1053,7 @@ function monitorarModulosTermicos(ch)
     
     % IDs e Textos de Status
     idsTermicos = [1296, 1312, 1328];
+    lastRxK = -Inf(1, 3); % Último frame de cada módulo (push ou resposta)
     nomesModulos = {'M1 (Main)', 'M2 (Aux)', 'M3 (Aux)'};
     statusTxt = {'OK ', 'Er1', 'Er2', 'Er3'}; % 0=OK, 1..3=Erros
     
@@ -1026,9 +1063,11 @@ function monitorarModulosTermicos(ch)
                 disp('>>> Voltando ao Menu...'); break;
             end
             
-            % Envia RTRs
+            % Envia RTRs só para os módulos que não transmitiram sozinhos
             for k=1:length(idsTermicos)
-                try, transmit(ch, canMessage(idsTermicos(k), false, 0, 'Remote', true)); catch, end
+                if (now - lastRxK(k))*86400 > 0.5
+                    try, transmit(ch, canMessage(idsTermicos(k), false, 0, 'Remote', true)); catch, end
+                end
             end
             
             pause(0.1); 
@@ -1047,6 +1086,7 @@ function monitorarModulosTermicos(ch)
                     idx = find([msgs.ID] == targetID & ~[msgs.Remote], 1, 'last');
                     
                     if ~isempty(idx)
+                        lastRxK(k) = now;
                         d = uint16(msgs(idx).Data);
                         
                         % --- DECODIFICAÇÃO COMPLETA (VALOR + STATUS) ---
@@ -0,0 +1,123 @@
+"""Migração do barramento para 1 Mbps (ou de volta para 500 kbps).
+
+Uso:
+  python can_bitrate.py config                 # gera config-*-1m.json dos CAN input
+  python can_bitrate.py status  [-i socketcan -c can0 -b 500000]
+  python can_bitrate.py migrate 1000000 [-d 2000] [-i ... -c ... -b 500000]
+
+Sequência recomendada para 1 Mbps:
+  1. Grave config-01.04-1m.json (ou -push-1m) nos CAN input pela ferramenta
+     de configuração; o novo bitrate só vale quando o módulo reinicia.
+  2. `migrate 1000000`: transmite 0x40C em broadcast; todos os nós trocam
+     depois da mesma espera. Reinicie os CAN input dentro dessa espera.
+  3. O script reconecta no bitrate novo e confere o 0x42C de cada nó: o
+     nó fica em teste por ~3 s e só grava 1 Mbps na EEPROM se o
+     barramento responder; senão volta sozinho para 500 kbps.
+"""
+import argparse
+import glob
+import json
+import os
+import time
+
+BITRATE_CMD_ID = 0x40C
+BITRATE_STATUS_ID = 0x42C
+CODES = {500000: 0, 1000000: 1}
+STATES = {0: "Idle", 1: "Pending", 2: "Trial", 3: "Fallback"}
+TRIAL_S = 3.0
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+CONFIG_GLOB = os.path.join(HERE, "..", "Container *", "can input *", "config-*.json")
+
+
+def write_configs(bitrate):
+    suffix = "-1m" if bitrate == 1000000 else ""
+    for path in sorted(glob.glob(CONFIG_GLOB)):
+        if path.endswith("-1m.json"):
+            continue
+        with open(path, encoding="utf-8") as f:
+            cfg = json.load(f)
+        cfg["phy"]["can"]["phy"]["bit_rate_std"] = bitrate
+        out = path[:-len(".json")] + suffix + ".json"
+        with open(out, "w", encoding="utf-8") as f:
+            json.dump(cfg, f, indent=2)
+        print(f"{os.path.relpath(out, HERE)}: bit_rate_std = {bitrate}")
+
+
+def open_bus(args, bitrate):
+    import can  # python-can só é necessário para falar com o barramento
+    return can.Bus(interface=args.interface, channel=args.channel, bitrate=bitrate)
+
+
+def query(bus, timeout=0.5):
+    """RTR no 0x40C; retorna os 0x42C recebidos (um por nó)."""
+    import can
+    bus.send(can.Message(arbitration_id=BITRATE_CMD_ID, is_remote_frame=True,
+                         dlc=0, is_extended_id=False))
+    replies = []
+    end = time.time() + timeout
+    while time.time() < end:
+        msg = bus.recv(end - time.time())
+        if msg and msg.arbitration_id == BITRATE_STATUS_ID and len(msg.data) >= 7:
+            d = msg.data
+            replies.append({
+                "current": 1000000 if d[0] == 1 else 500000,
+                "state": STATES.get(d[1], d[1]),
+                "target": 1000000 if d[2] == 1 else 500000,
+                "remaining_ms": (d[3] << 8) | d[4],
+                "stored": d[5],
+                "fallbacks": d[6],
+            })
+    return replies
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("command", choices=["config", "status", "migrate"])
+    ap.add_argument("bitrate", nargs="?", type=int, default=1000000)
+    ap.add_argument("-i", "--interface", default="socketcan")
+    ap.add_argument("-c", "--channel", default="can0")
+    ap.add_argument("-b", "--current", type=int, default=500000,
+                    help="bitrate atual do barramento")
+    ap.add_argument("-d", "--delay", type=int, default=2000,
+                    help="espera até a troca combinada (ms)")
+    args = ap.parse_args()
+
+    if args.bitrate not in CODES:
+        ap.error("bitrate deve ser 500000 ou 1000000")
+
+    if args.command == "config":
+        write_configs(args.bitrate)
+        return
+
+    bus = open_bus(args, args.current)
+    if args.command == "status":
+        for r in query(bus):
+            print(r)
+        bus.shutdown()
+        return
+
+    import can
+    data = [CODES[args.bitrate], (args.delay >> 8) & 0xFF, args.delay & 0xFF]
+    bus.send(can.Message(arbitration_id=BITRATE_CMD_ID, data=data, is_extended_id=False))
+    print(f"0x40C: {args.bitrate} bps em {args.delay} ms")
+    bus.shutdown()
+
+    time.sleep(args.delay / 1000.0)
+    bus = open_bus(args, args.bitrate)
+    time.sleep(TRIAL_S + 0.5)
+    replies = query(bus)
+    bus.shutdown()
+    if not replies:
+        print(f"Nenhum nó respondeu a {args.bitrate} bps (voltaram para 500 kbps?)")
+        raise SystemExit(1)
+    ok = True
+    for r in replies:
+        print(r)
+        ok &= r["current"] == args.bitrate and r["state"] == "Idle"
+    raise SystemExit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
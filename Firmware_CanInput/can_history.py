@@ -0,0 +1,175 @@
+"""Download do histórico em RAM do nó (0x40F/0x42F/0x430) para CSV.
+
+Uso:
+  python can_history.py status   [-i socketcan -c can0 -b 500000]
+  python can_history.py download [-o historico.csv] [-i ... -c ... -b ...]
+  python can_history.py clear
+  python can_history.py decode dump.bin [-o historico.csv]
+
+O download congela o anel do nó (temperaturas filtradas, relés e eventos dos
+últimos minutos, ver include/history.h) e o transmite em frames
+[seq][até 7 bytes] no 0x430. O script confere a sequência e o tamanho
+anunciado no 0x42F, salva o stream cru (.bin) e decodifica para CSV com o
+horário de cada linha no relógio do PC (pelo millis() do 0x42F).
+"""
+import argparse
+import csv
+import struct
+import sys
+import time
+
+HISTORY_CMD_ID = 0x40F
+HISTORY_STATUS_ID = 0x42F
+HISTORY_DATA_ID = 0x430
+CMD_STATUS, CMD_START, CMD_ABORT, CMD_CLEAR = 0, 1, 2, 3
+STATES = {0: "Idle", 1: "Sending", 2: "Done", 3: "Aborted"}
+
+KEY_BYTES = 14
+EVENT_BYTES = 3
+EVENTS = {0: "boot", 1: "trip", 2: "normal", 3: "stale", 4: "fresh",
+          5: "release", 6: "busoff", 7: "bitrate", 8: "lost", 9: "stack"}
+
+
+def open_bus(args):
+    import can  # python-can só é necessário para falar com o barramento
+    return can.Bus(interface=args.interface, channel=args.channel, bitrate=args.bitrate)
+
+
+def parse_status(data):
+    state, length, period10, uptime = struct.unpack(">BHBI", bytes(data[:8]))
+    return {"state": STATES.get(state, state), "length": length,
+            "period_ms": period10 * 10, "uptime_ms": uptime}
+
+
+def command(bus, cmd, timeout=0.5):
+    """Envia o 0x40F e devolve o primeiro 0x42F."""
+    import can
+    bus.send(can.Message(arbitration_id=HISTORY_CMD_ID, data=[cmd], is_extended_id=False))
+    end = time.time() + timeout
+    while time.time() < end:
+        msg = bus.recv(end - time.time())
+        if msg and msg.arbitration_id == HISTORY_STATUS_ID and len(msg.data) >= 8:
+            return parse_status(msg.data), time.time()
+    return None, None
+
+
+def download(bus, timeout=5.0):
+    status, t_pc = command(bus, CMD_START)
+    if status is None:
+        raise SystemExit("Nenhum 0x42F: nó não respondeu")
+    stream = bytearray()
+    seq = 0
+    end = time.time() + timeout
+    while len(stream) < status["length"]:
+        msg = bus.recv(max(0.0, end - time.time()))
+        if msg is None:
+            break
+        if msg.arbitration_id == HISTORY_STATUS_ID and msg.data[0] == 3:
+            raise SystemExit("Download cancelado pelo nó")
+        if msg.arbitration_id != HISTORY_DATA_ID or len(msg.data) < 1:
+            continue
+        if msg.data[0] != seq:
+            command(bus, CMD_ABORT)
+            raise SystemExit(f"Frame perdido: seq {msg.data[0]}, esperado {seq}")
+        stream += bytes(msg.data[1:])
+        seq = (seq + 1) & 0xFF
+    if len(stream) != status["length"]:
+        raise SystemExit(f"Incompleto: {len(stream)} de {status['length']} bytes")
+    return bytes(stream), status, t_pc
+
+
+def decode(stream, period_ms):
+    """Gera dicts (ms, t1..t4, relays) e (ms, event, arg), como historyDecode."""
+    rows = []
+    cur = None
+    i = 0
+    while i < len(stream):
+        tag = stream[i]
+        kind = tag & 0xC0
+        if kind == 0x40:
+            length = KEY_BYTES
+        elif kind == 0x80:
+            length = EVENT_BYTES
+        elif kind == 0x00:
+            length = 1 + bin(tag & 0x0F).count("1") + (1 if tag & 0x10 else 0)
+        else:
+            raise ValueError(f"tag inválida 0x{tag:02X} no byte {i}")
+        if i + length > len(stream):
+            raise ValueError("stream truncado")
+        p = stream[i + 1:i + length]
+        if kind == 0x40:
+            ms, t1, t2, t3, t4, relays = struct.unpack(">IhhhhB", p)
+            cur = {"ms": ms, "temp": [t1, t2, t3, t4], "relays": relays}
+            rows.append(dict(cur, event=""))
+        elif cur is None:
+            raise ValueError("stream sem KEY no início")
+        elif kind == 0x00:
+            cur["ms"] += period_ms
+            k = 0
+            for ch in range(4):
+                if tag & (1 << ch):
+                    cur["temp"][ch] += struct.unpack("b", p[k:k + 1])[0]
+                    k += 1
+            if tag & 0x10:
+                cur["relays"] = p[k]
+            rows.append(dict(cur, temp=list(cur["temp"]), event=""))
+        else:
+            name = EVENTS.get(tag & 0x3F, f"evento {tag & 0x3F}")
+            rows.append(dict(cur, temp=list(cur["temp"]), ms=cur["ms"] + 2 * p[1],
+                             event=f"{name} {p[0]}"))
+        i += length
+    return rows
+
+
+def write_csv(rows, out, uptime_ms=None, t_pc=None):
+    w = csv.writer(out)
+    w.writerow(["ms", "pc_time", "T1", "T2", "T3", "T4", "relays", "event"])
+    for r in rows:
+        pc = ""
+        if uptime_ms is not None:
+            pc = time.strftime("%H:%M:%S", time.localtime(t_pc - (uptime_ms - r["ms"]) / 1000.0))
+        w.writerow([r["ms"], pc] + [f"{t / 4:.2f}" for t in r["temp"]] +
+                   [f"0x{r['relays']:02X}", r["event"]])
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("command", choices=["status", "download", "clear", "decode"])
+    ap.add_argument("dump", nargs="?", help="stream cru (decode)")
+    ap.add_argument("-o", "--output", help="CSV de saída (padrão: stdout)")
+    ap.add_argument("-p", "--period", type=int, default=250, help="período das amostras (decode)")
+    ap.add_argument("-i", "--interface", default="socketcan")
+    ap.add_argument("-c", "--channel", default="can0")
+    ap.add_argument("-b", "--bitrate", type=int, default=500000)
+    args = ap.parse_args()
+
+    out = open(args.output, "w", newline="", encoding="utf-8") if args.output else sys.stdout
+
+    if args.command == "decode":
+        if not args.dump:
+            ap.error("decode precisa do arquivo .bin")
+        with open(args.dump, "rb") as f:
+            write_csv(decode(f.read(), args.period), out)
+        return
+
+    bus = open_bus(args)
+    try:
+        if args.command == "status":
+            print(command(bus, CMD_STATUS)[0])
+        elif args.command == "clear":
+            print(command(bus, CMD_CLEAR)[0])
+        else:
+            stream, status, t_pc = download(bus)
+            dump = (args.output or "historico.csv").rsplit(".", 1)[0] + ".bin"
+            with open(dump, "wb") as f:
+                f.write(stream)
+            rows = decode(stream, status["period_ms"])
+            write_csv(rows, out, status["uptime_ms"], t_pc)
+            print(f"{len(stream)} bytes, {len(rows)} linhas (cru em {dump})", file=sys.stderr)
+    finally:
+        bus.shutdown()
+
+
+if __name__ == "__main__":
+    main()
@@ -1,15 +1,21 @@
 #!/usr/bin/env python3
 import json
 import shutil
+import sys
 from datetime import datetime
 from pathlib import Path
 from SCons.Script import Import
 
 Import("env")
 
+# memory_report.py fica ao lado deste script
+sys.path.insert(0, env.subst("$PROJECT_DIR"))
+import memory_report
+
 # --- CONFIGURAÇÕES ---
 OUTPUT_DIR_NAME = "firmwares"
 VERSION_FILE_NAME = "version.json"
+MEMORY_HISTORY_NAME = "memory_history.csv"   # Uma linha por versão; não é limpo
 # Defina se quer incrementar a versão a cada build (True) ou não (False)
 AUTO_INCREMENT = True 
 
@@ -57,7 +63,7 @@ def clean_old_files(output_dir):
         return
 
     # Padrões de arquivos para remover
-    patterns = ["firmware_v*.bin", "firmware_v*.hex", "info_v*.txt"]
+    patterns = ["firmware_v*.bin", "firmware_v*.hex", "info_v*.txt", "memory_v*.txt"]
     
     deleted_count = 0
     for pattern in patterns:
@@ -71,7 +77,7 @@ def clean_old_files(output_dir):
     if deleted_count > 0:
         print(f"🗑️  Limpeza: {deleted_count} arquivos antigos removidos.")
 
-def generate_info_file(file_path, version, board_name, size_kb):
+def generate_info_file(file_path, version, board_name, pioenv, size_kb):
     timestamp = datetime.now().strftime("%Y-%m-%d %H:%M:%S")
     content = (
         f"Firmware Info\n"
@@ -79,17 +85,33 @@ def generate_info_file(file_path, version, board_name, size_kb):
         f"Versão:  {version}\n"
         f"Build:   {timestamp}\n"
         f"Placa:   {board_name}\n"
+        f"Ambiente: {pioenv}\n"
         f"Tamanho: {size_kb:.2f} KB\n"
     )
     with open(file_path, 'w') as f:
         f.write(content)
 
+def ram_total():
+    return int(env.BoardConfig().get("upload.maximum_ram_size", memory_report.RAM_TOTAL))
+
+def flash_total():
+    return int(env.BoardConfig().get("upload.maximum_size", memory_report.FLASH_TOTAL))
+
+def print_memory(source, target, env):
+    """pio run -e <ambiente> -t memory: relatório sem gerar versão"""
+    elf = memory_report.Elf(str(source[0]))
+    m = memory_report.measure(elf)
+    history = Path(env.subst("$PROJECT_DIR")) / OUTPUT_DIR_NAME / env.subst("$PIOENV") / MEMORY_HISTORY_NAME
+    print(memory_report.render(elf, m, f"Memória {env.subst('$PIOENV')}", ram_total(), flash_total(), 20,
+                               memory_report.last_history(history)))
+
 def finalize_firmware(source, target, env):
     """Função principal executada pelo PlatformIO"""
     
     # 1. Definição de Caminhos
+    # Um subdiretório (e um version.json) por ambiente/container
     project_dir = Path(env.subst("$PROJECT_DIR"))
-    output_dir = project_dir / OUTPUT_DIR_NAME
+    output_dir = project_dir / OUTPUT_DIR_NAME / env.subst("$PIOENV")
     version_file = output_dir / VERSION_FILE_NAME
     
     source_firmware = Path(str(target[0]))
@@ -125,13 +147,25 @@ def finalize_firmware(source, target, env):
         
         # Gera TXT
         board = env.subst("$BOARD")
-        generate_info_file(info_txt, version_str, board, size_kb)
+        generate_info_file(info_txt, version_str, board, env.subst("$PIOENV"), size_kb)
+
+        # RAM/flash por seção e por símbolo (memory_report.py)
+        mem = memory_report.write_report(
+            source_firmware.with_suffix(".elf"),
+            output_dir / f"memory_{version_str}.txt",
+            output_dir / MEMORY_HISTORY_NAME,
+            version_str,
+            env.subst("$PIOENV"),
+            ram_total=ram_total(),
+            flash_total=flash_total(),
+        )
         
         # 6. Feedback Visual
         print("\n" + "="*50)
         print(f"✅ SUCESSO! Nova versão gerada: {version_str}")
         print(f"📂 Destino: {output_dir}")
         print(f"📄 Arquivo: {new_fw_name} ({size_kb:.2f} KB)")
+        print(f"🧮 RAM estática: {mem['ram']} / {ram_total()} bytes, flash: {mem['flash']} bytes")
         print("="*50 + "\n")
         
     except Exception as e:
@@ -139,4 +173,6 @@ def finalize_firmware(source, target, env):
 
 # Registra o script no PlatformIO
 env.AddPostAction("$BUILD_DIR/${PROGNAME}.hex", finalize_firmware)
-env.AddPostAction("$BUILD_DIR/${PROGNAME}.bin", finalize_firmware)
\ No newline at end of file
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.bin", finalize_firmware)
+env.AddCustomTarget("memory", "$BUILD_DIR/${PROGNAME}.elf", print_memory,
+                    title="Memória", description="RAM/flash por seção e por símbolo")
\ No newline at end of file
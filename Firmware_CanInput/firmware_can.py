@@ -2,13 +2,18 @@ import can
 import time
 import sys
 import struct
+import os
 from intelhex import IntelHex
 
 # --- CONFIGURAÇÕES ---
 VECTOR_APP_NAME = "PythonCAN"
 VECTOR_CHANNEL = 0
 # [AJUSTE] Velocidade definida para 500kbps
+# O bootloader (mcp-can-boot) sempre roda a 500 kbps
 CAN_BITRATE = 500000           
+# Bitrate da aplicação (0x40C pode ter migrado o barramento para 1 Mbps):
+# o reset é enviado neste bitrate e o flash continua em CAN_BITRATE
+APP_BITRATE = int(os.environ.get("APP_BITRATE", CAN_BITRATE))
 
 # IDs do Protocolo
 CAN_ID_MCU_TO_REMOTE = 0x1FFFFF01
@@ -37,13 +42,13 @@ class VectorFlasher:
         self.ih = IntelHex(hex_file)
         self.max_addr = self.ih.maxaddr()
         
-    def connect(self):
+    def connect(self, bitrate=CAN_BITRATE):
         try:
-            print(f"🔌 Conectando ao Vector Channel {VECTOR_CHANNEL} @ {CAN_BITRATE/1000} kbps...")
+            print(f"🔌 Conectando ao Vector Channel {VECTOR_CHANNEL} @ {bitrate/1000} kbps...")
             self.bus = can.Bus(interface='vector', 
                                app_name=VECTOR_APP_NAME, 
                                channel=VECTOR_CHANNEL, 
-                               bitrate=CAN_BITRATE)
+                               bitrate=bitrate)
             print("✅ Conectado ao hardware Vector.")
         except Exception as e:
             print(f"❌ Erro ao conectar no Vector: {e}")
@@ -83,7 +88,15 @@ class VectorFlasher:
 
     def start_flashing(self):
         # Chama o reset automático
-        self.send_reset_command()
+        if APP_BITRATE != CAN_BITRATE:
+            # Aplicação em outro bitrate: reset nele, bootloader a 500 kbps
+            self.bus.shutdown()
+            self.connect(APP_BITRATE)
+            self.send_reset_command()
+            self.bus.shutdown()
+            self.connect(CAN_BITRATE)
+        else:
+            self.send_reset_command()
         
         print("⏳ Aguardando bootloader iniciar...")
         
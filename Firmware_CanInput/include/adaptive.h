@@ -0,0 +1,60 @@
+//═══════════════════════════════════════════════════════════════════════════
+// AQUISIÇÃO ADAPTATIVA - PERÍODO POR MÓDULO CONFORME A PROXIMIDADE DO LIMITE
+//═══════════════════════════════════════════════════════════════════════════
+// Em vez de um único aquisc.timer para todos, cada canal de segurança pede
+// um período de amostragem:
+//
+//   - longe do limite (distância >= marginC): maxMs
+//   - dentro da margem: interpola linearmente até minMs no limite
+//   - subindo rápido: no máximo 1/ADAPT_SAMPLES_TO_LIMIT do tempo estimado
+//     até o limite (distância / taxa de subida)
+//
+// O período de um ID da tabela de ingestão é o menor entre os canais que
+// leem dele. Se a soma (RTR + resposta) passar do orçamento de carga do
+// barramento, todos os períodos são esticados na mesma proporção, sem
+// passar de maxMs.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+#include <stdint.h>
+
+#include "config.h"
+#include "ingest.h"
+
+#define ADAPT_SAMPLES_TO_LIMIT 4     // Amostras mínimas até atingir o limite na taxa atual
+#define ADAPT_IDLE_PERIOD      0xFFFF // Canal que não pede nada (outro módulo, monitor desligado)
+
+class AdaptiveSampler {
+public:
+    samplingConfigStructure config;
+
+    // Período pedido por um canal (ms, já limitado a [minMs, maxMs])
+    uint16_t channelPeriod(float temp, float limit, float risePerS) const;
+
+    // Período pedido para o slot i da ingestão (ADAPT_IDLE_PERIOD = maxMs)
+    void setWanted(uint8_t i, uint16_t periodMs);
+
+    // Estica os períodos se a carga estimada passar do orçamento
+    void applyBudget(uint32_t bitrate);
+
+    uint16_t period(uint8_t i) const { return period_[i]; }
+    bool budgetLimited() const { return limited_; }
+
+    // Agenda por slot
+    bool due(uint8_t i, uint32_t nowMs) const { return (nowMs - lastMs_[i]) >= period_[i]; }
+    void sampled(uint8_t i, uint32_t nowMs) { lastMs_[i] = nowMs; }
+
+    // Bits de uma amostra por RTR: o RTR e a resposta de 8 bytes
+    static uint16_t sampleBits() {
+        return IngestTracker::frameBits(false, true, 0) + IngestTracker::frameBits(false, false, 8);
+    }
+
+private:
+    uint16_t wanted_[INGEST_MAX_IDS] = {0};   // 0 = slot fora da aquisição adaptativa
+    uint16_t period_[INGEST_MAX_IDS] = {0};
+    uint32_t lastMs_[INGEST_MAX_IDS] = {0};
+    bool limited_ = false;
+};
+
+#endif
@@ -0,0 +1,108 @@
+//═══════════════════════════════════════════════════════════════════════════
+// AQUISIÇÃO PELO ADC INTERNO EM MODO FREE-RUNNING (0x40E/0x42E)
+//═══════════════════════════════════════════════════════════════════════════
+// O ADC do ATmega2560 converte sem parar (ADATE, gatilho free-running) e a
+// ISR(ADC_vect) entrega cada conversão para onConversion(), que:
+//
+//   - soma a conversão no acumulador do canal (oversampling de 4^k amostras)
+//   - fecha a média decimada (soma >> k: 10 + k bits) e põe no anel
+//   - devolve o MUX do próximo canal da lista
+//
+// O loop() esvazia o anel com drain(): último valor e taxa medida por canal.
+// Anel de produtor único (ISR) e consumidor único (loop), índices de 8 bits:
+// atômicos no AVR, sem desligar interrupções.
+//
+// Pipeline do free-running: quando a ISR da conversão n roda, a n+1 já
+// começou com o MUX antigo; o MUX escrito agora vale para a n+2. Por isso a
+// conversão recebida é sempre do canal "em conversão", não do último escrito.
+//
+// Taxa: ADC a 16 MHz / 128 = 125 kHz, 13 ciclos por conversão = 9615/s,
+// divididas entre os canais da lista e pelo oversampling.
+//
+// Sem dependência do Arduino: registradores ficam no main.cpp.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef ADCENGINE_H
+#define ADCENGINE_H
+
+#include <stdint.h>
+
+#define ADC_INPUTS           16     // ADC0-ADC15 (máscara de 16 bits)
+#define ADC_MAX_CHANNELS     4      // Canais simultâneos na lista
+#define ADC_MAX_OVERSAMPLE   3      // 4^3 = 64 amostras: 13 bits, soma cabe em 16 bits
+#define ADC_RING_SIZE        32     // Potência de 2
+#define ADC_CONVERSIONS_PER_S 9615  // Prescaler 128, 13 ciclos por conversão
+
+struct AdcSample {
+    uint8_t slot;       // Posição na lista de canais
+    uint16_t value;     // Média decimada (10 + oversampleBits bits)
+};
+
+class AdcEngine {
+public:
+    // Monta a lista a partir da máscara (bit N = ADCN, no máximo
+    // ADC_MAX_CHANNELS). Chamar com o ADC parado. false = máscara vazia.
+    bool configure(uint16_t mask, uint8_t oversampleBits);
+
+    uint16_t mask() const { return mask_; }
+    uint8_t oversampleBits() const { return bits_; }
+    uint8_t count() const { return count_; }
+    uint8_t channel(uint8_t slot) const { return list_[slot]; }
+    uint8_t firstMux() const { return list_[0]; }
+
+    // Valor máximo da média decimada: 1023 << k
+    uint16_t fullScale() const { return (uint16_t)(1023u << bits_); }
+
+    // Taxa nominal por canal (Hz): conversões / canais / 4^k
+    uint16_t nominalHz() const;
+
+    //───────────────────────────────────────────────────────────────────────
+    // ISR: recebe a conversão e devolve o MUX a escrever
+    //───────────────────────────────────────────────────────────────────────
+    uint8_t onConversion(uint16_t raw);
+
+    //───────────────────────────────────────────────────────────────────────
+    // loop(): esvazia o anel; a cada segundo fecha a taxa medida
+    //───────────────────────────────────────────────────────────────────────
+    void drain(uint32_t nowMs);
+
+    bool valid(uint8_t slot) const { return slot < count_ && valid_[slot]; }
+    uint16_t latest(uint8_t slot) const { return latest_[slot]; }
+    uint16_t measuredHz(uint8_t slot) const { return rateHz_[slot]; }
+
+    // Valor do canal ADCn (0 se não está na lista ou ainda sem amostra)
+    uint16_t latestOf(uint8_t adcChannel) const;
+
+    uint8_t drops() const { return drops_; }          // Amostras perdidas com o anel cheio
+    uint8_t highWater() const { return highWater_; }  // Maior ocupação do anel
+
+private:
+    // Configuração (escrita só com o ADC parado)
+    uint16_t mask_ = 0;
+    uint8_t bits_ = 0;
+    uint8_t count_ = 0;
+    uint8_t list_[ADC_MAX_CHANNELS] = {0};
+
+    // Estado da ISR
+    uint8_t converting_ = 0;      // Slot da conversão em andamento
+    uint8_t queued_ = 0;          // Slot já escrito no MUX (próxima conversão)
+    uint16_t acc_[ADC_MAX_CHANNELS] = {0};
+    uint8_t samples_[ADC_MAX_CHANNELS] = {0};
+
+    // Anel ISR → loop
+    AdcSample ring_[ADC_RING_SIZE];
+    volatile uint8_t head_ = 0;   // Escrito pela ISR
+    volatile uint8_t tail_ = 0;   // Escrito pelo loop
+    volatile uint8_t drops_ = 0;
+    uint8_t highWater_ = 0;
+
+    // Consumidor
+    uint16_t latest_[ADC_MAX_CHANNELS] = {0};
+    bool valid_[ADC_MAX_CHANNELS] = {false};
+    uint16_t window_[ADC_MAX_CHANNELS] = {0};
+    uint16_t rateHz_[ADC_MAX_CHANNELS] = {0};
+    uint32_t windowStart_ = 0;
+
+    static_assert((ADC_RING_SIZE & (ADC_RING_SIZE - 1)) == 0, "ADC_RING_SIZE: potência de 2");
+};
+
+#endif
@@ -0,0 +1,75 @@
+//═══════════════════════════════════════════════════════════════════════════
+// MIGRAÇÃO DE BITRATE (500 kbps ↔ 1 Mbps) COORDENADA PELO SUPERVISOR
+//═══════════════════════════════════════════════════════════════════════════
+// O supervisor transmite 0x40C [alvo][espera ms BE] em broadcast: todos os
+// nós que cooperam recebem o mesmo frame e trocam de bitrate quando a
+// espera acaba (o instante combinado).
+//
+// Depois da troca para 1 Mbps o nó fica em TESTE por BITRATE_TRIAL_MS:
+//   - recebeu ao menos um frame e o MCP2515 não acusou erro → confirma e
+//     grava o bitrate na EEPROM
+//   - EFLG com warning/erro passivo/bus-off, ou silêncio total → volta para
+//     500 kbps e grava 500 kbps
+// Um boot com 1 Mbps na EEPROM também começa em teste.
+//
+// ⚠️ Com o cristal de 8 MHz do MCP2515, 1 Mbps só tem 4 TQ por bit (a norma
+// pede 8-25): funciona em barramento curto, sem margem para cabos longos.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef BITRATE_H
+#define BITRATE_H
+
+#include <stdint.h>
+
+#define BITRATE_TRIAL_MS         3000
+#define BITRATE_DEFAULT_DELAY_MS 1000   // Espera quando o 0x40C vem com 0
+
+enum BitrateCode : uint8_t {
+    BITRATE_500K = 0,
+    BITRATE_1M = 1
+};
+
+enum MigrationState : uint8_t {
+    MIGRATION_IDLE = 0,
+    MIGRATION_PENDING = 1,   // Aguardando o instante combinado
+    MIGRATION_TRIAL = 2,     // Já no novo bitrate, verificando o barramento
+    MIGRATION_FALLBACK = 3   // Teste falhou: voltou para 500 kbps
+};
+
+// Ações que poll() pede para o loop
+#define MIGRATION_APPLY    0x01   // Reiniciar o MCP2515 em current()
+#define MIGRATION_PERSIST  0x02   // Gravar current() na EEPROM
+
+class BitrateMigration {
+public:
+    // Bitrate lido da EEPROM no boot (0xFF/inválido = 500 kbps)
+    void begin(uint8_t stored, uint32_t nowMs);
+
+    // 0x40C; false se o alvo é inválido
+    bool request(uint8_t target, uint16_t delayMs, uint32_t nowMs);
+
+    void onRx() { if (rxSeen_ < 255) rxSeen_++; }
+
+    // Chamado a cada amostra de saúde do barramento (EFLG do MCP2515)
+    uint8_t poll(uint8_t eflg, uint32_t nowMs);
+
+    uint8_t current() const { return current_; }
+    uint8_t target() const { return target_; }
+    MigrationState state() const { return state_; }
+    uint8_t fallbacks() const { return fallbacks_; }
+    uint16_t remainingMs(uint32_t nowMs) const;
+
+    static uint32_t bitsPerSecond(uint8_t code) { return code == BITRATE_1M ? 1000000UL : 500000UL; }
+
+private:
+    uint8_t current_ = BITRATE_500K;
+    uint8_t target_ = BITRATE_500K;
+    MigrationState state_ = MIGRATION_IDLE;
+    uint32_t startMs_ = 0;      // Recebimento do pedido ou início do teste
+    uint16_t delayMs_ = 0;
+    uint8_t rxSeen_ = 0;
+    uint8_t fallbacks_ = 0;
+
+    void startTrial(uint32_t nowMs);
+};
+
+#endif
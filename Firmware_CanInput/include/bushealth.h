@@ -0,0 +1,70 @@
+//═══════════════════════════════════════════════════════════════════════════
+// SAÚDE DO BARRAMENTO - CONTADORES DE ERRO DO MCP2515 E RECUPERAÇÃO DE BUS-OFF
+//═══════════════════════════════════════════════════════════════════════════
+// A cada BUSHEALTH_SAMPLE_MS o loop lê TEC, REC e EFLG do MCP2515 e passa
+// para sample(). Frames recebidos/enviados são contados numa janela de 1 s
+// (a carga em bits continua com o IngestTracker).
+//
+// Bus-off (EFLG.TXBO): o controlador é reiniciado quando recoveryDue()
+// mandar, com espera dobrando a cada tentativa seguida (BUSHEALTH_BACKOFF_MIN_MS
+// até BUSHEALTH_BACKOFF_MAX_MS). Depois de BUSHEALTH_STABLE_MS sem bus-off a
+// espera volta ao mínimo.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef BUSHEALTH_H
+#define BUSHEALTH_H
+
+#include <stdint.h>
+
+#define BUSHEALTH_SAMPLE_MS       100
+#define BUSHEALTH_BACKOFF_MIN_MS  100
+#define BUSHEALTH_BACKOFF_MAX_MS  5000
+#define BUSHEALTH_STABLE_MS       10000
+
+// Bits do registrador EFLG do MCP2515
+#define EFLG_EWARN   0x01   // TEC ou REC >= 96
+#define EFLG_RXWAR   0x02
+#define EFLG_TXWAR   0x04
+#define EFLG_RXEP    0x08   // Erro passivo na recepção (REC >= 128)
+#define EFLG_TXEP    0x10   // Erro passivo na transmissão (TEC >= 128)
+#define EFLG_TXBO    0x20   // Bus-off (TEC > 255)
+#define EFLG_RX0OVR  0x40   // Buffer RX0 sobrescrito (o loop limpa depois de cada amostra)
+#define EFLG_RX1OVR  0x80
+
+class BusHealth {
+public:
+    // Leitura dos registradores; retorna true se o nó está em bus-off
+    bool sample(uint8_t tec, uint8_t rec, uint8_t eflg, uint32_t nowMs);
+
+    void countRx() { rxWindow_++; }
+    void countTx() { txWindow_++; }
+    void update(uint32_t nowMs);                 // Fecha a janela a cada 1 s
+
+    // Bus-off: hora de tentar reiniciar o controlador?
+    bool recoveryDue(uint32_t nowMs) const;
+    void recoveryAttempted(uint32_t nowMs);
+
+    uint8_t tec() const { return tec_; }
+    uint8_t rec() const { return rec_; }
+    uint8_t eflg() const { return eflg_; }
+    uint8_t eflgSeen() const { return eflgSeen_; }   // OU de todos os EFLG da janela
+    bool busOff() const { return busOff_; }
+    uint8_t recoveries() const { return recoveries_; }
+    uint16_t backoffMs() const { return backoffMs_; }
+    uint16_t rxPerSecond() const { return rxLast_; }
+    uint16_t txPerSecond() const { return txLast_; }
+
+private:
+    uint8_t tec_ = 0, rec_ = 0, eflg_ = 0;
+    uint8_t eflgSeen_ = 0, eflgWindow_ = 0;
+    bool busOff_ = false;
+    uint8_t recoveries_ = 0;                     // Satura em 255
+    uint16_t backoffMs_ = BUSHEALTH_BACKOFF_MIN_MS;
+    uint32_t busOffMs_ = 0;                      // Início do bus-off ou da última tentativa
+    uint32_t lastBusOffMs_ = 0;
+
+    uint32_t windowStartMs_ = 0;
+    uint16_t rxWindow_ = 0, txWindow_ = 0;
+    uint16_t rxLast_ = 0, txLast_ = 0;
+};
+
+#endif
@@ -0,0 +1,359 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Universidade de Brasilia (UnB)
+// Faculdade do Gama
+// Projeto: SegurAuto
+// Biblioteca para comunicar com o radar ARS404 V1
+// DUFOUR Amelie
+//////////////////////////////////////////////////////////////////////////////////
+
+// /!\tem a explicacao das funcao na documentacao sobre a biblioteca "AR404"
+#ifndef config_H
+#define config_H
+
+#ifdef ARDUINO
+#include <SPI.h>
+#include "mcp2515.h"
+#else
+// Build no host (Host_CanToolkit): os codecs abaixo sao C++ puro
+#include <stdint.h>
+typedef bool boolean;
+#endif
+
+struct safetyConfigStructure {
+	uint8_t saveeeprom = 0;
+	uint8_t Monit_Enable = 0;
+	float	maxtemp = 0;
+	uint16_t timer = 1000; // Milliseconds
+};
+
+struct aquisitionConfigStructure {
+	uint8_t Aquics_Enable_Continuous, Aquics_Enable = 0;
+	boolean	analog = 0;
+	uint16_t timer = 1000; // Milliseconds
+};
+
+struct tempReadStructure {
+	int8_t CJtemp = 25;
+	int8_t TLstatus, TRstatus, BLstatus, BRstatus = 0;
+	int16_t TLtemp, TRtemp, BLtemp, BRtemp = 0;
+};
+
+// 0x427: estado da ingestão em push (resposta ao 0x407)
+struct ingestStatusStructure {
+	uint8_t mode = 1;             // 0 = polling por RTR, 1 = push com RTR para IDs velhos
+	uint8_t pushMask = 0;         // bit i = ID i da tabela transmite sozinho
+	uint8_t freshMask = 0;        // bit i = ID i fresco (sem RTR neste ciclo)
+	uint16_t loadPermille = 0;    // Carga vista pelo nó no último segundo (‰)
+	uint16_t pollLoadPermille = 0;// Estimativa com o polling antigo (‰)
+	uint8_t rtrSent = 0, rtrSkipped = 0; // RTRs no último segundo
+};
+
+// 0x408/0x428: idade das temperaturas dos canais de segurança
+// Ação quando um canal fica sem amostra por mais de maxAgeMs:
+enum StaleAction : uint8_t {
+	STALE_REPORT = 0,   // Só avisa (0x428 e serial)
+	STALE_TRIP = 1,     // Trata como limite atingido: relés de disparo (padrão)
+	STALE_RELEASE = 2   // Desliga os relés de normalização do canal
+};
+
+struct freshnessConfigStructure {
+	uint8_t action = STALE_TRIP;
+	uint16_t maxAgeMs = 3000;     // Deve ser >= 2x o período de aquisição (0x404)
+};
+
+struct freshnessStatusStructure {
+	uint8_t usedMask = 0;         // bit N = canal T(N+1) existe no perfil
+	uint8_t staleMask = 0;        // bit N = canal sem amostra há mais de maxAgeMs
+	uint8_t action = STALE_TRIP;
+	uint16_t maxAgeMs = 3000;
+	uint16_t ageMs[4] = {0, 0, 0, 0};  // Idade da última amostra (satura em 65535)
+};
+
+// 0x409/0x429: aquisição adaptativa (período por módulo conforme o limite)
+struct samplingConfigStructure {
+	uint8_t enabled = 1;          // 0 = período fixo aquisc.timer para todos
+	uint16_t minMs = 20;          // Período no limite / subindo rápido
+	uint16_t maxMs = 500;         // Período longe do limite
+	uint8_t marginC = 30;         // Abaixo do limite a partir de onde acelera (°C)
+	uint8_t budgetPermille = 50;  // Carga máxima da aquisição (‰ do bitrate, 0 = sem limite)
+};
+
+struct samplingStatusStructure {
+	samplingConfigStructure config;
+	uint8_t budgetLimited = 0;    // Períodos esticados pelo orçamento
+	uint16_t periodMs[3] = {0, 0, 0};  // Período atual de 0x510/0x520/0x530
+};
+
+// 0x40A/0x42A: relatório por mudança e heartbeat
+struct reportConfigStructure {
+	uint8_t mode = 1;             // 0 = sempre envia, 1 = só quando muda
+	uint8_t heartbeatS = 5;       // Período do heartbeat 0x42A (s), 0 = desligado
+};
+
+struct heartbeatStructure {
+	reportConfigStructure config;
+	uint32_t uptimeS = 0;
+	uint8_t sent = 0, suppressed = 0;  // Frames de estado na última janela do heartbeat
+};
+
+// 0x42B: saúde do barramento vista pelo MCP2515 (1 s, ou RTR no 0x40B)
+struct busHealthStructure {
+	uint8_t tec = 0, rec = 0;     // Contadores de erro de transmissão/recepção
+	uint8_t eflg = 0;             // OU dos EFLG lidos no último segundo
+	uint8_t recoveries = 0;       // Reinícios por bus-off desde o boot (satura em 255)
+	uint16_t loadPermille = 0;    // Carga do barramento no último segundo (‰)
+	uint16_t rxPerS = 0, txPerS = 0; // Frames por segundo
+};
+
+// 0x40C/0x42C: migração de bitrate (0 = 500 kbps, 1 = 1 Mbps)
+struct bitrateCommandStructure {
+	uint8_t target = 0;
+	uint16_t delayMs = 0;         // Espera até a troca (0 = padrão do firmware)
+};
+
+struct bitrateStatusStructure {
+	uint8_t current = 0;
+	uint8_t state = 0;            // MigrationState (bitrate.h)
+	uint8_t target = 0;
+	uint16_t remainingMs = 0;     // Até a troca ou até o fim do teste
+	uint8_t stored = 0;           // Valor na EEPROM
+	uint8_t fallbacks = 0;        // Testes de 1 Mbps que falharam desde o boot
+};
+
+// 0x40D/0x42D: contagem de pulsos (canal 0 = motor, 1 = bomba; ver pulse.h)
+struct pulseConfigStructure {
+	uint8_t enableMask = 0;       // bit N = canal N contando
+	uint16_t gateMs[2] = {100, 100};  // Janela de contagem (10-2550 ms)
+	uint16_t ppr[2] = {1, 1};     // Pulsos por volta (RPM)
+};
+
+struct pulseStatusStructure {
+	uint16_t rpm[2] = {0, 0};
+	uint16_t frequencyHz[2] = {0, 0};  // Satura em 65535
+};
+
+// 0x40E/0x42E: ADC interno em free-running (ver adcengine.h)
+struct adcConfigStructure {
+	uint16_t channelMask = 0x0003;  // bit N = ADCN (até 4 canais)
+	uint8_t oversampleBits = 2;     // 4^k amostras por valor: 10 + k bits (0-3)
+};
+
+struct adcStatusStructure {
+	adcConfigStructure config;
+	uint8_t running = 0;          // aquisc.analog ligado e lista não vazia
+	uint8_t drops = 0;            // Amostras perdidas com o anel cheio
+	uint16_t measuredHz = 0;      // Taxa medida por canal (primeiro da lista)
+	uint16_t nominalHz = 0;       // Taxa teórica por canal
+};
+
+// 0x40F/0x42F: download do histórico (ver history.h); dados no 0x430
+enum HistoryCommand : uint8_t {
+	HISTORY_CMD_STATUS = 0,
+	HISTORY_CMD_START = 1,       // Congela e transmite tudo
+	HISTORY_CMD_ABORT = 2,
+	HISTORY_CMD_CLEAR = 3
+};
+
+enum HistoryTransferState : uint8_t {
+	HISTORY_IDLE = 0,
+	HISTORY_SENDING = 1,
+	HISTORY_DONE = 2,            // Último frame de dados enviado
+	HISTORY_ABORTED = 3
+};
+
+struct historyStatusStructure {
+	uint8_t state = HISTORY_IDLE;
+	uint16_t length = 0;          // Bytes do download (parado: bytes no anel)
+	uint8_t period10ms = 25;      // Período das amostras / 10 ms
+	uint32_t uptimeMs = 0;        // millis() quando o status saiu (alinha os KEYs)
+};
+
+// 0x080: SYNC do mestre, [seq]; 0x081: FOLLOW-UP, [seq][0][t1 µs 48 bits BE] (timesync.h)
+// 0x431: estado do relógio do nó depois de cada par SYNC/FOLLOW-UP
+struct timeSyncStatusStructure {
+	uint8_t state = 0;            // TimeSyncState
+	uint8_t seq = 0;
+	int16_t offsetUs = 0;         // t1 - relógio do nó em t2, antes da correção (satura)
+	int16_t drift01ppm = 0;       // Correção de frequência (0,1 ppm)
+	uint8_t rejected = 0;         // SYNCs sem t2 confiável (satura)
+	uint8_t samples = 0;          // Pares aplicados (mod 256)
+};
+
+// 0x432: amostra com o tempo sincronizado, [canal][valor int16 BE][µs 40 bits BE]
+enum StampedChannel : uint8_t {
+	STAMP_T1 = 0,                 // T1..T4: temperatura filtrada em 0,25 °C
+	STAMP_DOWNPIPE = 4,           // ADC decimado, 10 + k bits (0x426)
+	STAMP_VALVE = 5
+};
+
+struct stampedSampleStructure {
+	uint8_t channel = 0;
+	int16_t value = 0;
+	uint64_t timeUs = 0;          // Só os 40 bits de baixo vão no fio (~12,7 dias)
+};
+
+// ISO-TP (0x400 → nó, 0x420 ← nó, ver isotp.h): serviços sem o limite de 8 bytes
+// Resposta positiva = serviço | 0x40; negativa = [0x7F][serviço][código]
+enum IsoTpService : uint8_t {
+	ISOTP_SVC_READ_SAFETY = 0x01,  // → [0x41][4 x registro de canal]
+	ISOTP_SVC_WRITE_SAFETY = 0x02, // [0x02][canal][registro][salva] → [0x42][canal][registro]
+	ISOTP_SVC_READ_HISTORY = 0x03, // → [0x43][stream do histórico (history.h)]
+	ISOTP_SVC_TRANSPORT = 0x04,    // [0x04][BS][STmin] → [0x44][BS][STmin] (FC do nó)
+	ISOTP_SVC_READ_PARAM = 0x05,   // [0x05][índice] → [0x45][registro de parâmetro]
+	ISOTP_SVC_WRITE_PARAM = 0x06,  // [0x06][índice][valor BE 4] → [0x46][registro aplicado]
+	ISOTP_SVC_BULK_READ = 0x07,    // [0x07][primeiro][quantos] → [0x47][primeiro][quantos] + n x [tipo][valor BE 4]
+	ISOTP_SVC_DESCRIBE = 0x08,     // [0x08][primeiro][quantos] → [0x48][primeiro][quantos] + n x descrição (objdict.h)
+	ISOTP_SVC_NEGATIVE = 0x7F
+};
+
+enum IsoTpNrc : uint8_t {
+	ISOTP_NRC_NOT_SUPPORTED = 0x11,
+	ISOTP_NRC_BAD_LENGTH = 0x13,
+	ISOTP_NRC_BUSY = 0x21,        // Download do histórico já em andamento
+	ISOTP_NRC_READ_ONLY = 0x22,   // Parâmetro sem PARAM_WRITE
+	ISOTP_NRC_OUT_OF_RANGE = 0x31
+};
+
+#define ISOTP_POSITIVE 0x40
+#define SAFETY_RECORD_BYTES 7     // [habilita][maxtemp float BE][timer ms BE]
+
+// Dicionário de parâmetros (objdict.h): índice = posição na tabela do main.cpp.
+// Novos parâmetros entram no fim; os índices publicados não mudam.
+enum ObjectIndex : uint8_t {
+	OD_T1_ENABLE, OD_T1_MAXTEMP, OD_T1_TIMER,
+	OD_T2_ENABLE, OD_T2_MAXTEMP, OD_T2_TIMER,
+	OD_T3_ENABLE, OD_T3_MAXTEMP, OD_T3_TIMER,
+	OD_T4_ENABLE, OD_T4_MAXTEMP, OD_T4_TIMER,
+	OD_AQ_PERIOD, OD_AQ_CONTINUOUS, OD_AQ_ANALOG, OD_AQ_RUN,
+	OD_INGEST_MODE,
+	OD_STALE_ACTION, OD_STALE_MAX_AGE,
+	OD_SAMPLING_ENABLED, OD_SAMPLING_MIN, OD_SAMPLING_MAX, OD_SAMPLING_MARGIN, OD_SAMPLING_BUDGET,
+	OD_REPORT_MODE, OD_REPORT_HEARTBEAT,
+	OD_PULSE_MASK, OD_PULSE_GATE0, OD_PULSE_GATE1, OD_PULSE_PPR0, OD_PULSE_PPR1,
+	OD_ADC_MASK, OD_ADC_OVERSAMPLE,
+	OD_ISOTP_BS, OD_ISOTP_STMIN,
+	OD_CAN_BITRATE,               // Só leitura: troca pelo 0x40C
+	OD_RAM_STATIC,                // Só leitura: .data + .bss (bytes)
+	OD_STACK_SIZE,                // Só leitura: região pintada da pilha
+	OD_STACK_FREE,                // Só leitura: folga mínima da pilha desde o boot
+	OD_SYNC_ALIGN,                // Ciclo de aquisição nos múltiplos do tempo sincronizado
+	OD_SYNC_STAMP,                // Amostras com tempo sincronizado no 0x432
+	OD_COUNT
+};
+
+// Registro dos serviços 0x05/0x06: [índice][tipo][flags][valor BE 4]
+#define PARAM_RECORD_BYTES 7
+
+struct paramValueStructure {
+	uint8_t index = 0;
+	uint8_t type = 0;             // ParamType (objdict.h)
+	uint8_t flags = 0;            // ParamFlags
+	uint32_t wire = 0;            // Inteiro estendido ou bits do float
+};
+
+#define TempFrameId 0x123
+#define saveEepromId 0x120
+
+// para usar o tipo "byte" do arduino
+typedef unsigned char byte;
+
+void readDigital(byte *buf, int digitalCommand[8]);
+
+int readPWMEnc (byte *buf, int num);
+
+void sendDigital(int digitalCommand[8], int PWM1, int PWM2, int Enc, byte *txBuf);
+
+safetyConfigStructure safetyConfig (byte *buf);
+
+void sendsafetyConfig (safetyConfigStructure tempc, byte *txBuf);
+
+aquisitionConfigStructure aquisitionConfig(byte *buf);
+
+void sendaquisitionConfig(aquisitionConfigStructure aquisc, byte *txBuf);
+
+tempReadStructure tempRead(byte *buf);
+
+// Formatos efetivamente usados pelo loop() (0x403/0x406, 0x404, 0x405)
+void readSafetyPair(byte *buf, safetyConfigStructure &first, safetyConfigStructure &second);
+
+void sendSafetyPair(const safetyConfigStructure &first, const safetyConfigStructure &second, byte *txBuf);
+
+aquisitionConfigStructure readAquisitionFrame(byte *buf, aquisitionConfigStructure current);
+
+void sendAquisitionFrame(const aquisitionConfigStructure &aquisc, byte *txBuf);
+
+uint8_t readStartStop(byte *buf);
+
+void sendStartStop(uint8_t enable, byte *txBuf);
+
+uint8_t readIngestMode(byte *buf);
+
+void sendIngestStatus(const ingestStatusStructure &status, byte *txBuf);
+
+ingestStatusStructure readIngestStatus(const byte *buf);
+
+freshnessConfigStructure readFreshnessConfig(byte *buf, freshnessConfigStructure current);
+
+void sendFreshnessStatus(const freshnessStatusStructure &status, byte *txBuf);
+
+freshnessStatusStructure readFreshnessStatus(const byte *buf);
+
+samplingConfigStructure readSamplingConfig(byte *buf, samplingConfigStructure current);
+
+void sendSamplingStatus(const samplingStatusStructure &status, byte *txBuf);
+
+samplingStatusStructure readSamplingStatus(const byte *buf);
+
+reportConfigStructure readReportConfig(byte *buf, reportConfigStructure current);
+
+void sendHeartbeat(const heartbeatStructure &hb, byte *txBuf);
+
+heartbeatStructure readHeartbeat(const byte *buf);
+
+void sendBusHealth(const busHealthStructure &health, byte *txBuf);
+
+busHealthStructure readBusHealth(const byte *buf);
+
+bitrateCommandStructure readBitrateCommand(byte *buf);
+
+void sendBitrateStatus(const bitrateStatusStructure &status, byte *txBuf);
+
+bitrateStatusStructure readBitrateStatus(const byte *buf);
+
+pulseConfigStructure readPulseConfig(byte *buf, pulseConfigStructure current);
+
+void sendPulseStatus(const pulseStatusStructure &status, byte *txBuf);
+
+pulseStatusStructure readPulseStatus(const byte *buf);
+
+adcConfigStructure readAdcConfig(byte *buf, adcConfigStructure current);
+
+void sendAdcStatus(const adcStatusStructure &status, byte *txBuf);
+
+adcStatusStructure readAdcStatus(const byte *buf);
+
+void sendHistoryStatus(const historyStatusStructure &status, byte *txBuf);
+
+historyStatusStructure readHistoryStatus(const byte *buf);
+
+void sendSafetyRecord(const safetyConfigStructure &config, byte *txBuf);
+
+safetyConfigStructure readSafetyRecord(const byte *buf);
+
+void sendParamValue(const paramValueStructure &value, byte *txBuf);
+
+paramValueStructure readParamValue(const byte *buf);
+
+void sendTimeFollowUp(uint8_t seq, uint64_t masterUs, byte *txBuf);
+
+uint64_t readTimeFollowUp(const byte *buf, uint8_t &seq);
+
+void sendTimeSyncStatus(const timeSyncStatusStructure &status, byte *txBuf);
+
+timeSyncStatusStructure readTimeSyncStatus(const byte *buf);
+
+void sendStampedSample(const stampedSampleStructure &sample, byte *txBuf);
+
+stampedSampleStructure readStampedSample(const byte *buf);
+
+#endif
\ No newline at end of file
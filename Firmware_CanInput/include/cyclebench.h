@@ -0,0 +1,43 @@
+//═══════════════════════════════════════════════════════════════════════════
+// MARCAS DE CICLO PARA O SIMULADOR (ambiente bench_cycles)
+//═══════════════════════════════════════════════════════════════════════════
+// Com CYCLE_BENCH, CYCLE_BEGIN/CYCLE_END escrevem o número da marca em
+// GPIOR1/GPIOR2 (um OUT, 1 ciclo; registradores de uso geral que nada mais
+// no firmware usa). O avr_cycles do Host_CanToolkit roda o ELF no simavr,
+// observa essas escritas e conta os ciclos entre o início e o fim de cada
+// marca. Sem CYCLE_BENCH as macros somem e o firmware é o mesmo de sempre.
+//
+// As marcas podem se aninhar (CYCLE_LOOP contém as outras), mas a mesma
+// marca não pode abrir de novo antes de fechar. CYCLE_CAL é um par vazio no
+// fim do setup(): o custo da própria marca, descontado das demais.
+//
+// A barreira de memória impede o compilador de mover loads/stores para
+// fora do trecho medido; contas só em registradores ainda podem escapar.
+//
+// Sem dependência do Arduino: o host usa só os números das marcas.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef CYCLEBENCH_H
+#define CYCLEBENCH_H
+
+#include <stdint.h>
+
+enum CycleMark : uint8_t {
+    CYCLE_CAL = 1,         // Par vazio (calibração)
+    CYCLE_LOOP,            // Uma volta do loop()
+    CYCLE_TEMP_READ,       // tempRead() de um 0x510/0x520/0x530
+    CYCLE_FILTER,          // EMA dos 4 canais (SafetyChannel::onTemperature)
+    CYCLE_DIGITAL_CMD,     // Tratamento do 0x402 com dados (relés, PWM, eco 0x422)
+    CYCLE_MOTOR,           // setMotor()
+    CYCLE_MARKS
+};
+
+#ifdef CYCLE_BENCH
+#include <avr/io.h>
+#define CYCLE_BEGIN(mark) do { __asm__ __volatile__("" ::: "memory"); GPIOR1 = (mark); } while (0)
+#define CYCLE_END(mark)   do { GPIOR2 = (mark); __asm__ __volatile__("" ::: "memory"); } while (0)
+#else
+#define CYCLE_BEGIN(mark) do { } while (0)
+#define CYCLE_END(mark)   do { } while (0)
+#endif
+
+#endif
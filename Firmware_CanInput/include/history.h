@@ -0,0 +1,145 @@
+//═══════════════════════════════════════════════════════════════════════════
+// HISTÓRICO EM RAM COM CODIFICAÇÃO DELTA (0x40F/0x42F, dados no 0x430)
+//═══════════════════════════════════════════════════════════════════════════
+// Anel de bytes com as temperaturas filtradas, o estado dos relés e os
+// eventos de alarme dos últimos minutos, para análise depois de um disparo
+// sem depender do PC ter estado ligado.
+//
+// Registros (o byte de tag diz o tipo e o tamanho):
+//
+//   DELTA  00rm cccc  + 1 byte int8 por canal c mudado + relés se r
+//                     tempo = amostra anterior + HISTORY_PERIOD_MS
+//   KEY    01-- ----  + ms u32 + 4 x int16 + relés (BE)     14 bytes
+//   EVENT  10ee eeee  + argumento + ms desde a amostra / 2    3 bytes
+//
+// Temperatura em 0,25 °C (int16). Amostra sem mudança = 1 byte. Um KEY
+// abre cada segmento de até HISTORY_KEY_EVERY amostras e também sai quando
+// um delta não cabe em int8 ou o período atrasou: o anel descarta sempre um
+// segmento inteiro (o mais antigo), então o primeiro registro é um KEY e
+// o histórico sempre pode ser decodificado.
+//
+// Download: begin() congela o trecho [mais antigo, mais novo] e chunk()/
+// advance() entregam 7 bytes por frame. Durante o download nada é
+// descartado; amostras sem espaço são perdidas e contadas num EVENT
+// HIST_EV_LOST (e o próximo registro é um KEY).
+//
+// Sem dependência do Arduino. No host (Host_CanToolkit) há também o
+// decodificador (historyDecode) usado pelo benchmark history_bench.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdint.h>
+
+#ifndef ARDUINO
+#include <stddef.h>
+#include <vector>
+#endif
+
+#ifndef HISTORY_BYTES
+#define HISTORY_BYTES       2048    // Potência de 2 (ver history_bench para a duração)
+#endif
+#define HISTORY_PERIOD_MS   250     // Uma amostra a cada 250 ms
+#define HISTORY_CHANNELS    4       // T1..T4
+#define HISTORY_KEY_EVERY   64      // Amostras por segmento (máximo)
+#define HISTORY_KEY_BYTES   14
+#define HISTORY_EVENT_BYTES 3
+
+// Tag
+#define HIST_TAG_DELTA      0x00
+#define HIST_TAG_KEY        0x40
+#define HIST_TAG_EVENT      0x80
+#define HIST_TAG_TYPE       0xC0
+#define HIST_DELTA_RELAYS   0x10
+
+// Eventos (6 bits)
+enum HistoryEvent : uint8_t {
+    HIST_EV_BOOT = 0,       // arg = MCUSR (causa do reset)
+    HIST_EV_TRIP,           // arg = canal (0-3)
+    HIST_EV_NORMAL,         // arg = canal
+    HIST_EV_STALE,          // arg = canal
+    HIST_EV_FRESH,          // arg = canal
+    HIST_EV_RELEASE,        // arg = canal (fail-safe STALE_RELEASE)
+    HIST_EV_BUSOFF,         // arg = recuperações (satura em 255)
+    HIST_EV_BITRATE,        // arg = BitrateCode aplicado
+    HIST_EV_LOST,           // arg = amostras perdidas durante um download
+    HIST_EV_STACK           // arg = folga da pilha (bytes, < STACK_WARN_BYTES)
+};
+
+// Temperatura (°C) → unidades de 0,25 °C, saturando em int16
+int16_t historyQuantize(float celsius);
+
+class HistoryLog {
+public:
+    // Amostra: chamar a cada HISTORY_PERIOD_MS (o chamador controla o tempo)
+    void sample(uint32_t nowMs, const int16_t temp[HISTORY_CHANNELS], uint8_t relays);
+
+    // Evento entre amostras
+    void event(uint32_t nowMs, uint8_t code, uint8_t arg);
+
+    void clear();
+
+    uint16_t size() const { return (uint16_t)(head_ - tail_); }
+    uint16_t capacity() const { return HISTORY_BYTES; }
+    uint32_t oldestMs() const { return oldestMs_; }   // ms do KEY mais antigo
+
+    //───────────────────────────────────────────────────────────────────────
+    // DOWNLOAD
+    //───────────────────────────────────────────────────────────────────────
+    void begin();                          // Congela o conteúdo atual
+    void abort() { downloading_ = false; }
+    bool downloading() const { return downloading_; }
+    uint16_t length() const { return (uint16_t)(end_ - start_); }
+    uint16_t position() const { return (uint16_t)(read_ - start_); }
+
+    // Copia até 7 bytes a partir da posição atual (0 = fim)
+    uint8_t chunk(uint8_t *out) const;
+    void advance(uint8_t n);
+
+    // Acesso direto ao conteúdo congelado (ISO-TP, serviço 0x03)
+    uint8_t read(uint16_t offset, uint8_t *out, uint8_t n) const;
+
+private:
+    uint8_t buf_[HISTORY_BYTES];
+    uint32_t head_ = 0, tail_ = 0;         // Posições absolutas (índice = pos % HISTORY_BYTES)
+    uint32_t oldestMs_ = 0;
+
+    // Estado do codificador
+    int16_t last_[HISTORY_CHANNELS] = {0};
+    uint8_t lastRelays_ = 0;
+    uint32_t lastMs_ = 0;
+    uint8_t sinceKey_ = 0;
+    bool needKey_ = true;
+    uint8_t lost_ = 0;
+
+    // Download
+    bool downloading_ = false;
+    uint32_t start_ = 0, end_ = 0, read_ = 0;
+
+    static_assert((HISTORY_BYTES & (HISTORY_BYTES - 1)) == 0, "HISTORY_BYTES: potência de 2");
+
+    uint8_t at(uint32_t pos) const { return buf_[pos & (HISTORY_BYTES - 1)]; }
+    void put(uint8_t b) { buf_[head_++ & (HISTORY_BYTES - 1)] = b; }
+    uint8_t recordLength(uint32_t pos) const;
+    bool reserve(uint8_t n);
+    void writeKey(uint32_t nowMs, const int16_t temp[HISTORY_CHANNELS], uint8_t relays);
+    void flushLost(uint32_t nowMs);
+};
+
+#ifndef ARDUINO
+//───────────────────────────────────────────────────────────────────────────
+// DECODIFICADOR (só no host)
+//───────────────────────────────────────────────────────────────────────────
+struct HistoryRecord {
+    uint32_t ms;
+    bool isEvent;
+    uint8_t code, arg;                     // Evento
+    int16_t temp[HISTORY_CHANNELS];        // 0,25 °C
+    uint8_t relays;
+};
+
+// false = stream truncado ou sem KEY no início (os registros até ali ficam em out)
+bool historyDecode(const uint8_t *data, size_t n, std::vector<HistoryRecord> &out);
+#endif
+
+#endif
@@ -0,0 +1,91 @@
+//═══════════════════════════════════════════════════════════════════════════
+// INGESTÃO DE SENSORES EM MODO PUSH (COM RTR SÓ PARA IDs VELHOS)
+//═══════════════════════════════════════════════════════════════════════════
+// Os módulos CANmod.Temp e CAN input podem transmitir sozinhos (CAN input:
+// "trigger": 0 + "scaler" em config-01.04.json). Para cada ID rastreado:
+//
+//   - frame que chega sem RTR pendente = espontâneo (push); dois seguidos
+//     dão o período medido (média exponencial, peso 1/4)
+//   - o ID está FRESCO se está em push, o período medido atende a taxa de
+//     aquisição pedida e o último frame tem menos de 2 períodos
+//   - a cada ciclo de aquisição, só IDs não frescos recebem RTR
+//
+// Também contabiliza a carga do barramento vista pelo nó (frames recebidos
+// e enviados, bits nominais sem stuffing) e estima quanto seria com o
+// polling antigo (a mesma carga + os RTRs economizados).
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef INGEST_H
+#define INGEST_H
+
+#include <stdint.h>
+
+#define INGEST_MAX_IDS         8
+#define INGEST_RTR_WINDOW_MS   50    // Resposta a um RTR chega dentro desta janela
+#define INGEST_FRESH_MARGIN_MS 10    // Folga sobre 2 períodos antes de considerar velho
+
+enum IngestMode : uint8_t {
+    INGEST_POLL = 0,  // Comportamento antigo: RTR para todos a cada ciclo
+    INGEST_PUSH = 1   // Push esperado, RTR apenas para IDs velhos (padrão)
+};
+
+struct IngestSlot {
+    uint16_t id = 0;
+    bool rtrFallback = false;   // Este nó pode pedir o ID por RTR
+    bool rtrPending = false;    // RTR (nosso ou de outro nó) sem resposta ainda
+    uint8_t pushCount = 0;      // Frames espontâneos seguidos (satura em 255)
+    uint16_t periodMs = 0;      // Período medido dos frames espontâneos
+    uint32_t rtrMs = 0;
+    uint32_t lastMs = 0;        // Último frame de dados (qualquer origem)
+    uint32_t lastPushMs = 0;    // Último frame espontâneo
+    bool seen = false;
+};
+
+class IngestTracker {
+public:
+    IngestMode mode = INGEST_PUSH;
+    uint32_t bitrate = 500000;
+
+    // Registra um ID rastreado; retorna o índice ou -1 se a tabela estiver cheia
+    int add(uint16_t id, bool rtrFallback);
+    uint8_t size() const { return count_; }
+    const IngestSlot &slot(uint8_t i) const { return slots_[i]; }
+    int find(uint16_t id) const;
+
+    // Frame recebido (dados ou RTR de qualquer nó). Retorna o índice do ID ou -1.
+    int onFrame(uint16_t id, bool remote, uint32_t nowMs);
+
+    // Em push, com período medido <= wantedPeriodMs (+25%) e sem atraso
+    bool fresh(uint8_t i, uint32_t nowMs, uint16_t wantedPeriodMs) const;
+
+    // Decide se o ciclo de aquisição deve mandar RTR para o slot i
+    bool needsRtr(uint8_t i, uint32_t nowMs, uint16_t wantedPeriodMs) const;
+    void rtrSent(uint8_t i, uint32_t nowMs);
+    void rtrSkipped(uint8_t) { skippedWindow_++; }
+
+    //───────────────────────────────────────────────────────────────────────
+    // CARGA DO BARRAMENTO (janela de 1 s)
+    //───────────────────────────────────────────────────────────────────────
+    void countFrame(bool extended, bool remote, uint8_t dlc);
+    void update(uint32_t nowMs);                // Fecha a janela a cada 1 s
+    uint16_t loadPermille() const { return loadPermille_; }
+    uint16_t pollLoadPermille() const { return pollLoadPermille_; }
+    uint8_t rtrSentLast() const { return rtrLast_; }
+    uint8_t rtrSkippedLast() const { return skippedLast_; }
+    uint8_t pushMask() const;
+    uint8_t freshMask(uint32_t nowMs, uint16_t wantedPeriodMs) const;
+
+    // Bits nominais de um frame: cabeçalho + dados + CRC + ACK + EOF + IFS
+    static uint16_t frameBits(bool extended, bool remote, uint8_t dlc);
+
+private:
+    IngestSlot slots_[INGEST_MAX_IDS];
+    uint8_t count_ = 0;
+
+    uint32_t windowStartMs_ = 0;
+    uint32_t bitsWindow_ = 0;
+    uint16_t rtrWindow_ = 0, skippedWindow_ = 0;
+    uint16_t loadPermille_ = 0, pollLoadPermille_ = 0;
+    uint8_t rtrLast_ = 0, skippedLast_ = 0;
+};
+
+#endif
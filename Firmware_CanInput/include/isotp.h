@@ -0,0 +1,127 @@
+//═══════════════════════════════════════════════════════════════════════════
+// ISO-TP (ISO 15765-2) - MENSAGENS DE ATÉ 4095 BYTES SOBRE FRAMES CAN
+//═══════════════════════════════════════════════════════════════════════════
+// Endereçamento normal, IDs de 11 bits, um canal (rxId/txId):
+//
+//   SF  0L dd dd dd dd dd dd dd     mensagem de até 7 bytes
+//   FF  1L LL dd dd dd dd dd dd     primeiro frame, tamanho de 12 bits
+//   CF  2N dd dd dd dd dd dd dd     consecutivo, N = sequência (mod 16)
+//   FC  3S BS ST                    controle de fluxo: S = 0 continua,
+//                                   1 espera, 2 estouro; BS frames por
+//                                   bloco (0 = sem limite); ST = STmin
+//
+// Recepção: guarda até ISOTP_RX_MAX bytes e responde FC com blockSize/stMin
+// (ajustáveis). Transmissão: dados de um buffer ou de uma função fonte
+// (ex.: o histórico de 2 KB, sem cópia), respeitando o BS e o STmin que o
+// receptor pedir. Frames sempre com DLC 8 (preenchimento 0xCC).
+//
+// Sem dependência do Arduino: o envio de frames e a fonte de dados são
+// ponteiros de função com contexto, o tempo (µs) vem por parâmetro.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef ISOTP_H
+#define ISOTP_H
+
+#include <stdint.h>
+
+#ifndef ISOTP_RX_MAX
+#define ISOTP_RX_MAX        128     // Maior mensagem recebida (bytes)
+#endif
+#define ISOTP_TX_BUF        64      // Cópia das respostas curtas (send com buffer)
+#define ISOTP_MAX_LEN       4095
+#define ISOTP_TIMEOUT_US    1000000UL  // N_Bs / N_Cr: 1 s sem FC ou CF aborta
+#define ISOTP_CF_PER_POLL   4       // CFs seguidos por poll() com STmin 0
+#define ISOTP_PAD           0xCC
+
+// Frame de saída: id + 8 bytes. false = driver ocupado (tenta no próximo poll)
+typedef bool (*IsoTpSendFn)(void *ctx, uint16_t id, const uint8_t *data, uint8_t len);
+
+// Fonte dos dados: copia n bytes a partir de offset, retorna quantos copiou
+typedef uint8_t (*IsoTpSourceFn)(void *ctx, uint16_t offset, uint8_t *out, uint8_t n);
+
+enum IsoTpError : uint8_t {
+    ISOTP_OK = 0,
+    ISOTP_ERR_TIMEOUT,      // Sem FC (transmissão) ou sem CF (recepção) a tempo
+    ISOTP_ERR_SEQUENCE,     // CF fora de ordem
+    ISOTP_ERR_OVERFLOW,     // FF maior que ISOTP_RX_MAX (respondeu FC estouro) ou FC estouro recebido
+    ISOTP_ERR_UNEXPECTED    // CF/FC sem transferência em andamento
+};
+
+struct IsoTpStats {
+    uint16_t rxMessages = 0, txMessages = 0;
+    uint16_t errors = 0;
+    uint8_t lastError = ISOTP_OK;
+};
+
+class IsoTp {
+public:
+    IsoTp(uint16_t txId, IsoTpSendFn send, void *ctx) : txId_(txId), send_(send), ctx_(ctx) {}
+
+    // FC enviado quando este lado recebe (ajustável em operação)
+    uint8_t blockSize = 8;          // CFs por bloco, 0 = sem limite
+    uint8_t stMin = 0;              // Codificação ISO: 0-127 ms, 0xF1-0xF9 = 100-900 µs
+
+    // Frame recebido no rxId (só o payload)
+    void onFrame(const uint8_t *data, uint8_t len, uint32_t nowUs);
+
+    // CFs pendentes e timeouts; chamar a cada volta do loop()
+    void poll(uint32_t nowUs);
+
+    //───────────────────────────────────────────────────────────────────────
+    // TRANSMISSÃO
+    //───────────────────────────────────────────────────────────────────────
+    // false = já transmitindo ou tamanho inválido
+    bool send(const uint8_t *data, uint16_t len, uint32_t nowUs);
+    bool send(uint16_t len, IsoTpSourceFn source, void *sourceCtx, uint32_t nowUs);
+    bool sending() const { return tx_ != TX_IDLE; }
+
+    //───────────────────────────────────────────────────────────────────────
+    // RECEPÇÃO: mensagem completa fica até release()
+    //───────────────────────────────────────────────────────────────────────
+    bool available() const { return rx_ == RX_DONE; }
+    const uint8_t *message() const { return rxBuf_; }
+    uint16_t length() const { return rxLen_; }
+    void release() { rx_ = RX_IDLE; }
+
+    const IsoTpStats &stats() const { return stats_; }
+
+    // STmin (codificação ISO) → µs
+    static uint32_t stMinUs(uint8_t st);
+
+private:
+    enum TxState : uint8_t { TX_IDLE, TX_WAIT_FC, TX_SEND_CF };
+    enum RxState : uint8_t { RX_IDLE, RX_RECEIVING, RX_DONE };
+
+    uint16_t txId_;
+    IsoTpSendFn send_;
+    void *ctx_;
+    IsoTpStats stats_;
+
+    // Transmissão
+    TxState tx_ = TX_IDLE;
+    IsoTpSourceFn source_ = nullptr;
+    void *sourceCtx_ = nullptr;
+    uint8_t txBuf_[ISOTP_TX_BUF];
+    uint16_t txLen_ = 0, txPos_ = 0;
+    uint8_t txSn_ = 0;
+    uint8_t txBlockLeft_ = 0;       // CFs até o próximo FC (0 = sem limite)
+    uint32_t txStMinUs_ = 0;
+    uint32_t txNextUs_ = 0;
+    uint32_t txDeadlineUs_ = 0;
+
+    // Recepção
+    RxState rx_ = RX_IDLE;
+    uint8_t rxBuf_[ISOTP_RX_MAX];
+    uint16_t rxLen_ = 0, rxPos_ = 0;
+    uint8_t rxSn_ = 0;
+    uint8_t rxBlockCount_ = 0;
+    uint32_t rxDeadlineUs_ = 0;
+
+    static uint8_t bufferSource(void *ctx, uint16_t offset, uint8_t *out, uint8_t n);
+    bool startTx(uint16_t len, uint32_t nowUs);
+    bool sendFrame(const uint8_t *frame);
+    bool sendFlowControl(uint8_t status);
+    bool sendConsecutive(uint32_t nowUs);
+    void fail(uint8_t error);
+};
+
+#endif
@@ -0,0 +1,109 @@
+//═══════════════════════════════════════════════════════════════════════════
+// DRIVER ENXUTO DO MCP2515 (substitui coryjfowler/mcp_can no firmware)
+//═══════════════════════════════════════════════════════════════════════════
+// Usa as instruções rápidas do MCP2515 em vez de leitura/escrita genérica
+// de registradores:
+//
+//   READ STATUS (0xA0)         1 transação: RXnIF e TXREQ dos 3 buffers
+//   READ RX BUFFER (0x90/0x94) 1 transação: ID + DLC + dados; o RXnIF é
+//                              limpo sozinho ao subir o CS
+//   LOAD TX BUFFER (0x40)      1 transação: ID + DLC + dados
+//   RTS (0x81)                 1 byte: dispara a transmissão
+//
+// O CS é escrito direto no registrador da porta (digitalWrite custa ~4 µs
+// no AVR) e o SPI roda a 8 MHz, o máximo do ATmega2560 a 16 MHz (o MCP2515
+// aceita até 10 MHz, independente do cristal de 8 MHz dele).
+//
+// Envio só pelo TXB0: com prioridades iguais o MCP2515 transmite primeiro o
+// buffer de número MAIOR, o que inverteria frames enviados em sequência
+// (RTRs 0x510/0x520/0x530, eco e aquisição no 0x426). Em vez de esperar o
+// frame sair depois de carregar (como o mcp_can), espera o anterior antes
+// de carregar o próximo: o loop() só bloqueia em rajadas.
+//
+// Mesma convenção de ID do mcp_can: 0x80000000 = extended, 0x40000000 = RTR.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef MCP2515_H
+#define MCP2515_H
+
+#include <Arduino.h>
+
+// Retornos
+#define MCP2515_OK        0
+#define MCP2515_FAIL      1
+#define MCP2515_NOMSG     2     // readMsgBuf sem frame nos buffers
+#define MCP2515_TXBUSY    3     // TXB0 ocupado por mais de MCP2515_TX_TIMEOUT_US
+
+#define MCP2515_TX_TIMEOUT_US 2000   // > 1 frame de 8 bytes com stuffing a 500 kbps
+
+// Bitrates com cristal de 8 MHz (mesmos CNF1-3 do mcp_can)
+enum Mcp2515Bitrate : uint8_t {
+    MCP2515_500KBPS = 0,
+    MCP2515_1000KBPS = 1
+};
+
+// REQOP do CANCTRL
+enum Mcp2515Mode : uint8_t {
+    MCP2515_NORMAL = 0x00,
+    MCP2515_SLEEP = 0x20,
+    MCP2515_LOOPBACK = 0x40,
+    MCP2515_LISTENONLY = 0x60,
+    MCP2515_CONFIG = 0x80
+};
+
+// Bits do EFLG (ver também bushealth.h)
+#define MCP2515_EFLG_RX0OVR 0x40
+#define MCP2515_EFLG_RX1OVR 0x80
+
+class Mcp2515 {
+public:
+    explicit Mcp2515(uint8_t csPin) : csPin_(csPin) {}
+
+    // Reset, bitrate, aceita qualquer ID (standard e extended), rollover
+    // RXB0→RXB1 e interrupção no pino INT para RX. Sai em modo de configuração.
+    uint8_t begin(Mcp2515Bitrate bitrate);
+    uint8_t setMode(Mcp2515Mode mode);
+
+    uint8_t checkReceive();                                   // MCP2515_OK se há frame
+    uint8_t readMsgBuf(unsigned long *id, uint8_t *len, uint8_t *buf);
+    uint8_t sendMsgBuf(unsigned long id, uint8_t len, const uint8_t *buf);
+
+    uint8_t getError() { return readRegister(REG_EFLG); }
+    uint8_t errorCountTX() { return readRegister(REG_TEC); }
+    uint8_t errorCountRX() { return readRegister(REG_REC); }
+    void errorCounts(uint8_t &tec, uint8_t &rec);             // TEC e REC numa transação
+
+    // RX0OVR/RX1OVR só voltam a zero por escrita (o mcp_can não expunha)
+    void clearOverflow() { modifyRegister(REG_EFLG, MCP2515_EFLG_RX0OVR | MCP2515_EFLG_RX1OVR, 0); }
+
+    uint16_t txTimeouts() const { return txTimeouts_; }
+
+private:
+    // Registradores usados
+    static const uint8_t REG_CANSTAT = 0x0E;
+    static const uint8_t REG_CANCTRL = 0x0F;
+    static const uint8_t REG_TEC = 0x1C;
+    static const uint8_t REG_REC = 0x1D;
+    static const uint8_t REG_RXM0SIDH = 0x20;
+    static const uint8_t REG_CNF3 = 0x28;
+    static const uint8_t REG_CANINTE = 0x2B;
+    static const uint8_t REG_CANINTF = 0x2C;
+    static const uint8_t REG_EFLG = 0x2D;
+    static const uint8_t REG_TXB0CTRL = 0x30;
+    static const uint8_t REG_RXB0CTRL = 0x60;
+    static const uint8_t REG_RXB1CTRL = 0x70;
+
+    uint8_t csPin_;
+    volatile uint8_t *csPort_ = nullptr;
+    uint8_t csMask_ = 0;
+    uint16_t txTimeouts_ = 0;
+
+    void select();
+    void deselect();
+    uint8_t readStatus();
+    uint8_t readRegister(uint8_t reg);
+    void writeRegisters(uint8_t reg, const uint8_t *values, uint8_t n);
+    void writeRegister(uint8_t reg, uint8_t value) { writeRegisters(reg, &value, 1); }
+    void modifyRegister(uint8_t reg, uint8_t mask, uint8_t value);
+};
+
+#endif
@@ -0,0 +1,110 @@
+//═══════════════════════════════════════════════════════════════════════════
+// DICIONÁRIO DE PARÂMETROS (ESTILO SDO DO CANopen)
+//═══════════════════════════════════════════════════════════════════════════
+// Cada valor configurável do nó é uma linha de uma tabela constexpr: índice,
+// tipo, direitos de acesso, faixa, grupo de aplicação e onde mora na RAM.
+// Um serviço genérico lê, escreve e lê em massa qualquer índice, sem um
+// formato de frame por configuração como o 0x403/0x404/0x405/0x406.
+//
+//   - busca O(1): o índice é a posição na tabela (checado em compilação)
+//   - valor no fio: 4 bytes big-endian; inteiros estendidos (com sinal no
+//     int16), float pelos bits IEEE-754
+//   - na AVR a tabela fica na flash (PROGMEM) e é lida linha a linha
+//   - base nula = parâmetro que não existe neste container (canal sem uso)
+//
+// A escrita só muda a variável; efeitos colaterais e EEPROM ficam com quem
+// chama, pelo campo apply (grupo) e pela flag PARAM_EEPROM (ver main.cpp).
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef OBJDICT_H
+#define OBJDICT_H
+
+#include <stddef.h>     // offsetof nas tabelas
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <avr/pgmspace.h>
+#define OBJDICT_PROGMEM PROGMEM
+#else
+#define OBJDICT_PROGMEM
+#endif
+
+enum ParamType : uint8_t {
+    PARAM_U8 = 0,
+    PARAM_U16 = 1,
+    PARAM_I16 = 2,
+    PARAM_U32 = 3,
+    PARAM_F32 = 4,
+    PARAM_ABSENT = 0xFF     // Só no fio: índice sem variável neste container
+};
+
+enum ParamFlags : uint8_t {
+    PARAM_READ = 0x01,
+    PARAM_WRITE = 0x02,
+    PARAM_EEPROM = 0x04,    // A escrita é gravada na EEPROM pelo grupo
+    PARAM_RW = PARAM_READ | PARAM_WRITE
+};
+
+enum ParamStatus : uint8_t {
+    PARAM_OK = 0,
+    PARAM_NO_INDEX,         // Fora da tabela ou sem variável neste container
+    PARAM_READ_ONLY,
+    PARAM_OUT_OF_RANGE
+};
+
+#define PARAM_NAME_LEN 12
+
+struct ParamDef {
+    uint8_t index;
+    uint8_t type;           // ParamType
+    uint8_t flags;          // ParamFlags
+    uint8_t apply;          // Grupo para efeitos colaterais (definido por quem usa)
+    void *base;             // Estrutura ou variável; nullptr = não existe
+    uint8_t offset;         // offsetof do campo dentro de base
+    float min, max;         // Faixa aceita na escrita
+    char name[PARAM_NAME_LEN];  // Até 11 caracteres + terminador
+    uint8_t step;           // Inteiros: múltiplo exigido na escrita (0 = qualquer), p.ex. campo gravado /10
+};
+
+// Tabela densa: ParamDef::index igual à posição (use em static_assert)
+constexpr bool paramTableDense(const ParamDef *table, uint8_t count, uint8_t i = 0) {
+    return i >= count || (table[i].index == i && paramTableDense(table, count, i + 1));
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// REGISTROS DOS SERVIÇOS EM MASSA (tamanho fixo: qualquer byte é calculável)
+//───────────────────────────────────────────────────────────────────────────
+#define PARAM_VALUE_BYTES    5   // [tipo][valor BE 4]
+#define PARAM_DESCRIBE_BYTES (3 + 4 + 4 + PARAM_NAME_LEN)  // [índice][tipo][flags][min][max][nome]
+
+class ObjectDictionary {
+public:
+    ObjectDictionary(const ParamDef *table, uint8_t count) : table_(table), count_(count) {}
+
+    uint8_t count() const { return count_; }
+
+    // Cópia da linha (da flash na AVR); false = índice fora da tabela
+    bool find(uint8_t index, ParamDef &def) const;
+
+    // Valor atual no formato do fio
+    uint8_t read(uint8_t index, uint32_t &wire, ParamDef &def) const;
+    // Confere direito, existência e faixa antes de mudar a variável
+    uint8_t write(uint8_t index, uint32_t wire, ParamDef &def) const;
+
+    // Um pedaço dos registros de first..first+count-1 a partir de offset
+    // (fonte de dados do ISO-TP); retorna n
+    uint8_t valueBytes(uint8_t first, uint16_t offset, uint8_t *out, uint8_t n) const;
+    uint8_t describeBytes(uint8_t first, uint16_t offset, uint8_t *out, uint8_t n) const;
+
+    static uint32_t load(const ParamDef &def);
+    static void store(const ParamDef &def, uint32_t wire);
+    static float asFloat(uint8_t type, uint32_t wire);
+
+private:
+    const ParamDef *table_;
+    uint8_t count_;
+
+    void valueRecord(uint8_t index, uint8_t *rec) const;
+    void describeRecord(uint8_t index, uint8_t *rec) const;
+};
+
+#endif
@@ -0,0 +1,160 @@
+//═══════════════════════════════════════════════════════════════════════════
+// PERFIS DE CONTAINER - CONFIGURAÇÃO EM TEMPO DE COMPILAÇÃO
+//═══════════════════════════════════════════════════════════════════════════
+// Cada container é um ambiente do platformio.ini que define CONTAINER_ID:
+//   [env:container17] → -DCONTAINER_ID=17
+//   [env:container22] → -DCONTAINER_ID=22
+//
+// O perfil diz, por canal de segurança (0-3 = T1..T4):
+//   - de qual CANmod.Temp (0x510/0x520/0x530) e termopar (TL/TR/BL/BR) vem
+//   - quais relés são ligados (LOW) no disparo e desligados (HIGH) ao normalizar
+//
+// Canal sem especialização = não usado: o SafetyChannel correspondente em
+// main.cpp vira uma classe vazia e não gera código nem ocupa RAM.
+//
+// Relés em máscara de bits: bit 0 = D1 ... bit 7 = D8
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+#ifndef CONTAINER_ID
+#error "CONTAINER_ID não definido: selecione um ambiente do platformio.ini (container17, container22)"
+#endif
+
+// Termopar dentro do frame do CANmod.Temp
+enum TcInput : uint8_t { TC_TL = 0, TC_TR = 1, TC_BL = 2, TC_BR = 3 };
+
+// Máscaras dos relés
+#define RELAY_D1  0x01
+#define RELAY_D2  0x02
+#define RELAY_D3  0x04
+#define RELAY_D4  0x08
+#define RELAY_D5  0x10
+#define RELAY_D6  0x20
+#define RELAY_D7  0x40
+#define RELAY_D8  0x80
+
+//───────────────────────────────────────────────────────────────────────────
+// PERFIL DO CONTAINER (dados gerais)
+//───────────────────────────────────────────────────────────────────────────
+template <int Container>
+struct ContainerProfile;
+
+//───────────────────────────────────────────────────────────────────────────
+// PERFIL DE CANAL DE SEGURANÇA (primário = canal não usado)
+//───────────────────────────────────────────────────────────────────────────
+template <int Container, uint8_t Ch>
+struct ChannelProfile {
+    static constexpr bool used = false;
+};
+
+//═══════════════════════════════════════════════════════════════════════════
+// CONTAINER 17
+//═══════════════════════════════════════════════════════════════════════════
+// Saídas: D5 = NA2/NF2, D6 = NA1/NF1, D8 = Bomba
+//───────────────────────────────────────────────────────────────────────────
+template <>
+struct ContainerProfile<17> {
+    static constexpr uint16_t nodeId = 0x042;      // Reset/bootloader (mcp-can-boot -m)
+    static constexpr uint8_t pumpRelays = RELAY_D8;
+};
+
+// T1 - Starter: TL do CANmod.Temp 1 → D1
+template <>
+struct ChannelProfile<17, 0> {
+    static constexpr bool used = true;
+    static constexpr uint16_t moduleId = 0x510;
+    static constexpr TcInput input = TC_TL;
+    static constexpr uint8_t tripRelays = RELAY_D1;
+    static constexpr uint8_t releaseRelays = RELAY_D1;
+};
+
+// T2 - Engine: TR → D2
+template <>
+struct ChannelProfile<17, 1> {
+    static constexpr bool used = true;
+    static constexpr uint16_t moduleId = 0x510;
+    static constexpr TcInput input = TC_TR;
+    static constexpr uint8_t tripRelays = RELAY_D2;
+    static constexpr uint8_t releaseRelays = RELAY_D2;
+};
+
+// T3 - Intercooler: BL → D2 (mesmo relé do Engine)
+template <>
+struct ChannelProfile<17, 2> {
+    static constexpr bool used = true;
+    static constexpr uint16_t moduleId = 0x510;
+    static constexpr TcInput input = TC_BL;
+    static constexpr uint8_t tripRelays = RELAY_D2;
+    static constexpr uint8_t releaseRelays = RELAY_D2;
+};
+
+// T4 - Água: BR → liga NA2/NF2 (D5); ao normalizar desliga Bomba, NA2/NF2 e NA1/NF1
+template <>
+struct ChannelProfile<17, 3> {
+    static constexpr bool used = true;
+    static constexpr uint16_t moduleId = 0x510;
+    static constexpr TcInput input = TC_BR;
+    static constexpr uint8_t tripRelays = RELAY_D5;
+    static constexpr uint8_t releaseRelays = RELAY_D8 | RELAY_D5 | RELAY_D6;
+};
+
+//═══════════════════════════════════════════════════════════════════════════
+// CONTAINER 22
+//═══════════════════════════════════════════════════════════════════════════
+// Mesma fiação do 17: D5 = NA2/NF2, D6 = NA1/NF1, D8 = Bomba
+//───────────────────────────────────────────────────────────────────────────
+template <>
+struct ContainerProfile<22> {
+    static constexpr uint16_t nodeId = 0x042;
+    static constexpr uint8_t pumpRelays = RELAY_D8;
+};
+
+template <>
+struct ChannelProfile<22, 0> {
+    static constexpr bool used = true;
+    static constexpr uint16_t moduleId = 0x510;
+    static constexpr TcInput input = TC_TL;
+    static constexpr uint8_t tripRelays = RELAY_D1;
+    static constexpr uint8_t releaseRelays = RELAY_D1;
+};
+
+template <>
+struct ChannelProfile<22, 1> {
+    static constexpr bool used = true;
+    static constexpr uint16_t moduleId = 0x510;
+    static constexpr TcInput input = TC_TR;
+    static constexpr uint8_t tripRelays = RELAY_D2;
+    static constexpr uint8_t releaseRelays = RELAY_D2;
+};
+
+template <>
+struct ChannelProfile<22, 2> {
+    static constexpr bool used = true;
+    static constexpr uint16_t moduleId = 0x510;
+    static constexpr TcInput input = TC_BL;
+    static constexpr uint8_t tripRelays = RELAY_D2;
+    static constexpr uint8_t releaseRelays = RELAY_D2;
+};
+
+// T4 - Água: liga NA2/NF2 (D5); ao normalizar desliga Bomba, NA2/NF2 e NA1/NF1
+template <>
+struct ChannelProfile<22, 3> {
+    static constexpr bool used = true;
+    static constexpr uint16_t moduleId = 0x510;
+    static constexpr TcInput input = TC_BR;
+    static constexpr uint8_t tripRelays = RELAY_D5;
+    static constexpr uint8_t releaseRelays = RELAY_D8 | RELAY_D5 | RELAY_D6;
+};
+
+//───────────────────────────────────────────────────────────────────────────
+// PERFIL ATIVO
+//───────────────────────────────────────────────────────────────────────────
+typedef ContainerProfile<CONTAINER_ID> Profile;
+
+template <uint8_t Ch>
+struct ActiveChannel : ChannelProfile<CONTAINER_ID, Ch> {};
+
+#endif
@@ -0,0 +1,63 @@
+//═══════════════════════════════════════════════════════════════════════════
+// CONTAGEM DE PULSOS POR HARDWARE (ENCODER DO MOTOR E BOMBA)
+//═══════════════════════════════════════════════════════════════════════════
+// Cada canal é um timer de 16 bits com clock externo: o próprio timer conta
+// as bordas de subida do pino, sem nenhuma ISR por borda.
+//
+//   Canal 0 (motor): Timer1, entrada T1 (PD6)
+//   Canal 1 (bomba): Timer3, entrada T3 (PE6)
+//
+// A cada janela (gate) um slot do serviço de timers (timerservice.h) lê o
+// contador, calcula as bordas da janela pela diferença de 16 bits e publica
+// PulseState por Snapshot. O loop() converte em frequência e RPM.
+//
+// Limites:
+//   - bordas por janela < 65536 (a diferença de 16 bits dá a volta):
+//     janela ≤ 65535 / f_max. PulseMeter marca "saturado" acima de 0xF000.
+//   - borda máxima ≈ 16 MHz / 2,5 = 6,4 MHz (amostragem do pino de clock)
+//   - só uma fase: sem decodificação de quadratura/sentido em hardware
+//
+// Sem dependência do Arduino: as contas ficam aqui, os registradores no main.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef PULSE_H
+#define PULSE_H
+
+#include <stdint.h>
+
+#define PULSE_CHANNELS       2
+#define PULSE_SATURATED      0xF000   // Bordas por janela perto da volta do contador
+
+// Produtor: slots de janela do serviço de timers (mesma ISR, não aninham)
+struct PulseState {
+    uint32_t total[PULSE_CHANNELS];     // Bordas desde o boot
+    uint16_t edges[PULSE_CHANNELS];     // Bordas na última janela
+    uint16_t gateMs[PULSE_CHANNELS];    // Duração da última janela (0 = nenhuma ainda)
+};
+
+// Estado de um canal dentro da ISR da janela
+class PulseGate {
+public:
+    // counter = TCNTn no fim da janela; retorna as bordas da janela
+    uint16_t close(uint16_t counter) {
+        uint16_t edges = counter - last_;
+        last_ = counter;
+        return edges;
+    }
+
+    void restart(uint16_t counter) { last_ = counter; }
+
+private:
+    uint16_t last_ = 0;
+};
+
+namespace PulseMeter {
+    // Frequência em Hz (satura em 65535)
+    uint16_t frequencyHz(uint16_t edges, uint16_t gateMs);
+
+    // RPM com ppr pulsos por volta (satura em 65535)
+    uint16_t rpm(uint16_t edges, uint16_t gateMs, uint16_t ppr);
+
+    inline bool saturated(uint16_t edges) { return edges >= PULSE_SATURATED; }
+}
+
+#endif
@@ -0,0 +1,52 @@
+//═══════════════════════════════════════════════════════════════════════════
+// RELATÓRIO POR MUDANÇA - FRAMES DE ESTADO SÓ QUANDO O CONTEÚDO MUDA
+//═══════════════════════════════════════════════════════════════════════════
+// Os ecos 0x422/0x423/0x426 e o frame periódico de aquisição (0x426) passam
+// por offer(): no modo REPORT_ON_CHANGE o frame só sai se o payload for
+// diferente do último enviado naquele slot (ou se for forçado, ex.: RTR).
+//
+// A vivacidade do nó fica por conta de um heartbeat de baixa taxa (0x42A)
+// com o tempo ligado e quantos frames foram enviados/suprimidos.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <stdint.h>
+
+#define REPORT_MAX_SLOTS 5
+
+enum ReportMode : uint8_t {
+    REPORT_ALWAYS = 0,     // Comportamento antigo: todo frame de estado sai
+    REPORT_ON_CHANGE = 1   // Só quando muda (padrão)
+};
+
+class ChangeReporter {
+public:
+    ReportMode mode = REPORT_ON_CHANGE;
+    uint8_t heartbeatS = 5;        // Período do heartbeat (s), 0 = desligado
+
+    // true = transmitir agora (payload novo, forçado ou modo sempre);
+    // o payload passa a ser a referência do slot
+    bool offer(uint8_t slot, const uint8_t *data, uint8_t len, bool force);
+
+    // Esquece os payloads: a próxima oferta de cada slot sai
+    void invalidate();
+    // Só um slot (a transmissão do payload aceito por offer() falhou)
+    void invalidate(uint8_t slot) { valid_[slot] = false; }
+
+    // true uma vez a cada heartbeatS; fecha a janela de contagem
+    bool heartbeatDue(uint32_t nowMs);
+    uint8_t sentLast() const { return sentLast_; }
+    uint8_t suppressedLast() const { return suppressedLast_; }
+
+private:
+    uint8_t data_[REPORT_MAX_SLOTS][8] = {{0}};
+    uint8_t len_[REPORT_MAX_SLOTS] = {0};
+    bool valid_[REPORT_MAX_SLOTS] = {false};
+
+    uint32_t heartbeatMs_ = 0;
+    uint16_t sent_ = 0, suppressed_ = 0;
+    uint8_t sentLast_ = 0, suppressedLast_ = 0;
+};
+
+#endif
@@ -0,0 +1,114 @@
+//═══════════════════════════════════════════════════════════════════════════
+// SNAPSHOT DUPLO COM CONTADOR DE SEQUÊNCIA (estilo seqlock, para AVR)
+//═══════════════════════════════════════════════════════════════════════════
+// Troca de estado multi-byte entre ISRs e loop() sem desligar interrupções.
+//
+//   - Um único produtor (o loop OU um conjunto de ISRs que não se aninham)
+//     escreve no buffer de trás com edit() e publica com publish(): uma
+//     troca de índice de 1 byte, atômica no AVR.
+//   - Leitores chamam read(copia). Se o produtor publicou durante a cópia
+//     (leitor no loop interrompido pela ISR produtora), seq mudou e a cópia
+//     é refeita. Leitor dentro de ISR nunca é interrompido pelo loop, então
+//     sempre lê o buffer da frente inteiro na primeira tentativa.
+//
+//   seq e index (8 bits) são os únicos campos "volatile": o buffer
+//   em si é copiado normalmente e protegido pelas barreiras de compilador.
+//
+// Sem dependência do Arduino: no host (Host_CanToolkit/bench/snapshot_stress)
+// a barreira vira um fence de hardware para rodar com threads reais. Lá o
+// leitor pode ser preemptado por milissegundos, então o teste usa Seq de 32
+// bits; no AVR a ISR é curta e 8 bits não dão a volta durante uma cópia.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#define SNAPSHOT_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#include <atomic>
+#define SNAPSHOT_BARRIER() std::atomic_thread_fence(std::memory_order_seq_cst)
+#endif
+
+template <typename T, typename Seq = uint8_t>
+class Snapshot {
+public:
+    Snapshot() : index_(0), seq_(0) {
+        memset(buf_, 0, sizeof(buf_));
+    }
+
+    //───────────────────────────────────────────────────────────────────────
+    // PRODUTOR
+    //───────────────────────────────────────────────────────────────────────
+    // Copia o estado publicado para o buffer de trás e o devolve para edição.
+    // Nada fica visível aos leitores até publish().
+    T &edit() {
+        uint8_t back = index_ ^ 1;
+        memcpy(&buf_[back], &buf_[index_], sizeof(T));
+        return buf_[back];
+    }
+
+    // Troca o índice ANTES de incrementar seq: um leitor que já leu o seq
+    // novo sempre lê também o índice novo, e o buffer antigo só volta a ser
+    // escrito depois da próxima publicação (que muda seq de novo).
+    void publish() {
+        SNAPSHOT_BARRIER();     // Escritas no buffer antes da troca
+        index_ = index_ ^ 1;
+        SNAPSHOT_BARRIER();
+        seq_ = seq_ + 1;
+        SNAPSHOT_BARRIER();
+    }
+
+    //───────────────────────────────────────────────────────────────────────
+    // LEITOR
+    //───────────────────────────────────────────────────────────────────────
+    // Retorna o número de tentativas extras (0 = cópia direta)
+    uint8_t read(T &out) const {
+        uint8_t retries = 0;
+        for (;;) {
+            Seq s1 = seq_;
+            SNAPSHOT_BARRIER();
+            uint8_t front = index_;
+            memcpy(&out, (const void *)&buf_[front], sizeof(T));
+            SNAPSHOT_BARRIER();
+            if (seq_ == s1) return retries;
+            if (retries < 255) retries++;
+        }
+    }
+
+    T get() const {
+        T out;
+        read(out);
+        return out;
+    }
+
+    Seq sequence() const { return seq_; }
+
+private:
+    T buf_[2];
+    volatile uint8_t index_;
+    volatile Seq seq_;
+};
+
+//═══════════════════════════════════════════════════════════════════════════
+// ESTADO COMPARTILHADO DO MONITOR DE SEGURANÇA
+//═══════════════════════════════════════════════════════════════════════════
+#define SNAPSHOT_CHANNELS 4
+
+// Produtor: loop() (temperaturas filtradas e disparos)
+struct SensorState {
+    float temp[SNAPSHOT_CHANNELS];         // Temperatura filtrada (°C)
+    uint32_t sampleMs[SNAPSHOT_CHANNELS];  // millis() da última amostra
+    uint8_t trippedMask;                   // bit N = canal N com relés acionados
+};
+
+// Produtor: ISRs dos timers de alarme (não aninhadas no AVR)
+struct AlarmState {
+    uint32_t tickMs[SNAPSHOT_CHANNELS];    // millis() do último estouro do timer
+    uint16_t ticks[SNAPSHOT_CHANNELS];     // Estouros acumulados (o loop guarda o valor no disparo)
+    float tempAtTick[SNAPSHOT_CHANNELS];   // Temperatura vista pela ISR no estouro
+};
+
+#endif
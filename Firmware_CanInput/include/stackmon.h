@@ -0,0 +1,49 @@
+//═══════════════════════════════════════════════════════════════════════════
+// PILHA PINTADA E MARCA D'ÁGUA
+//═══════════════════════════════════════════════════════════════════════════
+// Na AVR a pilha desce do RAMEND em direção ao fim do .bss; sem MMU, uma
+// colisão corrompe variáveis em silêncio. No reset a região livre é pintada
+// com STACK_PAINT (main.cpp, seção .init3); o que continua pintado desde o
+// boot é a folga mínima que a pilha já teve.
+//
+//   [ .data | .bss ][ pintado (nunca usado) | já usado pela pilha ]
+//   bottom          ^ varredura de baixo para cima            top = RAMEND+1
+//
+// poll() continua a varredura em pedaços de STACK_SCAN_CHUNK bytes, então
+// o custo por volta do loop() é limitado. O firmware não usa malloc; com
+// heap, bottom teria que acompanhar o __brkval.
+//
+// Sem dependência do Arduino: as bordas da região vêm de quem chama.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef STACKMON_H
+#define STACKMON_H
+
+#include <stdint.h>
+
+#define STACK_PAINT       0xC5
+#define STACK_SCAN_CHUNK  64      // Bytes lidos por poll()
+#define STACK_WARN_BYTES  256     // Folga abaixo disto vira aviso e evento no histórico
+
+class StackMonitor {
+public:
+    // Expostos no dicionário de parâmetros (só leitura)
+    uint16_t staticBytes = 0;     // .data + .bss (do início da RAM até bottom)
+    uint16_t sizeBytes = 0;       // Região da pilha: top - bottom
+    uint16_t minFree = 0;         // Bytes nunca tocados desde o boot
+
+    // Região [bottom, top) já pintada; ramStart = início da SRAM
+    void begin(const uint8_t *ramStart, const uint8_t *bottom, const uint8_t *top);
+
+    // Pinta [bottom, top) (testes no host; na AVR é feito antes do main())
+    static void paint(uint8_t *bottom, uint8_t *top);
+
+    // true quando uma passada terminou e minFree foi atualizado
+    bool poll();
+
+private:
+    const volatile uint8_t *bottom_ = nullptr;
+    const volatile uint8_t *top_ = nullptr;
+    const volatile uint8_t *cursor_ = nullptr;
+};
+
+#endif
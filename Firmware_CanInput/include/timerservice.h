@@ -0,0 +1,194 @@
+//═══════════════════════════════════════════════════════════════════════════
+// SERVIÇO DE TIMERS POR SOFTWARE SOBRE UM ÚNICO TICK DE HARDWARE
+//═══════════════════════════════════════════════════════════════════════════
+// Substitui TimerInterrupt_Generic (um timer de hardware por alarme). Todos
+// os timers de software andam no tick de 1 ms do Timer2 em modo CTC:
+//
+//   - N slots fixos em tempo de compilação (TimerService<N>), sem malloc
+//   - lista encadeada ordenada por prazo: o tick só olha a cabeça, então o
+//     custo sem nada vencendo é constante, não importa quantos timers há
+//   - callback roda no contexto da ISR, como antes: curto e sem Serial
+//   - tempo de cada callback medido (execuções, máximo e total em µs)
+//
+// Com o Timer2 (pinos 9/10, não usados) fazendo o tick, os timers de 16 bits
+// 1, 3, 4 e 5 ficam livres para PWM (Timer4: pinos 6/8 da ponte H, Timer5:
+// pinos 44/46) e captura de entrada.
+//
+// attach()/detach() são chamados do loop(): a lista é alterada com as
+// interrupções desligadas (poucos µs). No host (Host_CanToolkit) não há ISR
+// e tick() é chamado direto.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef TIMERSERVICE_H
+#define TIMERSERVICE_H
+
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <util/atomic.h>
+#define TIMERSERVICE_ATOMIC() ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#define TIMERSERVICE_US() ((uint32_t)micros())
+#else
+#include <chrono>
+#define TIMERSERVICE_ATOMIC()
+#define TIMERSERVICE_US() \
+    ((uint32_t)std::chrono::duration_cast<std::chrono::microseconds>( \
+         std::chrono::steady_clock::now().time_since_epoch()).count())
+#endif
+
+#define TIMERSERVICE_TICK_HZ 1000
+#define TIMERSERVICE_NONE    0xFF
+
+// Estatística de um callback (lida com TimerService::stats)
+struct TimerStats {
+    uint16_t runs = 0;        // Execuções (satura em 65535)
+    uint16_t maxUs = 0;       // Pior tempo de um callback
+    uint32_t totalUs = 0;     // Soma dos tempos (média = totalUs / runs)
+    uint16_t lateTicks = 0;   // Maior atraso em ticks entre o prazo e a execução
+};
+
+template <uint8_t N>
+class TimerService {
+public:
+    typedef void (*Callback)();
+
+    TimerService() {
+        for (uint8_t i = 0; i < N; i++) next_[i] = TIMERSERVICE_NONE;
+    }
+
+#ifdef ARDUINO
+    // Timer2 em CTC: 16 MHz / 64 / (249 + 1) = 1 kHz. ISR(TIMER2_COMPA_vect)
+    // chama tick() (ver main.cpp).
+    void begin() {
+        TIMERSERVICE_ATOMIC() {
+            TCCR2A = _BV(WGM21);               // CTC com topo em OCR2A
+            TCCR2B = _BV(CS22);                // Prescaler 64
+            OCR2A = F_CPU / 64 / TIMERSERVICE_TICK_HZ - 1;
+            TCNT2 = 0;
+            TIMSK2 = _BV(OCIE2A);
+        }
+    }
+#endif
+
+    // Periódico a cada periodMs (primeira execução depois de um período).
+    // Reagendar um slot ativo reinicia a contagem.
+    void attach(uint8_t slot, uint16_t periodMs, Callback cb) {
+        if (slot >= N || cb == nullptr) return;
+        if (periodMs == 0) periodMs = 1;
+        TIMERSERVICE_ATOMIC() {
+            unlink(slot);
+            period_[slot] = periodMs;
+            callback_[slot] = cb;
+            insert(slot, now_ + periodMs);
+        }
+    }
+
+    void detach(uint8_t slot) {
+        if (slot >= N) return;
+        TIMERSERVICE_ATOMIC() {
+            unlink(slot);
+            callback_[slot] = nullptr;
+        }
+    }
+
+    bool active(uint8_t slot) const {
+        bool on = false;
+        TIMERSERVICE_ATOMIC() {
+            on = slot < N && linked(slot);
+        }
+        return on;
+    }
+
+    // Um tick (1 ms). Executa os vencidos em ordem de prazo e reagenda.
+    void tick() {
+        now_++;
+        while (head_ != TIMERSERVICE_NONE && (int32_t)(now_ - due_[head_]) >= 0) {
+            uint8_t slot = head_;
+            uint32_t due = due_[slot];
+            head_ = next_[slot];
+            next_[slot] = TIMERSERVICE_NONE;
+            inList_ &= ~mask(slot);
+
+            uint32_t t0 = TIMERSERVICE_US();
+            callback_[slot]();
+            record(slot, TIMERSERVICE_US() - t0, now_ - due);
+
+            // O callback pode ter religado ou desligado o próprio slot; se
+            // não, reagenda a partir do prazo (sem acumular deriva)
+            if (!linked(slot) && callback_[slot] != nullptr) {
+                insert(slot, due + period_[slot]);
+            }
+        }
+    }
+
+    uint32_t now() const {
+        uint32_t t;
+        TIMERSERVICE_ATOMIC() {
+            t = now_;
+        }
+        return t;
+    }
+
+    // Cópia consistente da estatística do slot (a ISR atualiza)
+    TimerStats stats(uint8_t slot) const {
+        TimerStats s;
+        if (slot >= N) return s;
+        TIMERSERVICE_ATOMIC() {
+            s = stats_[slot];
+        }
+        return s;
+    }
+
+    void resetStats(uint8_t slot) {
+        if (slot >= N) return;
+        TIMERSERVICE_ATOMIC() {
+            stats_[slot] = TimerStats();
+        }
+    }
+
+private:
+    volatile uint32_t now_ = 0;
+    uint8_t head_ = TIMERSERVICE_NONE;
+    uint8_t next_[N];
+    uint32_t due_[N] = {0};
+    uint16_t period_[N] = {0};
+    Callback callback_[N] = {nullptr};
+    TimerStats stats_[N];
+    uint32_t inList_ = 0;          // Bit por slot (N <= 32)
+
+    static_assert(N <= 32, "TimerService: no máximo 32 slots");
+
+    static uint32_t mask(uint8_t slot) { return (uint32_t)1 << slot; }
+    bool linked(uint8_t slot) const { return inList_ & mask(slot); }
+
+    // Insere mantendo a ordem por prazo; prazos iguais saem na ordem de inserção
+    void insert(uint8_t slot, uint32_t due) {
+        due_[slot] = due;
+        uint8_t *link = &head_;
+        while (*link != TIMERSERVICE_NONE && (int32_t)(due_[*link] - due) <= 0) link = &next_[*link];
+        next_[slot] = *link;
+        *link = slot;
+        inList_ |= mask(slot);
+    }
+
+    void unlink(uint8_t slot) {
+        if (!linked(slot)) return;
+        uint8_t *link = &head_;
+        while (*link != slot) link = &next_[*link];
+        *link = next_[slot];
+        next_[slot] = TIMERSERVICE_NONE;
+        inList_ &= ~mask(slot);
+    }
+
+    void record(uint8_t slot, uint32_t us, uint32_t late) {
+        TimerStats &s = stats_[slot];
+        if (s.runs < 0xFFFF) s.runs++;
+        uint16_t us16 = us > 0xFFFF ? 0xFFFF : (uint16_t)us;
+        if (us16 > s.maxUs) s.maxUs = us16;
+        s.totalUs += us;
+        uint16_t late16 = late > 0xFFFF ? 0xFFFF : (uint16_t)late;
+        if (late16 > s.lateTicks) s.lateTicks = late16;
+    }
+};
+
+#endif
@@ -0,0 +1,91 @@
+//═══════════════════════════════════════════════════════════════════════════
+// SINCRONIZAÇÃO DE TEMPO NO BARRAMENTO (SYNC 0x080 + FOLLOW-UP 0x081)
+//═══════════════════════════════════════════════════════════════════════════
+// Dois passos, como o gPTP/CanTSyn: o mestre (host, cansync) manda o SYNC
+// e mede quando ele saiu de verdade (eco do kernel); o FOLLOW-UP leva esse
+// instante t1. O nó guarda t2 = quando o SYNC chegou (borda do INT do
+// MCP2515, capturada na interrupção) e disciplina um relógio local:
+//
+//   tempo(local) = baseMaster + Δ + Δ·drift      Δ = local - baseLocal (µs)
+//
+// A cada par (t1, t2) o erro e = t1 - tempo(t2) corrige a fase pela metade
+// e o drift (ppb) por e/intervalo: um servo PI. Erro acima de
+// TIMESYNC_STEP_US (boot, mestre trocado) reinicia a fase num passo; os
+// dois primeiros pares já dão a frequência.
+//
+// SYNC que não foi o primeiro frame depois da borda (chegou com outro na
+// fila) não tem t2 confiável e é descartado (rejected).
+//
+// O tempo do mestre é µs Unix (CLOCK_REALTIME do host) em 48 bits.
+// Sem dependência do Arduino: os instantes (micros) vêm por parâmetro.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef TIMESYNC_H
+#define TIMESYNC_H
+
+#include <stdint.h>
+
+#define TIMESYNC_SYNC_ID      0x080
+#define TIMESYNC_FUP_ID       0x081
+#define TIMESYNC_STEP_US      2000      // Erro acima disto: novo passo de fase
+#define TIMESYNC_LOCK_US      100       // |erro| para contar como travado
+#define TIMESYNC_LOCK_COUNT   4         // Pares seguidos dentro de LOCK_US
+#define TIMESYNC_HOLDOVER_US  5000000UL // Sem par válido por 5 s: só o drift
+#define TIMESYNC_DRIFT_MAX    10000000L // ±10000 ppm (ressonador cerâmico)
+#define TIMESYNC_KI_DIV       4         // Ganho integral 1/4; o de fase é 1/2
+#define TIMESYNC_MASK         0xFFFFFFFFFFFFULL   // 48 bits no fio
+
+enum TimeSyncState : uint8_t {
+    TSYNC_NONE = 0,       // Nunca recebeu um par
+    TSYNC_ACQUIRING,      // Fase ajustada, drift ainda convergindo
+    TSYNC_LOCKED,         // TIMESYNC_LOCK_COUNT pares com |erro| < LOCK_US
+    TSYNC_HOLDOVER        // Sem SYNC há mais de TIMESYNC_HOLDOVER_US
+};
+
+class TimeSync {
+public:
+    // SYNC recebido em rxLocalUs; precise = t2 veio da borda do INT
+    void onSync(uint8_t seq, uint32_t rxLocalUs, bool precise);
+
+    // FOLLOW-UP com t1 do mesmo seq; true = par aplicado (publicar o status)
+    bool onFollowUp(uint8_t seq, uint64_t masterUs);
+
+    // Holdover e rebase antes de Δ chegar perto do estouro de 32 bits
+    void poll(uint32_t localUs);
+
+    bool synced() const { return state_ != TSYNC_NONE; }
+
+    // Tempo do mestre (µs) no instante local; 0 sem sincronismo
+    uint64_t now(uint32_t localUs) const;
+    // Inverso: instante local em que o mestre marca masterUs
+    uint32_t toLocal(uint64_t masterUs) const;
+
+    uint8_t state() const { return state_; }
+    uint8_t seq() const { return seq_; }
+    int32_t lastErrorUs() const { return lastError_; }    // t1 - tempo(t2) antes da correção
+    int32_t driftPpb() const { return drift_; }
+    uint8_t rejected() const { return rejected_; }        // SYNCs sem t2 confiável (satura)
+    uint8_t samples() const { return samples_; }          // Pares aplicados (mod 256)
+
+private:
+    uint64_t predict(uint32_t localUs) const;
+    void rebase(uint32_t localUs, uint64_t masterUs);
+
+    uint32_t baseLocal_ = 0;
+    uint64_t baseMaster_ = 0;
+    int32_t drift_ = 0;             // ppb: mestre - local
+    uint8_t state_ = TSYNC_NONE;
+    uint8_t lockCount_ = 0;
+
+    uint8_t seq_ = 0;               // Último SYNC
+    bool pending_ = false;          // SYNC com t2 esperando o FOLLOW-UP
+    uint32_t pendingLocal_ = 0;
+
+    bool fresh_ = false;            // Próximo par vem logo depois de um passo
+    uint32_t lastPairLocal_ = 0;
+
+    int32_t lastError_ = 0;
+    uint8_t rejected_ = 0;
+    uint8_t samples_ = 0;
+};
+
+#endif
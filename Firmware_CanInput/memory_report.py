@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""
+Relatório de RAM/flash do firmware a partir do ELF.
+
+Lê as seções e a tabela de símbolos direto do ELF (sem avr-size/avr-nm) e
+mostra onde estão os bytes: flash = .text + .data (valores iniciais), RAM
+estática = .data + .bss + .noinit, e o que sobra para a pilha. O
+copy_firmware.py gera um memory_vX.txt ao lado do info_vX.txt e acrescenta
+uma linha em memory_history.csv, que não é apagado entre versões.
+
+Uso:
+    python memory_report.py .pio/build/container17/firmware.elf
+    python memory_report.py firmware.elf --top 30 --history firmwares/container17/memory_history.csv
+"""
+import argparse
+import csv
+import shutil
+import struct
+import subprocess
+from datetime import datetime
+from pathlib import Path
+
+# ATmega2560 (megaatmega2560); o PlatformIO passa os valores da placa
+RAM_TOTAL = 8192
+FLASH_TOTAL = 253952          # 256 KB menos o bootloader
+
+RAM_SECTIONS = (".data", ".bss", ".noinit")
+FLASH_SECTIONS = (".text", ".data")
+
+STT_OBJECT, STT_FUNC = 1, 2
+HISTORY_FIELDS = ["version", "build", "flash", "ram", "text", "data", "bss", "noinit", "stack"]
+
+
+class Elf:
+    """Seções e símbolos de um ELF 32 ou 64 bits little-endian."""
+
+    def __init__(self, path):
+        raw = Path(path).read_bytes()
+        if raw[:4] != b"\x7fELF":
+            raise ValueError(f"{path}: não é um ELF")
+        is64 = raw[4] == 2
+        if raw[5] != 1:
+            raise ValueError(f"{path}: ELF big-endian não suportado")
+
+        if is64:
+            shoff, = struct.unpack_from("<Q", raw, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", raw, 0x3A)
+        else:
+            shoff, = struct.unpack_from("<I", raw, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", raw, 0x2E)
+
+        headers = []
+        for i in range(shnum):
+            base = shoff + i * shentsize
+            if is64:
+                name, typ, flags, addr, off, size, link = struct.unpack_from("<IIQQQQI", raw, base)
+            else:
+                name, typ, flags, addr, off, size, link = struct.unpack_from("<IIIIIII", raw, base)
+            headers.append((name, typ, flags, addr, off, size, link))
+
+        strtab = headers[shstrndx][4]
+        self.sections = []    # (nome, tamanho, alocada)
+        for name, typ, flags, addr, off, size, link in headers:
+            self.sections.append((self._str(raw, strtab + name), size, bool(flags & 0x2)))
+
+        self.symbols = []     # (nome, tamanho, seção, tipo)
+        for name, typ, flags, addr, off, size, link in headers:
+            if typ != 2:      # SHT_SYMTAB
+                continue
+            names = headers[link][4]
+            entsize = 24 if is64 else 16
+            for pos in range(off, off + size, entsize):
+                if is64:
+                    st_name, st_info, _, st_shndx, _, st_size = struct.unpack_from("<IBBHQQ", raw, pos)
+                else:
+                    st_name, _, st_size, st_info, _, st_shndx = struct.unpack_from("<IIIBBH", raw, pos)
+                kind = st_info & 0x0F
+                if st_size == 0 or kind not in (STT_OBJECT, STT_FUNC) or st_shndx >= len(self.sections):
+                    continue
+                self.symbols.append((self._str(raw, names + st_name), st_size,
+                                     self.sections[st_shndx][0], kind))
+
+    @staticmethod
+    def _str(raw, pos):
+        return raw[pos:raw.index(b"\0", pos)].decode(errors="replace")
+
+    def section_size(self, name):
+        return sum(size for sec, size, _ in self.sections if sec == name)
+
+
+def demangle(names):
+    """Nomes C++ legíveis com (avr-)c++filt, se houver; senão os originais."""
+    tool = shutil.which("avr-c++filt") or shutil.which("c++filt")
+    if not tool or not names:
+        return list(names)
+    try:
+        out = subprocess.run([tool], input="\n".join(names), capture_output=True, text=True, check=True).stdout
+        result = out.splitlines()
+        return result if len(result) == len(names) else list(names)
+    except (OSError, subprocess.CalledProcessError):
+        return list(names)
+
+
+def measure(elf):
+    """Totais por seção e por região (bytes)."""
+    m = {sec.lstrip("."): elf.section_size(sec) for sec in (".text", ".data", ".bss", ".noinit")}
+    m["flash"] = sum(elf.section_size(s) for s in FLASH_SECTIONS)
+    m["ram"] = sum(elf.section_size(s) for s in RAM_SECTIONS)
+    return m
+
+
+def top_symbols(elf, sections, count):
+    syms = sorted((s for s in elf.symbols if s[2] in sections), key=lambda s: -s[1])[:count]
+    names = demangle([s[0] for s in syms])
+    return [(size, sec, name) for (_, size, sec, _), name in zip(syms, names)]
+
+
+def last_history(history):
+    if not history or not Path(history).exists():
+        return None
+    with open(history, newline="") as f:
+        rows = list(csv.DictReader(f))
+    return rows[-1] if rows else None
+
+
+def render(elf, m, title, ram_total, flash_total, top, previous=None):
+    stack = ram_total - m["ram"]
+    lines = [title, "-" * len(title)]
+    for sec in (".text", ".data", ".bss", ".noinit", ".eeprom"):
+        lines.append(f"{sec:<10}{elf.section_size(sec):>8}")
+    lines.append("")
+
+    def delta(key):
+        if not previous or key not in previous or not previous[key]:
+            return ""
+        d = m[key] - int(previous[key])
+        return f"  ({d:+d} desde {previous['version']})" if d else ""
+
+    lines.append(f"Flash:        {m['flash']:>6} / {flash_total} ({100.0 * m['flash'] / flash_total:.1f}%)"
+                 f"  .text + .data{delta('flash')}")
+    lines.append(f"RAM estática: {m['ram']:>6} / {ram_total} ({100.0 * m['ram'] / ram_total:.1f}%)"
+                 f"  .data + .bss + .noinit{delta('ram')}")
+    lines.append(f"Pilha:        {stack:>6} bytes livres no boot (folga real: parâmetro stack.free)")
+
+    for label, sections in (("RAM", RAM_SECTIONS), ("flash", (".text",))):
+        lines.append("")
+        lines.append(f"Maiores símbolos na {label}:")
+        for size, sec, name in top_symbols(elf, sections, top):
+            lines.append(f"{size:>8}  {sec:<8} {name}")
+    return "\n".join(lines) + "\n"
+
+
+def append_history(history, version, m, ram_total):
+    path = Path(history)
+    new = not path.exists()
+    path.parent.mkdir(parents=True, exist_ok=True)
+    with open(path, "a", newline="") as f:
+        w = csv.DictWriter(f, fieldnames=HISTORY_FIELDS)
+        if new:
+            w.writeheader()
+        w.writerow({"version": version, "build": datetime.now().strftime("%Y-%m-%d %H:%M:%S"),
+                    "flash": m["flash"], "ram": m["ram"], "text": m["text"], "data": m["data"],
+                    "bss": m["bss"], "noinit": m["noinit"], "stack": ram_total - m["ram"]})
+
+
+def write_report(elf_path, out_path, history, version, env_name, ram_total=RAM_TOTAL,
+                 flash_total=FLASH_TOTAL, top=20):
+    """Chamado pelo copy_firmware.py: memory_vX.txt + uma linha no histórico."""
+    elf = Elf(elf_path)
+    m = measure(elf)
+    text = render(elf, m, f"Memória {env_name} {version}", ram_total, flash_total, top, last_history(history))
+    Path(out_path).write_text(text, encoding="utf-8")
+    append_history(history, version, m, ram_total)
+    return m
+
+
+def main():
+    ap = argparse.ArgumentParser(description="RAM/flash por seção e por símbolo a partir do ELF")
+    ap.add_argument("elf")
+    ap.add_argument("--top", type=int, default=20, help="símbolos por região (padrão 20)")
+    ap.add_argument("--ram", type=int, default=RAM_TOTAL, help="RAM da placa (bytes)")
+    ap.add_argument("--flash", type=int, default=FLASH_TOTAL, help="flash disponível (bytes)")
+    ap.add_argument("--history", help="memory_history.csv para comparar com a última versão")
+    args = ap.parse_args()
+
+    elf = Elf(args.elf)
+    m = measure(elf)
+    print(render(elf, m, f"Memória {Path(args.elf).name}", args.ram, args.flash, args.top,
+                 last_history(args.history)), end="")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,50 @@
+#include "adaptive.h"
+
+uint16_t AdaptiveSampler::channelPeriod(float temp, float limit, float risePerS) const {
+    float distance = limit - temp;
+    if (distance <= 0) return config.minMs;
+
+    float span = (float)config.maxMs - config.minMs;
+    float period = config.maxMs;
+    if (distance < config.marginC) period = config.minMs + span * (distance / config.marginC);
+
+    // Subindo: garante ADAPT_SAMPLES_TO_LIMIT amostras até o limite
+    if (risePerS > 0) {
+        float reachMs = distance / risePerS * 1000.0f / ADAPT_SAMPLES_TO_LIMIT;
+        if (reachMs < period) period = reachMs;
+    }
+
+    if (period < config.minMs) return config.minMs;
+    if (period > config.maxMs) return config.maxMs;
+    return (uint16_t)period;
+}
+
+void AdaptiveSampler::setWanted(uint8_t i, uint16_t periodMs) {
+    if (periodMs < config.minMs) periodMs = config.minMs;
+    if (periodMs > config.maxMs) periodMs = config.maxMs;
+    wanted_[i] = periodMs;
+    period_[i] = periodMs;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// ORÇAMENTO DE CARGA
+//───────────────────────────────────────────────────────────────────────────
+// Carga = Σ sampleBits * 1000 / período (bits/s) dos slots adaptativos.
+// Acima de budgetPermille do bitrate, cada período é multiplicado por
+// carga/orçamento (32 bits: período <= 65535 e carga < ~65 kbit/s por slot).
+//───────────────────────────────────────────────────────────────────────────
+void AdaptiveSampler::applyBudget(uint32_t bitrate) {
+    uint32_t load = 0;
+    for (uint8_t i = 0; i < INGEST_MAX_IDS; i++) {
+        if (wanted_[i]) load += (uint32_t)sampleBits() * 1000UL / wanted_[i];
+    }
+    uint32_t budget = (bitrate / 1000) * config.budgetPermille;
+    limited_ = config.budgetPermille > 0 && load > budget;
+
+    for (uint8_t i = 0; i < INGEST_MAX_IDS; i++) {
+        if (!wanted_[i]) continue;
+        uint32_t p = wanted_[i];
+        if (limited_) p = (p * load + budget - 1) / budget;
+        period_[i] = p > config.maxMs ? config.maxMs : (uint16_t)p;
+    }
+}
@@ -0,0 +1,82 @@
+#include "adcengine.h"
+
+bool AdcEngine::configure(uint16_t mask, uint8_t oversampleBits) {
+    count_ = 0;
+    mask_ = 0;
+    for (uint8_t ch = 0; ch < ADC_INPUTS && count_ < ADC_MAX_CHANNELS; ch++) {
+        if (!(mask & (1u << ch))) continue;
+        list_[count_++] = ch;
+        mask_ |= 1u << ch;
+    }
+    bits_ = oversampleBits > ADC_MAX_OVERSAMPLE ? ADC_MAX_OVERSAMPLE : oversampleBits;
+
+    converting_ = 0;
+    queued_ = 0;
+    head_ = tail_ = 0;
+    drops_ = 0;
+    highWater_ = 0;
+    for (uint8_t i = 0; i < ADC_MAX_CHANNELS; i++) {
+        acc_[i] = 0;
+        samples_[i] = 0;
+        valid_[i] = false;
+        window_[i] = 0;
+        rateHz_[i] = 0;
+    }
+    return count_ > 0;
+}
+
+uint16_t AdcEngine::nominalHz() const {
+    if (count_ == 0) return 0;
+    return (ADC_CONVERSIONS_PER_S / count_) >> (2 * bits_);
+}
+
+uint8_t AdcEngine::onConversion(uint16_t raw) {
+    uint8_t slot = converting_;
+    acc_[slot] += raw;
+    if (++samples_[slot] >= (1u << (2 * bits_))) {
+        uint8_t used = head_ - tail_;
+        if (used < ADC_RING_SIZE) {
+            AdcSample &s = ring_[head_ & (ADC_RING_SIZE - 1)];
+            s.slot = slot;
+            s.value = acc_[slot] >> bits_;
+            head_ = head_ + 1;          // Publica depois de escrever a amostra
+            if (used + 1 > highWater_) highWater_ = used + 1;
+        } else if (drops_ < 0xFF) {
+            drops_ = drops_ + 1;
+        }
+        acc_[slot] = 0;
+        samples_[slot] = 0;
+    }
+
+    // A conversão que acabou de começar é a do MUX escrito na ISR anterior
+    converting_ = queued_;
+    queued_ = queued_ + 1 < count_ ? queued_ + 1 : 0;
+    return list_[queued_];
+}
+
+void AdcEngine::drain(uint32_t nowMs) {
+    while (tail_ != head_) {
+        const AdcSample &s = ring_[tail_ & (ADC_RING_SIZE - 1)];
+        latest_[s.slot] = s.value;
+        valid_[s.slot] = true;
+        if (window_[s.slot] < 0xFFFF) window_[s.slot]++;
+        tail_ = tail_ + 1;              // Libera a posição para a ISR
+    }
+
+    uint32_t elapsed = nowMs - windowStart_;
+    if (elapsed >= 1000) {
+        for (uint8_t i = 0; i < count_; i++) {
+            uint32_t hz = (uint32_t)window_[i] * 1000 / elapsed;
+            rateHz_[i] = hz > 0xFFFF ? 0xFFFF : (uint16_t)hz;
+            window_[i] = 0;
+        }
+        windowStart_ = nowMs;
+    }
+}
+
+uint16_t AdcEngine::latestOf(uint8_t adcChannel) const {
+    for (uint8_t i = 0; i < count_; i++) {
+        if (list_[i] == adcChannel) return valid_[i] ? latest_[i] : 0;
+    }
+    return 0;
+}
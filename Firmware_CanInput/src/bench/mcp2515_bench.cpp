@@ -0,0 +1,112 @@
+//═══════════════════════════════════════════════════════════════════════════
+// MICROBENCHMARK DO DRIVER MCP2515 (pio run -e bench_mcp2515 -t upload)
+//═══════════════════════════════════════════════════════════════════════════
+// Compara o driver do firmware (include/mcp2515.h) com coryjfowler/mcp_can
+// no mesmo chip, em modo loopback (não precisa de barramento):
+//
+//   TX: tempo da chamada de envio de um frame de 8 bytes. O mcp_can espera
+//       o frame sair; o driver novo só carrega o TXB0 e dispara.
+//   RX: tempo de readMsgBuf de um frame de 8 bytes já no buffer.
+//
+// Cada frame enviado é relido e conferido (ID e dados). Resultado na serial
+// (115200) em µs por frame: média, mínimo e máximo.
+//═══════════════════════════════════════════════════════════════════════════
+#include <Arduino.h>
+#include <SPI.h>
+#include <mcp_can.h>
+
+#include "mcp2515.h"
+
+#define BENCH_CS     33
+#define BENCH_INT    3
+#define BENCH_FRAMES 1000
+
+struct Timing {
+    uint32_t sum = 0;
+    uint16_t min = 0xFFFF, max = 0;
+    void add(uint16_t us) {
+        sum += us;
+        if (us < min) min = us;
+        if (us > max) max = us;
+    }
+};
+
+struct Result {
+    Timing tx, rx;
+    uint16_t errors = 0;
+};
+
+// Espera o frame do loopback chegar (INT em nível baixo)
+static bool waitRx() {
+    unsigned long start = micros();
+    while (digitalRead(BENCH_INT)) {
+        if (micros() - start > 5000) return false;
+    }
+    return true;
+}
+
+template <typename Send, typename Read>
+static Result run(Send send, Read read) {
+    Result r;
+    byte tx[8], rx[8];
+    for (uint16_t n = 0; n < BENCH_FRAMES; n++) {
+        unsigned long id = 0x100 + (n & 0xFF);
+        for (uint8_t i = 0; i < 8; i++) tx[i] = n + i * 37;
+
+        unsigned long t0 = micros();
+        send(id, tx);
+        r.tx.add(micros() - t0);
+
+        if (!waitRx()) {
+            r.errors++;
+            continue;
+        }
+        unsigned long rxId = 0;
+        byte len = 0;
+        t0 = micros();
+        read(&rxId, &len, rx);
+        r.rx.add(micros() - t0);
+        if (rxId != id || len != 8 || memcmp(tx, rx, 8) != 0) r.errors++;
+    }
+    return r;
+}
+
+static void print(const char *name, const Result &r) {
+    Serial.print(name);
+    Serial.print("\tTX ");
+    Serial.print((float)r.tx.sum / BENCH_FRAMES, 1);
+    Serial.print(" (");
+    Serial.print(r.tx.min);
+    Serial.print("-");
+    Serial.print(r.tx.max);
+    Serial.print(")\tRX ");
+    Serial.print((float)r.rx.sum / BENCH_FRAMES, 1);
+    Serial.print(" (");
+    Serial.print(r.rx.min);
+    Serial.print("-");
+    Serial.print(r.rx.max);
+    Serial.print(")\terros ");
+    Serial.println(r.errors);
+}
+
+void setup() {
+    Serial.begin(115200);
+    pinMode(BENCH_INT, INPUT);
+    Serial.println("MCP2515 loopback 500 kbps, us por frame de 8 bytes: media (min-max)");
+
+    MCP_CAN lib(BENCH_CS);
+    lib.begin(MCP_ANY, CAN_500KBPS, MCP_8MHZ);
+    lib.setMode(MCP_LOOPBACK);
+    Result a = run([&](unsigned long id, byte *buf) { lib.sendMsgBuf(id, 0, 8, buf); },
+                   [&](unsigned long *id, byte *len, byte *buf) { lib.readMsgBuf(id, len, buf); });
+    print("mcp_can", a);
+
+    Mcp2515 drv(BENCH_CS);
+    drv.begin(MCP2515_500KBPS);
+    drv.setMode(MCP2515_LOOPBACK);
+    Result b = run([&](unsigned long id, byte *buf) { drv.sendMsgBuf(id, 8, buf); },
+                   [&](unsigned long *id, byte *len, byte *buf) { drv.readMsgBuf(id, len, buf); });
+    print("mcp2515", b);
+}
+
+void loop() {}
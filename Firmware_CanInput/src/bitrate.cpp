@@ -0,0 +1,68 @@
+#include "bitrate.h"
+
+#include "bushealth.h"
+
+void BitrateMigration::begin(uint8_t stored, uint32_t nowMs) {
+    current_ = stored == BITRATE_1M ? BITRATE_1M : BITRATE_500K;
+    target_ = current_;
+    if (current_ == BITRATE_1M) startTrial(nowMs);
+}
+
+bool BitrateMigration::request(uint8_t target, uint16_t delayMs, uint32_t nowMs) {
+    if (target > BITRATE_1M) return false;
+    target_ = target;
+    startMs_ = nowMs;
+    delayMs_ = delayMs ? delayMs : BITRATE_DEFAULT_DELAY_MS;
+    state_ = MIGRATION_PENDING;
+    return true;
+}
+
+void BitrateMigration::startTrial(uint32_t nowMs) {
+    state_ = MIGRATION_TRIAL;
+    startMs_ = nowMs;
+    delayMs_ = BITRATE_TRIAL_MS;
+    rxSeen_ = 0;
+}
+
+uint8_t BitrateMigration::poll(uint8_t eflg, uint32_t nowMs) {
+    switch (state_) {
+        case MIGRATION_PENDING:
+            if (nowMs - startMs_ < delayMs_) return 0;
+            if (target_ == current_) {
+                state_ = MIGRATION_IDLE;
+                return 0;
+            }
+            current_ = target_;
+            // Voltar para 500 kbps é sempre seguro: grava sem teste
+            if (current_ == BITRATE_500K) {
+                state_ = MIGRATION_IDLE;
+                return MIGRATION_APPLY | MIGRATION_PERSIST;
+            }
+            startTrial(nowMs);
+            return MIGRATION_APPLY;
+
+        case MIGRATION_TRIAL: {
+            bool errors = eflg & (EFLG_EWARN | EFLG_RXEP | EFLG_TXEP | EFLG_TXBO);
+            bool elapsed = nowMs - startMs_ >= delayMs_;
+            if (!errors && !elapsed) return 0;
+            if (!errors && rxSeen_ > 0) {
+                state_ = MIGRATION_IDLE;
+                return MIGRATION_PERSIST;
+            }
+            current_ = BITRATE_500K;
+            target_ = BITRATE_500K;
+            state_ = MIGRATION_FALLBACK;
+            if (fallbacks_ < 255) fallbacks_++;
+            return MIGRATION_APPLY | MIGRATION_PERSIST;
+        }
+
+        default:
+            return 0;
+    }
+}
+
+uint16_t BitrateMigration::remainingMs(uint32_t nowMs) const {
+    if (state_ != MIGRATION_PENDING && state_ != MIGRATION_TRIAL) return 0;
+    uint32_t elapsed = nowMs - startMs_;
+    return elapsed >= delayMs_ ? 0 : (uint16_t)(delayMs_ - elapsed);
+}
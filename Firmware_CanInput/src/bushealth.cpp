@@ -0,0 +1,40 @@
+#include "bushealth.h"
+
+bool BusHealth::sample(uint8_t tec, uint8_t rec, uint8_t eflg, uint32_t nowMs) {
+    tec_ = tec;
+    rec_ = rec;
+    eflg_ = eflg;
+    eflgWindow_ |= eflg;
+
+    bool off = eflg & EFLG_TXBO;
+    if (off && !busOff_) busOffMs_ = nowMs;          // Primeira tentativa após backoffMs_
+    if (off) lastBusOffMs_ = nowMs;
+    busOff_ = off;
+
+    // Estável por tempo suficiente: a próxima queda começa do mínimo
+    if (!off && (nowMs - lastBusOffMs_) >= BUSHEALTH_STABLE_MS) backoffMs_ = BUSHEALTH_BACKOFF_MIN_MS;
+    return off;
+}
+
+bool BusHealth::recoveryDue(uint32_t nowMs) const {
+    return busOff_ && (nowMs - busOffMs_) >= backoffMs_;
+}
+
+void BusHealth::recoveryAttempted(uint32_t nowMs) {
+    busOffMs_ = nowMs;
+    if (recoveries_ < 255) recoveries_++;
+    uint32_t next = (uint32_t)backoffMs_ * 2;
+    backoffMs_ = next > BUSHEALTH_BACKOFF_MAX_MS ? BUSHEALTH_BACKOFF_MAX_MS : (uint16_t)next;
+}
+
+void BusHealth::update(uint32_t nowMs) {
+    uint32_t elapsed = nowMs - windowStartMs_;
+    if (elapsed < 1000) return;
+    rxLast_ = (uint16_t)((uint32_t)rxWindow_ * 1000UL / elapsed);
+    txLast_ = (uint16_t)((uint32_t)txWindow_ * 1000UL / elapsed);
+    eflgSeen_ = eflgWindow_;
+    rxWindow_ = 0;
+    txWindow_ = 0;
+    eflgWindow_ = eflg_;
+    windowStartMs_ = nowMs;
+}
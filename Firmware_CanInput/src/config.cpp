@@ -0,0 +1,523 @@
+#include "config.h"
+
+#include <string.h>
+
+//All of the functions present here have been validated for their use cases
+void readDigital(byte *buf, int digitalCommand[8]){
+    digitalCommand[3] = buf[0] & 0x03;
+    digitalCommand[2] = (buf[0] >> 2) & 0x03;
+    digitalCommand[1] = (buf[0] >> 4) & 0x03;
+    digitalCommand[0] = buf[0] >> 6;
+    digitalCommand[7] = buf[1] & 0x03;
+    digitalCommand[6] = (buf[1] >> 2) & 0x03;
+    digitalCommand[5] = (buf[1] >> 4) & 0x03;
+    digitalCommand[4] = buf[1] >> 6;
+}
+
+int readPWMEnc (byte *buf, int num){
+    int value = buf[num];
+    if (value <= 250){
+       value = (value * 255) / 250;
+    } else if(value == 255){
+        return -2;
+    } else if (value >= 251){
+        return -1;
+    } else {
+        value = 255;
+    }
+    return value;
+} 
+
+void sendDigital(int digitalCommand[8], int PWM1, int PWM2, int Enc, byte *txBuf){
+    txBuf[0] = (digitalCommand[0] << 6) | (digitalCommand[1] << 4) | (digitalCommand[2] << 2) | (digitalCommand[3]);
+    txBuf[1] = (digitalCommand[4] << 6) | (digitalCommand[5] << 4) | (digitalCommand[6] << 2) | (digitalCommand[7]); 
+    txBuf[2] = PWM1;
+    txBuf[3] = PWM2;
+    txBuf[4] = Enc; 
+    txBuf[5] = 0; 
+    txBuf[6] = 0; 
+    txBuf[7] = 0; 
+}
+
+safetyConfigStructure safetyConfig (byte *buf){
+    safetyConfigStructure tempc;
+    tempc.saveeeprom = 0;
+    uint16_t checkId = ((uint16_t)buf[0] << 4 | (buf[1] >> 4));
+    if(checkId != TempFrameId){
+        if(checkId == saveEepromId){
+            tempc.saveeeprom = 1;
+        } else {
+            tempc.Monit_Enable = 2;
+            return tempc;
+        }
+    } 
+    tempc.Monit_Enable = (buf[1] & 0x03);
+    tempc.maxtemp = (buf[2]*120)/255;
+    tempc.timer = (uint16_t)(((float)buf[3] * 10000.0f) / 255.0f);
+    return tempc;
+}
+
+void sendsafetyConfig (safetyConfigStructure tempc, byte *txBuf){
+    txBuf[0] = 0x12;
+    txBuf[1] = 0x30 | tempc.Monit_Enable;
+    txBuf[2] = (tempc.maxtemp*255)/120;
+    txBuf[3] = (uint8_t)((((float)tempc.timer) * 255.0f) / 10000.0f);
+}
+
+aquisitionConfigStructure aquisitionConfig (byte *buf){
+    aquisitionConfigStructure aquisc;
+#ifdef ARDUINO
+    Serial.println(F("Parsing aquisitionConfigStructure from buffer:"));
+    for(int i=0; i<8; i++) {
+        Serial.print(buf[i], HEX);
+        Serial.print(F(" "));
+    }
+#endif
+    aquisc.timer = (buf[0] << 8) | buf[1];
+    aquisc.analog = (buf[2] & 0x01);
+    aquisc.Aquics_Enable_Continuous = (buf[3] & 0x03);
+    return aquisc;
+}
+
+void sendaquisitionConfig(aquisitionConfigStructure aquisc, byte *txBuf){
+    txBuf[0] = (aquisc.timer >> 8) & 0xFF;  
+    txBuf[1] = aquisc.timer & 0xFF;         
+    txBuf[2] = aquisc.analog & 0x01;
+    txBuf[3] = aquisc.Aquics_Enable_Continuous & 0x03;
+    txBuf[4] = 0x00;
+    txBuf[5] = 0x00;
+    txBuf[6] = 0x00;
+    txBuf[7] = 0x00;
+}
+
+tempReadStructure tempRead(byte *buf){
+    tempReadStructure temp;
+    temp.CJtemp = buf[0] - 128;
+    temp.TLstatus = (buf[1] & 0x03);
+    temp.TLtemp = (((buf[2] & 0x3f) << 6) | (buf[1] >> 2)) - 2048;
+    temp.TRstatus = (buf[2] >> 6);
+    temp.TRtemp = (((buf[4] & 0x0F) << 8) | buf[3]) - 2048;
+    temp.BLstatus = ((buf[4] >> 4) & 0x03);
+    temp.BLtemp = (((buf[6] & 0x03) << 10) | (buf[5] << 2) | (buf[4] >> 6)) - 2048;
+    temp.BRstatus = ((buf[6] >> 2) & 0x03);
+    temp.BRtemp = ((buf[7] << 4) | (buf[6] >> 4)) - 2048;
+    return temp;
+}
+
+// 0x403/0x406: dois canais por frame, 4 bytes cada
+// [0x12][0x30 | Monit_Enable][maxtemp em degC][timer em ms, 1 byte]
+void readSafetyPair(byte *buf, safetyConfigStructure &first, safetyConfigStructure &second){
+    first.Monit_Enable = (buf[1] & 0x03);
+    first.maxtemp = (float)buf[2];
+    first.timer = (uint16_t)buf[3];
+    first.saveeeprom = 1;
+    second.Monit_Enable = (buf[5] & 0x03);
+    second.maxtemp = (float)buf[6];
+    second.timer = (uint16_t)buf[7];
+    second.saveeeprom = 1;
+}
+
+void sendSafetyPair(const safetyConfigStructure &first, const safetyConfigStructure &second, byte *txBuf){
+    txBuf[0] = 0x12;
+    txBuf[1] = 0x30 | (first.Monit_Enable & 0x03);
+    txBuf[2] = (byte)first.maxtemp;
+    txBuf[3] = (byte)first.timer;
+    txBuf[4] = 0x12;
+    txBuf[5] = 0x30 | (second.Monit_Enable & 0x03);
+    txBuf[6] = (byte)second.maxtemp;
+    txBuf[7] = (byte)second.timer;
+}
+
+// 0x404/0x424: timer big-endian nos bytes 0-1, analog no byte 2, continuo no bit 2 do byte 3
+aquisitionConfigStructure readAquisitionFrame(byte *buf, aquisitionConfigStructure current){
+    uint16_t newTimer = ((uint16_t)buf[0] << 8) | buf[1];
+    if(newTimer < 10) newTimer = 100; // Protecao
+    current.timer = newTimer;
+    current.analog = buf[2];
+    current.Aquics_Enable_Continuous = (buf[3] >> 2) & 0x01;
+    return current;
+}
+
+void sendAquisitionFrame(const aquisitionConfigStructure &aquisc, byte *txBuf){
+    txBuf[0] = (aquisc.timer >> 8) & 0xFF;
+    txBuf[1] = aquisc.timer & 0xFF;
+    txBuf[2] = aquisc.analog;
+    txBuf[3] = (aquisc.Aquics_Enable_Continuous & 0x01) << 2;
+    txBuf[4] = 0; txBuf[5] = 0; txBuf[6] = 0; txBuf[7] = 0;
+}
+
+// 0x405/0x425: enable nos bits 6-7 do byte 0; retorna 2+ para valor invalido
+uint8_t readStartStop(byte *buf){
+    return buf[0] >> 6;
+}
+
+void sendStartStop(uint8_t enable, byte *txBuf){
+    txBuf[0] = (enable << 6) & 0xC0;
+    for(int i=1; i<8; i++) txBuf[i] = 0;
+}
+
+// 0x407: modo de ingestão no byte 0 (0 = polling, 1 = push); 2+ = invalido
+uint8_t readIngestMode(byte *buf){
+    return buf[0];
+}
+
+// 0x427: [modo<<7 | RTRs enviados][push mask][fresh mask][carga ‰ BE][carga polling ‰ BE][RTRs economizados]
+// Contagens por segundo; enviados satura em 127, economizados em 255
+void sendIngestStatus(const ingestStatusStructure &status, byte *txBuf){
+    txBuf[0] = ((status.mode & 0x01) << 7) | (status.rtrSent > 127 ? 127 : status.rtrSent);
+    txBuf[1] = status.pushMask;
+    txBuf[2] = status.freshMask;
+    txBuf[3] = (status.loadPermille >> 8) & 0xFF;
+    txBuf[4] = status.loadPermille & 0xFF;
+    txBuf[5] = (status.pollLoadPermille >> 8) & 0xFF;
+    txBuf[6] = status.pollLoadPermille & 0xFF;
+    txBuf[7] = status.rtrSkipped;
+}
+
+ingestStatusStructure readIngestStatus(const byte *buf){
+    ingestStatusStructure status;
+    status.mode = buf[0] >> 7;
+    status.rtrSent = buf[0] & 0x7F;
+    status.pushMask = buf[1];
+    status.freshMask = buf[2];
+    status.loadPermille = ((uint16_t)buf[3] << 8) | buf[4];
+    status.pollLoadPermille = ((uint16_t)buf[5] << 8) | buf[6];
+    status.rtrSkipped = buf[7];
+    return status;
+}
+
+// 0x408: ação no byte 0 (3+ = mantém), idade máxima em ms BE nos bytes 1-2 (0 = mantém)
+freshnessConfigStructure readFreshnessConfig(byte *buf, freshnessConfigStructure current){
+    if(buf[0] <= STALE_RELEASE) current.action = buf[0];
+    uint16_t maxAge = ((uint16_t)buf[1] << 8) | buf[2];
+    if(maxAge > 0) current.maxAgeMs = maxAge;
+    return current;
+}
+
+// 0x428: [usados<<4 | velhos][ação][idade máx ms BE][idade T1..T4 em 10 ms, satura em 255]
+static byte tenMsUnits(uint16_t ms){
+    uint16_t units = ms / 10;
+    return units > 255 ? 255 : (byte)units;
+}
+
+void sendFreshnessStatus(const freshnessStatusStructure &status, byte *txBuf){
+    txBuf[0] = ((status.usedMask & 0x0F) << 4) | (status.staleMask & 0x0F);
+    txBuf[1] = status.action;
+    txBuf[2] = (status.maxAgeMs >> 8) & 0xFF;
+    txBuf[3] = status.maxAgeMs & 0xFF;
+    for(int i=0; i<4; i++) txBuf[4 + i] = tenMsUnits(status.ageMs[i]);
+}
+
+freshnessStatusStructure readFreshnessStatus(const byte *buf){
+    freshnessStatusStructure status;
+    status.usedMask = buf[0] >> 4;
+    status.staleMask = buf[0] & 0x0F;
+    status.action = buf[1];
+    status.maxAgeMs = ((uint16_t)buf[2] << 8) | buf[3];
+    for(int i=0; i<4; i++) status.ageMs[i] = (uint16_t)buf[4 + i] * 10;
+    return status;
+}
+
+// 0x409: [enable no bit 0][min em 10 ms][max em 20 ms][margem °C][orçamento ‰]
+// min/max/margem 0 = mantém; min > max é ignorado
+samplingConfigStructure readSamplingConfig(byte *buf, samplingConfigStructure current){
+    samplingConfigStructure next = current;
+    next.enabled = buf[0] & 0x01;
+    if(buf[1] > 0) next.minMs = (uint16_t)buf[1] * 10;
+    if(buf[2] > 0) next.maxMs = (uint16_t)buf[2] * 20;
+    if(buf[3] > 0) next.marginC = buf[3];
+    next.budgetPermille = buf[4];
+    if(next.minMs > next.maxMs) return current;
+    return next;
+}
+
+// 0x429: bytes 0-4 como no 0x409 (bit 1 do byte 0 = limitado pelo orçamento),
+// bytes 5-7 = período atual de 0x510/0x520/0x530 em 10 ms (satura em 255)
+void sendSamplingStatus(const samplingStatusStructure &status, byte *txBuf){
+    txBuf[0] = (status.config.enabled & 0x01) | ((status.budgetLimited & 0x01) << 1);
+    txBuf[1] = status.config.minMs / 10;
+    txBuf[2] = status.config.maxMs / 20;
+    txBuf[3] = status.config.marginC;
+    txBuf[4] = status.config.budgetPermille;
+    for(int i=0; i<3; i++) txBuf[5 + i] = tenMsUnits(status.periodMs[i]);
+}
+
+samplingStatusStructure readSamplingStatus(const byte *buf){
+    samplingStatusStructure status;
+    status.config.enabled = buf[0] & 0x01;
+    status.budgetLimited = (buf[0] >> 1) & 0x01;
+    status.config.minMs = (uint16_t)buf[1] * 10;
+    status.config.maxMs = (uint16_t)buf[2] * 20;
+    status.config.marginC = buf[3];
+    status.config.budgetPermille = buf[4];
+    for(int i=0; i<3; i++) status.periodMs[i] = (uint16_t)buf[5 + i] * 10;
+    return status;
+}
+
+// 0x40A: [modo (2+ = mantém)][período do heartbeat em s, 0 = desligado]
+reportConfigStructure readReportConfig(byte *buf, reportConfigStructure current){
+    if(buf[0] < 2) current.mode = buf[0];
+    current.heartbeatS = buf[1];
+    return current;
+}
+
+// 0x42A: [modo][heartbeat s][tempo ligado s BE 32 bits][enviados][suprimidos]
+void sendHeartbeat(const heartbeatStructure &hb, byte *txBuf){
+    txBuf[0] = hb.config.mode;
+    txBuf[1] = hb.config.heartbeatS;
+    txBuf[2] = (hb.uptimeS >> 24) & 0xFF;
+    txBuf[3] = (hb.uptimeS >> 16) & 0xFF;
+    txBuf[4] = (hb.uptimeS >> 8) & 0xFF;
+    txBuf[5] = hb.uptimeS & 0xFF;
+    txBuf[6] = hb.sent;
+    txBuf[7] = hb.suppressed;
+}
+
+heartbeatStructure readHeartbeat(const byte *buf){
+    heartbeatStructure hb;
+    hb.config.mode = buf[0];
+    hb.config.heartbeatS = buf[1];
+    hb.uptimeS = ((uint32_t)buf[2] << 24) | ((uint32_t)buf[3] << 16) | ((uint32_t)buf[4] << 8) | buf[5];
+    hb.sent = buf[6];
+    hb.suppressed = buf[7];
+    return hb;
+}
+
+// 0x42B: [TEC][REC][EFLG][reinícios][carga ‰ BE][RX/s ÷ 16][TX/s] (saturam em 255)
+void sendBusHealth(const busHealthStructure &health, byte *txBuf){
+    uint16_t rx = health.rxPerS / 16;
+    txBuf[0] = health.tec;
+    txBuf[1] = health.rec;
+    txBuf[2] = health.eflg;
+    txBuf[3] = health.recoveries;
+    txBuf[4] = (health.loadPermille >> 8) & 0xFF;
+    txBuf[5] = health.loadPermille & 0xFF;
+    txBuf[6] = rx > 255 ? 255 : (byte)rx;
+    txBuf[7] = health.txPerS > 255 ? 255 : (byte)health.txPerS;
+}
+
+busHealthStructure readBusHealth(const byte *buf){
+    busHealthStructure health;
+    health.tec = buf[0];
+    health.rec = buf[1];
+    health.eflg = buf[2];
+    health.recoveries = buf[3];
+    health.loadPermille = ((uint16_t)buf[4] << 8) | buf[5];
+    health.rxPerS = (uint16_t)buf[6] * 16;
+    health.txPerS = buf[7];
+    return health;
+}
+
+// 0x40C: [alvo][espera ms BE]
+bitrateCommandStructure readBitrateCommand(byte *buf){
+    bitrateCommandStructure cmd;
+    cmd.target = buf[0];
+    cmd.delayMs = ((uint16_t)buf[1] << 8) | buf[2];
+    return cmd;
+}
+
+// 0x42C: [atual][estado][alvo][restante ms BE][EEPROM][falhas][0]
+void sendBitrateStatus(const bitrateStatusStructure &status, byte *txBuf){
+    txBuf[0] = status.current;
+    txBuf[1] = status.state;
+    txBuf[2] = status.target;
+    txBuf[3] = (status.remainingMs >> 8) & 0xFF;
+    txBuf[4] = status.remainingMs & 0xFF;
+    txBuf[5] = status.stored;
+    txBuf[6] = status.fallbacks;
+    txBuf[7] = 0;
+}
+
+bitrateStatusStructure readBitrateStatus(const byte *buf){
+    bitrateStatusStructure status;
+    status.current = buf[0];
+    status.state = buf[1];
+    status.target = buf[2];
+    status.remainingMs = ((uint16_t)buf[3] << 8) | buf[4];
+    status.stored = buf[5];
+    status.fallbacks = buf[6];
+    return status;
+}
+
+// 0x40D: [máscara (4+ mantém)][janela0/10 ms][janela1/10 ms][ppr0 BE][ppr1 BE]
+// 0 em janela/ppr mantém o valor atual
+pulseConfigStructure readPulseConfig(byte *buf, pulseConfigStructure current){
+    pulseConfigStructure cfg = current;
+    if (buf[0] < 4) cfg.enableMask = buf[0];
+    for (int i = 0; i < 2; i++) {
+        if (buf[1 + i] != 0) cfg.gateMs[i] = buf[1 + i] * 10;
+        uint16_t ppr = ((uint16_t)buf[3 + 2 * i] << 8) | buf[4 + 2 * i];
+        if (ppr != 0) cfg.ppr[i] = ppr;
+    }
+    return cfg;
+}
+
+// 0x42D: [RPM0 BE][RPM1 BE][Hz0 BE][Hz1 BE]
+void sendPulseStatus(const pulseStatusStructure &status, byte *txBuf){
+    for (int i = 0; i < 2; i++) {
+        txBuf[2 * i] = (status.rpm[i] >> 8) & 0xFF;
+        txBuf[2 * i + 1] = status.rpm[i] & 0xFF;
+        txBuf[4 + 2 * i] = (status.frequencyHz[i] >> 8) & 0xFF;
+        txBuf[5 + 2 * i] = status.frequencyHz[i] & 0xFF;
+    }
+}
+
+pulseStatusStructure readPulseStatus(const byte *buf){
+    pulseStatusStructure status;
+    for (int i = 0; i < 2; i++) {
+        status.rpm[i] = ((uint16_t)buf[2 * i] << 8) | buf[2 * i + 1];
+        status.frequencyHz[i] = ((uint16_t)buf[4 + 2 * i] << 8) | buf[5 + 2 * i];
+    }
+    return status;
+}
+
+// 0x40E: [máscara BE][oversampling]; máscara 0 ou oversampling > 3 mantém o atual
+adcConfigStructure readAdcConfig(byte *buf, adcConfigStructure current){
+    uint16_t mask = ((uint16_t)buf[0] << 8) | buf[1];
+    if (mask != 0) current.channelMask = mask;
+    if (buf[2] <= 3) current.oversampleBits = buf[2];
+    return current;
+}
+
+// 0x42E: [máscara BE][oversampling | rodando << 7][perdas][Hz medido BE][Hz nominal BE]
+void sendAdcStatus(const adcStatusStructure &status, byte *txBuf){
+    txBuf[0] = (status.config.channelMask >> 8) & 0xFF;
+    txBuf[1] = status.config.channelMask & 0xFF;
+    txBuf[2] = (status.config.oversampleBits & 0x03) | (status.running ? 0x80 : 0);
+    txBuf[3] = status.drops;
+    txBuf[4] = (status.measuredHz >> 8) & 0xFF;
+    txBuf[5] = status.measuredHz & 0xFF;
+    txBuf[6] = (status.nominalHz >> 8) & 0xFF;
+    txBuf[7] = status.nominalHz & 0xFF;
+}
+
+adcStatusStructure readAdcStatus(const byte *buf){
+    adcStatusStructure status;
+    status.config.channelMask = ((uint16_t)buf[0] << 8) | buf[1];
+    status.config.oversampleBits = buf[2] & 0x03;
+    status.running = buf[2] >> 7;
+    status.drops = buf[3];
+    status.measuredHz = ((uint16_t)buf[4] << 8) | buf[5];
+    status.nominalHz = ((uint16_t)buf[6] << 8) | buf[7];
+    return status;
+}
+
+// 0x42F: [estado][tamanho BE][período/10 ms][millis BE u32]
+void sendHistoryStatus(const historyStatusStructure &status, byte *txBuf){
+    txBuf[0] = status.state;
+    txBuf[1] = (status.length >> 8) & 0xFF;
+    txBuf[2] = status.length & 0xFF;
+    txBuf[3] = status.period10ms;
+    txBuf[4] = (status.uptimeMs >> 24) & 0xFF;
+    txBuf[5] = (status.uptimeMs >> 16) & 0xFF;
+    txBuf[6] = (status.uptimeMs >> 8) & 0xFF;
+    txBuf[7] = status.uptimeMs & 0xFF;
+}
+
+historyStatusStructure readHistoryStatus(const byte *buf){
+    historyStatusStructure status;
+    status.state = buf[0];
+    status.length = ((uint16_t)buf[1] << 8) | buf[2];
+    status.period10ms = buf[3];
+    status.uptimeMs = ((uint32_t)buf[4] << 24) | ((uint32_t)buf[5] << 16) |
+                      ((uint32_t)buf[6] << 8) | buf[7];
+    return status;
+}
+
+// Registro de canal dos serviços ISO-TP: [habilita][maxtemp float BE][timer BE]
+// (maxtemp e timer com resolução completa, sem o byte único do 0x403/0x406)
+void sendSafetyRecord(const safetyConfigStructure &config, byte *txBuf){
+    uint32_t bits;
+    memcpy(&bits, &config.maxtemp, sizeof(bits));
+    txBuf[0] = config.Monit_Enable;
+    txBuf[1] = (bits >> 24) & 0xFF;
+    txBuf[2] = (bits >> 16) & 0xFF;
+    txBuf[3] = (bits >> 8) & 0xFF;
+    txBuf[4] = bits & 0xFF;
+    txBuf[5] = (config.timer >> 8) & 0xFF;
+    txBuf[6] = config.timer & 0xFF;
+}
+
+safetyConfigStructure readSafetyRecord(const byte *buf){
+    safetyConfigStructure config;
+    uint32_t bits = ((uint32_t)buf[1] << 24) | ((uint32_t)buf[2] << 16) |
+                    ((uint32_t)buf[3] << 8) | buf[4];
+    config.Monit_Enable = buf[0];
+    memcpy(&config.maxtemp, &bits, sizeof(bits));
+    config.timer = ((uint16_t)buf[5] << 8) | buf[6];
+    return config;
+}
+
+// Registro de parâmetro dos serviços 0x05/0x06: [índice][tipo][flags][valor BE]
+void sendParamValue(const paramValueStructure &value, byte *txBuf){
+    txBuf[0] = value.index;
+    txBuf[1] = value.type;
+    txBuf[2] = value.flags;
+    txBuf[3] = (value.wire >> 24) & 0xFF;
+    txBuf[4] = (value.wire >> 16) & 0xFF;
+    txBuf[5] = (value.wire >> 8) & 0xFF;
+    txBuf[6] = value.wire & 0xFF;
+}
+
+paramValueStructure readParamValue(const byte *buf){
+    paramValueStructure value;
+    value.index = buf[0];
+    value.type = buf[1];
+    value.flags = buf[2];
+    value.wire = ((uint32_t)buf[3] << 24) | ((uint32_t)buf[4] << 16) |
+                 ((uint32_t)buf[5] << 8) | buf[6];
+    return value;
+}
+
+// 0x081: [seq][0][t1 µs 48 bits BE]
+void sendTimeFollowUp(uint8_t seq, uint64_t masterUs, byte *txBuf){
+    txBuf[0] = seq;
+    txBuf[1] = 0;
+    for (uint8_t i = 0; i < 6; i++) txBuf[2 + i] = (masterUs >> (40 - 8 * i)) & 0xFF;
+}
+
+uint64_t readTimeFollowUp(const byte *buf, uint8_t &seq){
+    uint64_t us = 0;
+    seq = buf[0];
+    for (uint8_t i = 0; i < 6; i++) us = (us << 8) | buf[2 + i];
+    return us;
+}
+
+// 0x431: [estado][seq][erro µs int16 BE][drift 0,1 ppm int16 BE][rejeitados][pares]
+void sendTimeSyncStatus(const timeSyncStatusStructure &status, byte *txBuf){
+    txBuf[0] = status.state;
+    txBuf[1] = status.seq;
+    txBuf[2] = ((uint16_t)status.offsetUs >> 8) & 0xFF;
+    txBuf[3] = (uint16_t)status.offsetUs & 0xFF;
+    txBuf[4] = ((uint16_t)status.drift01ppm >> 8) & 0xFF;
+    txBuf[5] = (uint16_t)status.drift01ppm & 0xFF;
+    txBuf[6] = status.rejected;
+    txBuf[7] = status.samples;
+}
+
+timeSyncStatusStructure readTimeSyncStatus(const byte *buf){
+    timeSyncStatusStructure status;
+    status.state = buf[0];
+    status.seq = buf[1];
+    status.offsetUs = (int16_t)((buf[2] << 8) | buf[3]);
+    status.drift01ppm = (int16_t)((buf[4] << 8) | buf[5]);
+    status.rejected = buf[6];
+    status.samples = buf[7];
+    return status;
+}
+
+// 0x432: [canal][valor int16 BE][µs 40 bits BE]
+void sendStampedSample(const stampedSampleStructure &sample, byte *txBuf){
+    txBuf[0] = sample.channel;
+    txBuf[1] = ((uint16_t)sample.value >> 8) & 0xFF;
+    txBuf[2] = (uint16_t)sample.value & 0xFF;
+    for (uint8_t i = 0; i < 5; i++) txBuf[3 + i] = (sample.timeUs >> (32 - 8 * i)) & 0xFF;
+}
+
+stampedSampleStructure readStampedSample(const byte *buf){
+    stampedSampleStructure sample;
+    sample.channel = buf[0];
+    sample.value = (int16_t)((buf[1] << 8) | buf[2]);
+    for (uint8_t i = 0; i < 5; i++) sample.timeUs = (sample.timeUs << 8) | buf[3 + i];
+    return sample;
+}
@@ -0,0 +1,220 @@
+#include "history.h"
+
+static uint8_t popcount4(uint8_t v) {
+    return (v & 1) + ((v >> 1) & 1) + ((v >> 2) & 1) + ((v >> 3) & 1);
+}
+
+int16_t historyQuantize(float celsius) {
+    float q = celsius * 4.0f;
+    if (q >= 32767.0f) return 32767;
+    if (q <= -32767.0f) return -32767;
+    return (int16_t)(q < 0 ? q - 0.5f : q + 0.5f);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// ANEL
+//───────────────────────────────────────────────────────────────────────────
+uint8_t HistoryLog::recordLength(uint32_t pos) const {
+    uint8_t tag = at(pos);
+    switch (tag & HIST_TAG_TYPE) {
+        case HIST_TAG_KEY:   return HISTORY_KEY_BYTES;
+        case HIST_TAG_EVENT: return HISTORY_EVENT_BYTES;
+        case HIST_TAG_DELTA: return 1 + popcount4(tag & 0x0F) + ((tag & HIST_DELTA_RELAYS) ? 1 : 0);
+        default:             return 1;
+    }
+}
+
+// Abre espaço para n bytes descartando segmentos inteiros (KEY + seguintes).
+// Durante o download nada é descartado: false = sem espaço.
+bool HistoryLog::reserve(uint8_t n) {
+    while (HISTORY_BYTES - size() < n) {
+        if (downloading_ || head_ == tail_) return false;
+        tail_ += recordLength(tail_);
+        while (tail_ != head_ && (at(tail_) & HIST_TAG_TYPE) != HIST_TAG_KEY) tail_ += recordLength(tail_);
+        if (tail_ == head_) {
+            needKey_ = true;           // O segmento atual também saiu
+        } else {
+            oldestMs_ = ((uint32_t)at(tail_ + 1) << 24) | ((uint32_t)at(tail_ + 2) << 16) |
+                        ((uint32_t)at(tail_ + 3) << 8) | at(tail_ + 4);
+        }
+    }
+    return true;
+}
+
+void HistoryLog::writeKey(uint32_t nowMs, const int16_t temp[HISTORY_CHANNELS], uint8_t relays) {
+    if (head_ == tail_) oldestMs_ = nowMs;
+    put(HIST_TAG_KEY);
+    put(nowMs >> 24);
+    put(nowMs >> 16);
+    put(nowMs >> 8);
+    put(nowMs);
+    for (uint8_t ch = 0; ch < HISTORY_CHANNELS; ch++) {
+        put((uint16_t)temp[ch] >> 8);
+        put((uint16_t)temp[ch]);
+        last_[ch] = temp[ch];
+    }
+    put(relays);
+    lastRelays_ = relays;
+    lastMs_ = nowMs;
+    sinceKey_ = 0;
+    needKey_ = false;
+}
+
+void HistoryLog::clear() {
+    head_ = tail_ = 0;
+    needKey_ = true;
+    lost_ = 0;
+    downloading_ = false;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// GRAVAÇÃO
+//───────────────────────────────────────────────────────────────────────────
+void HistoryLog::sample(uint32_t nowMs, const int16_t temp[HISTORY_CHANNELS], uint8_t relays) {
+    int16_t diff[HISTORY_CHANNELS];
+    uint8_t mask = 0;
+    bool fits = true;
+    for (uint8_t ch = 0; ch < HISTORY_CHANNELS; ch++) {
+        diff[ch] = temp[ch] - last_[ch];
+        if (diff[ch] != 0) mask |= 1 << ch;
+        if (diff[ch] < -128 || diff[ch] > 127) fits = false;
+    }
+    bool relaysChanged = relays != lastRelays_;
+
+    // O decodificador soma HISTORY_PERIOD_MS por delta: atraso de mais de
+    // meio período vira KEY (com o tempo real)
+    int32_t drift = (int32_t)(nowMs - (lastMs_ + HISTORY_PERIOD_MS));
+    bool key = needKey_ || !fits || sinceKey_ >= HISTORY_KEY_EVERY - 1 ||
+               drift > HISTORY_PERIOD_MS / 2 || drift < -(HISTORY_PERIOD_MS / 2);
+
+    if (!key) {
+        uint8_t n = 1 + popcount4(mask) + (relaysChanged ? 1 : 0);
+        if (!reserve(n)) {
+            if (lost_ < 0xFF) lost_++;
+            needKey_ = true;
+            return;
+        }
+        if (!needKey_) {
+            put(HIST_TAG_DELTA | (relaysChanged ? HIST_DELTA_RELAYS : 0) | mask);
+            for (uint8_t ch = 0; ch < HISTORY_CHANNELS; ch++) {
+                if (mask & (1 << ch)) put((uint8_t)(int8_t)diff[ch]);
+                last_[ch] = temp[ch];
+            }
+            if (relaysChanged) put(relays);
+            lastRelays_ = relays;
+            lastMs_ += HISTORY_PERIOD_MS;
+            sinceKey_++;
+        } else {
+            key = true;                // O anel esvaziou: recomeça com KEY
+        }
+    }
+
+    if (key) {
+        if (!reserve(HISTORY_KEY_BYTES)) {
+            if (lost_ < 0xFF) lost_++;
+            needKey_ = true;
+            return;
+        }
+        writeKey(nowMs, temp, relays);
+    }
+
+    // Perdas do último download, registradas logo depois do KEY de retomada
+    if (lost_ && !downloading_) {
+        uint8_t lost = lost_;
+        lost_ = 0;
+        event(nowMs, HIST_EV_LOST, lost);
+    }
+}
+
+void HistoryLog::event(uint32_t nowMs, uint8_t code, uint8_t arg) {
+    uint8_t n = HISTORY_EVENT_BYTES + (needKey_ ? HISTORY_KEY_BYTES : 0);
+    if (!reserve(n)) {
+        if (lost_ < 0xFF) lost_++;
+        return;
+    }
+    // Sem segmento aberto: KEY com o último estado conhecido
+    if (needKey_) {
+        reserve(HISTORY_KEY_BYTES + HISTORY_EVENT_BYTES);
+        writeKey(nowMs, last_, lastRelays_);
+    }
+    int32_t offset = (int32_t)(nowMs - lastMs_) / 2;
+    put(HIST_TAG_EVENT | (code & 0x3F));
+    put(arg);
+    put(offset < 0 ? 0 : offset > 0xFF ? 0xFF : (uint8_t)offset);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// DOWNLOAD
+//───────────────────────────────────────────────────────────────────────────
+void HistoryLog::begin() {
+    start_ = read_ = tail_;
+    end_ = head_;
+    downloading_ = true;
+}
+
+uint8_t HistoryLog::chunk(uint8_t *out) const {
+    uint32_t left = end_ - read_;
+    uint8_t n = left > 7 ? 7 : (uint8_t)left;
+    for (uint8_t i = 0; i < n; i++) out[i] = at(read_ + i);
+    return n;
+}
+
+void HistoryLog::advance(uint8_t n) {
+    read_ += n;
+    if (read_ == end_) downloading_ = false;
+}
+
+uint8_t HistoryLog::read(uint16_t offset, uint8_t *out, uint8_t n) const {
+    uint32_t left = offset < end_ - start_ ? end_ - start_ - offset : 0;
+    if (n > left) n = (uint8_t)left;
+    for (uint8_t i = 0; i < n; i++) out[i] = at(start_ + offset + i);
+    return n;
+}
+
+#ifndef ARDUINO
+//───────────────────────────────────────────────────────────────────────────
+// DECODIFICADOR (host)
+//───────────────────────────────────────────────────────────────────────────
+bool historyDecode(const uint8_t *data, size_t n, std::vector<HistoryRecord> &out) {
+    HistoryRecord cur = HistoryRecord();
+    bool haveKey = false;
+    size_t i = 0;
+    while (i < n) {
+        uint8_t tag = data[i];
+        uint8_t type = tag & HIST_TAG_TYPE;
+        size_t len = type == HIST_TAG_KEY     ? HISTORY_KEY_BYTES
+                     : type == HIST_TAG_EVENT ? HISTORY_EVENT_BYTES
+                     : type == HIST_TAG_DELTA ? 1 + popcount4(tag & 0x0F) + ((tag & HIST_DELTA_RELAYS) ? 1 : 0)
+                                              : 0;
+        if (len == 0 || i + len > n) return false;
+        const uint8_t *p = data + i + 1;
+
+        if (type == HIST_TAG_KEY) {
+            cur.ms = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+            for (int ch = 0; ch < HISTORY_CHANNELS; ch++) cur.temp[ch] = (int16_t)((p[4 + 2 * ch] << 8) | p[5 + 2 * ch]);
+            cur.relays = p[12];
+            cur.isEvent = false;
+            out.push_back(cur);
+            haveKey = true;
+        } else if (!haveKey) {
+            return false;
+        } else if (type == HIST_TAG_DELTA) {
+            cur.ms += HISTORY_PERIOD_MS;
+            for (int ch = 0; ch < HISTORY_CHANNELS; ch++) {
+                if (tag & (1 << ch)) cur.temp[ch] += (int8_t)*p++;
+            }
+            if (tag & HIST_DELTA_RELAYS) cur.relays = *p;
+            out.push_back(cur);
+        } else {
+            HistoryRecord e = cur;
+            e.isEvent = true;
+            e.code = tag & 0x3F;
+            e.arg = p[0];
+            e.ms = cur.ms + 2u * p[1];
+            out.push_back(e);
+        }
+        i += len;
+    }
+    return true;
+}
+#endif
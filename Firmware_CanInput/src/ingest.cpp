@@ -0,0 +1,122 @@
+#include "ingest.h"
+
+int IngestTracker::add(uint16_t id, bool rtrFallback) {
+    if (count_ >= INGEST_MAX_IDS) return -1;
+    slots_[count_].id = id;
+    slots_[count_].rtrFallback = rtrFallback;
+    return count_++;
+}
+
+int IngestTracker::find(uint16_t id) const {
+    for (uint8_t i = 0; i < count_; i++) {
+        if (slots_[i].id == id) return i;
+    }
+    return -1;
+}
+
+int IngestTracker::onFrame(uint16_t id, bool remote, uint32_t nowMs) {
+    int i = find(id);
+    if (i < 0) return -1;
+    IngestSlot &s = slots_[i];
+
+    // RTR de outro nó (ex.: MATLAB): a próxima resposta não é push
+    if (remote) {
+        s.rtrPending = true;
+        s.rtrMs = nowMs;
+        return i;
+    }
+
+    bool solicited = s.rtrPending && (nowMs - s.rtrMs) <= INGEST_RTR_WINDOW_MS;
+    s.rtrPending = false;
+    s.lastMs = nowMs;
+    s.seen = true;
+    if (solicited) return i;
+
+    // Frame espontâneo: atualiza o período medido. Depois de uma lacuna
+    // longa (módulo reiniciado, push desligado) a medição recomeça.
+    if (s.pushCount > 0) {
+        uint32_t delta = nowMs - s.lastPushMs;
+        if (delta > 0xFFFF) delta = 0xFFFF;
+        if (s.pushCount >= 2 && delta > 4UL * s.periodMs) {
+            s.pushCount = 1;
+            s.lastPushMs = nowMs;
+            return i;
+        }
+        if (s.pushCount == 1) s.periodMs = (uint16_t)delta;
+        else s.periodMs = (uint16_t)((3UL * s.periodMs + delta) / 4);
+    }
+    if (s.pushCount < 255) s.pushCount++;
+    s.lastPushMs = nowMs;
+    return i;
+}
+
+bool IngestTracker::fresh(uint8_t i, uint32_t nowMs, uint16_t wantedPeriodMs) const {
+    const IngestSlot &s = slots_[i];
+    if (s.pushCount < 2 || s.periodMs == 0) return false;
+    if (s.periodMs > wantedPeriodMs + wantedPeriodMs / 4) return false;  // Push mais lento que o pedido
+    return (nowMs - s.lastMs) <= 2UL * s.periodMs + INGEST_FRESH_MARGIN_MS;
+}
+
+bool IngestTracker::needsRtr(uint8_t i, uint32_t nowMs, uint16_t wantedPeriodMs) const {
+    if (!slots_[i].rtrFallback) return false;
+    if (mode == INGEST_POLL) return true;
+    return !fresh(i, nowMs, wantedPeriodMs);
+}
+
+void IngestTracker::rtrSent(uint8_t i, uint32_t nowMs) {
+    slots_[i].rtrPending = true;
+    slots_[i].rtrMs = nowMs;
+    rtrWindow_++;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// CARGA DO BARRAMENTO
+//───────────────────────────────────────────────────────────────────────────
+// Standard: SOF(1) + ID(11) + RTR/IDE/r0(3) + DLC(4) + dados + CRC(15) +
+// delimitador(1) + ACK(2) + EOF(7) + IFS(3) = 47 + 8*dlc bits.
+// Extended acrescenta SRR/IDE + 18 bits de ID + r1 = 20 bits.
+// Stuffing não é contado (limite inferior; o host calcula o valor exato).
+//───────────────────────────────────────────────────────────────────────────
+uint16_t IngestTracker::frameBits(bool extended, bool remote, uint8_t dlc) {
+    if (dlc > 8) dlc = 8;
+    return (extended ? 67 : 47) + (remote ? 0 : 8 * dlc);
+}
+
+void IngestTracker::countFrame(bool extended, bool remote, uint8_t dlc) {
+    bitsWindow_ += frameBits(extended, remote, dlc);
+}
+
+void IngestTracker::update(uint32_t nowMs) {
+    uint32_t elapsed = nowMs - windowStartMs_;
+    if (elapsed < 1000) return;
+
+    // bits/s em relação ao bitrate, em milésimos (32 bits: sem divisão de
+    // 64 bits no AVR; cabe até ~4 Mbit por janela)
+    uint32_t pollBits = bitsWindow_ + (uint32_t)skippedWindow_ * frameBits(false, true, 0);
+    uint32_t den = (bitrate / 1000) * elapsed;
+    loadPermille_ = (uint16_t)((bitsWindow_ * 1000UL) / den);
+    pollLoadPermille_ = (uint16_t)((pollBits * 1000UL) / den);
+    rtrLast_ = rtrWindow_ > 255 ? 255 : (uint8_t)rtrWindow_;
+    skippedLast_ = skippedWindow_ > 255 ? 255 : (uint8_t)skippedWindow_;
+
+    bitsWindow_ = 0;
+    rtrWindow_ = 0;
+    skippedWindow_ = 0;
+    windowStartMs_ = nowMs;
+}
+
+uint8_t IngestTracker::pushMask() const {
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+        if (slots_[i].pushCount >= 2) mask |= (1 << i);
+    }
+    return mask;
+}
+
+uint8_t IngestTracker::freshMask(uint32_t nowMs, uint16_t wantedPeriodMs) const {
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+        if (fresh(i, nowMs, wantedPeriodMs)) mask |= (1 << i);
+    }
+    return mask;
+}
@@ -0,0 +1,203 @@
+#include "isotp.h"
+
+#include <string.h>
+
+// Tipo do frame (nibble alto do byte de PCI)
+#define PCI_SF 0x00
+#define PCI_FF 0x10
+#define PCI_CF 0x20
+#define PCI_FC 0x30
+
+#define FC_CTS      0
+#define FC_WAIT     1
+#define FC_OVERFLOW 2
+
+uint32_t IsoTp::stMinUs(uint8_t st) {
+    if (st <= 0x7F) return (uint32_t)st * 1000;
+    if (st >= 0xF1 && st <= 0xF9) return (uint32_t)(st - 0xF0) * 100;
+    return 127000;   // Valor reservado: usa o máximo (ISO 15765-2)
+}
+
+void IsoTp::fail(uint8_t error) {
+    if (stats_.errors < 0xFFFF) stats_.errors++;
+    stats_.lastError = error;
+}
+
+bool IsoTp::sendFrame(const uint8_t *frame) {
+    return send_(ctx_, txId_, frame, 8);
+}
+
+bool IsoTp::sendFlowControl(uint8_t status) {
+    uint8_t f[8] = {(uint8_t)(PCI_FC | status), blockSize, stMin, ISOTP_PAD, ISOTP_PAD, ISOTP_PAD, ISOTP_PAD, ISOTP_PAD};
+    return sendFrame(f);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// TRANSMISSÃO
+//───────────────────────────────────────────────────────────────────────────
+uint8_t IsoTp::bufferSource(void *ctx, uint16_t offset, uint8_t *out, uint8_t n) {
+    IsoTp *self = static_cast<IsoTp *>(ctx);
+    memcpy(out, self->txBuf_ + offset, n);
+    return n;
+}
+
+bool IsoTp::send(const uint8_t *data, uint16_t len, uint32_t nowUs) {
+    if (len > ISOTP_TX_BUF || tx_ != TX_IDLE) return false;
+    memcpy(txBuf_, data, len);
+    source_ = bufferSource;
+    sourceCtx_ = this;
+    return startTx(len, nowUs);
+}
+
+bool IsoTp::send(uint16_t len, IsoTpSourceFn source, void *sourceCtx, uint32_t nowUs) {
+    if (tx_ != TX_IDLE) return false;
+    source_ = source;
+    sourceCtx_ = sourceCtx;
+    return startTx(len, nowUs);
+}
+
+bool IsoTp::startTx(uint16_t len, uint32_t nowUs) {
+    if (len == 0 || len > ISOTP_MAX_LEN) return false;
+    uint8_t f[8];
+    memset(f, ISOTP_PAD, sizeof(f));
+    txLen_ = len;
+    if (len <= 7) {
+        f[0] = PCI_SF | len;
+        source_(sourceCtx_, 0, f + 1, len);
+        if (!sendFrame(f)) return false;
+        if (stats_.txMessages < 0xFFFF) stats_.txMessages++;
+        return true;
+    }
+    f[0] = PCI_FF | (len >> 8);
+    f[1] = len & 0xFF;
+    source_(sourceCtx_, 0, f + 2, 6);
+    if (!sendFrame(f)) return false;
+    txPos_ = 6;
+    txSn_ = 1;
+    tx_ = TX_WAIT_FC;
+    txDeadlineUs_ = nowUs + ISOTP_TIMEOUT_US;
+    return true;
+}
+
+bool IsoTp::sendConsecutive(uint32_t nowUs) {
+    uint8_t f[8];
+    memset(f, ISOTP_PAD, sizeof(f));
+    uint16_t left = txLen_ - txPos_;
+    uint8_t n = left > 7 ? 7 : (uint8_t)left;
+    f[0] = PCI_CF | txSn_;
+    source_(sourceCtx_, txPos_, f + 1, n);
+    if (!sendFrame(f)) return false;
+
+    txPos_ += n;
+    txSn_ = (txSn_ + 1) & 0x0F;
+    txNextUs_ = nowUs + txStMinUs_;
+    if (txPos_ >= txLen_) {
+        tx_ = TX_IDLE;
+        if (stats_.txMessages < 0xFFFF) stats_.txMessages++;
+    } else if (txBlockLeft_ && --txBlockLeft_ == 0) {
+        tx_ = TX_WAIT_FC;
+        txDeadlineUs_ = nowUs + ISOTP_TIMEOUT_US;
+    }
+    return true;
+}
+
+void IsoTp::poll(uint32_t nowUs) {
+    if (tx_ == TX_WAIT_FC && (int32_t)(nowUs - txDeadlineUs_) >= 0) {
+        tx_ = TX_IDLE;
+        fail(ISOTP_ERR_TIMEOUT);
+    }
+    // STmin 0: alguns CFs seguidos (o driver espera o anterior sair); com
+    // STmin, um por vez no horário
+    for (uint8_t i = 0; i < ISOTP_CF_PER_POLL && tx_ == TX_SEND_CF; i++) {
+        if ((int32_t)(nowUs - txNextUs_) < 0) break;
+        if (!sendConsecutive(nowUs)) break;
+        if (txStMinUs_) break;
+    }
+
+    if (rx_ == RX_RECEIVING && (int32_t)(nowUs - rxDeadlineUs_) >= 0) {
+        rx_ = RX_IDLE;
+        fail(ISOTP_ERR_TIMEOUT);
+    }
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// RECEPÇÃO
+//───────────────────────────────────────────────────────────────────────────
+void IsoTp::onFrame(const uint8_t *data, uint8_t len, uint32_t nowUs) {
+    if (len == 0) return;
+    uint8_t pci = data[0] & 0xF0;
+
+    if (pci == PCI_FC) {
+        if (tx_ != TX_WAIT_FC || len < 3) {
+            if (tx_ == TX_IDLE) fail(ISOTP_ERR_UNEXPECTED);
+            return;
+        }
+        uint8_t status = data[0] & 0x0F;
+        if (status == FC_CTS) {
+            txBlockLeft_ = data[1];
+            txStMinUs_ = stMinUs(data[2]);
+            txNextUs_ = nowUs;
+            tx_ = TX_SEND_CF;
+        } else if (status == FC_WAIT) {
+            txDeadlineUs_ = nowUs + ISOTP_TIMEOUT_US;
+        } else {
+            tx_ = TX_IDLE;
+            fail(ISOTP_ERR_OVERFLOW);
+        }
+        return;
+    }
+
+    // Mensagem anterior ainda não lida: ignora a nova (o emissor dá timeout)
+    if (rx_ == RX_DONE) return;
+
+    if (pci == PCI_SF) {
+        uint8_t n = data[0] & 0x0F;
+        if (n == 0 || n > 7 || n + 1 > len) return;
+        memcpy(rxBuf_, data + 1, n);
+        rxLen_ = n;
+        rx_ = RX_DONE;
+        if (stats_.rxMessages < 0xFFFF) stats_.rxMessages++;
+    } else if (pci == PCI_FF) {
+        if (len < 8) return;
+        uint16_t total = ((uint16_t)(data[0] & 0x0F) << 8) | data[1];
+        if (total < 8) return;
+        if (total > ISOTP_RX_MAX) {
+            sendFlowControl(FC_OVERFLOW);
+            rx_ = RX_IDLE;
+            fail(ISOTP_ERR_OVERFLOW);
+            return;
+        }
+        memcpy(rxBuf_, data + 2, 6);
+        rxLen_ = total;
+        rxPos_ = 6;
+        rxSn_ = 1;
+        rxBlockCount_ = 0;
+        rx_ = RX_RECEIVING;
+        rxDeadlineUs_ = nowUs + ISOTP_TIMEOUT_US;
+        sendFlowControl(FC_CTS);
+    } else if (pci == PCI_CF) {
+        if (rx_ != RX_RECEIVING) {
+            fail(ISOTP_ERR_UNEXPECTED);
+            return;
+        }
+        if ((data[0] & 0x0F) != rxSn_) {
+            rx_ = RX_IDLE;
+            fail(ISOTP_ERR_SEQUENCE);
+            return;
+        }
+        uint16_t left = rxLen_ - rxPos_;
+        uint8_t n = left > 7 ? 7 : (uint8_t)left;
+        if (n + 1 > len) n = len - 1;
+        memcpy(rxBuf_ + rxPos_, data + 1, n);
+        rxPos_ += n;
+        rxSn_ = (rxSn_ + 1) & 0x0F;
+        rxDeadlineUs_ = nowUs + ISOTP_TIMEOUT_US;
+        if (rxPos_ >= rxLen_) {
+            rx_ = RX_DONE;
+            if (stats_.rxMessages < 0xFFFF) stats_.rxMessages++;
+        } else if (blockSize && ++rxBlockCount_ >= blockSize) {
+            rxBlockCount_ = 0;
+            sendFlowControl(FC_CTS);
+        }
+    }
+}
@@ -0,0 +1,2319 @@
+//───────────────────────────────────────────────────────────────────────────
+// INFORMAÇÃO IMPORTANTE SOBRE O BOOTLOADER
+//───────────────────────────────────────────────────────────────────────────
+// Os MCUs deste projeto tiveram o bootloader USB REMOVIDO
+// Eles NÃO podem receber uploads via USB e devem ser atualizados via CAN
+// Para atualizar o firmware, use o comando:
+// mcp-can-boot-flash-app -f your_file.hex -p m2560 -m 0x0042
+//───────────────────────────────────────────────────────────────────────────
+
+//═════════════════════════════════════════════════════════════════════════
+// INCLUDES - BIBLIOTECAS NECESSÁRIAS
+//═══════════════════════════════════════════════════════════════════════════
+#include <avr/wdt.h>                 // Watchdog Timer (para reset remoto)
+#include <Arduino.h>                 // Core do Arduino
+#include "mcp2515.h"                 // Driver do MCP2515 (instruções rápidas, ver mcp2515.h)
+#include <SPI.h>                     // Comunicação SPI com MCP2515
+#include <EEPROM.h>                  // Persistência de dados na memória
+#include "config.h"                  // ⚠️ Funções auxiliares (parse de msgs CAN)
+#include "profile.h"                 // Perfil do container (CONTAINER_ID)
+#include "ingest.h"                  // Ingestão em push + carga do barramento
+#include "snapshot.h"                // Estado compartilhado ISR ↔ loop (seqlock)
+#include "adaptive.h"                // Período de aquisição por módulo
+#include "report.h"                  // Frames de estado só quando mudam
+#include "bushealth.h"               // TEC/REC/EFLG e recuperação de bus-off
+#include "bitrate.h"                 // Migração 500 kbps ↔ 1 Mbps (0x40C/0x42C)
+#include "timerservice.h"            // Timers por software no tick de 1 ms do Timer2
+#include "pulse.h"                   // Contagem de pulsos por hardware (0x40D/0x42D)
+#include "adcengine.h"               // ADC interno em free-running (0x40E/0x42E)
+#include "history.h"                 // Histórico em RAM e download (0x40F/0x42F/0x430)
+#include "isotp.h"                   // ISO-TP: mensagens longas em 0x400/0x420
+#include "objdict.h"                 // Dicionário de parâmetros (serviços ISO-TP 0x05-0x08)
+#include "stackmon.h"                // Pilha pintada e folga mínima (stack.free)
+#include "timesync.h"                // Relógio sincronizado pelo SYNC/FOLLOW-UP (0x080/0x081)
+#include "cyclebench.h"              // Marcas de ciclo do ambiente bench_cycles (simavr)
+
+//═══════════════════════════════════════════════════════════════════════════
+// DEFINIÇÕES DE HARDWARE - PINOS
+//═══════════════════════════════════════════════════════════════════════════
+
+#ifndef LED_BUILTIN
+	#define LED_BUILTIN  13  // LED onboard (caso não esteja definido)
+#endif
+
+//───────────────────────────────────────────────────────────────────────────
+// SAÍDAS DIGITAIS (8 Relés)
+//───────────────────────────────────────────────────────────────────────────
+// Estes pinos controlam 6 módulos relé de 2 canais cada:
+// - D1/D2: Start Engine / Emergency
+// - D3/D4: Saídas digitais genéricas (DO1/DO2)
+// - D5/D6: Ventilador/Exaustor
+// - D7/D8: Válvulas NA1/NF1 ou Bomba d'água
+//───────────────────────────────────────────────────────────────────────────
+#define D1  39  // Saída Digital 1
+#define D2  41  // Saída Digital 2
+#define D3  32  // Saída Digital 3
+#define D4  34  // Saída Digital 4
+#define D5  36  // Saída Digital 5
+#define D6  38  // Saída Digital 6
+#define D7  40  // Saída Digital 7
+#define D8  42  // Saída Digital 8
+
+// Array para facilitar iteração sobre todos os pinos
+int ledpins[8] = {D1, D2, D3, D4, D5, D6, D7, D8};
+
+//───────────────────────────────────────────────────────────────────────────
+// IDs DAS MENSAGENS CAN
+//───────────────────────────────────────────────────────────────────────────
+// DataIDs: IDs das mensagens de dados (Data Frame)
+// remoteIDs: Mesmo ID mas com flag de Remote Frame (bit 30 setado)
+//            Remote Frame = solicita dados sem enviar payload
+//───────────────────────────────────────────────────────────────────────────
+unsigned long DataIDs[8] = {
+    0x510, 0x520, 0x530,  // Temperaturas (pedidas por RTR quando velhas)
+    0x610, 0x611,          // Sensores diversos
+    0x620, 0x621, 0x622    // Sensores diversos
+};
+
+// Adiciona flag 0x40000000 para criar Remote Frame
+// Bit 30 do ID indica que é remote frame no padrão CAN
+unsigned long remoteIDs[8] = {
+    0x510|0x40000000, 0x520|0x40000000, 0x530|0x40000000,
+    0x610|0x40000000, 0x611|0x40000000,
+    0x620|0x40000000, 0x621|0x40000000, 0x622|0x40000000
+};
+
+//───────────────────────────────────────────────────────────────────────────
+// CONFIGURAÇÃO DO MÓDULO CAN (MCP2515)
+//───────────────────────────────────────────────────────────────────────────
+#define CAN0_INT  3        // Pino de interrupção do MCP2515 (INT)
+Mcp2515 CAN0(33);          // Pino CS (Chip Select) do MCP2515 = 33
+
+// Variáveis para recepção de mensagens CAN
+long unsigned int rxId;           // ID da mensagem recebida
+unsigned char len;                // Tamanho da mensagem (DLC)
+unsigned char rxBuf[8] = " ";  
+unsigned long fullId = rxId & 0x1FFFFFFF;   // Buffer de dados recebidos (max 8 bytes)
+
+// Buffers para transmissão
+byte txBufDebug[8] = {0x55, 0x55, 0x55, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+byte txBuf[8] = " ";              // Buffer de dados a transmitir
+
+//───────────────────────────────────────────────────────────────────────────
+// INGESTÃO EM PUSH (ver ingest.h)
+//───────────────────────────────────────────────────────────────────────────
+// Rastreia período e idade de cada ID de DataIDs; o ciclo de aquisição só
+// manda RTR para as temperaturas que não chegaram sozinhas a tempo.
+// 0x407 troca o modo (0 = polling antigo, 1 = push) e 0x427 responde o estado.
+//───────────────────────────────────────────────────────────────────────────
+IngestTracker ingest;
+
+// Contadores de erro do MCP2515, frames/s e bus-off (0x40B/0x42B)
+BusHealth health;
+
+// Período de RTR por ID conforme a proximidade do limite (0x409/0x429)
+AdaptiveSampler sampler;
+
+// Bitrate atual, troca combinada e teste de 1 Mbps (0x40C/0x42C)
+BitrateMigration migration;
+
+//───────────────────────────────────────────────────────────────────────────
+// ENVIO DE FRAME (contabiliza a carga do barramento)
+//───────────────────────────────────────────────────────────────────────────
+// O MCP2515 não recebe os próprios frames, então todo envio passa por aqui.
+// Flags no ID (convenção do mcp_can): 0x80000000 = extended, 0x40000000 = remote.
+//───────────────────────────────────────────────────────────────────────────
+byte canSend(unsigned long id, byte len, byte *buf) {
+    ingest.countFrame(id & 0x80000000, id & 0x40000000, len);
+    health.countTx();
+    return CAN0.sendMsgBuf(id, len, buf);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// INICIALIZA O MCP2515 (setup e recuperação de bus-off)
+//───────────────────────────────────────────────────────────────────────────
+// begin(): aceita mensagens standard e extended, cristal de 8 MHz
+// MCP2515_500KBPS / MCP2515_1000KBPS: bitrate atual da migração (ver bitrate.h)
+// Modo normal permite transmitir e receber (outros: MCP2515_LOOPBACK, MCP2515_LISTENONLY)
+//───────────────────────────────────────────────────────────────────────────
+bool canStart() {
+    Mcp2515Bitrate speed = migration.current() == BITRATE_1M ? MCP2515_1000KBPS : MCP2515_500KBPS;
+    bool ok = CAN0.begin(speed) == MCP2515_OK;
+    CAN0.setMode(MCP2515_NORMAL);
+    // Carga (‰) e orçamento da aquisição adaptativa no bitrate novo
+    ingest.bitrate = BitrateMigration::bitsPerSecond(migration.current());
+    return ok;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// FRAMES DE ESTADO POR MUDANÇA (ver report.h)
+//───────────────────────────────────────────────────────────────────────────
+// Cada frame de estado tem um slot com o último payload enviado. force = o
+// cliente pediu explicitamente (RTR ou snapshot 0x40A). 0x40A configura o
+// modo e o heartbeat; 0x42A é o heartbeat.
+//───────────────────────────────────────────────────────────────────────────
+enum ReportSlotId : uint8_t {
+    RPT_OUTPUTS = 0,   // 0x422 eco/estado dos relés
+    RPT_SAFETY12,      // 0x423 eco de segurança T1/T2
+    RPT_SAFETY34,      // 0x426 eco de segurança T3/T4
+    RPT_AQUIS,         // 0x426 frame periódico de aquisição
+    RPT_PULSE          // 0x42D RPM/frequência, no ritmo da aquisição
+};
+
+ChangeReporter reporter;
+
+byte reportSend(uint8_t slot, unsigned long id, byte len, byte *buf, bool force) {
+    if (!reporter.offer(slot, buf, len, force)) return MCP2515_OK;
+    byte rc = canSend(id, len, buf);
+    // TXBUSY/erro: o host não viu este payload, a próxima oferta tem que sair
+    if (rc != MCP2515_OK) reporter.invalidate(slot);
+    return rc;
+}
+
+//═══════════════════════════════════════════════════════════════════════════
+// ESTRUTURAS DE DADOS - CONFIGURAÇÕES DO SISTEMA
+//═══════════════════════════════════════════════════════════════════════════
+
+//───────────────────────────────────────────────────────────────────────────
+// MONITORAMENTO DE TEMPERATURA E SEGURANÇA
+//───────────────────────────────────────────────────────────────────────────
+// Estrutura definida em config.h (não vemos aqui, mas inferida pelo uso)
+// Provavelmente contém:
+// struct safetyConfigStructure {
+//     float maxtemp;          // Temperatura máxima permitida (°C)
+//     uint16_t timer;         // Tempo que temp deve ficar acima (ms)
+//     uint8_t Monit_Enable;   // Habilitado? 0=não, 1=sim, 2=erro
+//     uint8_t saveeeprom;     // Flag para salvar na EEPROM
+// };
+//───────────────────────────────────────────────────────────────────────────
+// As configurações de cada canal (T1..T4) ficam em SafetyChannel<N>::config
+safetyConfigStructure tconfigbuf; // Buffer temporário para receber config
+
+//───────────────────────────────────────────────────────────────────────────
+// LEITURA DE TEMPERATURA
+//───────────────────────────────────────────────────────────────────────────
+// Estrutura para armazenar dados dos sensores de temperatura
+// Provavelmente contém:
+// struct tempReadStructure {
+//     int16_t BLtemp;   // Temperatura do termopar (Bare Lead)
+//     int16_t CJtemp;   // Temperatura de junção fria (Cold Junction)
+//     uint8_t BLstatus; // Status do sensor (1=OK, 0=erro)
+// };
+//───────────────────────────────────────────────────────────────────────────
+tempReadStructure tempS;   // Último frame CANmod.Temp decodificado
+
+//───────────────────────────────────────────────────────────────────────────
+// CONFIGURAÇÃO DE AQUISIÇÃO DE DADOS
+//───────────────────────────────────────────────────────────────────────────
+// Estrutura definida em config.h, provavelmente:
+// struct aquisitionConfigStructure {
+//     uint16_t timer;                    // Taxa de aquisição (10-3000ms)
+//     uint8_t Aquics_Enable;             // Habilitado temporariamente
+//     uint8_t Aquics_Enable_Continuous;  // Modo contínuo
+// };
+//───────────────────────────────────────────────────────────────────────────
+aquisitionConfigStructure aquisc;      // Configuração atual
+aquisitionConfigStructure aconfigbuf;  // Buffer para receber nova config
+
+//───────────────────────────────────────────────────────────────────────────
+// IDADE DAS TEMPERATURAS (FAIL-SAFE)
+//───────────────────────────────────────────────────────────────────────────
+// Um canal sem amostra há mais de freshc.maxAgeMs está VELHO: o monitor
+// aplica freshc.action (ver StaleAction em config.h) em vez de confiar na
+// última temperatura filtrada. 0x408 configura, 0x428 responde/avisa.
+//───────────────────────────────────────────────────────────────────────────
+freshnessConfigStructure freshc;
+
+//───────────────────────────────────────────────────────────────────────────
+// SENSORES ANALÓGICOS (ADC interno, ver adcengine.h)
+//───────────────────────────────────────────────────────────────────────────
+// Com aquisc.analog ligado (0x404 byte 2) o ADC converte em free-running
+// os canais da lista (0x40E). Escala linear no fundo de escala do ADC (5 V).
+//───────────────────────────────────────────────────────────────────────────
+#define ADC_DOWNPIPE_CH  0          // A0: pressão no downpipe
+#define ADC_VALVE_CH     1          // A1: posição da válvula borboleta
+#define DOWNPIPE_FULL_BAR 20.0f
+#define VALVE_FULL_PCT    100.0f
+
+adcConfigStructure adcc;
+AdcEngine adcEngine;
+
+float downpipePress = 0;    // Pressão no downpipe (0-20 bar)
+float valvPos = 0;          // Posição válvula borboleta (0-100%)
+
+//═══════════════════════════════════════════════════════════════════════════
+// CONTROLE DE MOTORES - PONTE H
+//═══════════════════════════════════════════════════════════════════════════
+// Pinos para controlar 2 motores DC via ponte H (L298N ou similar)
+// F_PWM = Forward (frente), R_PWM = Reverse (ré)
+//───────────────────────────────────────────────────────────────────────────
+#define F_PWM_1  6   // Forward PWM - Motor 1
+#define R_PWM_1  8   // Reverse PWM - Motor 1
+
+#define F_PWM_2  16  // Forward PWM - Motor 2  
+#define R_PWM_2  37  // Reverse PWM - Motor 2
+
+// Saídas PWM adicionais (propósito não claro na documentação)
+#define PWM1  44
+#define PWM2  46
+
+// Pinos de enable dos motores
+#define MOTOR1_EN  16
+#define MOTOR2_EN  17
+
+//───────────────────────────────────────────────────────────────────────────
+// VARIÁVEIS DE CONTROLE DO MOTOR
+//───────────────────────────────────────────────────────────────────────────
+// ⚠️ PROBLEMA: Estas variáveis nunca mudam de valor!
+//    dir e pwmVal sempre ficam em 0, então o motor nunca se move
+//───────────────────────────────────────────────────────────────────────────
+int dir = 0;       // Direção: 0=parado, 1=horário, 2=anti-horário
+int pwmVal = 0;    // Velocidade PWM (0-255)
+int PWM1_val = 0;  // Valor PWM1 recebido via CAN
+int PWM2_val = 0;  // Valor PWM2 recebido via CAN
+int Enc = 0;       // Encoder (não implementado corretamente)
+int Temp = 0;      // Variável temporária para leituras
+
+//═══════════════════════════════════════════════════════════════════════════
+// CONTROLE DE TEMPO E TIMERS
+//═══════════════════════════════════════════════════════════════════════════
+
+#define LED_TOGGLE_INTERVAL_MS  1000L  // Intervalo para toggle LED (não usado)
+
+// Timestamps para controle de tempo
+uint32_t timetempmess = 0;                   // Último recebimento de temp
+uint32_t timeaquisition = 0;                 // Último ciclo de aquisição
+
+//───────────────────────────────────────────────────────────────────────────
+// VARIÁVEIS DE TEMPERATURA
+//───────────────────────────────────────────────────────────────────────────
+// volatile = pode mudar durante ISR (Interrupt Service Routine)
+//───────────────────────────────────────────────────────────────────────────
+volatile int16_t temp1 = 120;   // Temp bruta sensor 1 (não usado)
+volatile int16_t temp2 = 120;   // Temp bruta sensor 2 (não usado)
+volatile int16_t temp3 = 120;   // Temp bruta sensor 3 (não usado)
+volatile int16_t temp4 = 120;   // Temp bruta sensor 4 (não usado)
+
+//───────────────────────────────────────────────────────────────────────────
+// ESTADO COMPARTILHADO ENTRE ISRs E loop() (ver snapshot.h)
+//───────────────────────────────────────────────────────────────────────────
+// Nenhuma variável multi-byte é escrita de um lado e lida do outro:
+//   sensorState - produtor loop(): temperaturas filtradas, amostra, disparos
+//   alarmState  - produtor ISRs dos timers de alarme: estouros e temperatura
+//                 vista no estouro
+// Quem lê faz read()/get() e recebe uma cópia consistente, sem noInterrupts().
+//───────────────────────────────────────────────────────────────────────────
+Snapshot<SensorState> sensorState;
+Snapshot<AlarmState> alarmState;
+Snapshot<PulseState> pulseState;   // Produtor: slots de janela dos pulsos
+
+//═══════════════════════════════════════════════════════════════════════════
+// SISTEMA DE PERSISTÊNCIA - EEPROM
+//═══════════════════════════════════════════════════════════════════════════
+// Endereços na EEPROM onde cada variável é salva
+// EEPROM tem ~4KB no ATmega2560 (endereços 0-4095)
+//───────────────────────────────────────────────────────────────────────────
+constexpr int eepromMaxAddr(uint8_t ch)    { return ch == 0 ? 0  : ch == 1 ? 4  : ch == 2 ? 14 : 21; }  // float (4 bytes)
+constexpr int eepromTimerAddr(uint8_t ch)  { return ch == 0 ? 8  : ch == 1 ? 10 : ch == 2 ? 18 : 25; }  // uint16_t (2 bytes)
+constexpr int eepromEnableAddr(uint8_t ch) { return ch == 0 ? 12 : ch == 1 ? 13 : ch == 2 ? 20 : 27; }  // uint8_t
+#define EEPROM_MAXAGE_ADDR     28   // uint16_t (2 bytes)
+#define EEPROM_STALEACT_ADDR   30   // uint8_t
+#define EEPROM_BITRATE_ADDR    31   // uint8_t (BitrateCode)
+#define EEPROM_PULSE_ADDR      32   // máscara, janela0/10, janela1/10, ppr0, ppr1 (7 bytes)
+#define EEPROM_ADC_ADDR        39   // máscara de canais (uint16_t), oversampling (uint8_t)
+
+// Layout da EEPROM:
+// ┌─────────────┬──────────┬────────┐
+// │ Endereço    │ Variável │ Bytes  │
+// ├─────────────┼──────────┼────────┤
+// │ 0-3         │ temp1max │ 4      │
+// │ 4-7         │ temp2max │ 4      │
+// │ 8-9         │ timer1   │ 2      │
+// │ 10-11       │ timer2   │ 2      │
+// │ 12          │ enable1  │ 1      │
+// │ 13          │ enable2  │ 1      │
+// │ 14-17       │ temp3max │ 4      │
+// │ 18-19       │ timer3   │ 2      │
+// │ 20          │ enable3  │ 1      │
+// │ 21-24       │ temp4max │ 4      │
+// │ 25-26       │ timer4   │ 2      │
+// │ 27          │ enable4  │ 1      │
+// │ 28-29       │ maxAge   │ 2      │
+// │ 30          │ staleAct │ 1      │
+// │ 31          │ bitrate  │ 1      │
+// │ 32          │ pulseEn  │ 1      │
+// │ 33          │ gate0/10 │ 1      │
+// │ 34          │ gate1/10 │ 1      │
+// │ 35-36       │ ppr0     │ 2      │
+// │ 37-38       │ ppr1     │ 2      │
+// │ 39-40       │ adcMask  │ 2      │
+// │ 41          │ ovsBits  │ 1      │
+// └─────────────┴──────────┴────────┘
+
+//═══════════════════════════════════════════════════════════════════════════
+// FUNÇÕES AUXILIARES - EEPROM
+//═══════════════════════════════════════════════════════════════════════════
+
+//───────────────────────────────────────────────────────────────────────────
+// SALVAR FLOAT NA EEPROM
+//───────────────────────────────────────────────────────────────────────────
+// EEPROM.update() só escreve se o valor mudou (economiza ciclos de escrita)
+// EEPROM tem vida útil limitada (~100.000 escritas por byte)
+//───────────────────────────────────────────────────────────────────────────
+void updateEEPROMFloat(int address, float value) {
+    byte *p = (byte*)(void*)&value;  // Converte float para array de bytes
+    for (int i = 0; i < sizeof(float); i++) {
+        EEPROM.update(address + i, p[i]);  // Salva byte por byte
+    }
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// SALVAR UINT16 NA EEPROM (mesmo princípio do float)
+//───────────────────────────────────────────────────────────────────────────
+void updateEEPROMUInt16(int address, uint16_t value) {
+    byte *p = (byte*)(void*)&value;
+    for (int i = 0; i < sizeof(uint16_t); i++) {
+        EEPROM.update(address + i, p[i]);
+    }
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// SALVAR UINT8 NA EEPROM (1 byte, simples)
+//───────────────────────────────────────────────────────────────────────────
+void updateEEPROMUInt8(int address, uint8_t value) {
+    EEPROM.update(address, value);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// LER FLOAT DA EEPROM
+//───────────────────────────────────────────────────────────────────────────
+float readEEPROMFloat(int address) {
+    float value;
+    byte *p = (byte*)(void*)&value;  // Ponteiro para os bytes do float
+    for (int i = 0; i < sizeof(float); i++) {
+        p[i] = EEPROM.read(address + i);  // Lê byte por byte
+    }
+    return value;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// LER UINT16 DA EEPROM
+//───────────────────────────────────────────────────────────────────────────
+uint16_t readEEPROMUInt16(int address) {
+    uint16_t value;
+    byte *p = (byte*)(void*)&value;
+    for (int i = 0; i < sizeof(uint16_t); i++) {
+        p[i] = EEPROM.read(address + i);
+    }
+    return value;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// LER UINT8 DA EEPROM
+//───────────────────────────────────────────────────────────────────────────
+uint8_t readEEPROMUInt8(int address) {
+    return EEPROM.read(address);
+}
+
+//═══════════════════════════════════════════════════════════════════════════
+// PUBLICAÇÃO DO ESTADO REAL DAS SAÍDAS (0x422)
+//═══════════════════════════════════════════════════════════════════════════
+// Enviado quando o monitor de segurança aciona ou libera um relé, para que
+// o host (e o runner de HIL) veja o disparo sem depender de um comando 0x402.
+// Mesmo formato do eco do 0x402: 0 = LOW (relé ligado), 1 = HIGH (desligado).
+// Divide o slot RPT_OUTPUTS com o eco: só sai se o estado mudou (ou force).
+//───────────────────────────────────────────────────────────────────────────
+void publishOutputs(bool force = false) {
+    int states[8];
+    byte outBuf[8];
+    for (size_t i = 0; i < 8; i++) states[i] = digitalRead(ledpins[i]) == LOW ? 0 : 1;
+    sendDigital(states, PWM1_val, PWM2_val, Enc, outBuf);
+    reportSend(RPT_OUTPUTS, 0x422, 8, outBuf, force);
+}
+
+//═══════════════════════════════════════════════════════════════════════════
+// HISTÓRICO EM RAM (ver history.h)
+//═══════════════════════════════════════════════════════════════════════════
+// Temperaturas filtradas e relés a cada HISTORY_PERIOD_MS, mais os eventos
+// de alarme. 0x40F pede status/download/cancela/limpa; 0x42F é o status e
+// 0x430 leva os dados: [seq][até 7 bytes], um frame por volta do loop().
+//───────────────────────────────────────────────────────────────────────────
+HistoryLog history;
+uint8_t historySeq = 0;
+uint8_t historyState = HISTORY_IDLE;
+bool historyIsoTp = false;            // Congelado para o serviço ISO-TP 0x03
+
+// bit i = relé Di+1 acionado (ativo em LOW)
+uint8_t relayMask() {
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        if (digitalRead(ledpins[i]) == LOW) mask |= 1 << i;
+    }
+    return mask;
+}
+
+void historyEvent(uint8_t code, uint8_t arg) {
+    history.event(millis(), code, arg);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// PILHA PINTADA (ver stackmon.h)
+//───────────────────────────────────────────────────────────────────────────
+// A folga mínima sai no dicionário (stack.free) e no dashboard; abaixo de
+// STACK_WARN_BYTES vira aviso na serial e evento HIST_EV_STACK no histórico.
+// O tamanho estático por símbolo vem do memory_report.py a cada build.
+//───────────────────────────────────────────────────────────────────────────
+extern uint8_t __heap_start;          // Fim do .bss/.noinit (linker da avr-libc)
+StackMonitor stackMon;
+bool stackWarned = false;
+
+// Antes do .data/.bss e dos construtores, com SP = RAMEND e nada na pilha.
+// naked e sem chamadas: o laço só usa registradores
+extern "C" void stackPaintAtReset() __attribute__((naked, used, section(".init3")));
+void stackPaintAtReset() {
+    for (uint8_t *p = &__heap_start; p <= (uint8_t *)RAMEND; p++) *p = STACK_PAINT;
+}
+
+void stackPoll() {
+    if (!stackMon.poll() || stackWarned || stackMon.minFree >= STACK_WARN_BYTES) return;
+    stackWarned = true;
+    historyEvent(HIST_EV_STACK, stackMon.minFree);
+    Serial.print(F("AVISO: pilha com "));
+    Serial.print(stackMon.minFree);
+    Serial.println(F(" bytes de folga"));
+}
+
+
+//───────────────────────────────────────────────────────────────────────────
+// SINCRONIZAÇÃO DE TEMPO (SYNC 0x080 + FOLLOW-UP 0x081 → estado 0x431)
+//───────────────────────────────────────────────────────────────────────────
+// t2 = borda de descida do INT do MCP2515 (INT5, pino 3), capturada na ISR.
+// Só o primeiro frame lido depois de uma borda tem esse instante; os que
+// já estavam na fila ficam com o micros() da leitura (e um SYNC assim é
+// descartado). Com sincronismo o ciclo de aquisição cai nos múltiplos de
+// aquisc.timer do tempo do mestre (sync.align), igual nos dois containers,
+// e as amostras podem sair com o tempo no 0x432 (sync.stamp).
+//───────────────────────────────────────────────────────────────────────────
+TimeSync timeSync;
+uint8_t syncAlign = 1;                // Dicionário: sync.align
+uint8_t syncStamp = 0;                // Dicionário: sync.stamp (carga extra no barramento)
+uint32_t nextAlignedUs = 0;           // micros() do próximo ciclo alinhado
+bool alignedValid = false;
+
+volatile uint32_t canEdgeUs = 0;      // Escritos só pela ISR
+volatile uint8_t canEdgeSeq = 0;
+uint32_t rxEdgeUs = 0;                // Cópia tirada antes de cada leitura
+uint8_t rxEdgeSeq = 0, canEdgeSeen = 0, canFramesSinceEdge = 0;
+
+void canIntEdge() {
+    canEdgeUs = micros();
+    canEdgeSeq++;
+}
+
+// Antes do readMsgBuf: a borda do frame que está no buffer já aconteceu
+void canRxSnapshot() {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        rxEdgeUs = canEdgeUs;
+        rxEdgeSeq = canEdgeSeq;
+    }
+}
+
+// Depois da leitura: instante de chegada e se veio da borda
+uint32_t canRxTime(bool &precise) {
+    if (rxEdgeSeq != canEdgeSeen) {
+        canEdgeSeen = rxEdgeSeq;
+        canFramesSinceEdge = 0;
+    }
+    if (canFramesSinceEdge < 255) canFramesSinceEdge++;
+    precise = canFramesSinceEdge == 1;
+    return precise ? rxEdgeUs : micros();
+}
+
+void publishTimeSync() {
+    timeSyncStatusStructure status;
+    int32_t err = timeSync.lastErrorUs();
+    int32_t drift = timeSync.driftPpb() / 100;
+    status.state = timeSync.state();
+    status.seq = timeSync.seq();
+    status.offsetUs = err > 32767 ? 32767 : err < -32768 ? -32768 : err;
+    status.drift01ppm = drift > 32767 ? 32767 : drift < -32768 ? -32768 : drift;
+    status.rejected = timeSync.rejected();
+    status.samples = timeSync.samples();
+    sendTimeSyncStatus(status, txBuf);
+    canSend(0x431, 8, txBuf);
+}
+
+// 0x432 com o tempo do mestre no instante local localUs
+void publishStamped(uint8_t channel, int16_t value, uint32_t localUs) {
+    if (!syncStamp || !timeSync.synced()) return;
+    stampedSampleStructure sample;
+    sample.channel = channel;
+    sample.value = value;
+    sample.timeUs = timeSync.now(localUs);
+    sendStampedSample(sample, txBuf);
+    canSend(0x432, 8, txBuf);
+}
+
+// Ciclo de aquisição: múltiplos de aquisc.timer no tempo do mestre quando
+// sincronizado, senão aquisc.timer desde o último ciclo como sempre
+bool acquisitionDue() {
+    if (!syncAlign || !timeSync.synced()) {
+        alignedValid = false;
+        return millis() - timeaquisition >= aquisc.timer;
+    }
+    uint32_t nowUs = micros();
+    if (alignedValid && (int32_t)(nowUs - nextAlignedUs) < 0) return false;
+    uint32_t periodUs = (uint32_t)aquisc.timer * 1000UL;
+    uint64_t next = (timeSync.now(nowUs) / periodUs + 1) * periodUs;
+    nextAlignedUs = timeSync.toLocal(next);
+    bool due = alignedValid;        // O primeiro cálculo só agenda
+    alignedValid = true;
+    return due;
+}
+
+//═══════════════════════════════════════════════════════════════════════════
+// CONTROLE DE MOTOR DC - PONTE H
+//═══════════════════════════════════════════════════════════════════════════
+
+//───────────────────────────────────────────────────────────────────────────
+// FUNÇÃO: setMotor
+// Controla direção e velocidade de 2 motores DC via ponte H
+//───────────────────────────────────────────────────────────────────────────
+// PARÂMETROS:
+//   dir    - Direção: 0=parado, 1=sentido horário, 2=sentido anti-horário
+//   pwmVal - Velocidade: 0-255 (duty cycle do PWM)
+//
+// FUNCIONAMENTO DA PONTE H:
+//   - Para girar num sentido: F_PWM=0, R_PWM=velocidade
+//   - Para girar no outro: F_PWM=velocidade, R_PWM=0
+//   - Para parar: F_PWM=0, R_PWM=0
+//───────────────────────────────────────────────────────────────────────────
+void setMotor(int dir, int pwmVal) {
+    if (dir == 1) {
+        // Sentido 1 (ex: válvula abrindo)
+        analogWrite(R_PWM_2, pwmVal);  // Motor 2 - Reverse ativo
+        analogWrite(F_PWM_2, 0);       // Motor 2 - Forward desligado
+        analogWrite(R_PWM_1, pwmVal);  // Motor 1 - Reverse ativo
+        analogWrite(F_PWM_1, 0);       // Motor 1 - Forward desligado
+    } 
+    else if (dir == 2) {
+        // Sentido 2 (ex: válvula fechando)
+        analogWrite(F_PWM_2, pwmVal);  // Motor 2 - Forward ativo
+        analogWrite(R_PWM_2, 0);       // Motor 2 - Reverse desligado
+        analogWrite(F_PWM_1, pwmVal);  // Motor 1 - Forward ativo
+        analogWrite(R_PWM_1, 0);       // Motor 1 - Reverse desligado
+    } 
+    else if (dir == 0) {
+        // Parado (freio elétrico)
+        analogWrite(R_PWM_2, 0);
+        analogWrite(F_PWM_2, 0);
+        analogWrite(R_PWM_1, 0);
+        analogWrite(F_PWM_1, 0);
+    }
+}
+
+//═══════════════════════════════════════════════════════════════════════════
+// CANAIS DE SEGURANÇA (T1..T4) - GERADOS A PARTIR DO PERFIL
+//═══════════════════════════════════════════════════════════════════════════
+// Cada canal é um SafetyChannel<N> com estado próprio (config, temperatura
+// filtrada, disparo). De onde vem a temperatura, quais relés acionar e qual
+// timer usar vêm de ActiveChannel<N> (profile.h), tudo constexpr.
+//
+// Canal que o perfil não usa cai na especialização <N, false>: métodos vazios
+// e nenhuma variável, então o compilador elimina o canal inteiro.
+//───────────────────────────────────────────────────────────────────────────
+
+//───────────────────────────────────────────────────────────────────────────
+// TIMERS POR SOFTWARE (ver timerservice.h)
+//───────────────────────────────────────────────────────────────────────────
+// Um slot por alarme de canal (slot = índice do canal). Novos timers entram
+// no enum antes de TIMER_SLOTS; todos andam no mesmo tick do Timer2.
+//───────────────────────────────────────────────────────────────────────────
+enum TimerSlot : uint8_t {
+    TIMER_ALARM_T1 = 0,
+    TIMER_ALARM_T2,
+    TIMER_ALARM_T3,
+    TIMER_ALARM_T4,
+    TIMER_PULSE_0,     // Janela de contagem do canal 0 (motor)
+    TIMER_PULSE_1,     // Janela de contagem do canal 1 (bomba)
+    TIMER_SLOTS
+};
+
+TimerService<TIMER_SLOTS> timers;
+
+ISR(TIMER2_COMPA_vect) {
+    timers.tick();
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// CONTAGEM DE PULSOS POR HARDWARE (ver pulse.h)
+//───────────────────────────────────────────────────────────────────────────
+// Timer1 e Timer3 com clock externo (CSn2:0 = 111, borda de subida) contam
+// sozinhos os pulsos de T1 (PD6) e T3 (PE6). Nenhuma ISR por borda: só o
+// slot da janela lê o contador a cada gateMs.
+//
+// ⚠️ PD6 e PE6 não saem nos conectores do Mega padrão: ligar direto no
+//    chip ou em placa que exponha os pinos. Timer4/Timer5 ficam com o PWM.
+//───────────────────────────────────────────────────────────────────────────
+pulseConfigStructure pulsec;
+PulseGate pulseGates[PULSE_CHANNELS];
+
+// Contador de 16 bits do canal (leitura de TCNTn é atômica pelo registrador TEMP)
+inline uint16_t pulseCounter(uint8_t ch) {
+    return ch == 0 ? TCNT1 : TCNT3;
+}
+
+// Roda dentro da ISR do Timer2 (as duas janelas não se aninham: um produtor)
+template <uint8_t Ch>
+void pulseGateHandler() {
+    uint16_t edges = pulseGates[Ch].close(pulseCounter(Ch));
+    PulseState &st = pulseState.edit();
+    st.edges[Ch] = edges;
+    st.total[Ch] += edges;
+    st.gateMs[Ch] = pulsec.gateMs[Ch];
+    pulseState.publish();
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// ADC EM FREE-RUNNING (ver adcengine.h)
+//───────────────────────────────────────────────────────────────────────────
+// ~9,6 mil ISRs/s de poucos µs. REFS0 = referência AVCC; MUX5 (ADCSRB)
+// seleciona ADC8-15. ADTS = 0 no ADCSRB: gatilho free-running.
+//───────────────────────────────────────────────────────────────────────────
+inline void adcSelect(uint8_t ch) {
+    ADMUX = _BV(REFS0) | (ch & 0x07);
+    ADCSRB = (ch & 0x08) ? _BV(MUX5) : 0;
+}
+
+ISR(ADC_vect) {
+    adcSelect(adcEngine.onConversion(ADC));
+}
+
+// Para o ADC, refaz a lista e religa se aquisc.analog estiver ligado
+void adcStart() {
+    ADCSRA = 0;                                    // Para antes de mexer na lista
+    bool ok = adcEngine.configure(adcc.channelMask, adcc.oversampleBits);
+    if (!ok || !aquisc.analog) return;
+
+    // Sem buffer digital nos pinos analógicos usados (menos ruído e consumo)
+    DIDR0 = adcc.channelMask & 0xFF;
+    DIDR2 = adcc.channelMask >> 8;
+    adcSelect(adcEngine.firstMux());
+    // Liga, free-running, ISR, prescaler 128 (125 kHz) e dispara a primeira
+    ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0) | _BV(ADSC);
+}
+
+// Liga/desliga os contadores e as janelas conforme pulsec
+void pulseStart() {
+    static const TimerService<TIMER_SLOTS>::Callback handlers[PULSE_CHANNELS] = {
+        pulseGateHandler<0>, pulseGateHandler<1>
+    };
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        TCCR1A = 0;                                   // Modo normal, sem saídas
+        TCCR1B = (pulsec.enableMask & 0x01) ? (_BV(CS12) | _BV(CS11) | _BV(CS10)) : 0;
+        TCCR3A = 0;
+        TCCR3B = (pulsec.enableMask & 0x02) ? (_BV(CS32) | _BV(CS31) | _BV(CS30)) : 0;
+        DDRD &= ~_BV(PD6);                            // Entradas sem pull-up
+        DDRE &= ~_BV(PE6);
+    }
+    for (uint8_t ch = 0; ch < PULSE_CHANNELS; ch++) {
+        if (pulsec.enableMask & (1 << ch)) {
+            // Primeira janela a partir da contagem atual
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                pulseGates[ch].restart(pulseCounter(ch));
+            }
+            timers.attach(TIMER_PULSE_0 + ch, pulsec.gateMs[ch], handlers[ch]);
+        } else {
+            timers.detach(TIMER_PULSE_0 + ch);
+            // Canal desligado: zera a medida. A janela do outro canal continua
+            // publicando pela ISR; sem as interrupções o loop é o único produtor
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                PulseState &st = pulseState.edit();
+                st.edges[ch] = 0;
+                st.gateMs[ch] = 0;
+                pulseState.publish();
+            }
+        }
+    }
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// ESCREVE UM NÍVEL EM TODOS OS RELÉS DA MÁSCARA (bit 0 = D1 ... bit 7 = D8)
+//───────────────────────────────────────────────────────────────────────────
+void writeRelays(uint8_t mask, uint8_t level) {
+    for (uint8_t i = 0; i < 8; i++) {
+        if (mask & (1 << i)) digitalWrite(ledpins[i], level);
+    }
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// TERMOPAR SELECIONADO DENTRO DO FRAME CANmod.Temp
+//───────────────────────────────────────────────────────────────────────────
+int16_t thermocouple(const tempReadStructure &t, TcInput input) {
+    switch (input) {
+        case TC_TL: return t.TLtemp;
+        case TC_TR: return t.TRtemp;
+        case TC_BL: return t.BLtemp;
+        default:    return t.BRtemp;
+    }
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// CANAL NÃO USADO NO PERFIL
+//───────────────────────────────────────────────────────────────────────────
+template <uint8_t Ch, bool Used = ActiveChannel<Ch>::used>
+struct SafetyChannel {
+    static void load() {}
+    static void save() {}
+    static constexpr safetyConfigStructure *storage() { return nullptr; }
+    static safetyConfigStructure get() { return safetyConfigStructure(); }  // Monit_Enable = 0
+    static void set(const safetyConfigStructure &) {}
+    static bool onTemperature(unsigned long, const tempReadStructure &, SensorState &) { return false; }
+    static bool monitor(uint32_t) { return false; }
+    static bool isStale() { return false; }
+    static uint16_t ageMs(uint32_t) { return 0; }
+    static uint16_t samplePeriod(unsigned long) { return ADAPT_IDLE_PERIOD; }
+    static void printStatus(const AlarmState &) {}
+};
+
+//───────────────────────────────────────────────────────────────────────────
+// CANAL USADO
+//───────────────────────────────────────────────────────────────────────────
+template <uint8_t Ch>
+struct SafetyChannel<Ch, true> {
+    typedef ActiveChannel<Ch> P;
+
+    // Só o loop() acessa estes campos; o que a ISR precisa vai por sensorState
+    static safetyConfigStructure config;
+    static float filtered;                 // Temperatura filtrada (°C)
+    static float risePerS;                 // Taxa de subida filtrada (°C/s)
+    static bool tripped;                   // Relés acionados e timer ativo?
+    static uint16_t ticksAtTrip;           // alarmState.ticks no momento do disparo
+    static uint32_t sampleMs;              // millis() da última amostra (0 = nenhuma)
+    static bool stale;                     // Sem amostra há mais de freshc.maxAgeMs
+    static bool staleReleased;             // STALE_RELEASE já aplicado neste episódio
+
+    // ISR do timer: registra o estouro e a temperatura publicada pelo loop
+    // (nada de Serial aqui). ISRs não se aninham: produtor único de alarmState.
+    static void timerHandler() {
+        SensorState sensors;
+        sensorState.read(sensors);
+        AlarmState &a = alarmState.edit();
+        a.tickMs[Ch] = millis();
+        a.ticks[Ch]++;
+        a.tempAtTick[Ch] = sensors.temp[Ch];
+        alarmState.publish();
+    }
+
+    //───────────────────────────────────────────────────────────────────────
+    // EEPROM (ver tabela de endereços acima)
+    //───────────────────────────────────────────────────────────────────────
+    static void load() {
+        config.maxtemp = readEEPROMFloat(eepromMaxAddr(Ch));
+        config.timer = readEEPROMUInt16(eepromTimerAddr(Ch));
+        config.Monit_Enable = readEEPROMUInt8(eepromEnableAddr(Ch));
+    }
+
+    static void save() {
+        updateEEPROMFloat(eepromMaxAddr(Ch), config.maxtemp);
+        updateEEPROMUInt16(eepromTimerAddr(Ch), config.timer);
+        updateEEPROMUInt8(eepromEnableAddr(Ch), config.Monit_Enable);
+    }
+
+    static safetyConfigStructure get() { return config; }
+    static void set(const safetyConfigStructure &c) { config = c; }
+    static constexpr safetyConfigStructure *storage() { return &config; }
+
+    //───────────────────────────────────────────────────────────────────────
+    // FILTRO EXPONENCIAL (EMA)
+    //───────────────────────────────────────────────────────────────────────
+    // filtrado[n] = α * novo + (1-α) * filtrado[n-1], com α = 0.1:
+    // resposta lenta mas suave (o novo valor contribui com 10%)
+    //───────────────────────────────────────────────────────────────────────
+    static bool onTemperature(unsigned long id, const tempReadStructure &t, SensorState &out) {
+        if (id != P::moduleId) return false;
+        const float alpha = 0.1f;
+        float previous = filtered;
+        uint32_t now = millis();
+        filtered = alpha * thermocouple(t, P::input) + (1 - alpha) * filtered;
+        if (sampleMs != 0 && now != sampleMs) {
+            float rise = (filtered - previous) * 1000.0f / (now - sampleMs);
+            risePerS = 0.25f * rise + 0.75f * risePerS;
+        }
+        sampleMs = now;
+        out.temp[Ch] = filtered;
+        out.sampleMs[Ch] = sampleMs;
+        return true;
+    }
+
+    //───────────────────────────────────────────────────────────────────────
+    // MONITOR: aciona os relés de disparo ao atingir o limite e libera os
+    // relés de normalização quando a temperatura volta. Canal VELHO (sem
+    // amostra há mais de freshc.maxAgeMs) segue freshc.action em vez da
+    // temperatura congelada. Retorna se está disparado.
+    //───────────────────────────────────────────────────────────────────────
+    static bool monitor(uint32_t now) {
+        bool old = (now - sampleMs) > freshc.maxAgeMs;
+        if (old != stale) {
+            stale = old;
+            staleReleased = false;
+            historyEvent(stale ? HIST_EV_STALE : HIST_EV_FRESH, Ch);
+            Serial.print(stale ? F("AVISO: T") : F("INFO: T"));
+            Serial.print(Ch + 1);
+            Serial.println(stale ? F(" SEM DADOS (fail-safe)") : F(" dados de volta"));
+        }
+
+        if (config.Monit_Enable == 1) {
+            if (stale && freshc.action == STALE_RELEASE) {
+                if (!staleReleased) {
+                    if (tripped) timers.detach(TIMER_ALARM_T1 + Ch);
+                    tripped = false;
+                    writeRelays(P::releaseRelays, HIGH);
+                    staleReleased = true;
+                    historyEvent(HIST_EV_RELEASE, Ch);
+                    publishOutputs();
+                }
+            } else if (filtered >= config.maxtemp || (stale && freshc.action == STALE_TRIP)) {
+                if (!tripped) {
+                    Serial.print(F("!!! ALERTA: T"));
+                    Serial.print(Ch + 1);
+                    Serial.println(stale ? F(" SEM DADOS, DISPARO POR SEGURANCA !!!") : F(" LIMITE ATINGIDO !!!"));
+                    writeRelays(P::tripRelays, LOW);
+                    ticksAtTrip = alarmState.get().ticks[Ch];
+                    timers.attach(TIMER_ALARM_T1 + Ch, config.timer, timerHandler);
+                    tripped = true;
+                    historyEvent(HIST_EV_TRIP, Ch);
+                    publishOutputs();
+                }
+            } else if (tripped) {
+                Serial.print(F("INFO: T"));
+                Serial.print(Ch + 1);
+                Serial.println(F(" Normalizado"));
+                writeRelays(P::releaseRelays, HIGH);
+                timers.detach(TIMER_ALARM_T1 + Ch);
+                tripped = false;
+                historyEvent(HIST_EV_NORMAL, Ch);
+                publishOutputs();
+            }
+        } else {
+            if (tripped) timers.detach(TIMER_ALARM_T1 + Ch);
+            tripped = false;
+        }
+        return tripped;
+    }
+
+    static bool isStale() { return stale; }
+
+    // Período de aquisição pedido para o ID id (ver adaptive.h)
+    static uint16_t samplePeriod(unsigned long id) {
+        if (id != P::moduleId || config.Monit_Enable != 1) return ADAPT_IDLE_PERIOD;
+        return sampler.channelPeriod(filtered, config.maxtemp, risePerS);
+    }
+
+    static uint16_t ageMs(uint32_t now) {
+        uint32_t age = now - sampleMs;
+        return age > 0xFFFF ? 0xFFFF : (uint16_t)age;
+    }
+
+    static void printStatus(const AlarmState &alarms) {
+        Serial.print(F(" T"));
+        Serial.print(Ch + 1);
+        Serial.print(F(": "));
+        Serial.print(filtered, 1);
+        Serial.print(F("C (Max:"));
+        Serial.print(config.maxtemp, 0);
+        Serial.print(F(")"));
+        if (stale) Serial.print(F(" [sem dados]"));
+        if (tripped) {
+            Serial.print(F(" [alarme: "));
+            Serial.print((uint16_t)(alarms.ticks[Ch] - ticksAtTrip));
+            Serial.print(F("x]"));
+        }
+    }
+};
+
+template <uint8_t Ch> safetyConfigStructure SafetyChannel<Ch, true>::config;
+template <uint8_t Ch> float SafetyChannel<Ch, true>::filtered = 0;
+template <uint8_t Ch> float SafetyChannel<Ch, true>::risePerS = 0;
+template <uint8_t Ch> bool SafetyChannel<Ch, true>::tripped = false;
+template <uint8_t Ch> uint16_t SafetyChannel<Ch, true>::ticksAtTrip = 0;
+template <uint8_t Ch> uint32_t SafetyChannel<Ch, true>::sampleMs = 0;
+template <uint8_t Ch> bool SafetyChannel<Ch, true>::stale = false;
+template <uint8_t Ch> bool SafetyChannel<Ch, true>::staleReleased = false;
+
+typedef SafetyChannel<0> SafetyT1;  // Starter
+typedef SafetyChannel<1> SafetyT2;  // Engine
+typedef SafetyChannel<2> SafetyT3;  // Intercooler
+typedef SafetyChannel<3> SafetyT4;  // Água
+
+//───────────────────────────────────────────────────────────────────────────
+// RECALCULA O PERÍODO DE AQUISIÇÃO DE CADA ID COM RTR DE RESERVA
+//───────────────────────────────────────────────────────────────────────────
+// Chamado a cada temperatura consumida e quando limites ou política mudam
+//───────────────────────────────────────────────────────────────────────────
+void updateSamplePeriods() {
+    for (uint8_t i = 0; i < ingest.size(); i++) {
+        if (!ingest.slot(i).rtrFallback) continue;
+        uint16_t period = SafetyT1::samplePeriod(DataIDs[i]);
+        uint16_t p = SafetyT2::samplePeriod(DataIDs[i]); if (p < period) period = p;
+        p = SafetyT3::samplePeriod(DataIDs[i]); if (p < period) period = p;
+        p = SafetyT4::samplePeriod(DataIDs[i]); if (p < period) period = p;
+        sampler.setWanted(i, period);
+    }
+    sampler.applyBudget(ingest.bitrate);
+}
+
+void publishSampling() {
+    samplingStatusStructure status;
+    status.config = sampler.config;
+    status.budgetLimited = sampler.budgetLimited();
+    for (uint8_t i = 0; i < 3; i++) {
+        status.periodMs[i] = sampler.config.enabled ? sampler.period(i) : aquisc.timer;
+    }
+    sendSamplingStatus(status, txBuf);
+    canSend(0x429, 8, txBuf);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// HEARTBEAT (0x42A) E SNAPSHOT COMPLETO (RTR 0x40A)
+//───────────────────────────────────────────────────────────────────────────
+void publishHeartbeat() {
+    heartbeatStructure hb;
+    hb.config.mode = reporter.mode;
+    hb.config.heartbeatS = reporter.heartbeatS;
+    hb.uptimeS = millis() / 1000;
+    hb.sent = reporter.sentLast();
+    hb.suppressed = reporter.suppressedLast();
+    sendHeartbeat(hb, txBuf);
+    canSend(0x42A, 8, txBuf);
+}
+
+void publishFreshness(uint32_t now);
+void publishPulse(bool force);
+void publishAdc();
+
+// Todos os frames de estado, mudados ou não
+void publishSnapshot() {
+    publishOutputs(true);
+    sendSafetyPair(SafetyT1::get(), SafetyT2::get(), txBuf);
+    reportSend(RPT_SAFETY12, 0x423, 8, txBuf, true);
+    sendSafetyPair(SafetyT3::get(), SafetyT4::get(), txBuf);
+    reportSend(RPT_SAFETY34, 0x426, 8, txBuf, true);
+    sendAquisitionFrame(aquisc, txBuf);
+    canSend(0x424, 8, txBuf);
+    sendStartStop(aquisc.Aquics_Enable, txBuf);
+    canSend(0x425, 8, txBuf);
+    publishFreshness(millis());
+    publishSampling();
+    publishHeartbeat();
+    publishPulse(true);
+    publishAdc();
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// SAÚDE DO BARRAMENTO (0x42B)
+//───────────────────────────────────────────────────────────────────────────
+void publishBusHealth() {
+    busHealthStructure h;
+    h.tec = health.tec();
+    h.rec = health.rec();
+    h.eflg = health.eflgSeen() | health.eflg();
+    h.recoveries = health.recoveries();
+    h.loadPermille = ingest.loadPermille();
+    h.rxPerS = health.rxPerSecond();
+    h.txPerS = health.txPerSecond();
+    sendBusHealth(h, txBuf);
+    canSend(0x42B, 8, txBuf);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// MIGRAÇÃO DE BITRATE (0x42C)
+//───────────────────────────────────────────────────────────────────────────
+void publishBitrate() {
+    bitrateStatusStructure b;
+    b.current = migration.current();
+    b.state = migration.state();
+    b.target = migration.target();
+    b.remainingMs = migration.remainingMs(millis());
+    b.stored = readEEPROMUInt8(EEPROM_BITRATE_ADDR);
+    b.fallbacks = migration.fallbacks();
+    sendBitrateStatus(b, txBuf);
+    canSend(0x42C, 8, txBuf);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// RPM E FREQUÊNCIA DOS PULSOS (0x42D)
+//───────────────────────────────────────────────────────────────────────────
+// Última janela fechada de cada canal; sai no ritmo da aquisição (0x426)
+// pelo slot RPT_PULSE, então só quando muda no modo por mudança.
+//───────────────────────────────────────────────────────────────────────────
+void publishPulse(bool force) {
+    PulseState st;
+    pulseState.read(st);
+    pulseStatusStructure p;
+    for (uint8_t ch = 0; ch < PULSE_CHANNELS; ch++) {
+        p.rpm[ch] = PulseMeter::rpm(st.edges[ch], st.gateMs[ch], pulsec.ppr[ch]);
+        p.frequencyHz[ch] = PulseMeter::frequencyHz(st.edges[ch], st.gateMs[ch]);
+    }
+    sendPulseStatus(p, txBuf);
+    reportSend(RPT_PULSE, 0x42D, 8, txBuf, force);
+}
+
+void savePulseConfig() {
+    updateEEPROMUInt8(EEPROM_PULSE_ADDR, pulsec.enableMask);
+    updateEEPROMUInt8(EEPROM_PULSE_ADDR + 1, pulsec.gateMs[0] / 10);
+    updateEEPROMUInt8(EEPROM_PULSE_ADDR + 2, pulsec.gateMs[1] / 10);
+    updateEEPROMUInt16(EEPROM_PULSE_ADDR + 3, pulsec.ppr[0]);
+    updateEEPROMUInt16(EEPROM_PULSE_ADDR + 5, pulsec.ppr[1]);
+}
+
+// EEPROM virgem (0xFF) mantém os padrões: contagem desligada
+void loadPulseConfig() {
+    uint8_t mask = readEEPROMUInt8(EEPROM_PULSE_ADDR);
+    if (mask <= 0x03) pulsec.enableMask = mask;
+    for (uint8_t ch = 0; ch < PULSE_CHANNELS; ch++) {
+        uint8_t gate = readEEPROMUInt8(EEPROM_PULSE_ADDR + 1 + ch);
+        uint16_t ppr = readEEPROMUInt16(EEPROM_PULSE_ADDR + 3 + 2 * ch);
+        if (gate != 0 && gate != 0xFF) pulsec.gateMs[ch] = gate * 10;
+        if (ppr != 0 && ppr != 0xFFFF) pulsec.ppr[ch] = ppr;
+    }
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// ADC INTERNO (0x42E)
+//───────────────────────────────────────────────────────────────────────────
+void publishAdc() {
+    adcStatusStructure a;
+    a.config.channelMask = adcEngine.mask();
+    a.config.oversampleBits = adcEngine.oversampleBits();
+    a.running = (ADCSRA & _BV(ADEN)) != 0;
+    a.drops = adcEngine.drops();
+    a.measuredHz = adcEngine.measuredHz(0);
+    a.nominalHz = adcEngine.nominalHz();
+    sendAdcStatus(a, txBuf);
+    canSend(0x42E, 8, txBuf);
+}
+
+void saveAdcConfig() {
+    updateEEPROMUInt16(EEPROM_ADC_ADDR, adcc.channelMask);
+    updateEEPROMUInt8(EEPROM_ADC_ADDR + 2, adcc.oversampleBits);
+}
+
+// EEPROM virgem (0xFFFF/0xFF) mantém A0/A1 com 4x oversampling
+void loadAdcConfig() {
+    uint16_t mask = readEEPROMUInt16(EEPROM_ADC_ADDR);
+    uint8_t bits = readEEPROMUInt8(EEPROM_ADC_ADDR + 2);
+    if (mask != 0 && mask != 0xFFFF) adcc.channelMask = mask;
+    if (bits <= ADC_MAX_OVERSAMPLE) adcc.oversampleBits = bits;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// HISTÓRICO: STATUS (0x42F) E DADOS (0x430)
+//───────────────────────────────────────────────────────────────────────────
+void publishHistory() {
+    historyStatusStructure h;
+    h.state = historyState;
+    h.length = historyState == HISTORY_SENDING || historyState == HISTORY_DONE ? history.length() : history.size();
+    h.period10ms = HISTORY_PERIOD_MS / 10;
+    h.uptimeMs = millis();
+    sendHistoryStatus(h, txBuf);
+    canSend(0x42F, 8, txBuf);
+}
+
+// Um frame de dados por chamada; se o TXB0 não liberou, tenta de novo na próxima
+void historyPump() {
+    if (!history.downloading() || historyIsoTp) return;
+    byte frame[8];
+    frame[0] = historySeq;
+    uint8_t n = history.chunk(frame + 1);
+    if (canSend(0x430, 1 + n, frame) != MCP2515_OK) return;
+    historySeq++;
+    history.advance(n);
+    if (!history.downloading()) {
+        historyState = HISTORY_DONE;
+        publishHistory();
+    }
+}
+
+// Uma amostra a cada HISTORY_PERIOD_MS no horário nominal; atraso maior que
+// um período recomeça o horário (o histórico grava um KEY com o tempo real)
+void historyRecord(uint32_t now) {
+    static uint32_t due = 0;
+    if ((int32_t)(now - due) < 0) return;
+    due += HISTORY_PERIOD_MS;
+    if ((int32_t)(now - due) >= 0) due = now + HISTORY_PERIOD_MS;
+
+    SensorState sensors;
+    sensorState.read(sensors);
+    int16_t temp[HISTORY_CHANNELS];
+    for (uint8_t ch = 0; ch < HISTORY_CHANNELS; ch++) temp[ch] = historyQuantize(sensors.temp[ch]);
+    history.sample(now, temp, relayMask());
+}
+
+//═══════════════════════════════════════════════════════════════════════════
+// ISO-TP: SERVIÇOS COM RESOLUÇÃO COMPLETA (ver isotp.h e config.h)
+//═══════════════════════════════════════════════════════════════════════════
+// Pedidos chegam no 0x400 e respostas saem no 0x420, com segmentação e
+// controle de fluxo. Os frames de 8 bytes (0x403/0x406) continuam valendo;
+// aqui o limite e o timer vão inteiros (float e ms de 16 bits) e o
+// histórico sai numa mensagem só, sem o protocolo próprio do 0x430.
+//───────────────────────────────────────────────────────────────────────────
+bool isoTpSend(void *, uint16_t id, const uint8_t *data, uint8_t len) {
+    return canSend(id, len, const_cast<byte *>(data)) == MCP2515_OK;
+}
+
+IsoTp isotp(0x420, isoTpSend, nullptr);   // FC do nó: ver setup()
+
+// Serviço 0x03: byte 0 = resposta positiva, depois o anel congelado
+uint8_t historySource(void *, uint16_t offset, uint8_t *out, uint8_t n) {
+    if (offset > 0) return history.read(offset - 1, out, n);
+    out[0] = ISOTP_SVC_READ_HISTORY | ISOTP_POSITIVE;
+    return 1 + history.read(0, out + 1, n - 1);
+}
+
+safetyConfigStructure safetyGet(uint8_t ch) {
+    switch (ch) {
+        case 0:  return SafetyT1::get();
+        case 1:  return SafetyT2::get();
+        case 2:  return SafetyT3::get();
+        default: return SafetyT4::get();
+    }
+}
+
+void safetySet(uint8_t ch, const safetyConfigStructure &c, bool save) {
+    switch (ch) {
+        case 0: SafetyT1::set(c); if (save) SafetyT1::save(); break;
+        case 1: SafetyT2::set(c); if (save) SafetyT2::save(); break;
+        case 2: SafetyT3::set(c); if (save) SafetyT3::save(); break;
+        default: SafetyT4::set(c); if (save) SafetyT4::save(); break;
+    }
+    updateSamplePeriods();
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// DICIONÁRIO DE PARÂMETROS (serviços 0x05-0x08)
+//───────────────────────────────────────────────────────────────────────────
+// Uma linha por valor configurável, na ordem de ObjectIndex (config.h). As
+// faixas são as mesmas dos frames 0x403-0x40D; o grupo diz o que refazer
+// depois da escrita. Canais sem uso no container têm base nula.
+//───────────────────────────────────────────────────────────────────────────
+enum ParamApply : uint8_t {
+    APPLY_NONE,
+    APPLY_SAFETY,      // Períodos de amostragem; EEPROM do canal
+    APPLY_AQUISITION,  // Religa o ADC (aquisc.analog)
+    APPLY_FRESHNESS,   // EEPROM de maxAge/ação
+    APPLY_SAMPLING,    // Períodos de amostragem; confere min <= max
+    APPLY_PULSE,       // EEPROM e reinício dos timers
+    APPLY_ADC          // EEPROM e nova lista de canais
+};
+
+#define OD_SAFETY(Ch, T)                                                                   \
+    {OD_T##Ch##_ENABLE, PARAM_U8, PARAM_RW | PARAM_EEPROM, APPLY_SAFETY, T::storage(),      \
+     offsetof(safetyConfigStructure, Monit_Enable), 0, 2, "t" #Ch ".enable"},               \
+    {OD_T##Ch##_MAXTEMP, PARAM_F32, PARAM_RW | PARAM_EEPROM, APPLY_SAFETY, T::storage(),    \
+     offsetof(safetyConfigStructure, maxtemp), 0, 1500, "t" #Ch ".maxtemp"},                \
+    {OD_T##Ch##_TIMER, PARAM_U16, PARAM_RW | PARAM_EEPROM, APPLY_SAFETY, T::storage(),      \
+     offsetof(safetyConfigStructure, timer), 10, 65535, "t" #Ch ".timer"}
+
+constexpr ParamDef paramTable[] OBJDICT_PROGMEM = {
+    OD_SAFETY(1, SafetyT1),
+    OD_SAFETY(2, SafetyT2),
+    OD_SAFETY(3, SafetyT3),
+    OD_SAFETY(4, SafetyT4),
+    {OD_AQ_PERIOD, PARAM_U16, PARAM_RW, APPLY_AQUISITION, &aquisc,
+     offsetof(aquisitionConfigStructure, timer), 10, 60000, "aq.period"},
+    {OD_AQ_CONTINUOUS, PARAM_U8, PARAM_RW, APPLY_AQUISITION, &aquisc,
+     offsetof(aquisitionConfigStructure, Aquics_Enable_Continuous), 0, 1, "aq.contin"},
+    {OD_AQ_ANALOG, PARAM_U8, PARAM_RW, APPLY_AQUISITION, &aquisc,
+     offsetof(aquisitionConfigStructure, analog), 0, 1, "aq.analog"},
+    {OD_AQ_RUN, PARAM_U8, PARAM_RW, APPLY_AQUISITION, &aquisc,
+     offsetof(aquisitionConfigStructure, Aquics_Enable), 0, 1, "aq.run"},
+    {OD_INGEST_MODE, PARAM_U8, PARAM_RW, APPLY_NONE, &ingest.mode, 0, 0, 1, "ingest.mode"},
+    {OD_STALE_ACTION, PARAM_U8, PARAM_RW | PARAM_EEPROM, APPLY_FRESHNESS, &freshc,
+     offsetof(freshnessConfigStructure, action), 0, 2, "stale.act"},
+    {OD_STALE_MAX_AGE, PARAM_U16, PARAM_RW | PARAM_EEPROM, APPLY_FRESHNESS, &freshc,
+     offsetof(freshnessConfigStructure, maxAgeMs), 1, 65535, "stale.age"},
+    {OD_SAMPLING_ENABLED, PARAM_U8, PARAM_RW, APPLY_SAMPLING, &sampler.config,
+     offsetof(samplingConfigStructure, enabled), 0, 1, "samp.on"},
+    {OD_SAMPLING_MIN, PARAM_U16, PARAM_RW, APPLY_SAMPLING, &sampler.config,
+     offsetof(samplingConfigStructure, minMs), 10, 2550, "samp.min"},
+    {OD_SAMPLING_MAX, PARAM_U16, PARAM_RW, APPLY_SAMPLING, &sampler.config,
+     offsetof(samplingConfigStructure, maxMs), 10, 5100, "samp.max"},
+    {OD_SAMPLING_MARGIN, PARAM_U8, PARAM_RW, APPLY_SAMPLING, &sampler.config,
+     offsetof(samplingConfigStructure, marginC), 1, 255, "samp.margin"},
+    {OD_SAMPLING_BUDGET, PARAM_U8, PARAM_RW, APPLY_SAMPLING, &sampler.config,
+     offsetof(samplingConfigStructure, budgetPermille), 0, 255, "samp.budget"},
+    {OD_REPORT_MODE, PARAM_U8, PARAM_RW, APPLY_NONE, &reporter.mode, 0, 0, 1, "report.mode"},
+    {OD_REPORT_HEARTBEAT, PARAM_U8, PARAM_RW, APPLY_NONE, &reporter.heartbeatS, 0, 0, 255, "report.hb"},
+    {OD_PULSE_MASK, PARAM_U8, PARAM_RW | PARAM_EEPROM, APPLY_PULSE, &pulsec,
+     offsetof(pulseConfigStructure, enableMask), 0, 3, "pulse.mask"},
+    {OD_PULSE_GATE0, PARAM_U16, PARAM_RW | PARAM_EEPROM, APPLY_PULSE, &pulsec,
+     offsetof(pulseConfigStructure, gateMs), 10, 2550, "pulse.gate0", 10},
+    {OD_PULSE_GATE1, PARAM_U16, PARAM_RW | PARAM_EEPROM, APPLY_PULSE, &pulsec,
+     offsetof(pulseConfigStructure, gateMs) + 2, 10, 2550, "pulse.gate1", 10},
+    {OD_PULSE_PPR0, PARAM_U16, PARAM_RW | PARAM_EEPROM, APPLY_PULSE, &pulsec,
+     offsetof(pulseConfigStructure, ppr), 1, 65535, "pulse.ppr0"},
+    {OD_PULSE_PPR1, PARAM_U16, PARAM_RW | PARAM_EEPROM, APPLY_PULSE, &pulsec,
+     offsetof(pulseConfigStructure, ppr) + 2, 1, 65535, "pulse.ppr1"},
+    {OD_ADC_MASK, PARAM_U16, PARAM_RW | PARAM_EEPROM, APPLY_ADC, &adcc,
+     offsetof(adcConfigStructure, channelMask), 1, 0xFFFF, "adc.mask"},
+    {OD_ADC_OVERSAMPLE, PARAM_U8, PARAM_RW | PARAM_EEPROM, APPLY_ADC, &adcc,
+     offsetof(adcConfigStructure, oversampleBits), 0, 3, "adc.osr"},
+    {OD_ISOTP_BS, PARAM_U8, PARAM_RW, APPLY_NONE, &isotp.blockSize, 0, 0, 255, "isotp.bs"},
+    {OD_ISOTP_STMIN, PARAM_U8, PARAM_RW, APPLY_NONE, &isotp.stMin, 0, 0, 255, "isotp.stmin"},
+    {OD_CAN_BITRATE, PARAM_U32, PARAM_READ, APPLY_NONE, &ingest.bitrate, 0, 0, 0, "can.bitrate"},
+    {OD_RAM_STATIC, PARAM_U16, PARAM_READ, APPLY_NONE, &stackMon.staticBytes, 0, 0, 0, "ram.static"},
+    {OD_STACK_SIZE, PARAM_U16, PARAM_READ, APPLY_NONE, &stackMon.sizeBytes, 0, 0, 0, "stack.size"},
+    {OD_STACK_FREE, PARAM_U16, PARAM_READ, APPLY_NONE, &stackMon.minFree, 0, 0, 0, "stack.free"},
+    {OD_SYNC_ALIGN, PARAM_U8, PARAM_RW, APPLY_NONE, &syncAlign, 0, 0, 1, "sync.align"},
+    {OD_SYNC_STAMP, PARAM_U8, PARAM_RW, APPLY_NONE, &syncStamp, 0, 0, 1, "sync.stamp"},
+};
+#undef OD_SAFETY
+
+static_assert(sizeof(paramTable) / sizeof(paramTable[0]) == OD_COUNT, "paramTable fora de ordem com ObjectIndex");
+static_assert(paramTableDense(paramTable, OD_COUNT), "paramTable: índice diferente da posição");
+
+ObjectDictionary od(paramTable, OD_COUNT);
+
+// Efeitos colaterais da escrita; false = combinação inválida (o valor volta)
+bool paramApply(const ParamDef &def) {
+    switch (def.apply) {
+        case APPLY_SAFETY: {
+            uint8_t ch = (def.index - OD_T1_ENABLE) / 3;
+            safetySet(ch, safetyGet(ch), def.flags & PARAM_EEPROM);
+            return true;
+        }
+        case APPLY_AQUISITION:
+            adcStart();
+            return true;
+        case APPLY_FRESHNESS:
+            updateEEPROMUInt16(EEPROM_MAXAGE_ADDR, freshc.maxAgeMs);
+            updateEEPROMUInt8(EEPROM_STALEACT_ADDR, freshc.action);
+            return true;
+        case APPLY_SAMPLING:
+            if (sampler.config.minMs > sampler.config.maxMs) return false;
+            updateSamplePeriods();
+            return true;
+        case APPLY_PULSE:
+            savePulseConfig();
+            pulseStart();
+            return true;
+        case APPLY_ADC:
+            saveAdcConfig();
+            adcStart();
+            return true;
+        default:
+            return true;
+    }
+}
+
+// Escreve, aplica e desfaz se o grupo recusar; retorna ParamStatus
+uint8_t paramWrite(uint8_t index, uint32_t wire) {
+    ParamDef def;
+    uint32_t old;
+    if (od.read(index, old, def) != PARAM_OK) return PARAM_NO_INDEX;
+    uint8_t st = od.write(index, wire, def);
+    if (st == PARAM_OK && !paramApply(def)) {
+        ObjectDictionary::store(def, old);
+        st = PARAM_OUT_OF_RANGE;
+    }
+    return st;
+}
+
+// Cabeçalho [resposta][primeiro][quantos] dos serviços 0x07/0x08; os
+// registros são montados sob demanda enquanto os CFs saem
+uint8_t paramHead[3];
+
+uint8_t paramSource(void *, uint16_t offset, uint8_t *out, uint8_t n) {
+    uint8_t i = 0;
+    for (; i < n && offset + i < sizeof(paramHead); i++) out[i] = paramHead[offset + i];
+    if (i == n) return n;
+    uint16_t rec = offset + i - sizeof(paramHead);
+    if (paramHead[0] == (ISOTP_SVC_BULK_READ | ISOTP_POSITIVE)) {
+        od.valueBytes(paramHead[1], rec, out + i, n - i);
+    } else {
+        od.describeBytes(paramHead[1], rec, out + i, n - i);
+    }
+    return n;
+}
+
+// Atende a mensagem recebida; fica na fila enquanto a resposta anterior sai
+void isoTpService(uint32_t nowUs) {
+    if (!isotp.available() || isotp.sending()) return;
+    const uint8_t *req = isotp.message();
+    uint16_t len = isotp.length();
+    uint8_t resp[1 + 4 * SAFETY_RECORD_BYTES];
+    uint8_t nrc = 0;
+    resp[0] = req[0] | ISOTP_POSITIVE;
+
+    switch (req[0]) {
+        case ISOTP_SVC_READ_SAFETY:
+            for (uint8_t ch = 0; ch < 4; ch++) sendSafetyRecord(safetyGet(ch), resp + 1 + ch * SAFETY_RECORD_BYTES);
+            isotp.send(resp, sizeof(resp), nowUs);
+            break;
+
+        case ISOTP_SVC_WRITE_SAFETY:
+            if (len < 3 + SAFETY_RECORD_BYTES) {
+                nrc = ISOTP_NRC_BAD_LENGTH;
+            } else if (req[1] > 3) {
+                nrc = ISOTP_NRC_OUT_OF_RANGE;
+            } else {
+                safetyConfigStructure c = readSafetyRecord(req + 2);
+                c.Monit_Enable &= 0x03;
+                safetySet(req[1], c, req[2 + SAFETY_RECORD_BYTES] != 0);
+                Serial.print(F("ISO-TP: T"));
+                Serial.print(req[1] + 1);
+                Serial.print(F(" max "));
+                Serial.print(c.maxtemp, 1);
+                Serial.print(F(" C, timer "));
+                Serial.print(c.timer);
+                Serial.println(F(" ms"));
+                resp[1] = req[1];
+                sendSafetyRecord(safetyGet(req[1]), resp + 2);
+                isotp.send(resp, 2 + SAFETY_RECORD_BYTES, nowUs);
+            }
+            break;
+
+        case ISOTP_SVC_READ_HISTORY:
+            if (history.downloading()) {
+                nrc = ISOTP_NRC_BUSY;
+            } else {
+                history.begin();
+                historyIsoTp = isotp.send(1 + history.length(), historySource, nullptr, nowUs);
+                if (!historyIsoTp) history.abort();
+            }
+            break;
+
+        case ISOTP_SVC_TRANSPORT:
+            if (len >= 3) {
+                isotp.blockSize = req[1];
+                isotp.stMin = req[2];
+            }
+            resp[1] = isotp.blockSize;
+            resp[2] = isotp.stMin;
+            isotp.send(resp, 3, nowUs);
+            break;
+
+        case ISOTP_SVC_READ_PARAM:
+        case ISOTP_SVC_WRITE_PARAM: {
+            paramValueStructure value;
+            ParamDef def;
+            uint8_t st = PARAM_OK;
+            if (len < (req[0] == ISOTP_SVC_READ_PARAM ? 2 : 6)) {
+                nrc = ISOTP_NRC_BAD_LENGTH;
+                break;
+            }
+            if (req[0] == ISOTP_SVC_WRITE_PARAM) {
+                uint32_t wire = ((uint32_t)req[2] << 24) | ((uint32_t)req[3] << 16) |
+                                ((uint32_t)req[4] << 8) | req[5];
+                st = paramWrite(req[1], wire);
+            }
+            if (st == PARAM_OK) st = od.read(req[1], value.wire, def);
+            if (st != PARAM_OK) {
+                nrc = st == PARAM_READ_ONLY ? ISOTP_NRC_READ_ONLY : ISOTP_NRC_OUT_OF_RANGE;
+                break;
+            }
+            value.index = req[1];
+            value.type = def.type;
+            value.flags = def.flags;
+            sendParamValue(value, resp + 1);
+            isotp.send(resp, 1 + PARAM_RECORD_BYTES, nowUs);
+            break;
+        }
+
+        case ISOTP_SVC_BULK_READ:
+        case ISOTP_SVC_DESCRIBE: {
+            uint8_t first = len >= 2 ? req[1] : 0;
+            uint8_t count = len >= 3 ? req[2] : 0;
+            if (first >= od.count()) {
+                nrc = ISOTP_NRC_OUT_OF_RANGE;
+                break;
+            }
+            // 0 ou além do fim = até o último índice
+            if (count == 0 || count > od.count() - first) count = od.count() - first;
+            paramHead[0] = resp[0];
+            paramHead[1] = first;
+            paramHead[2] = count;
+            uint16_t bytes = count * (req[0] == ISOTP_SVC_BULK_READ ? PARAM_VALUE_BYTES : PARAM_DESCRIBE_BYTES);
+            isotp.send(sizeof(paramHead) + bytes, paramSource, nullptr, nowUs);
+            break;
+        }
+
+        default:
+            nrc = ISOTP_NRC_NOT_SUPPORTED;
+    }
+    if (nrc) {
+        uint8_t neg[3] = {ISOTP_SVC_NEGATIVE, req[0], nrc};
+        isotp.send(neg, sizeof(neg), nowUs);
+    }
+    isotp.release();
+}
+
+// CFs pendentes, timeouts e fim do download do histórico
+void isoTpPoll(uint32_t nowUs) {
+    isotp.poll(nowUs);
+    if (historyIsoTp && !isotp.sending()) {
+        history.abort();
+        historyIsoTp = false;
+    }
+    isoTpService(nowUs);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// ENVIA A IDADE DAS TEMPERATURAS (0x428)
+//───────────────────────────────────────────────────────────────────────────
+// Resposta ao 0x408 e aviso espontâneo quando algum canal fica velho ou volta
+//───────────────────────────────────────────────────────────────────────────
+uint8_t staleMask() {
+    return (SafetyT1::isStale() << 0) | (SafetyT2::isStale() << 1) |
+           (SafetyT3::isStale() << 2) | (SafetyT4::isStale() << 3);
+}
+
+void publishFreshness(uint32_t now) {
+    freshnessStatusStructure status;
+    status.usedMask = (ActiveChannel<0>::used << 0) | (ActiveChannel<1>::used << 1) |
+                      (ActiveChannel<2>::used << 2) | (ActiveChannel<3>::used << 3);
+    status.staleMask = staleMask();
+    status.action = freshc.action;
+    status.maxAgeMs = freshc.maxAgeMs;
+    status.ageMs[0] = SafetyT1::ageMs(now);
+    status.ageMs[1] = SafetyT2::ageMs(now);
+    status.ageMs[2] = SafetyT3::ageMs(now);
+    status.ageMs[3] = SafetyT4::ageMs(now);
+    sendFreshnessStatus(status, txBuf);
+    canSend(0x428, 8, txBuf);
+}
+
+//═══════════════════════════════════════════════════════════════════════════
+// SETUP() - INICIALIZAÇÃO DO SISTEMA
+//═══════════════════════════════════════════════════════════════════════════
+
+void setup()
+{
+	//───────────────────────────────────────────────────────────────────────
+	// CONFIGURAÇÃO DOS PINOS DE SAÍDA
+	//───────────────────────────────────────────────────────────────────────
+	pinMode(LED_BUILTIN, OUTPUT);  // LED onboard (pino 13)
+	
+	// Configura os 8 pinos de controle dos relés como saída
+	pinMode(D1, OUTPUT);
+	pinMode(D2, OUTPUT);
+	pinMode(D3, OUTPUT);
+	pinMode(D4, OUTPUT);
+	pinMode(D5, OUTPUT);
+	pinMode(D6, OUTPUT);
+	pinMode(D7, OUTPUT);
+	pinMode(D8, OUTPUT);
+
+    digitalWrite(D1, HIGH);
+    digitalWrite(D2, HIGH);
+    digitalWrite(D3, HIGH);
+    digitalWrite(D4, HIGH);
+    digitalWrite(D5, HIGH);
+    digitalWrite(D6, HIGH);
+    digitalWrite(D7, HIGH);
+    digitalWrite(D8, HIGH);
+	
+	// Configura pino de interrupção do CAN como entrada
+	pinMode(CAN0_INT, INPUT);
+
+	//───────────────────────────────────────────────────────────────────────
+	// CONFIGURAÇÃO DOS PINOS PWM E PONTE H
+	//───────────────────────────────────────────────────────────────────────
+	pinMode(PWM1, OUTPUT);     // PWM auxiliar 1 (pino 44)
+	pinMode(PWM2, OUTPUT);     // PWM auxiliar 2 (pino 46)
+	
+	// Pinos da ponte H para controle de motores
+	pinMode(R_PWM_1, OUTPUT);  // Reverse Motor 1 (pino 8)
+    pinMode(F_PWM_1, OUTPUT);  // Forward Motor 1 (pino 6)
+    pinMode(R_PWM_2, OUTPUT);  // Reverse Motor 2 (pino 37)
+    pinMode(F_PWM_2, OUTPUT);  // Forward Motor 2 (pino 16)
+	
+	// Pinos de enable dos motores
+	pinMode(MOTOR1_EN, OUTPUT);
+    pinMode(MOTOR2_EN, OUTPUT);
+    
+    // Habilita os motores (ponte H ativada)
+    digitalWrite(MOTOR1_EN, HIGH);
+    digitalWrite(MOTOR2_EN, HIGH);
+
+	//───────────────────────────────────────────────────────────────────────
+	// INICIALIZAÇÃO DA COMUNICAÇÃO SERIAL
+	//───────────────────────────────────────────────────────────────────────
+	Serial.begin(115200);  // 115200 baud para debug
+    wdt_disable();  // Desabilita watchdog (se estiver habilitado por bootloader)
+
+	//───────────────────────────────────────────────────────────────────────
+	// TICK DOS TIMERS POR SOFTWARE (Timer2, 1 kHz)
+	//───────────────────────────────────────────────────────────────────────
+	// Os alarmes dos canais só entram na lista (timers.attach) quando a
+	// temperatura ultrapassa o limite
+	timers.begin();
+
+	//───────────────────────────────────────────────────────────────────────
+	// INICIALIZAÇÃO DO MÓDULO CAN (MCP2515) - ver canStart()
+	//───────────────────────────────────────────────────────────────────────
+	// Bitrate gravado pela última migração confirmada (0xFF = 500 kbps);
+	// 1 Mbps começa em teste e volta para 500 kbps se o barramento não responder
+	migration.begin(readEEPROMUInt8(EEPROM_BITRATE_ADDR), millis());
+	Serial.print(F("CAN: "));
+	Serial.print(BitrateMigration::bitsPerSecond(migration.current()) / 1000);
+	Serial.println(F(" kbps"));
+	if(canStart()){
+		Serial.println(F("MCP2515 Initialized Successfully!"));
+		// Instante de chegada dos frames (t2 do SYNC, tempo das amostras 0x432)
+		attachInterrupt(digitalPinToInterrupt(CAN0_INT), canIntEdge, FALLING);
+		Serial.println(F("TEste se esta funcionando"));
+	} else {
+		Serial.println(F("Error Initializing MCP2515..."));
+	}
+	
+	byte tempLen;
+    byte tempBuf[8];
+    unsigned long tempId;
+    for(int i = 0; i < 100; i++) {
+        if(CAN0.checkReceive() == MCP2515_OK) {
+            CAN0.readMsgBuf(&tempId, &tempLen, tempBuf);
+        } else {
+            break;
+        }
+    }
+    Serial.println(F("Buffer CAN limpo!"));
+	
+	//───────────────────────────────────────────────────────────────────────
+	// CARREGA CONFIGURAÇÕES SALVAS DA EEPROM
+	//───────────────────────────────────────────────────────────────────────
+	// Restaura as configurações de temperatura que foram salvas anteriormente
+	// Se for a primeira vez que o código roda, valores serão aleatórios!
+	// Melhor seria inicializar EEPROM com valores padrão na primeira execução
+	SafetyT1::load();
+	SafetyT2::load();
+	SafetyT3::load();
+	SafetyT4::load();
+
+	// Idade máxima e ação fail-safe; EEPROM virgem (0xFF) mantém o padrão
+	uint16_t maxAge = readEEPROMUInt16(EEPROM_MAXAGE_ADDR);
+	uint8_t staleAct = readEEPROMUInt8(EEPROM_STALEACT_ADDR);
+	if (maxAge != 0xFFFF && maxAge > 0) freshc.maxAgeMs = maxAge;
+	if (staleAct <= STALE_RELEASE) freshc.action = staleAct;
+
+	// Contadores de pulso: depois de timers.begin() (as janelas são slots)
+	loadPulseConfig();
+	pulseStart();
+	// Configura padrão para aquisição contínua automática
+    aquisc.Aquics_Enable_Continuous = 1; // 1 = Habilitado, 0 = Desabilitado
+    aquisc.timer = 100;                  // Solicita temperatura a cada 100ms
+    aquisc.analog = 1;                   // ADC interno ligado (pressão e válvula no 0x426)
+    loadAdcConfig();
+    adcStart();
+
+    // Histórico começa com um KEY e o motivo do reset
+    historyRecord(millis());
+    historyEvent(HIST_EV_BOOT, MCUSR);
+
+    // Região pintada no reset: do fim do .bss até o RAMEND
+    stackMon.begin((const uint8_t *)RAMSTART, &__heap_start, (const uint8_t *)RAMEND + 1);
+    Serial.print(F("RAM: "));
+    Serial.print(stackMon.staticBytes);
+    Serial.print(F(" bytes estaticos, "));
+    Serial.print(stackMon.sizeBytes);
+    Serial.println(F(" para a pilha"));
+
+    // ISO-TP: blocos de 8 CFs com 1 ms entre eles (o loop() lê um frame por
+    // volta e o MCP2515 só guarda dois); o host pode mudar pelo serviço 0x04
+    isotp.blockSize = 8;
+    isotp.stMin = 1;
+    timeaquisition = millis();           // Inicializa o contador de tempo
+    Serial.println(F("MODO CONTINUO INICIADO AUTOMATICAMENTE"));
+
+    // Tabela de ingestão: as 3 temperaturas têm RTR de reserva
+    for (size_t i = 0; i < 8; i++) ingest.add(DataIDs[i], i < 3);
+    updateSamplePeriods();
+    writeRelays(Profile::pumpRelays, HIGH);  // Bomba desligada
+
+    // Custo da própria marca (bench_cycles; vazio nos outros ambientes)
+    CYCLE_BEGIN(CYCLE_CAL);
+    CYCLE_END(CYCLE_CAL);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// ADC (dashboard serial)
+//───────────────────────────────────────────────────────────────────────────
+// [ADC] ADCn=valor@Hz medido por canal, nominal, perdas e ocupação máxima do anel
+//───────────────────────────────────────────────────────────────────────────
+void printAdcStats() {
+    if (!(ADCSRA & _BV(ADEN))) return;
+    Serial.print(F("[ADC]"));
+    for (uint8_t i = 0; i < adcEngine.count(); i++) {
+        Serial.print(F(" ADC"));
+        Serial.print(adcEngine.channel(i));
+        Serial.print(F("="));
+        Serial.print(adcEngine.latest(i));
+        Serial.print(F("@"));
+        Serial.print(adcEngine.measuredHz(i));
+        Serial.print(F("Hz"));
+    }
+    Serial.print(F(" nominal "));
+    Serial.print(adcEngine.nominalHz());
+    Serial.print(F("Hz perdas "));
+    Serial.print(adcEngine.drops());
+    Serial.print(F(" anel "));
+    Serial.print(adcEngine.highWater());
+    Serial.print(F("/"));
+    Serial.println(ADC_RING_SIZE);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// PILHA (dashboard serial)
+//───────────────────────────────────────────────────────────────────────────
+// [RAM] bytes estáticos e folga mínima da pilha desde o boot / tamanho
+//───────────────────────────────────────────────────────────────────────────
+void printStackStats() {
+    Serial.print(F("[RAM] estatica "));
+    Serial.print(stackMon.staticBytes);
+    Serial.print(F(" pilha livre min "));
+    Serial.print(stackMon.minFree);
+    Serial.print(F("/"));
+    Serial.println(stackMon.sizeBytes);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// TEMPO DOS CALLBACKS DOS TIMERS (dashboard serial)
+//───────────────────────────────────────────────────────────────────────────
+// [TIMERS] slot: execuções, média/máximo em µs e maior atraso em ticks (ms).
+// Só aparecem os slots que já rodaram.
+//───────────────────────────────────────────────────────────────────────────
+void printTimerStats() {
+    bool any = false;
+    for (uint8_t i = 0; i < TIMER_SLOTS; i++) {
+        TimerStats st = timers.stats(i);
+        if (st.runs == 0) continue;
+        if (!any) Serial.print(F("[TIMERS]"));
+        any = true;
+        Serial.print(F(" #"));
+        Serial.print(i);
+        Serial.print(F(": "));
+        Serial.print(st.runs);
+        Serial.print(F("x "));
+        Serial.print(st.totalUs / st.runs);
+        Serial.print(F("/"));
+        Serial.print(st.maxUs);
+        Serial.print(F("us atraso "));
+        Serial.print(st.lateTicks);
+    }
+    if (any) Serial.println();
+}
+
+//═══════════════════════════════════════════════════════════════════════════
+// LOOP() - CICLO PRINCIPAL DO PROGRAMA
+//═══════════════════════════════════════════════════════════════════════════
+// Este loop executa continuamente após setup()
+// Processa mensagens CAN, monitora temperatura, controla aquisição, etc.
+//═══════════════════════════════════════════════════════════════════════════
+
+// ...existing code...
+
+void loop()
+{
+    CYCLE_BEGIN(CYCLE_LOOP);
+
+    // LED pisca = loop está rodando (Heartbeat visual)
+    static unsigned long lastBlink = 0;
+    static unsigned long loopCounter = 0;
+    loopCounter++;
+    
+    if(millis() - lastBlink > 1000) {
+        digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+        loopCounter = 0;
+        lastBlink = millis();
+    }
+    
+    // Amostras decimadas do ADC (anel de 32: ~13 ms de folga com 2 canais a 12 bits)
+    adcEngine.drain(millis());
+
+    // Histórico: amostra no período e um frame do download em andamento
+    historyRecord(millis());
+    historyPump();
+    isoTpPoll(micros());
+
+    // Folga da pilha: STACK_SCAN_CHUNK bytes por volta
+    stackPoll();
+    timeSync.poll(micros());
+
+    //═══════════════════════════════════════════════════════════════════════
+    // PROCESSAMENTO CAN (Prioridade Alta)
+    //═══════════════════════════════════════════════════════════════════════
+    
+    // Variável local para armazenar o ID limpo desta iteração
+    unsigned long currentFullId = 0; 
+
+    if(!digitalRead(CAN0_INT)) {
+        // Lê mensagem
+        canRxSnapshot();
+        if(CAN0.readMsgBuf(&rxId, &len, rxBuf) == MCP2515_OK) {
+            bool rxPrecise;
+            uint32_t rxUs = canRxTime(rxPrecise);
+            
+            // [CORREÇÃO CRÍTICA] Calcula o ID limpo AQUI, toda vez que chega mensagem
+            currentFullId = rxId & 0x1FFFFFFF; 
+            bool remote = rxId & 0x40000000;
+
+            // Carga do barramento e período/idade dos IDs rastreados
+            ingest.countFrame(rxId & 0x80000000, remote, len);
+            health.countRx();
+            migration.onRx();
+            ingest.onFrame(currentFullId, remote, millis());
+
+            // 0x080/0x081 - SINCRONIZAÇÃO DE TEMPO (mestre: cansync no host) → 0x431
+            if (!remote && currentFullId == TIMESYNC_SYNC_ID && len >= 1) {
+                timeSync.onSync(rxBuf[0], rxUs, rxPrecise);
+            }
+            if (!remote && currentFullId == TIMESYNC_FUP_ID && len >= 8) {
+                uint8_t seq;
+                uint64_t t1 = readTimeFollowUp(rxBuf, seq);
+                if (timeSync.onFollowUp(seq, t1)) publishTimeSync();
+            }
+            
+            if(currentFullId == Profile::nodeId){
+                Serial.println(F("!!! COMANDO DE UPDATE RECEBIDO - RESETANDO !!!"));
+                
+                // Envia uma confirmação rápida (opcional, mas bom para debug)
+                txBuf[0] = 0xAA; 
+                canSend(Profile::nodeId, 1, txBuf);
+                delay(100); // Dá tempo da mensagem sair
+
+                // --- O TRUQUE DO RESET ---
+                // Configura o Watchdog para estourar em 15ms
+                wdt_enable(WDTO_15MS);
+                
+                // Entra num loop infinito. O processador vai travar aqui,
+                // e 15ms depois o Watchdog vai resetar o hardware.
+                while(1) {} 
+            }
+
+            // --- TRATAMENTO DE MENSAGENS ESPECÍFICAS (Usando currentFullId) ---
+
+            // 0x401 - Debug
+            if(currentFullId == 0x401){
+                Serial.println(F("cmd: 0x401 (Debug)"));
+                canSend(0x401, sizeof(txBufDebug), txBufDebug);
+            }
+
+            // 0x402 - SAÍDAS DIGITAIS
+            // RTR (sem dados): só o estado real dos relés, sem reaplicar nada
+            if(currentFullId == 0x402 && len == 0){
+                publishOutputs(true);
+            }
+            else if(currentFullId == 0x402){
+                CYCLE_BEGIN(CYCLE_DIGITAL_CMD);
+                Serial.println(F("cmd: 0x402 (Saidas)"));
+                static int result[8];
+                readDigital(rxBuf, result);
+
+                Serial.println(F("Estados do result antes:"));
+                Serial.print(F("[ "));
+                for (size_t i = 0; i < 8; i++) {    
+                    Serial.print(result[i]);
+                    if (i < 7) Serial.print(F(", "));
+                }
+                
+                for (size_t i = 0; i < 8; i++){
+                    if(result[i] == 0) {
+                    digitalWrite(ledpins[i], LOW);
+                    Serial.print(F("Led "));
+                    Serial.print(ledpins[i]);
+                    Serial.println(F(" Ativado"));
+                }
+                    else if(result[i] == 1) {
+                        digitalWrite(ledpins[i], HIGH);
+                        Serial.print(F("Led "));
+                        Serial.print(ledpins[i]);
+                        Serial.println(F(" Desativado"));
+                }}
+
+                
+                // PWM e Encoder
+                int tPWM1 = readPWMEnc(rxBuf, 2);
+                int tPWM2 = readPWMEnc(rxBuf, 3);
+                int tEnc = readPWMEnc(rxBuf, 4);
+
+                if(tPWM1 >= 0) { PWM1_val = tPWM1; analogWrite(PWM1, PWM1_val); }
+                if(tPWM2 >= 0) { PWM2_val = tPWM2; analogWrite(PWM2, PWM2_val); }
+                if(tEnc >= 0) Enc = tEnc;
+
+                sendDigital(result, PWM1_val, PWM2_val, Enc, txBuf);
+                reportSend(RPT_OUTPUTS, 0x422, sizeof(txBuf), txBuf, false);
+                CYCLE_END(CYCLE_DIGITAL_CMD);
+            }
+
+
+            // 0x403 - CONFIG SEGURANÇA (CORRIGIDO E FORÇADO)
+            if(currentFullId == 0x403){
+                
+                // Se tiver dados na mensagem (Len > 0), atualiza as variáveis
+                if(len > 0) {
+                    Serial.println(F("\n--- COMANDO 0x403 RECEBIDO ---"));
+
+                    // 1/2. Atualiza Temp 1 e Temp 2 na memória
+                    safetyConfigStructure c1 = SafetyT1::get(), c2 = SafetyT2::get();
+                    readSafetyPair(rxBuf, c1, c2);
+                    SafetyT1::set(c1);
+                    SafetyT2::set(c2);
+
+                    // 3. Salva na EEPROM se estiver habilitado
+                    if(c1.Monit_Enable != 2) SafetyT1::save();
+                    if(c2.Monit_Enable != 2) SafetyT2::save();
+                    updateSamplePeriods();
+
+                    
+                    Serial.println(F(" -> Configuracoes salvas na RAM e EEPROM"));
+                } 
+
+                // 4. BUFFER DE RESPOSTA (0x423) - Sensor 1 nos bytes 0-3, Sensor 2 nos bytes 4-7
+                sendSafetyPair(SafetyT1::get(), SafetyT2::get(), txBuf);
+
+                // DEBUG: Mostra no terminal o que vai ser enviado
+                Serial.print(F(" > TX (0x423) HEX: "));
+                for(int i=0; i<8; i++) { 
+                    Serial.print(txBuf[i], HEX); 
+                    Serial.print(F(" ")); 
+                }
+                Serial.println();
+
+                // Envia a resposta (Força tamanho 8 bytes) se mudou ou se foi RTR
+                reportSend(RPT_SAFETY12, 0x423, 8, txBuf, len == 0);
+            }
+
+            // 0x404 - CONFIG AQUISIÇÃO
+    // 0x404 - CONFIGURAÇÃO DE TAXA DE AQUISIÇÃO (Manual & Seguro)
+            if(currentFullId == 0x404){
+                
+                // CASO 1: Tem dados? Então é para GRAVAR (SET)
+                if(len > 0) {
+                   Serial.println(F("\n--- COMANDO 0x404 RECEBIDO ---"));
+                    
+                    // Timer (Bytes 0 e 1), Analógico (Byte 2) e BIT DE CONTÍNUO (Byte 3, bit 2)
+                    // Se você mandar 0x00 no byte 3, o bit 2 será 0 -> DESLIGA O MODO CONTÍNUO
+                    aquisc = readAquisitionFrame(rxBuf, aquisc);
+                    adcStart();   // analog liga/desliga o ADC em free-running
+                    
+                    Serial.print(F(" > Modo Continuo alterado para: "));
+                    Serial.println(aquisc.Aquics_Enable_Continuous ? F("LIGADO") : F("DESLIGADO"));
+                }
+                // CASO 2: Sem dados (RTR)? Então é apenas LEITURA (GET)
+                else {
+                    Serial.println(F("cmd: 0x404 (Ler Status - RTR)"));
+                }
+
+                // --- RESPOSTA (0x424) ---
+                // Sempre responde com o estado atual das variáveis
+                sendAquisitionFrame(aquisc, txBuf);
+                
+                canSend(0x424, 8, txBuf);
+                Serial.println(F(" > Resposta 0x424 enviada"));
+            }
+            // 0x405 - START/STOP (Dual Mode: Set & Get)
+            if(currentFullId == 0x405){
+                
+                // CASO 1: Data Frame -> ALTERA O ESTADO
+                if(len > 0) {
+                    Serial.println(F("\n--- COMANDO 0x405 (START/STOP) ---"));
+                    
+                    // --- DEBUG: ESTADO ANTERIOR ---
+                    Serial.print(F(" > Estado ANTERIOR: "));
+                    if(aquisc.Aquics_Enable == 1) Serial.println(F("LIGADO (Run)"));
+                    else Serial.println(F("DESLIGADO (Stop)"));
+
+                    // Lógica de leitura (Mantendo o deslocamento de bits original)
+                    // Lembra: 0x40 (bin 01000000) >> 6 vira 1.
+                    uint8_t rawByte = rxBuf[0];
+                    uint8_t EnableBuf = readStartStop(rxBuf); 
+                    
+                    // --- DEBUG: O QUE CHEGOU ---
+                    Serial.print(F(" > Byte Recebido:   0x"));
+                    Serial.print(rawByte, HEX);
+                    Serial.print(F(" (Interpretado como: "));
+                    Serial.print(EnableBuf);
+                    Serial.println(F(")"));
+
+                    // Aplica a mudança se for válida (0 ou 1)
+                    if(EnableBuf < 2) {
+                        aquisc.Aquics_Enable = EnableBuf;
+                        
+                        // --- DEBUG: ESTADO NOVO ---
+                        Serial.print(F(" > Estado NOVO:     ")); 
+                        if(aquisc.Aquics_Enable == 1) Serial.println(F("LIGADO (START)"));
+                        else Serial.println(F("DESLIGADO (STOP)"));
+                    } else {
+                        Serial.println(F(" > ERRO: Valor invalido recebido (Ignorado)"));
+                    }
+                }
+                // CASO 2: Remote Frame -> APENAS LEITURA
+                else {
+                    Serial.print(F("cmd: 0x405 (Ler Status - RTR) -> Atualmente: "));
+                    Serial.println(aquisc.Aquics_Enable ? F("ON") : F("OFF"));
+                }
+
+                // SEMPRE RESPONDE 0x425
+                sendStartStop(aquisc.Aquics_Enable, txBuf); // Empacota de volta para o bit 6
+                canSend(0x425, 8, txBuf);
+                Serial.println(F(" > Resposta 0x425 enviada"));
+            }
+
+            // 0x510/0x520/0x530 - LEITURA DE TEMPERATURA (CANmod.Temp 1-3)
+            // Cada canal consome o frame se for o módulo do seu perfil
+            // (RTRs de outros nós para esses IDs não têm dados e são ignorados)
+            if (!remote && (currentFullId == 0x510 || currentFullId == 0x520 || currentFullId == 0x530)){
+                CYCLE_BEGIN(CYCLE_TEMP_READ);
+                tempS = tempRead(rxBuf);
+                CYCLE_END(CYCLE_TEMP_READ);
+                SensorState &sensors = sensorState.edit();
+                CYCLE_BEGIN(CYCLE_FILTER);
+                uint8_t usedMask = (SafetyT1::onTemperature(currentFullId, tempS, sensors) << 0) |
+                                   (SafetyT2::onTemperature(currentFullId, tempS, sensors) << 1) |
+                                   (SafetyT3::onTemperature(currentFullId, tempS, sensors) << 2) |
+                                   (SafetyT4::onTemperature(currentFullId, tempS, sensors) << 3);
+                CYCLE_END(CYCLE_FILTER);
+                bool used = usedMask != 0;
+                if (used) {
+                    sensorState.publish();
+                    // Tempo da amostra = chegada do frame do módulo
+                    for (uint8_t ch = 0; ch < 4; ch++) {
+                        if (usedMask & (1 << ch)) publishStamped(STAMP_T1 + ch, (int16_t)(sensors.temp[ch] * 4), rxUs);
+                    }
+                    timetempmess = millis();
+                    updateSamplePeriods();
+                }
+            }
+
+            // 0x407 - MODO DE INGESTÃO (Set & Get) → resposta 0x427
+            if (currentFullId == 0x407){
+                if (len > 0) {
+                    uint8_t mode = readIngestMode(rxBuf);
+                    if (mode < 2) ingest.mode = (IngestMode)mode;
+                    Serial.print(F("cmd: 0x407 -> Ingestao: "));
+                    Serial.println(ingest.mode == INGEST_PUSH ? F("PUSH") : F("POLLING"));
+                }
+                ingestStatusStructure status;
+                status.mode = ingest.mode;
+                status.pushMask = ingest.pushMask();
+                status.freshMask = ingest.freshMask(millis(), aquisc.timer);
+                status.loadPermille = ingest.loadPermille();
+                status.pollLoadPermille = ingest.pollLoadPermille();
+                status.rtrSent = ingest.rtrSentLast();
+                status.rtrSkipped = ingest.rtrSkippedLast();
+                sendIngestStatus(status, txBuf);
+                canSend(0x427, 8, txBuf);
+            }
+
+            // 0x408 - IDADE MÁXIMA DAS TEMPERATURAS (Set & Get) → resposta 0x428
+            if (currentFullId == 0x408){
+                if (len > 0) {
+                    freshc = readFreshnessConfig(rxBuf, freshc);
+                    updateEEPROMUInt16(EEPROM_MAXAGE_ADDR, freshc.maxAgeMs);
+                    updateEEPROMUInt8(EEPROM_STALEACT_ADDR, freshc.action);
+                    Serial.print(F("cmd: 0x408 -> Idade max: "));
+                    Serial.print(freshc.maxAgeMs);
+                    Serial.print(F(" ms, acao: "));
+                    Serial.println(freshc.action);
+                }
+                publishFreshness(millis());
+            }
+
+            // 0x40A - RELATÓRIO POR MUDANÇA (Set) + SNAPSHOT COMPLETO (sempre)
+            if (currentFullId == 0x40A){
+                if (len > 0) {
+                    reportConfigStructure rc;
+                    rc.mode = reporter.mode;
+                    rc.heartbeatS = reporter.heartbeatS;
+                    rc = readReportConfig(rxBuf, rc);
+                    reporter.mode = (ReportMode)rc.mode;
+                    reporter.heartbeatS = rc.heartbeatS;
+                    Serial.print(F("cmd: 0x40A -> Relatorio: "));
+                    Serial.println(reporter.mode == REPORT_ON_CHANGE ? F("POR MUDANCA") : F("SEMPRE"));
+                }
+                publishSnapshot();
+            }
+
+            // 0x40B - SAÚDE DO BARRAMENTO (RTR) → resposta 0x42B
+            if (currentFullId == 0x40B){
+                publishBusHealth();
+            }
+
+            // 0x40C - MIGRAÇÃO DE BITRATE (Set & Get) → resposta 0x42C
+            // Broadcast do supervisor: todos os nós trocam depois da mesma espera
+            if (currentFullId == 0x40C){
+                if (len >= 3 && !remote) {
+                    bitrateCommandStructure cmd = readBitrateCommand(rxBuf);
+                    if (migration.request(cmd.target, cmd.delayMs, millis())) {
+                        Serial.print(F("cmd: 0x40C -> Bitrate "));
+                        Serial.print(BitrateMigration::bitsPerSecond(cmd.target) / 1000);
+                        Serial.print(F(" kbps em "));
+                        Serial.print(migration.remainingMs(millis()));
+                        Serial.println(F(" ms"));
+                    }
+                }
+                publishBitrate();
+            }
+
+            // 0x40D - CONTAGEM DE PULSOS (Set & Get) → resposta 0x42D
+            if (currentFullId == 0x40D){
+                if (len >= 7 && !remote) {
+                    pulsec = readPulseConfig(rxBuf, pulsec);
+                    savePulseConfig();
+                    pulseStart();
+                    Serial.print(F("cmd: 0x40D -> Pulsos: mascara "));
+                    Serial.print(pulsec.enableMask);
+                    Serial.print(F(", janelas "));
+                    Serial.print(pulsec.gateMs[0]);
+                    Serial.print(F("/"));
+                    Serial.print(pulsec.gateMs[1]);
+                    Serial.println(F(" ms"));
+                }
+                publishPulse(true);
+            }
+
+            // 0x40F - HISTÓRICO (status/download/cancela/limpa) → 0x42F (+ 0x430)
+            if (currentFullId == 0x40F){
+                uint8_t cmd = (len > 0 && !remote) ? rxBuf[0] : HISTORY_CMD_STATUS;
+                if (cmd == HISTORY_CMD_START && !historyIsoTp) {
+                    history.begin();
+                    historySeq = 0;
+                    historyState = HISTORY_SENDING;
+                    Serial.print(F("cmd: 0x40F -> Download do historico: "));
+                    Serial.print(history.length());
+                    Serial.println(F(" bytes"));
+                } else if (cmd == HISTORY_CMD_ABORT && history.downloading() && !historyIsoTp) {
+                    history.abort();
+                    historyState = HISTORY_ABORTED;
+                } else if (cmd == HISTORY_CMD_CLEAR && !historyIsoTp) {
+                    history.clear();
+                    historyState = HISTORY_IDLE;
+                    Serial.println(F("cmd: 0x40F -> Historico apagado"));
+                }
+                publishHistory();
+                // Download vazio termina na hora
+                if (historyState == HISTORY_SENDING && !history.downloading()) {
+                    historyState = HISTORY_DONE;
+                    publishHistory();
+                }
+            }
+
+            // 0x400 - ISO-TP (pedido segmentado) → respostas no 0x420
+            if (currentFullId == 0x400 && !remote){
+                isotp.onFrame(rxBuf, len, micros());
+            }
+
+            // 0x40E - ADC INTERNO (Set & Get) → resposta 0x42E
+            if (currentFullId == 0x40E){
+                if (len >= 3 && !remote) {
+                    adcc = readAdcConfig(rxBuf, adcc);
+                    saveAdcConfig();
+                    adcStart();
+                    Serial.print(F("cmd: 0x40E -> ADC: mascara 0x"));
+                    Serial.print(adcEngine.mask(), HEX);
+                    Serial.print(F(", "));
+                    Serial.print(10 + adcEngine.oversampleBits());
+                    Serial.print(F(" bits, "));
+                    Serial.print(adcEngine.nominalHz());
+                    Serial.println(F(" Hz/canal"));
+                }
+                publishAdc();
+            }
+
+            // 0x409 - AQUISIÇÃO ADAPTATIVA (Set & Get) → resposta 0x429
+            if (currentFullId == 0x409){
+                if (len > 0) {
+                    sampler.config = readSamplingConfig(rxBuf, sampler.config);
+                    updateSamplePeriods();
+                    Serial.print(F("cmd: 0x409 -> Aquisicao adaptativa: "));
+                    Serial.println(sampler.config.enabled ? F("LIGADA") : F("DESLIGADA"));
+                }
+                publishSampling();
+            }
+
+            if (currentFullId == 0x406){
+                if(len>0){
+                    Serial.println(F("cmd: 0x406 (Intercooler)"));
+                    safetyConfigStructure c3 = SafetyT3::get(), c4 = SafetyT4::get();
+                    readSafetyPair(rxBuf, c3, c4);
+                    SafetyT3::set(c3);
+                    SafetyT4::set(c4);
+                    if(c3.Monit_Enable != 2) SafetyT3::save();
+                    if(c4.Monit_Enable == 1) SafetyT4::save();
+                    updateSamplePeriods();
+                    Serial.println(F(" -> Configuracoes salvas na RAM e EEPROM"));
+                }
+                sendSafetyPair(SafetyT3::get(), SafetyT4::get(), txBuf);
+                Serial.print(F(" > TX (0x426) HEX: "));
+                for(int i=0; i<8; i++) { 
+                    Serial.print(txBuf[i], HEX); 
+                    Serial.print(F(" "));
+                }
+                Serial.println();
+                reportSend(RPT_SAFETY34, 0x426, 8, txBuf, len == 0);
+            }
+        } 
+    }
+
+    //═══════════════════════════════════════════════════════════════════════
+    // SISTEMA DE AQUISIÇÃO PERIÓDICA
+    //═══════════════════════════════════════════════════════════════════════
+    // No modo contínuo com aquisição adaptativa, cada ID tem o seu período
+    // (sampler); senão todos seguem aquisc.timer como antes.
+    bool adaptive = sampler.config.enabled && aquisc.Aquics_Enable_Continuous;
+
+    if((aquisc.Aquics_Enable || aquisc.Aquics_Enable_Continuous) && acquisitionDue()){
+        
+        timeaquisition = millis();
+        uint32_t acquisitionUs = micros();
+        if (aquisc.Aquics_Enable == 1) aquisc.Aquics_Enable = 0;
+        
+        // RTR só para os IDs que não chegaram sozinhos dentro do período
+        for (uint8_t i = 0; i < ingest.size() && !adaptive; i++){
+            if (!ingest.slot(i).rtrFallback) continue;
+            if (ingest.needsRtr(i, timeaquisition, aquisc.timer)) {
+                canSend(remoteIDs[i], 0, NULL);
+                ingest.rtrSent(i, timeaquisition);
+                delayMicroseconds(100);
+            } else {
+                ingest.rtrSkipped(i);
+            }
+        }
+        
+        // Bytes 0-1: escala de 8 bits de sempre; 2-5: média decimada com
+        // 10 + k bits (BE); 6: bits de resolução
+        uint16_t rawPress = adcEngine.latestOf(ADC_DOWNPIPE_CH);
+        uint16_t rawValve = adcEngine.latestOf(ADC_VALVE_CH);
+        downpipePress = rawPress * DOWNPIPE_FULL_BAR / adcEngine.fullScale();
+        valvPos = rawValve * VALVE_FULL_PCT / adcEngine.fullScale();
+        static byte aquisData[8];
+        aquisData[0] = (byte)((downpipePress * 255) / DOWNPIPE_FULL_BAR);
+        aquisData[1] = (byte)((valvPos * 255) / VALVE_FULL_PCT);
+        aquisData[2] = rawPress >> 8;
+        aquisData[3] = rawPress & 0xFF;
+        aquisData[4] = rawValve >> 8;
+        aquisData[5] = rawValve & 0xFF;
+        aquisData[6] = 10 + adcEngine.oversampleBits();
+        reportSend(RPT_AQUIS, 0x426, 8, aquisData, false);
+        publishStamped(STAMP_DOWNPIPE, rawPress, acquisitionUs);
+        publishStamped(STAMP_VALVE, rawValve, acquisitionUs);
+        if (pulsec.enableMask) publishPulse(false);
+    } 
+
+    if (adaptive) {
+        uint32_t now = millis();
+        for (uint8_t i = 0; i < ingest.size(); i++){
+            if (!ingest.slot(i).rtrFallback || !sampler.due(i, now)) continue;
+            sampler.sampled(i, now);
+            if (ingest.needsRtr(i, now, sampler.period(i))) {
+                canSend(remoteIDs[i], 0, NULL);
+                ingest.rtrSent(i, now);
+            } else {
+                ingest.rtrSkipped(i);
+            }
+        }
+    }
+
+    ingest.update(millis());
+
+    //═══════════════════════════════════════════════════════════════════════
+    // SAÚDE DO BARRAMENTO: TEC/REC/EFLG a cada 100 ms, 0x42B a cada 1 s
+    //═══════════════════════════════════════════════════════════════════════
+    static uint32_t lastHealthSample = 0, lastHealthPublish = 0;
+    if (millis() - lastHealthSample >= BUSHEALTH_SAMPLE_MS) {
+        lastHealthSample = millis();
+        bool wasOff = health.busOff();
+        uint8_t tec, rec;
+        CAN0.errorCounts(tec, rec);
+        uint8_t eflg = CAN0.getError();
+        bool off = health.sample(tec, rec, eflg, lastHealthSample);
+        // Overflow já contado em eflgSeen: limpa para ver o próximo
+        if (eflg & (EFLG_RX0OVR | EFLG_RX1OVR)) CAN0.clearOverflow();
+        if (off && !wasOff) Serial.println(F("!!! CAN BUS-OFF !!!"));
+        if (health.recoveryDue(lastHealthSample)) {
+            health.recoveryAttempted(lastHealthSample);
+            historyEvent(HIST_EV_BUSOFF, health.recoveries());
+            Serial.print(F("CAN: reiniciando MCP2515 (proxima espera "));
+            Serial.print(health.backoffMs());
+            Serial.println(F(" ms)"));
+            canStart();
+        }
+        if (!off && wasOff) {
+            Serial.println(F("INFO: CAN recuperado do bus-off"));
+            reporter.invalidate();   // Frames de estado perdidos no bus-off saem de novo
+            publishBusHealth();
+        }
+
+        // Troca combinada e teste do bitrate novo (mesma amostra de EFLG)
+        uint8_t action = migration.poll(health.eflg(), lastHealthSample);
+        if (action & MIGRATION_APPLY) {
+            Serial.print(F("CAN: trocando para "));
+            Serial.print(BitrateMigration::bitsPerSecond(migration.current()) / 1000);
+            Serial.println(migration.state() == MIGRATION_FALLBACK ? F(" kbps (teste falhou)") : F(" kbps"));
+            canStart();
+            updateSamplePeriods();
+            historyEvent(HIST_EV_BITRATE, migration.current());
+        }
+        if (action & MIGRATION_PERSIST) {
+            updateEEPROMUInt8(EEPROM_BITRATE_ADDR, migration.current());
+        }
+        if (action) publishBitrate();
+    }
+    health.update(millis());
+    if (millis() - lastHealthPublish >= 1000) {
+        lastHealthPublish = millis();
+        if (!health.busOff()) publishBusHealth();
+    }
+    if (reporter.heartbeatDue(millis())) publishHeartbeat();
+
+    //═══════════════════════════════════════════════════════════════════════
+    // MONITOR DE SEGURANÇA E TIMERS
+    //═══════════════════════════════════════════════════════════════════════
+    
+    // Um único instante para limites e idade de todos os canais
+    uint32_t monitorNow = millis();
+    uint8_t trippedMask = (SafetyT1::monitor(monitorNow) << 0) | (SafetyT2::monitor(monitorNow) << 1) |
+                          (SafetyT3::monitor(monitorNow) << 2) | (SafetyT4::monitor(monitorNow) << 3);
+    if (trippedMask != sensorState.get().trippedMask) {
+        sensorState.edit().trippedMask = trippedMask;
+        sensorState.publish();
+    }
+
+    static uint8_t lastStaleMask = 0;
+    if (staleMask() != lastStaleMask) {
+        lastStaleMask = staleMask();
+        publishFreshness(monitorNow);
+    }
+
+    //═══════════════════════════════════════════════════════════════════════
+    // CONTROLE DE MOTOR
+    //═══════════════════════════════════════════════════════════════════════
+    CYCLE_BEGIN(CYCLE_MOTOR);
+    setMotor(dir, pwmVal);
+    CYCLE_END(CYCLE_MOTOR);
+    
+    //═══════════════════════════════════════════════════════════════════════
+    // DASHBOARD SERIAL
+    //═══════════════════════════════════════════════════════════════════════
+    static unsigned long lastDebugPrint = 0;
+    if(millis() - lastDebugPrint >= 500) {
+        lastDebugPrint = millis();
+        
+        AlarmState alarms;
+        alarmState.read(alarms);
+        Serial.print(F("[STATUS]"));
+        SafetyT1::printStatus(alarms);
+        SafetyT2::printStatus(alarms);
+        SafetyT3::printStatus(alarms);
+        SafetyT4::printStatus(alarms);
+        Serial.println();
+        printTimerStats();
+        printAdcStats();
+        printStackStats();
+    }
+
+    // Limpa IDs para próximo ciclo
+    rxId = 0;
+    CYCLE_END(CYCLE_LOOP);
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "mcp2515.h"
+
+#include <SPI.h>
+
+//───────────────────────────────────────────────────────────────────────────
+// INSTRUÇÕES SPI
+//───────────────────────────────────────────────────────────────────────────
+#define INSTR_RESET       0xC0
+#define INSTR_READ        0x03
+#define INSTR_WRITE       0x02
+#define INSTR_BITMOD      0x05
+#define INSTR_READ_STATUS 0xA0
+#define INSTR_READ_RXB0   0x90   // Começa em RXB0SIDH
+#define INSTR_READ_RXB1   0x94   // Começa em RXB1SIDH
+#define INSTR_LOAD_TXB0   0x40   // Começa em TXB0SIDH
+#define INSTR_RTS_TXB0    0x81
+
+// Bits do READ STATUS
+#define STATUS_RX0IF      0x01
+#define STATUS_RX1IF      0x02
+#define STATUS_TX0REQ     0x04
+
+// SIDL/DLC
+#define SIDL_EXIDE        0x08
+#define SIDL_SRR          0x10   // RTR de frame standard recebido
+#define DLC_RTR           0x40
+
+static const SPISettings kSpi(8000000, MSBFIRST, SPI_MODE0);
+
+// CNF3, CNF2, CNF1 (ordem do endereço 0x28 em diante) para cristal de 8 MHz.
+// 500 kbps: TQ de 250 ns, 8 TQ (sync 1 + prop 1 + PS1 3 + PS2 3).
+// 1 Mbps: 4 TQ, fora da faixa 8-25 da norma (ver bitrate.h).
+static const uint8_t kCnf[2][3] = {
+    {0x82, 0x90, 0x00},   // MCP2515_500KBPS
+    {0x80, 0x80, 0x00},   // MCP2515_1000KBPS
+};
+
+//───────────────────────────────────────────────────────────────────────────
+// TRANSAÇÕES
+//───────────────────────────────────────────────────────────────────────────
+void Mcp2515::select() {
+    SPI.beginTransaction(kSpi);
+    *csPort_ &= ~csMask_;
+}
+
+void Mcp2515::deselect() {
+    *csPort_ |= csMask_;
+    SPI.endTransaction();
+}
+
+uint8_t Mcp2515::readStatus() {
+    select();
+    SPI.transfer(INSTR_READ_STATUS);
+    uint8_t status = SPI.transfer(0);
+    deselect();
+    return status;
+}
+
+uint8_t Mcp2515::readRegister(uint8_t reg) {
+    select();
+    SPI.transfer(INSTR_READ);
+    SPI.transfer(reg);
+    uint8_t value = SPI.transfer(0);
+    deselect();
+    return value;
+}
+
+void Mcp2515::writeRegisters(uint8_t reg, const uint8_t *values, uint8_t n) {
+    select();
+    SPI.transfer(INSTR_WRITE);
+    SPI.transfer(reg);
+    for (uint8_t i = 0; i < n; i++) SPI.transfer(values[i]);   // Endereço auto-incrementa
+    deselect();
+}
+
+void Mcp2515::modifyRegister(uint8_t reg, uint8_t mask, uint8_t value) {
+    select();
+    SPI.transfer(INSTR_BITMOD);
+    SPI.transfer(reg);
+    SPI.transfer(mask);
+    SPI.transfer(value);
+    deselect();
+}
+
+void Mcp2515::errorCounts(uint8_t &tec, uint8_t &rec) {
+    select();
+    SPI.transfer(INSTR_READ);
+    SPI.transfer(REG_TEC);
+    tec = SPI.transfer(0);
+    rec = SPI.transfer(0);   // REC vem logo depois do TEC
+    deselect();
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// INICIALIZAÇÃO
+//───────────────────────────────────────────────────────────────────────────
+uint8_t Mcp2515::begin(Mcp2515Bitrate bitrate) {
+    csPort_ = portOutputRegister(digitalPinToPort(csPin_));
+    csMask_ = digitalPinToBitMask(csPin_);
+    pinMode(csPin_, OUTPUT);
+    *csPort_ |= csMask_;
+    SPI.begin();
+
+    select();
+    SPI.transfer(INSTR_RESET);
+    deselect();
+    delay(10);   // Oscilador estável; o reset deixa o chip em modo de configuração
+
+    if ((readRegister(REG_CANSTAT) & 0xE0) != MCP2515_CONFIG) return MCP2515_FAIL;
+
+    writeRegisters(REG_CNF3, kCnf[bitrate == MCP2515_1000KBPS], 3);
+
+    // Filtros e máscaras zerados: aceita tudo (RXF0-2, RXF3-5, RXM0-1)
+    static const uint8_t zeros[12] = {0};
+    writeRegisters(0x00, zeros, 12);
+    writeRegisters(0x10, zeros, 12);
+    writeRegisters(REG_RXM0SIDH, zeros, 8);
+
+    writeRegister(REG_RXB0CTRL, 0x64);   // RXM = qualquer frame, BUKT = rollover para RXB1
+    writeRegister(REG_RXB1CTRL, 0x60);
+    writeRegister(REG_CANINTF, 0);
+    writeRegister(REG_CANINTE, STATUS_RX0IF | STATUS_RX1IF);   // INT em RX0IE/RX1IE
+
+    // CNF2 lido de volta confirma que o SPI e o chip respondem
+    return readRegister(REG_CNF3 + 1) == kCnf[bitrate == MCP2515_1000KBPS][1] ? MCP2515_OK : MCP2515_FAIL;
+}
+
+uint8_t Mcp2515::setMode(Mcp2515Mode mode) {
+    modifyRegister(REG_CANCTRL, 0xE0, mode);
+    unsigned long start = millis();
+    while ((readRegister(REG_CANSTAT) & 0xE0) != mode) {
+        if (millis() - start > 10) return MCP2515_FAIL;
+    }
+    return MCP2515_OK;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// RECEPÇÃO
+//───────────────────────────────────────────────────────────────────────────
+uint8_t Mcp2515::checkReceive() {
+    return (readStatus() & (STATUS_RX0IF | STATUS_RX1IF)) ? MCP2515_OK : MCP2515_NOMSG;
+}
+
+uint8_t Mcp2515::readMsgBuf(unsigned long *id, uint8_t *len, uint8_t *buf) {
+    uint8_t status = readStatus();
+    uint8_t instr;
+    if (status & STATUS_RX0IF) instr = INSTR_READ_RXB0;
+    else if (status & STATUS_RX1IF) instr = INSTR_READ_RXB1;
+    else return MCP2515_NOMSG;
+
+    // Uma transação: SIDH SIDL EID8 EID0 DLC D0..D7
+    select();
+    SPI.transfer(instr);
+    uint8_t sidh = SPI.transfer(0);
+    uint8_t sidl = SPI.transfer(0);
+    uint8_t eid8 = SPI.transfer(0);
+    uint8_t eid0 = SPI.transfer(0);
+    uint8_t dlc = SPI.transfer(0);
+    uint8_t n = dlc & 0x0F;
+    if (n > 8) n = 8;
+
+    unsigned long frameId;
+    bool rtr;
+    if (sidl & SIDL_EXIDE) {
+        frameId = ((unsigned long)sidh << 21) | ((unsigned long)(sidl & 0xE0) << 13) |
+                  ((unsigned long)(sidl & 0x03) << 16) | ((unsigned long)eid8 << 8) | eid0;
+        frameId |= 0x80000000UL;
+        rtr = dlc & DLC_RTR;
+    } else {
+        frameId = ((unsigned long)sidh << 3) | (sidl >> 5);
+        rtr = sidl & SIDL_SRR;
+    }
+    if (rtr) {
+        frameId |= 0x40000000UL;
+    } else {
+        for (uint8_t i = 0; i < n; i++) buf[i] = SPI.transfer(0);
+    }
+    deselect();   // Limpa o RXnIF do buffer lido
+
+    *id = frameId;
+    *len = n;
+    return MCP2515_OK;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// TRANSMISSÃO
+//───────────────────────────────────────────────────────────────────────────
+uint8_t Mcp2515::sendMsgBuf(unsigned long id, uint8_t len, const uint8_t *buf) {
+    // Espera o frame anterior sair (ver cabeçalho: só TXB0, ordem preservada)
+    if (readStatus() & STATUS_TX0REQ) {
+        unsigned long start = micros();
+        while (readStatus() & STATUS_TX0REQ) {
+            if (micros() - start > MCP2515_TX_TIMEOUT_US) {
+                // Bus-off ou barramento sem ACK: aborta o pendente para não travar
+                modifyRegister(REG_TXB0CTRL, 0x08, 0);
+                if (txTimeouts_ < 0xFFFF) txTimeouts_++;
+                return MCP2515_TXBUSY;
+            }
+        }
+    }
+
+    if (len > 8) len = 8;
+    bool rtr = id & 0x40000000UL;
+    uint8_t sidh, sidl, eid8 = 0, eid0 = 0;
+    if (id & 0x80000000UL) {
+        unsigned long ext = id & 0x1FFFFFFFUL;
+        sidh = ext >> 21;
+        sidl = ((ext >> 13) & 0xE0) | SIDL_EXIDE | ((ext >> 16) & 0x03);
+        eid8 = ext >> 8;
+        eid0 = ext;
+    } else {
+        unsigned long sid = id & 0x7FF;
+        sidh = sid >> 3;
+        sidl = (sid & 0x07) << 5;
+    }
+
+    // Uma transação: SIDH SIDL EID8 EID0 DLC D0..D7
+    select();
+    SPI.transfer(INSTR_LOAD_TXB0);
+    SPI.transfer(sidh);
+    SPI.transfer(sidl);
+    SPI.transfer(eid8);
+    SPI.transfer(eid0);
+    SPI.transfer(len | (rtr ? DLC_RTR : 0));
+    if (!rtr) {
+        for (uint8_t i = 0; i < len; i++) SPI.transfer(buf[i]);
+    }
+    deselect();
+
+    select();
+    SPI.transfer(INSTR_RTS_TXB0);
+    deselect();
+    return MCP2515_OK;
+}
@@ -0,0 +1,125 @@
+#include "objdict.h"
+
+#include <string.h>
+
+static void putBE32(uint8_t *out, uint32_t v) {
+    out[0] = v >> 24;
+    out[1] = v >> 16;
+    out[2] = v >> 8;
+    out[3] = v;
+}
+
+bool ObjectDictionary::find(uint8_t index, ParamDef &def) const {
+    if (index >= count_) return false;
+#ifdef ARDUINO
+    memcpy_P(&def, &table_[index], sizeof(def));
+#else
+    def = table_[index];
+#endif
+    return true;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// VALOR NA RAM ↔ FORMATO DO FIO
+//───────────────────────────────────────────────────────────────────────────
+uint32_t ObjectDictionary::load(const ParamDef &def) {
+    const uint8_t *p = (const uint8_t *)def.base + def.offset;
+    switch (def.type) {
+        case PARAM_U8:  return *p;
+        case PARAM_U16: { uint16_t v; memcpy(&v, p, 2); return v; }
+        case PARAM_I16: { int16_t v; memcpy(&v, p, 2); return (uint32_t)(int32_t)v; }
+        default:        { uint32_t v; memcpy(&v, p, 4); return v; }   // U32 e F32 (bits)
+    }
+}
+
+void ObjectDictionary::store(const ParamDef &def, uint32_t wire) {
+    uint8_t *p = (uint8_t *)def.base + def.offset;
+    switch (def.type) {
+        case PARAM_U8:  *p = (uint8_t)wire; break;
+        case PARAM_U16:
+        case PARAM_I16: { uint16_t v = (uint16_t)wire; memcpy(p, &v, 2); break; }
+        default:        memcpy(p, &wire, 4); break;
+    }
+}
+
+float ObjectDictionary::asFloat(uint8_t type, uint32_t wire) {
+    switch (type) {
+        case PARAM_I16: return (float)(int32_t)wire;
+        case PARAM_F32: { float f; memcpy(&f, &wire, 4); return f; }
+        default:        return (float)wire;
+    }
+}
+
+uint8_t ObjectDictionary::read(uint8_t index, uint32_t &wire, ParamDef &def) const {
+    if (!find(index, def) || !def.base) return PARAM_NO_INDEX;
+    wire = load(def);
+    return PARAM_OK;
+}
+
+uint8_t ObjectDictionary::write(uint8_t index, uint32_t wire, ParamDef &def) const {
+    if (!find(index, def) || !def.base) return PARAM_NO_INDEX;
+    if (!(def.flags & PARAM_WRITE)) return PARAM_READ_ONLY;
+    // Inteiros maiores que o tipo não podem passar truncados pela faixa
+    if ((def.type == PARAM_U8 && wire > 0xFF) || (def.type == PARAM_U16 && wire > 0xFFFF) ||
+        (def.type == PARAM_I16 && ((int32_t)wire < -32768 || (int32_t)wire > 32767))) {
+        return PARAM_OUT_OF_RANGE;
+    }
+    float v = asFloat(def.type, wire);
+    if (!(v >= def.min && v <= def.max)) return PARAM_OUT_OF_RANGE;   // NaN também cai aqui
+    if (def.step > 1 && def.type != PARAM_F32 && (int32_t)wire % def.step != 0) return PARAM_OUT_OF_RANGE;
+    store(def, wire);
+    return PARAM_OK;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// SERVIÇOS EM MASSA
+//───────────────────────────────────────────────────────────────────────────
+void ObjectDictionary::valueRecord(uint8_t index, uint8_t *rec) const {
+    ParamDef def;
+    uint32_t wire = 0;
+    rec[0] = read(index, wire, def) == PARAM_OK ? def.type : (uint8_t)PARAM_ABSENT;
+    putBE32(rec + 1, wire);
+}
+
+void ObjectDictionary::describeRecord(uint8_t index, uint8_t *rec) const {
+    ParamDef def;
+    memset(rec, 0, PARAM_DESCRIBE_BYTES);
+    rec[0] = index;
+    if (!find(index, def)) return;
+    uint32_t bits;
+    rec[1] = def.base ? def.type : (uint8_t)PARAM_ABSENT;
+    rec[2] = def.flags;
+    memcpy(&bits, &def.min, 4);
+    putBE32(rec + 3, bits);
+    memcpy(&bits, &def.max, 4);
+    putBE32(rec + 7, bits);
+    memcpy(rec + 11, def.name, PARAM_NAME_LEN);
+}
+
+uint8_t ObjectDictionary::valueBytes(uint8_t first, uint16_t offset, uint8_t *out, uint8_t n) const {
+    uint8_t rec[PARAM_VALUE_BYTES];
+    int16_t cached = -1;
+    for (uint8_t i = 0; i < n; i++) {
+        uint16_t r = (offset + i) / PARAM_VALUE_BYTES;
+        if ((int16_t)r != cached) {
+            valueRecord(first + r, rec);
+            cached = r;
+        }
+        out[i] = rec[(offset + i) % PARAM_VALUE_BYTES];
+    }
+    return n;
+}
+
+uint8_t ObjectDictionary::describeBytes(uint8_t first, uint16_t offset, uint8_t *out, uint8_t n) const {
+    uint8_t rec[PARAM_DESCRIBE_BYTES];
+    int16_t cached = -1;
+    for (uint8_t i = 0; i < n; i++) {
+        uint16_t r = (offset + i) / PARAM_DESCRIBE_BYTES;
+        if ((int16_t)r != cached) {
+            describeRecord(first + r, rec);
+            cached = r;
+        }
+        out[i] = rec[(offset + i) % PARAM_DESCRIBE_BYTES];
+    }
+    return n;
+}
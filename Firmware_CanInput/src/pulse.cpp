@@ -0,0 +1,20 @@
+#include "pulse.h"
+
+namespace PulseMeter {
+
+uint16_t frequencyHz(uint16_t edges, uint16_t gateMs) {
+    if (gateMs == 0) return 0;
+    // 65535 * 1000 cabe em 32 bits
+    uint32_t hz = ((uint32_t)edges * 1000UL + gateMs / 2) / gateMs;
+    return hz > 0xFFFF ? 0xFFFF : (uint16_t)hz;
+}
+
+uint16_t rpm(uint16_t edges, uint16_t gateMs, uint16_t ppr) {
+    if (gateMs == 0 || ppr == 0) return 0;
+    // 65535 * 60000 = 3,93e9 cabe em 32 bits sem sinal
+    uint32_t den = (uint32_t)gateMs * ppr;
+    uint32_t r = ((uint32_t)edges * 60000UL + den / 2) / den;
+    return r > 0xFFFF ? 0xFFFF : (uint16_t)r;
+}
+
+}  // namespace PulseMeter
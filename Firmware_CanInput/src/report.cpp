@@ -0,0 +1,32 @@
+#include "report.h"
+
+#include <string.h>
+
+bool ChangeReporter::offer(uint8_t slot, const uint8_t *data, uint8_t len, bool force) {
+    if (len > 8) len = 8;
+    bool same = valid_[slot] && len_[slot] == len && memcmp(data_[slot], data, len) == 0;
+    if (same && !force && mode == REPORT_ON_CHANGE) {
+        suppressed_++;
+        return false;
+    }
+    memcpy(data_[slot], data, len);
+    len_[slot] = len;
+    valid_[slot] = true;
+    sent_++;
+    return true;
+}
+
+void ChangeReporter::invalidate() {
+    for (uint8_t i = 0; i < REPORT_MAX_SLOTS; i++) valid_[i] = false;
+}
+
+bool ChangeReporter::heartbeatDue(uint32_t nowMs) {
+    if (heartbeatS == 0) return false;
+    if (nowMs - heartbeatMs_ < (uint32_t)heartbeatS * 1000UL) return false;
+    heartbeatMs_ = nowMs;
+    sentLast_ = sent_ > 255 ? 255 : (uint8_t)sent_;
+    suppressedLast_ = suppressed_ > 255 ? 255 : (uint8_t)suppressed_;
+    sent_ = 0;
+    suppressed_ = 0;
+    return true;
+}
@@ -0,0 +1,29 @@
+#include "stackmon.h"
+
+void StackMonitor::begin(const uint8_t *ramStart, const uint8_t *bottom, const uint8_t *top) {
+    bottom_ = bottom;
+    top_ = top;
+    cursor_ = bottom;
+    staticBytes = (uint16_t)(bottom - ramStart);
+    sizeBytes = (uint16_t)(top - bottom);
+    minFree = sizeBytes;
+}
+
+void StackMonitor::paint(uint8_t *bottom, uint8_t *top) {
+    while (bottom < top) *bottom++ = STACK_PAINT;
+}
+
+bool StackMonitor::poll() {
+    if (!bottom_) return false;
+    for (uint8_t i = 0; i < STACK_SCAN_CHUNK; i++) {
+        if (cursor_ >= top_ || *cursor_ != STACK_PAINT) {
+            // Primeiro byte tocado: tudo abaixo dele nunca foi usado
+            uint16_t free = (uint16_t)(cursor_ - bottom_);
+            if (free < minFree) minFree = free;
+            cursor_ = bottom_;
+            return true;
+        }
+        cursor_++;
+    }
+    return false;
+}
@@ -0,0 +1,90 @@
+#include "timesync.h"
+
+uint64_t TimeSync::predict(uint32_t localUs) const {
+    // Com sinal: instantes um pouco antes da base (frame lido antes do par)
+    int32_t d = (int32_t)(localUs - baseLocal_);
+    return baseMaster_ + (int64_t)d + (int64_t)d * drift_ / 1000000000LL;
+}
+
+void TimeSync::rebase(uint32_t localUs, uint64_t masterUs) {
+    baseLocal_ = localUs;
+    baseMaster_ = masterUs;
+}
+
+uint64_t TimeSync::now(uint32_t localUs) const {
+    if (state_ == TSYNC_NONE) return 0;
+    return predict(localUs) & TIMESYNC_MASK;
+}
+
+uint32_t TimeSync::toLocal(uint64_t masterUs) const {
+    int64_t dm = (int64_t)(masterUs - baseMaster_);
+    return baseLocal_ + (uint32_t)(dm - dm * drift_ / 1000000000LL);
+}
+
+void TimeSync::onSync(uint8_t seq, uint32_t rxLocalUs, bool precise) {
+    seq_ = seq;
+    pending_ = precise;
+    pendingLocal_ = rxLocalUs;
+    if (!precise && rejected_ < 255) rejected_++;
+}
+
+bool TimeSync::onFollowUp(uint8_t seq, uint64_t masterUs) {
+    if (!pending_ || seq != seq_) return false;
+    pending_ = false;
+    uint32_t t2 = pendingLocal_;
+    uint64_t t1 = masterUs & TIMESYNC_MASK;
+    samples_++;
+    lastPairLocal_ = t2;
+
+    if (state_ == TSYNC_NONE) {
+        rebase(t2, t1);
+        state_ = TSYNC_ACQUIRING;
+        fresh_ = true;
+        lastError_ = 0;
+        return true;
+    }
+
+    int64_t err = (int64_t)(t1 - predict(t2));
+    lastError_ = err > INT32_MAX ? INT32_MAX : err < INT32_MIN ? INT32_MIN : (int32_t)err;
+
+    // Erro de frequência no intervalo desde a última base (ppb)
+    uint32_t interval = t2 - baseLocal_;
+    int64_t freqErr = interval ? err * 1000000000LL / (int64_t)interval : 0;
+
+    // Logo depois de um passo todo o erro é frequência (ressonador a 2000 ppm
+    // passa de STEP_US num período de 1 s); só um absurdo vira outro passo
+    bool step = fresh_ ? (freqErr > TIMESYNC_DRIFT_MAX || freqErr < -TIMESYNC_DRIFT_MAX)
+                       : (err > TIMESYNC_STEP_US || err < -TIMESYNC_STEP_US);
+    if (step) {
+        // Boot do mestre, SYNC perdido por muito tempo, relógio trocado
+        rebase(t2, t1);
+        state_ = TSYNC_ACQUIRING;
+        lockCount_ = 0;
+        fresh_ = true;
+        return true;
+    }
+
+    int64_t drift = drift_ + (fresh_ ? freqErr : freqErr / TIMESYNC_KI_DIV);
+    if (drift > TIMESYNC_DRIFT_MAX) drift = TIMESYNC_DRIFT_MAX;
+    if (drift < -TIMESYNC_DRIFT_MAX) drift = -TIMESYNC_DRIFT_MAX;
+
+    // Logo depois de um passo a fase vai inteira; depois, metade do erro
+    rebase(t2, fresh_ ? t1 : predict(t2) + err / 2);
+    drift_ = (int32_t)drift;
+    fresh_ = false;
+
+    bool inLock = err < TIMESYNC_LOCK_US && err > -TIMESYNC_LOCK_US;
+    lockCount_ = inLock ? (lockCount_ < 255 ? lockCount_ + 1 : 255) : 0;
+    state_ = lockCount_ >= TIMESYNC_LOCK_COUNT ? TSYNC_LOCKED : TSYNC_ACQUIRING;
+    return true;
+}
+
+void TimeSync::poll(uint32_t localUs) {
+    if (state_ == TSYNC_NONE) return;
+    if (state_ != TSYNC_HOLDOVER && localUs - lastPairLocal_ > TIMESYNC_HOLDOVER_US) {
+        state_ = TSYNC_HOLDOVER;
+        lockCount_ = 0;
+    }
+    // Δ fica longe do estouro de 32 bits (71 min) mesmo sem SYNC
+    if (localUs - baseLocal_ > 0x40000000UL) rebase(localUs, predict(localUs));
+}
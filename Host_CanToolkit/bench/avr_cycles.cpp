@@ -0,0 +1,629 @@
+//═══════════════════════════════════════════════════════════════════════════
+// avr_cycles - CICLOS DOS CAMINHOS CRÍTICOS DO FIRMWARE NO SIMAVR
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: avr_cycles [-s segundos] [-b base.csv] [-t %] [-w nova_base.csv] [-v] firmware.elf
+//
+// Roda o ELF do ambiente bench_cycles (Firmware_CanInput/platformio.ini:
+// firmware de verdade do container 17 com CYCLE_BENCH) num ATmega2560 do
+// simavr a 16 MHz, ciclo a ciclo, com um MCP2515 emulado no SPI:
+//
+//   CS no pino 33 (PC4), INT no pino 3 (PE5); instruções RESET, READ, WRITE,
+//   BIT MODIFY, READ STATUS, READ RX BUFFER, LOAD TX BUFFER e RTS; RXB0 com
+//   rollover para RXB1 (o 3º frame sem buffer vira overflow no EFLG); cada
+//   TX ocupa o barramento pelo tempo de fio a 500 kbps (busload::frameBits)
+//
+// Tráfego: 0x510 a cada 100 ms (temperaturas em rampa), resposta aos RTRs
+// de 0x510/0x520/0x530 em 200 µs e um 0x402 a cada 250 ms alternando a
+// bomba e o NA1. A EEPROM começa com os 4 canais habilitados (80/105/70/50
+// °C), o resto apagado como numa placa nova.
+//
+// As marcas de include/cyclebench.h (escritas em GPIOR1/GPIOR2) viram
+// amostras de ciclos, descontado o par vazio CYCLE_CAL do fim do setup().
+// O loop() sai em duas linhas: voltas que leram um frame do MCP2515 e
+// voltas ociosas. Para cada uma: n, mín, p50, p99, máx em ciclos e µs.
+//
+// -w grava a tabela como base; -b compara p50 e p99 de cada linha com a
+// base e sai com código 1 se algum piorar mais que -t % (padrão 5) ou se
+// alguma marca não aparecer. A simulação é determinística: a mesma ELF dá
+// os mesmos números, então a folga só cobre mudanças de fase do tráfego.
+//
+// -v repassa a serial do firmware (115200, temporizada pelo simavr) ao stderr.
+//═══════════════════════════════════════════════════════════════════════════
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "avr_eeprom.h"
+#include "avr_ioport.h"
+#include "avr_spi.h"
+#include "avr_uart.h"
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_irq.h"
+
+#include "bus_load.h"
+#include "cyclebench.h"
+#include "protocol.h"
+
+namespace {
+
+const uint32_t kCpuHz = 16000000;
+const uint32_t kBitrate = 500000;
+
+// GPIOR1/GPIOR2: I/O 0x2A/0x2B = endereço 0x4A/0x4B no espaço de dados
+const avr_io_addr_t kMarkBeginAddr = 0x4A;
+const avr_io_addr_t kMarkEndAddr = 0x4B;
+
+avr_cycle_count_t usToCycles(double us) {
+    return static_cast<avr_cycle_count_t>(us * (kCpuHz / 1e6));
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// MCP2515 EMULADO
+//───────────────────────────────────────────────────────────────────────────
+// Só o que o driver do firmware (include/mcp2515.h) usa. A resposta de cada
+// byte sai na mesma transferência SPI em que o mestre manda o próximo.
+// Cada evento no tempo (fim de TX, chegada de RX) tem o seu param: o simavr
+// cancela um timer já agendado com o mesmo callback e param.
+//───────────────────────────────────────────────────────────────────────────
+class Mcp2515Model {
+public:
+    static const uint8_t CANSTAT = 0x0E, CANCTRL = 0x0F, CANINTE = 0x2B, CANINTF = 0x2C, EFLG = 0x2D;
+    static const uint8_t RX0IF = 0x01, RX1IF = 0x02;
+
+    std::vector<CanFrame> sent;      // Frames que o firmware transmitiu
+    uint64_t rxReads = 0;            // READ RX BUFFER concluídos
+    uint64_t overflows = 0;          // Frames perdidos com RXB0 e RXB1 cheios
+
+    void attach(avr_t *avr) {
+        avr_ = avr;
+        avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_SPI_GETIRQ(0), SPI_IRQ_OUTPUT), onSpi, this);
+        avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('C'), 4), onCs, this);
+        intIrq_ = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('E'), 5);
+        reset();
+    }
+
+    // Frame no fio a partir de agora (entra no RX quando terminar de chegar)
+    void receive(const CanFrame &frame) {
+        avr_cycle_count_t done = std::max(avr_->cycle, busFreeAt_) + wireCycles(frame);
+        busFreeAt_ = done;
+        avr_cycle_timer_register(avr_, done - avr_->cycle, onArrival, new Event{this, 0, frame});
+    }
+
+    // Chamado para cada frame transmitido; pode responder com receive()
+    void (*onTransmit)(Mcp2515Model &mcp, const CanFrame &frame) = nullptr;
+
+private:
+    avr_t *avr_ = nullptr;
+    avr_irq_t *intIrq_ = nullptr;
+    uint8_t regs_[128];
+    bool selected_ = false;
+    int index_ = 0;              // Byte da transação atual
+    uint8_t instr_ = 0;
+    uint8_t addr_ = 0;
+    uint8_t mask_ = 0;
+    int rxBufferRead_ = -1;      // RXnIF a limpar ao subir o CS
+    avr_cycle_count_t busFreeAt_ = 0;
+
+    struct Event {
+        Mcp2515Model *model;
+        uint8_t ctrl;            // TXBnCTRL (só TX)
+        CanFrame frame;
+    };
+
+    static avr_cycle_count_t wireCycles(const CanFrame &frame) {
+        return usToCycles(busload::frameBits(frame) * 1e6 / kBitrate);
+    }
+
+    void reset() {
+        memset(regs_, 0, sizeof(regs_));
+        regs_[CANSTAT] = 0x80;
+        regs_[CANCTRL] = 0x87;
+        updateInt();
+    }
+
+    uint8_t readStatus() const {
+        uint8_t s = regs_[CANINTF] & (RX0IF | RX1IF);
+        if (regs_[0x30] & 0x08) s |= 0x04;
+        if (regs_[CANINTF] & 0x04) s |= 0x08;
+        if (regs_[0x40] & 0x08) s |= 0x10;
+        if (regs_[CANINTF] & 0x08) s |= 0x20;
+        if (regs_[0x50] & 0x08) s |= 0x40;
+        if (regs_[CANINTF] & 0x10) s |= 0x80;
+        return s;
+    }
+
+    void updateInt() {
+        if (intIrq_) avr_raise_irq(intIrq_, (regs_[CANINTF] & regs_[CANINTE]) ? 0 : 1);
+    }
+
+    void write(uint8_t reg, uint8_t value) {
+        reg &= 0x7F;
+        uint8_t old = regs_[reg];
+        regs_[reg] = value;
+        if (reg == CANCTRL) regs_[CANSTAT] = (regs_[CANSTAT] & 0x1F) | (value & 0xE0);   // Troca de modo imediata
+        if ((reg == 0x30 || reg == 0x40 || reg == 0x50) && (value & 0x08) && !(old & 0x08)) requestTx(reg);
+        if (reg == CANINTF || reg == CANINTE) updateInt();
+    }
+
+    uint8_t read(uint8_t reg) const { return regs_[reg & 0x7F]; }
+
+    //───────────────────────────────────────────────────────────────────────
+    // TRANSMISSÃO: o frame ocupa o fio e só então libera o TXREQ
+    //───────────────────────────────────────────────────────────────────────
+    void requestTx(uint8_t ctrl) {
+        if ((regs_[CANSTAT] & 0xE0) == 0x80) return;   // Em configuração o pedido fica pendente
+        regs_[ctrl] |= 0x08;
+        const uint8_t *b = regs_ + ctrl + 1;            // SIDH SIDL EID8 EID0 DLC D0..D7
+        CanFrame f;
+        if (b[1] & 0x08) {
+            f.extended = true;
+            f.id = (uint32_t(b[0]) << 21) | (uint32_t(b[1] & 0xE0) << 13) | (uint32_t(b[1] & 0x03) << 16) |
+                   (uint32_t(b[2]) << 8) | b[3];
+        } else {
+            f.id = (uint32_t(b[0]) << 3) | (b[1] >> 5);
+        }
+        f.remote = b[4] & 0x40;
+        f.dlc = std::min<uint8_t>(b[4] & 0x0F, 8);
+        if (!f.remote) memcpy(f.data, b + 5, f.dlc);
+
+        avr_cycle_count_t done = std::max(avr_->cycle, busFreeAt_) + wireCycles(f);
+        busFreeAt_ = done;
+        avr_cycle_timer_register(avr_, done - avr_->cycle, onTxDone, new Event{this, ctrl, f});
+    }
+
+    static avr_cycle_count_t onTxDone(avr_t *, avr_cycle_count_t, void *param) {
+        Event tx = *static_cast<Event *>(param);
+        delete static_cast<Event *>(param);
+        Mcp2515Model &m = *tx.model;
+        if (!(m.regs_[tx.ctrl] & 0x08)) return 0;      // Abortado pelo firmware (timeout do TXB0)
+        m.regs_[tx.ctrl] &= static_cast<uint8_t>(~0x08);
+        m.regs_[CANINTF] |= static_cast<uint8_t>(0x04 << ((tx.ctrl - 0x30) >> 4));
+        m.updateInt();
+        m.sent.push_back(tx.frame);
+        if ((m.regs_[CANSTAT] & 0xE0) == 0x40) m.store(tx.frame);   // Loopback
+        if (m.onTransmit) m.onTransmit(m, tx.frame);
+        return 0;
+    }
+
+    //───────────────────────────────────────────────────────────────────────
+    // RECEPÇÃO: RXB0, rollover para RXB1 (BUKT), senão overflow
+    //───────────────────────────────────────────────────────────────────────
+    static avr_cycle_count_t onArrival(avr_t *, avr_cycle_count_t, void *param) {
+        Event rx = *static_cast<Event *>(param);
+        delete static_cast<Event *>(param);
+        uint8_t mode = rx.model->regs_[CANSTAT] & 0xE0;
+        if (mode == 0x00 || mode == 0x60) rx.model->store(rx.frame);
+        return 0;
+    }
+
+    void store(const CanFrame &f) {
+        uint8_t base;
+        if (!(regs_[CANINTF] & RX0IF)) {
+            base = 0x61;
+            regs_[CANINTF] |= RX0IF;
+        } else if ((regs_[0x60] & 0x04) && !(regs_[CANINTF] & RX1IF)) {
+            base = 0x71;
+            regs_[CANINTF] |= RX1IF;
+        } else {
+            regs_[EFLG] |= (regs_[0x60] & 0x04) ? 0x80 : 0x40;
+            overflows++;
+            return;
+        }
+        uint8_t *b = regs_ + base;
+        if (f.extended) {
+            b[0] = static_cast<uint8_t>(f.id >> 21);
+            b[1] = static_cast<uint8_t>(((f.id >> 13) & 0xE0) | 0x08 | ((f.id >> 16) & 0x03));
+            b[2] = static_cast<uint8_t>(f.id >> 8);
+            b[3] = static_cast<uint8_t>(f.id);
+            b[4] = static_cast<uint8_t>(f.dlc | (f.remote ? 0x40 : 0));
+        } else {
+            b[0] = static_cast<uint8_t>(f.id >> 3);
+            b[1] = static_cast<uint8_t>(((f.id & 0x07) << 5) | (f.remote ? 0x10 : 0));
+            b[2] = b[3] = 0;
+            b[4] = f.dlc;
+        }
+        memcpy(b + 5, f.data, 8);
+        updateInt();
+    }
+
+    //───────────────────────────────────────────────────────────────────────
+    // SPI
+    //───────────────────────────────────────────────────────────────────────
+    static void onCs(avr_irq_t *, uint32_t value, void *param) {
+        Mcp2515Model &m = *static_cast<Mcp2515Model *>(param);
+        if (!value) {
+            m.selected_ = true;
+            m.index_ = 0;
+            m.rxBufferRead_ = -1;
+            return;
+        }
+        if (m.selected_ && m.rxBufferRead_ >= 0) {
+            m.regs_[CANINTF] &= static_cast<uint8_t>(~(m.rxBufferRead_ ? RX1IF : RX0IF));
+            m.rxReads++;
+            m.updateInt();
+        }
+        m.selected_ = false;
+    }
+
+    static void onSpi(avr_irq_t *, uint32_t value, void *param) {
+        Mcp2515Model &m = *static_cast<Mcp2515Model *>(param);
+        uint8_t reply = m.selected_ ? m.transfer(static_cast<uint8_t>(value)) : 0xFF;
+        avr_raise_irq(avr_io_getirq(m.avr_, AVR_IOCTL_SPI_GETIRQ(0), SPI_IRQ_INPUT), reply);
+    }
+
+    uint8_t transfer(uint8_t in) {
+        int i = index_++;
+        if (i == 0) {
+            instr_ = in;
+            if (in == 0xC0) {
+                reset();
+            } else if ((in & 0xF9) == 0x90) {
+                // READ RX BUFFER: n (bit 2) e m (bit 1) escolhem buffer e início
+                rxBufferRead_ = (in >> 2) & 1;
+                addr_ = static_cast<uint8_t>((rxBufferRead_ ? 0x71 : 0x61) + ((in & 0x02) ? 5 : 0));
+            } else if ((in & 0xF8) == 0x40) {
+                // LOAD TX BUFFER: abc = buffer e início (SIDH ou D0)
+                uint8_t n = (in & 0x07) >> 1;
+                addr_ = static_cast<uint8_t>(0x31 + 0x10 * n + ((in & 0x01) ? 5 : 0));
+            } else if ((in & 0xF8) == 0x80) {
+                for (uint8_t n = 0; n < 3; n++) {
+                    if (in & (1 << n)) write(0x30 + 0x10 * n, regs_[0x30 + 0x10 * n] | 0x08);
+                }
+            }
+            return 0xFF;
+        }
+
+        switch (instr_) {
+            case 0x03:   // READ
+                if (i == 1) {
+                    addr_ = in;
+                    return 0xFF;
+                }
+                return read(addr_++);
+            case 0x02:   // WRITE
+                if (i == 1) addr_ = in;
+                else write(addr_++, in);
+                return 0xFF;
+            case 0x05:   // BIT MODIFY
+                if (i == 1) addr_ = in;
+                else if (i == 2) mask_ = in;
+                else if (i == 3) write(addr_, static_cast<uint8_t>((read(addr_) & ~mask_) | (in & mask_)));
+                return 0xFF;
+            case 0xA0:   // READ STATUS (repete enquanto o CS estiver baixo)
+                return readStatus();
+            case 0xB0:   // RX STATUS (não usado pelo driver)
+                return 0;
+            default:
+                if ((instr_ & 0xF9) == 0x90) return read(addr_++);
+                if ((instr_ & 0xF8) == 0x40) write(addr_++, in);
+                return 0xFF;
+        }
+    }
+};
+
+//───────────────────────────────────────────────────────────────────────────
+// TRÁFEGO SINTÉTICO
+//───────────────────────────────────────────────────────────────────────────
+struct Traffic {
+    avr_t *avr;
+    Mcp2515Model *mcp;
+    uint32_t tick = 0;            // ms simulados
+};
+
+CanFrame temperatureFrame(uint32_t id, uint32_t ms) {
+    tempReadStructure t{};
+    t.CJtemp = 30;
+    int ramp = static_cast<int>((ms / 100) % 60);   // Sobe 60 °C em 6 s e recomeça
+    t.TLtemp = static_cast<int16_t>(40 + ramp / 2);
+    t.TRtemp = static_cast<int16_t>(70 + ramp);
+    t.BLtemp = static_cast<int16_t>(45 + ramp / 3);
+    t.BRtemp = static_cast<int16_t>(30 + ramp / 2);
+    return proto::encodeTemperature(id, t);
+}
+
+CanFrame digitalFrame(bool na1) {
+    proto::DigitalState s;
+    s.relays[7] = proto::RelayOn;                               // Bomba (D8)
+    s.relays[5] = na1 ? proto::RelayOn : proto::RelayOff;       // NA1 (D6)
+    return proto::encodeDigital(s);
+}
+
+Traffic *traffic = nullptr;
+
+void answerRtr(Mcp2515Model &mcp, const CanFrame &frame) {
+    if (!frame.remote || frame.extended) return;
+    if (frame.id != 0x510 && frame.id != 0x520 && frame.id != 0x530) return;
+    // O módulo responde ~200 µs depois (entra na fila do fio depois do RTR)
+    struct Reply {
+        Mcp2515Model *mcp;
+        CanFrame frame;
+    };
+    Reply *r = new Reply{&mcp, temperatureFrame(frame.id, traffic->tick)};
+    avr_cycle_timer_register(
+        traffic->avr, usToCycles(200),
+        [](avr_t *, avr_cycle_count_t, void *param) -> avr_cycle_count_t {
+            Reply *reply = static_cast<Reply *>(param);
+            reply->mcp->receive(reply->frame);
+            delete reply;
+            return 0;
+        },
+        r);
+}
+
+avr_cycle_count_t onMillisecond(avr_t *avr, avr_cycle_count_t when, void *param) {
+    Traffic &t = *static_cast<Traffic *>(param);
+    t.tick++;
+    if (t.tick % 100 == 0) t.mcp->receive(temperatureFrame(0x510, t.tick));
+    if (t.tick % 250 == 0) t.mcp->receive(digitalFrame((t.tick / 250) % 2 != 0));
+    (void)avr;
+    return when + usToCycles(1000);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// MARCAS
+//───────────────────────────────────────────────────────────────────────────
+enum Row { RowLoopFrame, RowLoopIdle, RowTempRead, RowFilter, RowDigital, RowMotor, RowCount };
+const char *const kRowNames[RowCount] = {"loop_frame", "loop_idle", "tempRead", "filter", "handler_0x402", "setMotor"};
+
+struct Marks {
+    Mcp2515Model *mcp;
+    avr_cycle_count_t begin[CYCLE_MARKS] = {};
+    bool open[CYCLE_MARKS] = {};
+    uint64_t loopRxReads = 0;
+    bool calibrated = false;
+    avr_cycle_count_t calibration = 0;
+    std::vector<uint32_t> samples[RowCount];
+    uint64_t unbalanced = 0;
+};
+
+void onMarkBegin(avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param) {
+    Marks &m = *static_cast<Marks *>(param);
+    avr->data[addr] = v;
+    if (v == 0 || v >= CYCLE_MARKS) return;
+    if (m.open[v]) m.unbalanced++;
+    m.open[v] = true;
+    m.begin[v] = avr->cycle;
+    if (v == CYCLE_LOOP) m.loopRxReads = m.mcp->rxReads;
+}
+
+void onMarkEnd(avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param) {
+    Marks &m = *static_cast<Marks *>(param);
+    avr->data[addr] = v;
+    if (v == 0 || v >= CYCLE_MARKS) return;
+    if (!m.open[v]) {
+        m.unbalanced++;
+        return;
+    }
+    m.open[v] = false;
+    avr_cycle_count_t cycles = avr->cycle - m.begin[v];
+    if (v == CYCLE_CAL) {
+        m.calibration = cycles;
+        m.calibrated = true;
+        return;
+    }
+    if (!m.calibrated) return;   // Ainda no setup()
+    cycles = cycles > m.calibration ? cycles - m.calibration : 0;
+
+    Row row;
+    switch (v) {
+        case CYCLE_LOOP: row = m.mcp->rxReads != m.loopRxReads ? RowLoopFrame : RowLoopIdle; break;
+        case CYCLE_TEMP_READ: row = RowTempRead; break;
+        case CYCLE_FILTER: row = RowFilter; break;
+        case CYCLE_DIGITAL_CMD: row = RowDigital; break;
+        default: row = RowMotor; break;
+    }
+    m.samples[row].push_back(static_cast<uint32_t>(std::min<avr_cycle_count_t>(cycles, UINT32_MAX)));
+}
+
+void onSerial(avr_irq_t *, uint32_t value, void *) {
+    fputc(static_cast<int>(value & 0xFF), stderr);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// RESULTADO E BASE
+//───────────────────────────────────────────────────────────────────────────
+struct Stats {
+    size_t n = 0;
+    uint32_t min = 0, p50 = 0, p99 = 0, max = 0;
+};
+
+Stats summarize(std::vector<uint32_t> v) {
+    Stats s;
+    if (v.empty()) return s;
+    std::sort(v.begin(), v.end());
+    s.n = v.size();
+    s.min = v.front();
+    s.p50 = v[v.size() / 2];
+    s.p99 = v[std::min(v.size() - 1, v.size() * 99 / 100)];
+    s.max = v.back();
+    return s;
+}
+
+// Base: "linha,n,min,p50,p99,max" (ciclos), cabeçalho na primeira linha
+std::map<std::string, Stats> readBaseline(const char *path) {
+    std::map<std::string, Stats> base;
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "avr_cycles: não foi possível abrir %s\n", path);
+        exit(2);
+    }
+    char line[256];
+    if (!fgets(line, sizeof(line), f)) line[0] = 0;   // Cabeçalho
+    while (fgets(line, sizeof(line), f)) {
+        char name[64];
+        Stats s;
+        unsigned long n, mn, p50, p99, mx;
+        if (sscanf(line, "%63[^,],%lu,%lu,%lu,%lu,%lu", name, &n, &mn, &p50, &p99, &mx) != 6) continue;
+        s.n = n;
+        s.min = static_cast<uint32_t>(mn);
+        s.p50 = static_cast<uint32_t>(p50);
+        s.p99 = static_cast<uint32_t>(p99);
+        s.max = static_cast<uint32_t>(mx);
+        base[name] = s;
+    }
+    fclose(f);
+    return base;
+}
+
+void writeBaseline(const char *path, const Stats *stats) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "avr_cycles: não foi possível criar %s\n", path);
+        exit(2);
+    }
+    fprintf(f, "row,n,min,p50,p99,max\n");
+    for (int r = 0; r < RowCount; r++) {
+        fprintf(f, "%s,%zu,%lu,%lu,%lu,%lu\n", kRowNames[r], stats[r].n, static_cast<unsigned long>(stats[r].min),
+                static_cast<unsigned long>(stats[r].p50), static_cast<unsigned long>(stats[r].p99),
+                static_cast<unsigned long>(stats[r].max));
+    }
+    fclose(f);
+}
+
+double percent(uint32_t now, uint32_t base) {
+    return base ? (static_cast<double>(now) - base) * 100.0 / base : 0;
+}
+
+void usage() {
+    fprintf(stderr, "Uso: avr_cycles [-s segundos] [-b base.csv] [-t %%] [-w nova_base.csv] [-v] firmware.elf\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    double seconds = 5;
+    double threshold = 5;
+    const char *basePath = nullptr, *writePath = nullptr;
+    bool verbose = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:b:t:w:vh")) != -1) {
+        switch (opt) {
+            case 's': seconds = atof(optarg); break;
+            case 'b': basePath = optarg; break;
+            case 't': threshold = atof(optarg); break;
+            case 'w': writePath = optarg; break;
+            case 'v': verbose = true; break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind != argc - 1 || seconds <= 0 || threshold < 0) {
+        usage();
+        return 2;
+    }
+    const char *elfPath = argv[optind];
+
+    elf_firmware_t fw;
+    memset(&fw, 0, sizeof(fw));
+    if (elf_read_firmware(elfPath, &fw) != 0) {
+        fprintf(stderr, "avr_cycles: não foi possível ler %s\n", elfPath);
+        return 2;
+    }
+    strcpy(fw.mmcu, "atmega2560");
+    fw.frequency = kCpuHz;
+
+    avr_t *avr = avr_make_mcu_by_name(fw.mmcu);
+    if (!avr) {
+        fprintf(stderr, "avr_cycles: simavr sem suporte a %s\n", fw.mmcu);
+        return 2;
+    }
+    avr_init(avr);
+    avr_load_firmware(avr, &fw);
+
+    // EEPROM de uma placa configurada: só os 4 canais (ver tabela no main.cpp)
+    uint8_t eeprom[64];
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    const int maxAddr[4] = {0, 4, 14, 21}, timerAddr[4] = {8, 10, 18, 25}, enableAddr[4] = {12, 13, 20, 27};
+    const float maxTemp[4] = {80, 105, 70, 50};
+    for (int ch = 0; ch < 4; ch++) {
+        uint16_t timer = 1000;
+        memcpy(eeprom + maxAddr[ch], &maxTemp[ch], 4);    // Little-endian, como o AVR
+        memcpy(eeprom + timerAddr[ch], &timer, 2);
+        eeprom[enableAddr[ch]] = 1;
+    }
+    avr_eeprom_desc_t ee;
+    ee.ee = eeprom;
+    ee.offset = 0;
+    ee.size = sizeof(eeprom);
+    avr_ioctl(avr, AVR_IOCTL_EEPROM_SET, &ee);
+
+    // Serial: sem o eco do simavr no stdout; -v manda para o stderr
+    uint32_t uartFlags = 0;
+    avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &uartFlags);
+    uartFlags &= ~AVR_UART_FLAG_STDIO;
+    avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &uartFlags);
+    if (verbose) avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), onSerial, nullptr);
+
+    Mcp2515Model mcp;
+    mcp.attach(avr);
+    mcp.onTransmit = answerRtr;
+
+    Traffic t{avr, &mcp};
+    traffic = &t;
+    avr_cycle_timer_register(avr, usToCycles(1000), onMillisecond, &t);
+
+    Marks marks;
+    marks.mcp = &mcp;
+    avr_register_io_write(avr, kMarkBeginAddr, onMarkBegin, &marks);
+    avr_register_io_write(avr, kMarkEndAddr, onMarkEnd, &marks);
+
+    const avr_cycle_count_t end = static_cast<avr_cycle_count_t>(seconds * kCpuHz);
+    int state = cpu_Running;
+    while (avr->cycle < end && state != cpu_Done && state != cpu_Crashed) state = avr_run(avr);
+    if (state == cpu_Crashed) {
+        fprintf(stderr, "avr_cycles: CPU travou em PC=0x%05X\n", static_cast<unsigned>(avr->pc));
+        return 2;
+    }
+
+    //───────────────────────────────────────────────────────────────────────
+    // RELATÓRIO
+    //───────────────────────────────────────────────────────────────────────
+    printf("%s: %.1f s simulados a %.0f MHz, %zu frames enviados, %lu lidos, %lu perdidos (overflow)\n", elfPath,
+           seconds, kCpuHz / 1e6, mcp.sent.size(), static_cast<unsigned long>(mcp.rxReads),
+           static_cast<unsigned long>(mcp.overflows));
+    printf("marca vazia: %lu ciclos (descontados)%s\n", static_cast<unsigned long>(marks.calibration),
+           marks.calibrated ? "" : " - setup() NAO TERMINOU");
+    if (marks.unbalanced) printf("AVISO: %lu marcas sem par\n", static_cast<unsigned long>(marks.unbalanced));
+
+    Stats stats[RowCount];
+    std::map<std::string, Stats> base;
+    if (basePath) base = readBaseline(basePath);
+
+    printf("\n%-14s %7s %8s %8s %8s %8s %10s %10s", "", "n", "min", "p50", "p99", "max", "p50 µs", "p99 µs");
+    fputs(basePath ? "   Δp50    Δp99\n" : "\n", stdout);
+    int failures = marks.calibrated ? 0 : 1;
+    for (int r = 0; r < RowCount; r++) {
+        stats[r] = summarize(marks.samples[r]);
+        const Stats &s = stats[r];
+        printf("%-14s %7zu %8lu %8lu %8lu %8lu %10.2f %10.2f", kRowNames[r], s.n, static_cast<unsigned long>(s.min),
+               static_cast<unsigned long>(s.p50), static_cast<unsigned long>(s.p99), static_cast<unsigned long>(s.max),
+               s.p50 * 1e6 / kCpuHz, s.p99 * 1e6 / kCpuHz);
+        if (!s.n) failures++;
+        if (basePath) {
+            auto it = base.find(kRowNames[r]);
+            if (it == base.end()) {
+                printf("   (sem base)");
+            } else {
+                double d50 = percent(s.p50, it->second.p50), d99 = percent(s.p99, it->second.p99);
+                bool worse = d50 > threshold || d99 > threshold;
+                printf(" %+6.1f%% %+6.1f%%%s", d50, d99, worse ? "  PIOROU" : "");
+                if (worse) failures++;
+            }
+        }
+        printf("%s\n", s.n ? "" : "  SEM AMOSTRAS");
+    }
+
+    if (writePath) {
+        writeBaseline(writePath, stats);
+        printf("\nbase gravada em %s\n", writePath);
+    }
+    if (failures) printf("\nFALHOU: %d linha(s) %s\n", failures, basePath ? "acima da base ou sem amostras" : "sem amostras");
+    avr_terminate(avr);
+    return failures ? 1 : 0;
+}
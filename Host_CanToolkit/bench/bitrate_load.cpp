@@ -0,0 +1,166 @@
+//═══════════════════════════════════════════════════════════════════════════
+// bitrate_load - CARGA DO BARRAMENTO A 500 kbps x 1 Mbps (migração 0x40C)
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: bitrate_load [-c captura.canlog] [-t segundos] [-b orçamento‰]
+//
+// Conta os bits reais de cada frame (busload::frameBits: stuffing e CRC
+// calculados sobre o frame montado) e compara os dois bitrates do
+// Firmware_CanInput/include/bitrate.h:
+//
+//   - carga total e por ID
+//   - tempo de fio por frame (mín/médio) e o bloqueio no pior caso de
+//     um frame de alta prioridade (um frame inteiro já no fio)
+//   - período mínimo da aquisição adaptativa dentro do orçamento de carga
+//     (AdaptiveSampler do firmware, compilado no host)
+//
+// Sem -c, usa um perfil sintético do pior caso do nó: as 3 temperaturas
+// por RTR no período mínimo (20 ms), 0x426 a cada ciclo, 5 módulos em push
+// a 100 ms, 0x402/0x422 do MATLAB a 100 ms e os frames de status.
+//═══════════════════════════════════════════════════════════════════════════
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "adaptive.h"
+#include "bus_load.h"
+#include "can_log.h"
+
+namespace {
+
+const uint32_t kBitrates[] = {500000, 1000000};
+
+struct ProfileEntry {
+    uint32_t id;
+    bool rtr;          // RTR do nó + resposta de 8 bytes
+    uint8_t dlc;
+    uint32_t periodMs;
+};
+
+const ProfileEntry kProfile[] = {
+    {0x510, true, 8, 20}, {0x520, true, 8, 20}, {0x530, true, 8, 20},
+    {0x426, false, 8, 20},
+    {0x610, false, 8, 100}, {0x611, false, 8, 100},
+    {0x620, false, 8, 100}, {0x621, false, 8, 100}, {0x622, false, 8, 100},
+    {0x402, false, 8, 100}, {0x422, false, 8, 100},
+    {0x42B, false, 8, 1000}, {0x42A, false, 8, 5000},
+};
+
+// Payload pseudoaleatório determinístico (o stuffing depende dos dados)
+uint8_t nextByte(uint32_t &state) {
+    state = state * 1664525u + 1013904223u;
+    return static_cast<uint8_t>(state >> 24);
+}
+
+std::vector<CanFrame> synthetic(double seconds) {
+    std::vector<CanFrame> frames;
+    uint32_t rng = 12345;
+    uint64_t endNs = static_cast<uint64_t>(seconds * 1e9);
+    for (const ProfileEntry &e : kProfile) {
+        for (uint64_t t = 0; t < endNs; t += e.periodMs * 1000000ull) {
+            if (e.rtr) {
+                CanFrame r = CanFrame::rtr(e.id);
+                r.dlc = e.dlc;
+                r.timestampNs = t;
+                frames.push_back(r);
+            }
+            CanFrame f;
+            f.id = e.id;
+            f.dlc = e.dlc;
+            for (int i = 0; i < e.dlc; i++) f.data[i] = nextByte(rng);
+            f.timestampNs = t + (e.rtr ? 500000 : 0);
+            frames.push_back(f);
+        }
+    }
+    return frames;
+}
+
+std::vector<CanFrame> capture(const char *path) {
+    std::vector<CanFrame> frames;
+    canlog::Reader log(path);
+    frames.reserve(log.size());
+    log.forEach([&](uint64_t, const canlog::Record &rec, uint64_t ts) { frames.push_back(canlog::fromRecord(rec, ts)); });
+    return frames;
+}
+
+// Período das 3 temperaturas pedindo o mínimo, depois do orçamento
+uint16_t adaptivePeriod(uint32_t bitrate, uint8_t budgetPermille) {
+    AdaptiveSampler sampler;
+    sampler.config.budgetPermille = budgetPermille;
+    for (uint8_t i = 0; i < 3; i++) sampler.setWanted(i, sampler.config.minMs);
+    sampler.applyBudget(bitrate);
+    return sampler.period(0);
+}
+
+void report(const std::vector<CanFrame> &frames, uint8_t budgetPermille) {
+    busload::LoadStats stats;
+    unsigned minBits = ~0u, maxBits = 0;
+    for (const CanFrame &f : frames) {
+        stats.add(f);
+        unsigned bits = busload::frameBits(f);
+        if (bits < minBits) minBits = bits;
+        if (bits > maxBits) maxBits = bits;
+    }
+    if (!stats.frames) {
+        printf("nenhum frame\n");
+        return;
+    }
+    double meanBits = static_cast<double>(stats.bits) / stats.frames;
+    printf("%llu frames em %.3f s (%.1f frames/s), %.1f bits/frame (%u-%u)\n\n",
+           static_cast<unsigned long long>(stats.frames), stats.seconds(), stats.frames / stats.seconds(), meanBits,
+           minBits, maxBits);
+
+    // Bloqueio: o maior frame já no fio atrasa qualquer frame, mesmo o de maior prioridade
+    printf("%-10s %8s %10s %10s %12s %14s\n", "bitrate", "carga%", "min us", "medio us", "bloqueio us",
+           "aquis min ms");
+    for (uint32_t br : kBitrates) {
+        double usPerBit = 1e6 / br;
+        printf("%-10u %8.2f %10.1f %10.1f %12.1f %14u\n", br, stats.load(br) * 100, minBits * usPerBit,
+               meanBits * usPerBit, maxBits * usPerBit, adaptivePeriod(br, budgetPermille));
+    }
+
+    printf("\n%-8s %8s %10s %10s\n", "ID", "frames", "500k %", "1M %");
+    for (const auto &kv : stats.perId) {
+        bool ext = kv.first & 0x80000000u;
+        printf(ext ? "%08X %8llu" : "0x%03X    %8llu", kv.first & 0x1FFFFFFF,
+               static_cast<unsigned long long>(kv.second.frames));
+        printf(" %10.3f %10.3f\n", stats.load(kv.second, kBitrates[0]) * 100, stats.load(kv.second, kBitrates[1]) * 100);
+    }
+}
+
+void usage() {
+    fprintf(stderr, "Uso: bitrate_load [-c captura.canlog] [-t segundos] [-b orcamento_permil]\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const char *path = nullptr;
+    double seconds = 10;
+    int budget = samplingConfigStructure().budgetPermille;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:t:b:h")) != -1) {
+        switch (opt) {
+            case 'c': path = optarg; break;
+            case 't': seconds = atof(optarg); break;
+            case 'b': budget = atoi(optarg); break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (seconds <= 0 || budget < 0 || budget > 255) {
+        usage();
+        return 2;
+    }
+
+    std::vector<CanFrame> frames;
+    if (path) {
+        frames = capture(path);
+        printf("captura %s: ", path);
+    } else {
+        frames = synthetic(seconds);
+        printf("perfil sintetico (pior caso do no): ");
+    }
+    report(frames, static_cast<uint8_t>(budget));
+    return 0;
+}
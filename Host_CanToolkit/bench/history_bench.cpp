@@ -0,0 +1,192 @@
+//═══════════════════════════════════════════════════════════════════════════
+// history_bench - DURAÇÃO DO HISTÓRICO EM RAM E TEMPO DE DOWNLOAD
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: history_bench [-m minutos] [-s semente]
+//
+// Roda o HistoryLog do firmware (Firmware_CanInput/include/history.h) sobre
+// temperaturas sintéticas com o mesmo caminho do nó: termopar inteiro (1 °C)
+// a cada 100 ms, filtro EMA α = 0.1, amostra no histórico a cada 250 ms.
+//
+// Para cada cenário:
+//   - bytes por amostra e quanto tempo cabe no anel (HISTORY_BYTES)
+//   - comparação com amostras cruas (ms + 4 x int16 + relés = 13 bytes)
+//   - download: frames 0x430, bits no fio (busload::frameBits) e tempo a
+//     500 kbps / 1 Mbps; o firmware manda um frame por volta do loop()
+//   - decodificação do download (historyDecode) conferida com o original
+//═══════════════════════════════════════════════════════════════════════════
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <map>
+#include <vector>
+
+#include "bus_load.h"
+#include "history.h"
+#include "protocol.h"
+
+namespace {
+
+const uint32_t kRawPeriodMs = 100;     // Aquisição das temperaturas
+const float kAlpha = 0.1f;             // Filtro do SafetyChannel
+const unsigned kRawSampleBytes = 13;
+
+enum Scenario { STEADY, WARMUP, NOISY, TRIPS };
+const char *const kNames[] = {"repouso", "aquecimento", "ruidoso", "disparos"};
+
+// Uniforme em [0, 1) determinística
+double uniform(uint32_t &state) {
+    state = state * 1664525u + 1013904223u;
+    return (state >> 8) / 16777216.0;
+}
+
+// Temperatura crua (°C inteiro, como o CANmod.Temp) do canal ch no tempo t
+int16_t rawTemp(Scenario sc, int ch, double t, uint32_t &rng) {
+    double base = 60 + 40 * ch;
+    double v = base;
+    double noise = (uniform(rng) - 0.5) * 2.0;   // ±1 °C
+    switch (sc) {
+        case STEADY: v = base + noise * 0.6; break;
+        case WARMUP: v = base + 300 * (1 - exp(-t / 900.0)) + noise; break;
+        case NOISY: v = base + 5 * sin(t / 7.0 + ch) + noise * 3; break;
+        case TRIPS: v = base + 80 + 60 * sin(t / 120.0 + ch) + noise; break;
+    }
+    return static_cast<int16_t>(lround(v));
+}
+
+struct Result {
+    uint64_t samples = 0;
+    uint32_t spanMs = 0;
+    uint16_t bytes = 0;
+    size_t frames = 0;
+    uint64_t wireBits = 0;
+    size_t records = 0, events = 0;
+    bool decodedOk = false;
+    int maxErrQ = 0;     // Maior diferença decodificado x gravado (0,25 °C)
+};
+
+Result run(Scenario sc, double minutes, uint32_t seed) {
+    static HistoryLog log;      // 2 KB: fora da pilha
+    log.clear();
+    Result r;
+    uint32_t rng = seed;
+    float filtered[HISTORY_CHANNELS];
+    for (int ch = 0; ch < HISTORY_CHANNELS; ch++) filtered[ch] = static_cast<float>(rawTemp(sc, ch, 0, rng));
+    uint8_t relays = 0;
+    bool tripped[HISTORY_CHANNELS] = {false};
+
+    // Verdade das amostras gravadas, para conferir o download
+    std::map<uint32_t, std::vector<int16_t>> truth;
+
+    uint32_t endMs = static_cast<uint32_t>(minutes * 60000);
+    uint32_t nextHist = 0;
+    for (uint32_t now = 0; now <= endMs; now += kRawPeriodMs) {
+        for (int ch = 0; ch < HISTORY_CHANNELS; ch++) {
+            filtered[ch] = kAlpha * rawTemp(sc, ch, now / 1000.0, rng) + (1 - kAlpha) * filtered[ch];
+        }
+        // Como no nó: a primeira amostra sai antes de qualquer evento
+        if (now >= nextHist) {
+            nextHist += HISTORY_PERIOD_MS;
+            int16_t q[HISTORY_CHANNELS];
+            for (int ch = 0; ch < HISTORY_CHANNELS; ch++) q[ch] = historyQuantize(filtered[ch]);
+            log.sample(now, q, relays);
+            truth[now] = std::vector<int16_t>(q, q + HISTORY_CHANNELS);
+            r.samples++;
+        }
+        for (int ch = 0; ch < HISTORY_CHANNELS; ch++) {
+            // Disparo com histerese de 5 °C sobre um limite de 190 °C
+            bool trip = filtered[ch] >= 190 || (tripped[ch] && filtered[ch] > 185);
+            if (trip != tripped[ch]) {
+                tripped[ch] = trip;
+                relays ^= static_cast<uint8_t>(1 << ch);
+                log.event(now, trip ? HIST_EV_TRIP : HIST_EV_NORMAL, static_cast<uint8_t>(ch));
+            }
+        }
+    }
+    r.spanMs = endMs - log.oldestMs();
+    r.bytes = log.size();
+
+    // Download como no nó: [seq][até 7 bytes] no 0x430
+    std::vector<uint8_t> stream;
+    log.begin();
+    uint8_t seq = 0;
+    while (log.downloading()) {
+        uint8_t chunk[8];
+        chunk[0] = seq++;
+        uint8_t n = log.chunk(chunk + 1);
+        CanFrame f(proto::kHistoryDataId, chunk, static_cast<uint8_t>(1 + n));
+        r.wireBits += busload::frameBits(f);
+        r.frames++;
+        stream.insert(stream.end(), chunk + 1, chunk + 1 + n);
+        log.advance(n);
+    }
+
+    std::vector<HistoryRecord> decoded;
+    r.decodedOk = historyDecode(stream.data(), stream.size(), decoded);
+    r.records = decoded.size();
+    for (const HistoryRecord &rec : decoded) {
+        if (rec.isEvent) {
+            r.events++;
+            continue;
+        }
+        // O decodificador reconstrói o horário nominal (±meio período do real)
+        uint32_t low = rec.ms > HISTORY_PERIOD_MS / 2 ? rec.ms - HISTORY_PERIOD_MS / 2 : 0;
+        auto it = truth.lower_bound(low);
+        if (it == truth.end() || it->first > rec.ms + HISTORY_PERIOD_MS / 2) {
+            r.decodedOk = false;
+            continue;
+        }
+        for (int ch = 0; ch < HISTORY_CHANNELS; ch++) {
+            int err = abs(rec.temp[ch] - it->second[ch]);
+            if (err > r.maxErrQ) r.maxErrQ = err;
+        }
+    }
+    return r;
+}
+
+void usage() {
+    fprintf(stderr, "Uso: history_bench [-m minutos] [-s semente]\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    double minutes = 60;
+    uint32_t seed = 12345;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:s:h")) != -1) {
+        switch (opt) {
+            case 'm': minutes = atof(optarg); break;
+            case 's': seed = static_cast<uint32_t>(strtoul(optarg, nullptr, 0)); break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (minutes <= 0) {
+        usage();
+        return 2;
+    }
+
+    printf("anel %u bytes, amostra a cada %u ms, KEY a cada %u amostras, %.0f min simulados\n\n",
+           HISTORY_BYTES, HISTORY_PERIOD_MS, HISTORY_KEY_EVERY, minutes);
+    printf("%-12s %9s %10s %10s %8s %8s %9s %9s %6s\n", "cenario", "B/amostra", "historico", "cru", "frames",
+           "kbit", "500k ms", "1M ms", "decod");
+    bool ok = true;
+    for (int s = STEADY; s <= TRIPS; s++) {
+        Result r = run(static_cast<Scenario>(s), minutes, seed);
+        // Amostras dentro do anel: bytes / duração em períodos
+        double inRing = r.spanMs / static_cast<double>(HISTORY_PERIOD_MS) + 1;
+        double perSample = r.bytes / inRing;
+        double rawMin = HISTORY_BYTES / static_cast<double>(kRawSampleBytes) * HISTORY_PERIOD_MS / 60000.0;
+        char span[16], raw[16];
+        snprintf(span, sizeof(span), "%.1f min", r.spanMs / 60000.0);
+        snprintf(raw, sizeof(raw), "%.1f min", rawMin);
+        printf("%-12s %9.2f %10s %10s %8zu %8.1f %9.1f %9.1f %6s\n", kNames[s], perSample, span, raw, r.frames,
+               r.wireBits / 1000.0, r.wireBits / 500.0, r.wireBits / 1000.0,
+               r.decodedOk && r.maxErrQ == 0 ? "ok" : "FALHA");
+        ok &= r.decodedOk && r.maxErrQ == 0;
+    }
+    printf("\nTempo de download = tempo de fio; no nó sai um frame por volta do loop(),\n"
+           "então o tempo real é max(fio, frames x volta do loop).\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,266 @@
+//═══════════════════════════════════════════════════════════════════════════
+// isotp_bench - VAZÃO DO ISO-TP DO NÓ CONFORME BS/STmin E BITRATE
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: isotp_bench [-l volta_do_loop_us] [-n bytes] [-s semente]
+//
+// Dois IsoTp do firmware (Firmware_CanInput/include/isotp.h) ligados por
+// um barramento simulado em tempo virtual:
+//   - cada frame ocupa o fio por busload::frameBits / bitrate, um de cada vez
+//   - o nó chama poll() uma vez por volta do loop() (-l), lê um frame por
+//     volta (o MCP2515 guarda dois; o terceiro se perde) e o driver espera
+//     o frame anterior sair antes de carregar o próximo
+//   - o lado do host (kernel) responde e transmite sem atraso de agenda
+//
+// Cenários:
+//   nó → host   resposta do serviço 0x03 (histórico cheio, -n bytes) com
+//               o FC do host variando BS/STmin; comparado com o download
+//               antigo do 0x430 (um frame [seq][7 bytes] por volta)
+//   host → nó   maior pedido que o nó aceita (ISOTP_RX_MAX do firmware)
+//               com o FC do nó (BS 8 / STmin 1 ms do setup() e sem limite)
+//
+// Toda transferência é conferida byte a byte no receptor.
+//═══════════════════════════════════════════════════════════════════════════
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "bus_load.h"
+#include "isotp.h"
+#include "protocol.h"
+
+namespace {
+
+const uint16_t kNodeRxMax = 128;       // ISOTP_RX_MAX do firmware (aqui redefinido para o host)
+const uint32_t kStepUs = 5;            // Resolução do tempo virtual
+
+struct Endpoint;
+
+struct Bus {
+    struct InFlight {
+        uint64_t endNs;
+        Endpoint *to;
+        uint8_t data[8];
+        uint8_t len;
+    };
+    uint32_t bitrate = 500000;
+    uint64_t wireFreeNs = 0;
+    uint64_t bits = 0;
+    unsigned frames = 0;
+    std::deque<InFlight> wire;         // Ordem de término (o fio é serial)
+};
+
+struct Endpoint {
+    Bus *bus = nullptr;
+    Endpoint *peer = nullptr;
+    IsoTp *tp = nullptr;
+    uint64_t nowNs = 0;                // Relógio de quem está chamando send
+    uint64_t lastEndNs = 0;            // Fim do último frame próprio
+    uint64_t busyUntilNs = 0;          // Driver bloqueado esperando o TXB0
+    bool blockingDriver = false;       // MCP2515: um buffer de TX
+    std::deque<std::vector<uint8_t>> rxPending;  // MCP2515: dois buffers de RX
+    unsigned rxDropped = 0;
+};
+
+const size_t kMcpRxBuffers = 2;
+
+bool busSend(void *ctx, uint16_t id, const uint8_t *data, uint8_t len) {
+    Endpoint *ep = static_cast<Endpoint *>(ctx);
+    Bus &bus = *ep->bus;
+    uint64_t ready = ep->nowNs;
+    if (ep->blockingDriver && ep->lastEndNs > ready) {
+        ready = ep->lastEndNs;         // sendMsgBuf espera o anterior sair
+        if (ready > ep->busyUntilNs) ep->busyUntilNs = ready;
+    }
+    CanFrame f(id, data, len);
+    unsigned bits = busload::frameBits(f);
+    uint64_t start = ready > bus.wireFreeNs ? ready : bus.wireFreeNs;
+    uint64_t end = start + static_cast<uint64_t>(bits) * 1000000000ull / bus.bitrate;
+    Bus::InFlight fl;
+    fl.endNs = end;
+    fl.to = ep->peer;
+    fl.len = len;
+    for (uint8_t i = 0; i < len; i++) fl.data[i] = data[i];
+    bus.wire.push_back(fl);
+    bus.wireFreeNs = end;
+    bus.bits += bits;
+    bus.frames++;
+    ep->lastEndNs = end;
+    return true;
+}
+
+struct Result {
+    double ms = 0;
+    unsigned frames = 0;
+    uint64_t bits = 0;
+    unsigned dropped = 0;              // Frames perdidos nos buffers de RX do nó
+    bool completed = false;
+    bool ok = false;
+};
+
+// sender → receiver; o nó é quem tem volta de loop e driver bloqueante
+Result transfer(uint32_t bitrate, const std::vector<uint8_t> &payload, bool nodeSends, uint8_t bs, uint8_t stMin,
+                uint32_t loopUs) {
+    Bus bus;
+    bus.bitrate = bitrate;
+    Endpoint node, host;
+    node.bus = host.bus = &bus;
+    node.peer = &host;
+    host.peer = &node;
+    node.blockingDriver = true;
+    IsoTp nodeTp(proto::kIsoTpResponseId, busSend, &node);
+    IsoTp hostTp(proto::kIsoTpRequestId, busSend, &host);
+    node.tp = &nodeTp;
+    host.tp = &hostTp;
+
+    // FC de quem recebe
+    IsoTp &receiver = nodeSends ? hostTp : nodeTp;
+    receiver.blockSize = bs;
+    receiver.stMin = stMin;
+
+    Endpoint &tx = nodeSends ? node : host;
+    IsoTp &sender = *tx.tp;
+    static std::vector<uint8_t> source;
+    source = payload;
+    IsoTpSourceFn fn = [](void *, uint16_t offset, uint8_t *out, uint8_t n) -> uint8_t {
+        for (uint8_t i = 0; i < n; i++) out[i] = source[offset + i];
+        return n;
+    };
+    tx.nowNs = 0;
+    sender.send(static_cast<uint16_t>(payload.size()), fn, nullptr, 0);
+
+    uint64_t nextNodePoll = 0;
+    uint64_t limitNs = 10ull * 1000000000ull;
+    Result r;
+    for (uint64_t t = 0; t < limitNs; t += kStepUs * 1000) {
+        uint32_t us = static_cast<uint32_t>(t / 1000);
+        while (!bus.wire.empty() && bus.wire.front().endNs <= t) {
+            Bus::InFlight fl = bus.wire.front();
+            bus.wire.pop_front();
+            if (fl.to == &node) {
+                // O nó só lê na volta do loop(); buffers cheios = frame perdido
+                if (node.rxPending.size() >= kMcpRxBuffers) node.rxDropped++;
+                else node.rxPending.emplace_back(fl.data, fl.data + fl.len);
+            } else {
+                host.nowNs = t;
+                hostTp.onFrame(fl.data, fl.len, us);
+            }
+        }
+        host.nowNs = t;
+        hostTp.poll(us);
+        if (t >= nextNodePoll && t >= node.busyUntilNs) {
+            node.nowNs = t;
+            nodeTp.poll(us);
+            if (!node.rxPending.empty()) {
+                std::vector<uint8_t> f = node.rxPending.front();
+                node.rxPending.pop_front();
+                nodeTp.onFrame(f.data(), static_cast<uint8_t>(f.size()), us);
+            }
+            nextNodePoll = t + loopUs * 1000ull;
+        }
+        if (receiver.available()) {
+            r.ms = t / 1e6;
+            r.completed = true;
+            r.ok = receiver.length() == payload.size() &&
+                   std::equal(payload.begin(), payload.end(), receiver.message());
+            break;
+        }
+        // Perdeu frame: o receptor aborta (sequência) e o emissor fica sem FC
+        if (receiver.stats().errors || (!sender.sending() && sender.stats().errors)) break;
+    }
+    r.frames = bus.frames;
+    r.bits = bus.bits;
+    r.dropped = node.rxDropped;
+    return r;
+}
+
+// Download antigo: [seq][7 bytes] no 0x430, um frame por volta do loop()
+double legacyMs(uint32_t bitrate, size_t bytes, uint32_t loopUs) {
+    double ms = 0;
+    uint8_t data[8] = {0};
+    for (size_t done = 0; done < bytes; done += 7) {
+        uint8_t n = static_cast<uint8_t>(bytes - done > 7 ? 7 : bytes - done);
+        CanFrame f(proto::kHistoryDataId, data, static_cast<uint8_t>(1 + n));
+        double wire = busload::frameBits(f) * 1000.0 / bitrate;
+        ms += wire > loopUs / 1000.0 ? wire : loopUs / 1000.0;
+    }
+    return ms;
+}
+
+const char *stMinText(uint8_t st) {
+    static char buf[16];
+    uint32_t us = IsoTp::stMinUs(st);
+    if (us >= 1000) snprintf(buf, sizeof(buf), "%u ms", us / 1000);
+    else snprintf(buf, sizeof(buf), "%u us", us);
+    return buf;
+}
+
+void row(const char *what, uint32_t bitrate, size_t bytes, uint8_t bs, uint8_t st, const Result &r, bool &ok) {
+    char ms[16] = "-", kBps[16] = "-", eff[16] = "-";
+    if (r.completed && r.ms > 0) {
+        snprintf(ms, sizeof(ms), "%.1f", r.ms);
+        snprintf(kBps, sizeof(kBps), "%.1f", bytes / r.ms);
+        snprintf(eff, sizeof(eff), "%.1f%%", bytes * 8.0 / (r.ms / 1000.0) / bitrate * 100);
+    }
+    printf("%-12s %5uk %6zu %4u %8s %7u %9s %9s %8s %6s\n", what, bitrate / 1000, bytes, bs, stMinText(st), r.frames,
+           ms, kBps, eff, r.ok ? "ok" : !r.completed && r.dropped ? "perdeu" : "FALHA");
+    // Estouro dos buffers do MCP2515 é o resultado esperado sem STmin; só
+    // dados errados ou transferência parada sem perda contam como falha
+    ok &= r.ok || (!r.completed && r.dropped);
+}
+
+void usage() {
+    fprintf(stderr, "Uso: isotp_bench [-l volta_do_loop_us] [-n bytes] [-s semente]\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    uint32_t loopUs = 500;
+    size_t bytes = 2049;               // Serviço 0x03: 1 + HISTORY_BYTES
+    uint32_t seed = 12345;
+    int opt;
+    while ((opt = getopt(argc, argv, "l:n:s:h")) != -1) {
+        switch (opt) {
+            case 'l': loopUs = static_cast<uint32_t>(atoi(optarg)); break;
+            case 'n': bytes = static_cast<size_t>(atoi(optarg)); break;
+            case 's': seed = static_cast<uint32_t>(strtoul(optarg, nullptr, 0)); break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (bytes < 8 || bytes > ISOTP_MAX_LEN || loopUs == 0) {
+        usage();
+        return 2;
+    }
+
+    std::vector<uint8_t> big(bytes), small(kNodeRxMax);
+    uint32_t rng = seed;
+    for (uint8_t &b : big) b = static_cast<uint8_t>((rng = rng * 1664525u + 1013904223u) >> 24);
+    for (uint8_t &b : small) b = static_cast<uint8_t>((rng = rng * 1664525u + 1013904223u) >> 24);
+
+    printf("volta do loop() do no: %u us, %u CFs por poll() com STmin 0\n\n", loopUs, ISOTP_CF_PER_POLL);
+    printf("%-12s %6s %6s %4s %8s %7s %9s %9s %8s %6s\n", "sentido", "bps", "bytes", "BS", "STmin", "frames",
+           "ms", "kB/s", "fio", "dados");
+    bool ok = true;
+    const uint32_t rates[] = {500000, 1000000};
+    struct Fc {
+        uint8_t bs, st;
+    };
+    const Fc hostFc[] = {{0, 0}, {8, 0}, {2, 0}, {0, 0xF5}, {8, 1}};
+    for (uint32_t rate : rates) {
+        for (const Fc &fc : hostFc) row("no->host", rate, bytes, fc.bs, fc.st, transfer(rate, big, true, fc.bs, fc.st, loopUs), ok);
+        printf("%-12s %5uk %6zu %4s %8s %7zu %9.1f %9.1f\n", "0x430 antigo", rate / 1000, bytes - 1, "-", "-",
+               (bytes - 1 + 6) / 7, legacyMs(rate, bytes - 1, loopUs), (bytes - 1) / legacyMs(rate, bytes - 1, loopUs));
+        const Fc nodeFc[] = {{8, 1}, {0, 0}};
+        for (const Fc &fc : nodeFc) row("host->no", rate, small.size(), fc.bs, fc.st, transfer(rate, small, false, fc.bs, fc.st, loopUs), ok);
+        printf("\n");
+    }
+    printf("fio = bits de dados / (tempo x bitrate). Com STmin 0 o nó manda até %u CFs\n"
+           "por volta (o driver espera cada um sair); BS pequeno custa um FC e uma\n"
+           "volta do loop() a cada bloco. \"perdeu\" = CFs mais rápidos que o loop()\n"
+           "do nó estouraram os dois buffers de RX do MCP2515.\n", ISOTP_CF_PER_POLL);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,283 @@
+//═══════════════════════════════════════════════════════════════════════════
+// metrics_bench - CUSTO DAS MÉTRICAS NO LAÇO E SCRAPES CONCORRENTES
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: metrics_bench [-n containers] [-t segundos] [-c scrapers] [-a endereço]
+//
+// Monta um Registry do tamanho do que o cansupd -m cria (16 temperaturas,
+// 8 relés, contadores, 4 histogramas por container), serve por
+// metrics::Server (padrão unix:/tmp/metrics_bench.sock; também
+// 127.0.0.1:porta) e roda o "laço": uma thread que, por frame, faz o que o
+// cansupd faz (contador rx, gauges de temperatura, histograma de latência).
+//
+//   1. confere o formato do /metrics (HELP/TYPE, amostras, _count = +Inf)
+//   2. -t segundos só o laço: ns por frame e p99/máx de uma atualização
+//   3. -t segundos com -c clientes fazendo GET /metrics sem parar pelo
+//      socket: os mesmos números do laço + scrapes/s e latência do scrape
+//
+// O laço nunca espera o scrape (só atômicos); a diferença entre 2 e 3 é
+// cache compartilhado, não bloqueio. Código 1 se o formato não bater.
+//═══════════════════════════════════════════════════════════════════════════
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics.h"
+#include "metrics_server.h"
+#include "supervisor.h"
+
+namespace {
+
+uint64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+struct Container {
+    metrics::Counter *rx;
+    std::vector<metrics::Gauge *> temps, relays, others;
+    std::vector<metrics::Histogram *> latency;
+};
+
+std::vector<Container> build(metrics::Registry &r, unsigned n) {
+    using metrics::label;
+    using metrics::labels;
+    std::vector<Container> out(n);
+    for (unsigned c = 0; c < n; c++) {
+        std::string name = label("container", std::to_string(c));
+        Container &k = out[c];
+        k.rx = &r.counter("bench_rx_frames_total", "Frames", labels({name, label("interface", "vcan" + std::to_string(c))}));
+        for (int m = 0; m < 3; m++) {
+            for (const char *s : {"TL", "TR", "BL", "BR", "CJ"})
+                k.temps.push_back(&r.gauge("bench_temperature_celsius", "Temperaturas",
+                                           labels({name, label("message", "CANTemp" + std::to_string(m + 1)),
+                                                   label("signal", std::string(s) + "Temp")})));
+        }
+        k.temps.push_back(&r.gauge("bench_temperature_celsius", "Temperaturas",
+                                   labels({name, label("message", "extra"), label("signal", "X")})));
+        for (int i = 0; i < 8; i++)
+            k.relays.push_back(&r.gauge("bench_relay_on", "Relés", labels({name, label("relay", "D" + std::to_string(i + 1))})));
+        for (const char *g : {"bench_state", "bench_tec", "bench_rec", "bench_eflg", "bench_load_ratio",
+                              "bench_flash_progress_ratio", "bench_flash_phase", "bench_motor", "bench_water",
+                              "bench_age_seconds"})
+            k.others.push_back(&r.gauge(g, "Estado", name));
+        for (const char *h : {"bench_decision_seconds", "bench_actuation_seconds", "bench_rtt_0x402_seconds",
+                              "bench_rtt_rtr_seconds"})
+            k.latency.push_back(&r.histogram(h, "Latência", name));
+    }
+    return out;
+}
+
+bool checkFormat(const std::string &text, size_t &samples) {
+    std::istringstream in(text);
+    std::string line, lastInf;
+    samples = 0;
+    bool ok = true;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 7, "# HELP ") == 0 || line.compare(0, 7, "# TYPE ") == 0) continue;
+        size_t sp = line.rfind(' ');
+        size_t brace = line.find('{');
+        bool good = sp != std::string::npos && sp + 1 < line.size() && line[0] != '#' &&
+                    (brace == std::string::npos || line[sp - 1] == '}');
+        if (!good) {
+            fprintf(stderr, "linha inválida: %s\n", line.c_str());
+            ok = false;
+            continue;
+        }
+        samples++;
+        std::string value = line.substr(sp + 1);
+        if (line.find("le=\"+Inf\"") != std::string::npos) lastInf = value;
+        std::string name = line.substr(0, brace == std::string::npos ? sp : brace);
+        if (name.size() > 6 && name.compare(name.size() - 6, 6, "_count") == 0) {
+            if (value != lastInf) {
+                fprintf(stderr, "_count %s diferente do +Inf %s\n", value.c_str(), lastInf.c_str());
+                ok = false;
+            }
+        }
+    }
+    return ok && samples > 0;
+}
+
+int connectTo(const std::string &address) {
+    if (address.compare(0, 5, "unix:") == 0) {
+        struct sockaddr_un sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sun_family = AF_UNIX;
+        strncpy(sa.sun_path, address.c_str() + 5, sizeof(sa.sun_path) - 1);
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<struct sockaddr *>(&sa), sizeof(sa)) < 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+    size_t colon = address.rfind(':');
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(static_cast<uint16_t>(atoi(address.c_str() + colon + 1)));
+    std::string host = address.substr(0, colon);
+    inet_pton(AF_INET, host.empty() ? "127.0.0.1" : host.c_str(), &sa.sin_addr);
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<struct sockaddr *>(&sa), sizeof(sa)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// GET /metrics inteiro; "" em erro
+std::string scrape(const std::string &address) {
+    int fd = connectTo(address);
+    if (fd < 0) return "";
+    const char req[] = "GET /metrics HTTP/1.0\r\n\r\n";
+    std::string resp;
+    if (send(fd, req, sizeof(req) - 1, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(req) - 1)) {
+        char buf[16384];
+        ssize_t n;
+        while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) resp.append(buf, static_cast<size_t>(n));
+    }
+    close(fd);
+    size_t body = resp.find("\r\n\r\n");
+    if (resp.compare(0, 12, "HTTP/1.0 200") != 0 || body == std::string::npos) return "";
+    return resp.substr(body + 4);
+}
+
+struct LoopResult {
+    uint64_t frames = 0;
+    double seconds = 0;
+    sup::LatencyHistogram perUpdate;   // ns, amostrado
+};
+
+// O "laço" do cansupd: por frame, rx++, uma temperatura, às vezes relés e latência
+void runLoop(std::vector<Container> &cs, double seconds, LoopResult &res) {
+    uint64_t start = monotonicNs(), end = start + static_cast<uint64_t>(seconds * 1e9);
+    uint32_t rng = 1;
+    uint64_t i = 0, now = start;
+    for (; now < end; i++) {
+        Container &c = cs[i % cs.size()];
+        rng = rng * 1664525u + 1013904223u;
+        bool sample = (i & 63) == 0;
+        uint64_t t0 = sample ? monotonicNs() : 0;
+        c.rx->inc();
+        c.temps[rng % c.temps.size()]->set(20 + (rng >> 24) / 4.0);
+        if ((rng >> 8) % 10 == 0) {
+            c.latency[0]->observe(((rng >> 12) % 2000) * 1e-6);
+            c.relays[(rng >> 4) % 8]->set((rng >> 20) & 1);
+            c.others[(rng >> 16) % c.others.size()]->set(rng >> 24);
+        }
+        if (sample) res.perUpdate.add(monotonicNs() - t0);
+        if ((i & 1023) == 0) now = monotonicNs();
+    }
+    res.frames = i;
+    res.seconds = (monotonicNs() - start) / 1e9;
+}
+
+void printLoop(const char *what, const LoopResult &r) {
+    printf("%-22s %.1f ns por frame (%.1f M frames/s); atualização p50 %lu ns, p99 %lu ns, máx %lu ns\n", what,
+           r.seconds * 1e9 / r.frames, r.frames / r.seconds / 1e6,
+           static_cast<unsigned long>(r.perUpdate.percentile(0.5)),
+           static_cast<unsigned long>(r.perUpdate.percentile(0.99)), static_cast<unsigned long>(r.perUpdate.max()));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    unsigned containers = 4, scrapers = 2;
+    double seconds = 2;
+    std::string address = "unix:/tmp/metrics_bench.sock";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:c:a:h")) != -1) {
+        switch (opt) {
+            case 'n': containers = static_cast<unsigned>(atoi(optarg)); break;
+            case 't': seconds = atof(optarg); break;
+            case 'c': scrapers = static_cast<unsigned>(atoi(optarg)); break;
+            case 'a': address = optarg; break;
+            default:
+                fprintf(stderr, "Uso: metrics_bench [-n containers] [-t segundos] [-c scrapers] [-a endereço]\n");
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (!containers || seconds <= 0) {
+        fprintf(stderr, "metrics_bench: -n >= 1, -t > 0\n");
+        return 2;
+    }
+
+    try {
+        metrics::Registry registry;
+        std::vector<Container> cs = build(registry, containers);
+        metrics::Server server(registry);
+        server.listen(address);
+        server.start();
+
+        // Alguma coisa em cada histograma antes de conferir
+        for (Container &c : cs)
+            for (metrics::Histogram *h : c.latency) h->observe(0.0003);
+
+        std::string body = scrape(address);
+        size_t samples = 0;
+        bool ok = checkFormat(body, samples);
+        uint64_t t0 = monotonicNs();
+        const int kRenders = 200;
+        for (int i = 0; i < kRenders; i++) body = registry.render();
+        double renderUs = (monotonicNs() - t0) / 1e3 / kRenders;
+        printf("%u containers: %zu amostras, %zu bytes, render %.1f us, formato %s\n\n", containers, samples,
+               body.size(), renderUs, ok ? "ok" : "ERRO");
+
+        LoopResult alone, loaded;
+        runLoop(cs, seconds, alone);
+        printLoop("só o laço:", alone);
+
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> failures{0};
+        std::vector<sup::LatencyHistogram> scrapeUs(scrapers);
+        std::vector<std::thread> clients;
+        for (unsigned k = 0; k < scrapers; k++) {
+            clients.emplace_back([&, k] {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    uint64_t s = monotonicNs();
+                    if (scrape(address).empty()) failures++;
+                    scrapeUs[k].add((monotonicNs() - s) / 1000);
+                }
+            });
+        }
+        runLoop(cs, seconds, loaded);
+        stop = true;
+        for (auto &t : clients) t.join();
+        server.stop();
+
+        char what[64];
+        snprintf(what, sizeof(what), "com %u scrapers:", scrapers);
+        printLoop(what, loaded);
+
+        uint64_t count = 0;
+        for (const auto &h : scrapeUs) count += h.count();
+        for (unsigned k = 0; k < scrapers; k++) {
+            printf("  scraper %u: %lu scrapes, p50 %lu us, p99 %lu us, máx %lu us\n", k,
+                   static_cast<unsigned long>(scrapeUs[k].count()),
+                   static_cast<unsigned long>(scrapeUs[k].percentile(0.5)),
+                   static_cast<unsigned long>(scrapeUs[k].percentile(0.99)),
+                   static_cast<unsigned long>(scrapeUs[k].max()));
+        }
+        printf("%.0f scrapes/s por %s, %lu falhas\n", count / loaded.seconds, address.c_str(),
+               static_cast<unsigned long>(failures.load()));
+        return ok && !failures ? 0 : 1;
+    } catch (const std::exception &e) {
+        fprintf(stderr, "metrics_bench: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,168 @@
+//═══════════════════════════════════════════════════════════════════════════
+// snapshot_stress - ESTRESSE DO SNAPSHOT DUPLO (Firmware_CanInput/include/snapshot.h)
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: snapshot_stress [-t segundos] [-r leitores] [-n]
+//
+// Uma thread faz o papel do produtor (loop do firmware) e publica SensorState
+// sem parar; as outras fazem o papel dos leitores (ISRs de alarme) e conferem
+// cada cópia. Todos os campos de uma publicação derivam do mesmo contador k,
+// então qualquer mistura de duas publicações é detectada.
+//
+//   -n  controle: buffer único sem sequência (o que o firmware fazia com
+//       "volatile float"), para mostrar que a verificação enxerga rasgos
+//
+// Código de saída: 0 = nenhuma cópia rasgada no modo snapshot, 1 = rasgos.
+// O modo -n sai com 0 quando encontra rasgos (controle funcionou).
+//═══════════════════════════════════════════════════════════════════════════
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "snapshot.h"
+
+namespace {
+
+void fill(SensorState &s, uint32_t k) {
+    for (int c = 0; c < SNAPSHOT_CHANNELS; c++) {
+        s.temp[c] = (float)((k & 0xFFFF) + c);   // Exato em float (< 2^24)
+        s.sampleMs[c] = k * 4 + c;
+    }
+    s.trippedMask = (uint8_t)k;
+}
+
+// Retorna true se todos os campos vieram da mesma publicação
+bool consistent(const SensorState &s) {
+    uint32_t k = s.sampleMs[0] / 4;
+    SensorState expected;
+    memset(&expected, 0, sizeof(expected));
+    fill(expected, k);
+    for (int c = 0; c < SNAPSHOT_CHANNELS; c++) {
+        if (s.temp[c] != expected.temp[c] || s.sampleMs[c] != expected.sampleMs[c]) return false;
+    }
+    return s.trippedMask == expected.trippedMask;
+}
+
+struct ReaderStats {
+    uint64_t reads = 0;
+    uint64_t torn = 0;
+    uint64_t retries = 0;
+    uint64_t retriedReads = 0;
+};
+
+// Buffer único: o produtor escreve campo a campo por cima do que o leitor copia
+struct Naive {
+    SensorState s;
+    void publish(uint32_t k) {
+        for (int c = 0; c < SNAPSHOT_CHANNELS; c++) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            ((volatile float *)s.temp)[c] = (float)((k & 0xFFFF) + c);
+            ((volatile uint32_t *)s.sampleMs)[c] = k * 4 + c;
+        }
+        ((volatile uint8_t &)s.trippedMask) = (uint8_t)k;
+    }
+    void read(SensorState &out) {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        memcpy(&out, (const void *)&s, sizeof(out));
+    }
+};
+
+void usage() {
+    fprintf(stderr, "Uso: snapshot_stress [-t segundos] [-r leitores] [-n]\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    double seconds = 2.0;
+    unsigned readers = 2;
+    bool naive = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:r:nh")) != -1) {
+        switch (opt) {
+            case 't': seconds = atof(optarg); break;
+            case 'r': readers = (unsigned)atoi(optarg); break;
+            case 'n': naive = true; break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (readers == 0) readers = 1;
+
+    // Seq de 32 bits: ver comentário em snapshot.h (preempção no host)
+    static Snapshot<SensorState, uint32_t> snap;
+    static Naive plain;
+    memset(&plain.s, 0, sizeof(plain.s));
+
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> published(0);
+    std::vector<ReaderStats> stats(readers);
+
+    std::thread writer([&] {
+        uint32_t k = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            k++;
+            if (naive) {
+                plain.publish(k);
+            } else {
+                fill(snap.edit(), k);
+                snap.publish();
+            }
+        }
+        published = k;
+    });
+
+    std::vector<std::thread> pool;
+    for (unsigned r = 0; r < readers; r++) {
+        pool.emplace_back([&, r] {
+            ReaderStats &st = stats[r];
+            SensorState copy;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (naive) {
+                    plain.read(copy);
+                } else {
+                    uint8_t extra = snap.read(copy);
+                    st.retries += extra;
+                    if (extra) st.retriedReads++;
+                }
+                st.reads++;
+                if (!consistent(copy)) st.torn++;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    writer.join();
+    for (std::thread &t : pool) t.join();
+
+    ReaderStats total;
+    for (const ReaderStats &st : stats) {
+        total.reads += st.reads;
+        total.torn += st.torn;
+        total.retries += st.retries;
+        total.retriedReads += st.retriedReads;
+    }
+
+    printf("modo:           %s\n", naive ? "buffer único (controle)" : "snapshot duplo + seq");
+    printf("publicações:    %llu\n", (unsigned long long)published.load());
+    printf("leituras:       %llu (%u leitores)\n", (unsigned long long)total.reads, readers);
+    printf("rasgadas:       %llu\n", (unsigned long long)total.torn);
+    if (!naive) {
+        printf("refeitas:       %llu (%.3f%%), %llu tentativas extras\n",
+               (unsigned long long)total.retriedReads,
+               total.reads ? 100.0 * total.retriedReads / total.reads : 0.0,
+               (unsigned long long)total.retries);
+    }
+
+    if (naive) {
+        if (total.torn == 0) printf("AVISO: nenhum rasgo no controle, aumente -t\n");
+        return 0;
+    }
+    return total.torn ? 1 : 0;
+}
@@ -0,0 +1,191 @@
+//═══════════════════════════════════════════════════════════════════════════
+// timesync_bench - PRECISÃO DO RELÓGIO SINCRONIZADO (SYNC/FOLLOW-UP)
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: timesync_bench [-m minutos] [-s semente] [-L loop_us]
+//
+// Roda o TimeSync do firmware (Firmware_CanInput/include/timesync.h) em dois
+// nós simulados contra um mestre ideal, sem barramento:
+//
+//   - relógio local = micros() de 32 bits com passo de 4 µs (16 MHz / 64),
+//     adiantado ou atrasado em ppm (cristal ~±50 ppm, ressonador ~±2000)
+//   - t1 = saída real do SYNC + atraso do eco no host (uniforme 0..J)
+//   - t2 = fim do frame no nó + latência da ISR do INT (uniforme 4..12 µs);
+//     uma fração dos SYNCs chega com outro frame na fila e é rejeitada
+//   - a aquisição alinhada (sync.align) dispara no primeiro loop() depois
+//     do instante agendado: atraso uniforme 0..L (padrão 500 µs)
+//
+// Por cenário: erro do relógio de um nó contra o mestre depois de travado
+// (médio = viés, p99, máximo), distância entre os relógios dos dois nós e
+// entre os ciclos de aquisição deles, comparado com dois nós livres
+// (millis() de cada um) no mesmo intervalo.
+//═══════════════════════════════════════════════════════════════════════════
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "timesync.h"
+
+namespace {
+
+struct Scenario {
+    const char *name;
+    double ppmA, ppmB;          // Relógio de cada nó
+    unsigned periodMs;          // Período do SYNC
+    unsigned echoJitterUs;      // Atraso máximo do eco no host
+    double queuedFraction;      // SYNCs com outro frame na fila (rejeitados)
+    unsigned outageS;           // Sem SYNC nos últimos outageS segundos
+};
+
+const Scenario kScenarios[] = {
+    {"cristal, 1 s, socketcan", 40, -35, 1000, 20, 0.02, 0},
+    {"cristal, 100 ms", 40, -35, 100, 20, 0.02, 0},
+    {"ressonador ±2000 ppm", 1800, -2100, 1000, 20, 0.02, 0},
+    {"adaptador USB (eco 200 µs)", 40, -35, 1000, 200, 0.02, 0},
+    {"barramento cheio (30% fila)", 40, -35, 1000, 20, 0.30, 0},
+    {"60 s sem SYNC (holdover)", 40, -35, 1000, 20, 0.02, 60},
+};
+
+const uint64_t kEpochUs = 1760000000ull * 1000000ull;   // µs Unix arbitrário
+const unsigned kSettleS = 30;                           // Fora da estatística
+
+// Uniforme em [0, 1) determinística
+double uniform(uint32_t &state) {
+    state = state * 1664525u + 1013904223u;
+    return (state >> 8) / 16777216.0;
+}
+
+struct Node {
+    double ppm;
+    double originUs;            // micros() começa num instante qualquer
+    TimeSync sync;
+
+    // micros() no instante real t (µs desde o início da simulação)
+    uint32_t local(double t) const {
+        double us = (t + originUs) * (1.0 + ppm * 1e-6);
+        return static_cast<uint32_t>(static_cast<uint64_t>(us) & ~3ull);
+    }
+    // Instante real em que micros() passa por l (inverso de local, sem o passo)
+    double real(uint32_t l, double near) const {
+        uint32_t ref = local(near);
+        double dl = static_cast<int32_t>(l - ref);
+        return near + dl / (1.0 + ppm * 1e-6);
+    }
+};
+
+struct Stats {
+    std::vector<double> v;
+    void add(double x) { v.push_back(x); }
+    double mean() const {
+        double s = 0;
+        for (double x : v) s += x;
+        return v.empty() ? 0 : s / v.size();
+    }
+    double absQuantile(double q) {
+        if (v.empty()) return 0;
+        std::vector<double> a(v.size());
+        for (size_t i = 0; i < v.size(); i++) a[i] = fabs(v[i]);
+        size_t k = std::min(a.size() - 1, static_cast<size_t>(q * a.size()));
+        std::nth_element(a.begin(), a.begin() + k, a.end());
+        return a[k];
+    }
+};
+
+struct Result {
+    Stats clockA, nodes, ticks;
+    double freeRunUs = 0;       // Distância entre dois millis() livres no fim
+    uint8_t state = TSYNC_NONE;
+};
+
+Result run(const Scenario &sc, double minutes, unsigned loopUs, uint32_t seed) {
+    Result r;
+    uint32_t rng = seed;
+    Node nodes[2] = {{sc.ppmA, 1e6 + uniform(rng) * 1e9, TimeSync()}, {sc.ppmB, 1e6 + uniform(rng) * 1e9, TimeSync()}};
+    const double endUs = minutes * 60e6;
+    const double outageStart = endUs - sc.outageS * 1e6;
+    const double periodUs = sc.periodMs * 1000.0;
+    const double acqUs = 100e3;         // aquisc.timer = 100 ms
+    uint8_t seq = 0;
+
+    for (double t = 0; t < endUs; t += periodUs) {
+        if (t < outageStart || !sc.outageS) {
+            // SYNC sai do mestre em t (fim do frame); eco chega no host depois
+            double t1 = t + uniform(rng) * sc.echoJitterUs;
+            for (Node &n : nodes) {
+                bool queued = uniform(rng) < sc.queuedFraction;
+                double t2 = t + 4 + uniform(rng) * 8;
+                n.sync.onSync(seq, n.local(t2), !queued);
+                // FOLLOW-UP chega ~1 ms depois
+                n.sync.onFollowUp(seq, (kEpochUs + static_cast<uint64_t>(llround(t1))) & TIMESYNC_MASK);
+            }
+            seq++;
+        }
+
+        // Amostra o erro em instantes aleatórios até o próximo SYNC
+        for (double s = t; s < t + periodUs; s += 100e3) {
+            double at = s + uniform(rng) * 100e3;
+            for (Node &n : nodes) n.sync.poll(n.local(at));
+            if (at < kSettleS * 1e6) continue;
+            double truth = static_cast<double>((kEpochUs + static_cast<uint64_t>(at)) & TIMESYNC_MASK);
+            double a = static_cast<double>(nodes[0].sync.now(nodes[0].local(at))) - truth;
+            double b = static_cast<double>(nodes[1].sync.now(nodes[1].local(at))) - truth;
+            r.clockA.add(a);
+            r.nodes.add(a - b);
+
+            // Próximo ciclo alinhado de cada nó (acquisitionDue) e o loop() que o vê
+            uint64_t next = (nodes[0].sync.now(nodes[0].local(at)) / 100000 + 1) * 100000;
+            double fire[2];
+            for (int i = 0; i < 2; i++) {
+                uint32_t l = nodes[i].sync.toLocal(next);
+                fire[i] = nodes[i].real(l, at) + uniform(rng) * loopUs;
+            }
+            if (fabs(fire[0] - fire[1]) < acqUs / 2) r.ticks.add(fire[0] - fire[1]);
+        }
+    }
+    r.freeRunUs = fabs(sc.ppmA - sc.ppmB) * 1e-6 * endUs;
+    r.state = nodes[0].sync.state();
+    return r;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    double minutes = 20;
+    unsigned loopUs = 500;
+    uint32_t seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:s:L:h")) != -1) {
+        switch (opt) {
+            case 'm': minutes = atof(optarg); break;
+            case 's': seed = static_cast<uint32_t>(strtoul(optarg, nullptr, 0)); break;
+            case 'L': loopUs = static_cast<unsigned>(atoi(optarg)); break;
+            default:
+                fprintf(stderr, "Uso: timesync_bench [-m minutos] [-s semente] [-L loop_us]\n");
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (minutes * 60 <= kSettleS + 60) {
+        fprintf(stderr, "timesync_bench: -m precisa passar de %.1f minutos\n", (kSettleS + 60) / 60.0);
+        return 2;
+    }
+
+    printf("%.0f min simulados por cenário, loop() até %u us, estatística depois de %u s\n\n", minutes, loopUs,
+           kSettleS);
+    static const char *const states[] = {"sem sync", "adquirindo", "travado", "holdover"};
+    printf("%-30s %18s %16s %18s %14s  %s\n", "cenário", "nó-mestre us", "nó A-nó B us", "ciclos A-B us",
+           "livres us", "estado do A");
+    printf("%-30s %18s %16s %18s %14s\n", "", "viés / p99 / máx", "p99 / máx", "p99 / máx", "no fim");
+    for (const Scenario &sc : kScenarios) {
+        Result r = run(sc, minutes, loopUs, seed);
+        char clock[32], nodes[32], ticks[32];
+        snprintf(clock, sizeof(clock), "%+.0f / %.0f / %.0f", r.clockA.mean(), r.clockA.absQuantile(0.99),
+                 r.clockA.absQuantile(1.0));
+        snprintf(nodes, sizeof(nodes), "%.0f / %.0f", r.nodes.absQuantile(0.99), r.nodes.absQuantile(1.0));
+        snprintf(ticks, sizeof(ticks), "%.0f / %.0f", r.ticks.absQuantile(0.99), r.ticks.absQuantile(1.0));
+        printf("%-30s %18s %16s %18s %14.0f  %s\n", sc.name, clock, nodes, ticks, r.freeRunUs, states[r.state & 3]);
+    }
+    return 0;
+}
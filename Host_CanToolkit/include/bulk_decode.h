@@ -0,0 +1,69 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - DECODIFICAÇÃO OFFLINE EM MASSA (captura → colunas)
+//═══════════════════════════════════════════════════════════════════════════
+// Pipeline:
+//   1. Carga: a captura (.canlog ou texto do candump) é dividida em fatias
+//      parseadas em paralelo. Cada frame conhecido pelo DBC vai para a coluna
+//      de timestamps e a coluna de payloads (uint64) da sua mensagem.
+//   2. Decodificação: por mensagem, cada sinal é um laço sem desvios sobre a
+//      coluna de payloads ((p >> shift) & mask) * fator + offset, que o
+//      compilador vetoriza. Mensagens diferentes rodam em threads diferentes.
+//   3. Saída: um CSV e/ou um arquivo de colunas binárias por mensagem.
+//
+// Formato de colunas binárias (<Mensagem>_<ID>.cols), little-endian:
+//   Header 24 bytes: "CANCOL1\0" | uint32 ncols | uint32 reservado | uint64 linhas
+//   ncols descritores de 64 bytes: char nome[48] | char unidade[16]
+//   ncols colunas contíguas de linhas × float64 (coluna 0 = tempo em s)
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef BULK_DECODE_H
+#define BULK_DECODE_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "dbc.h"
+
+namespace bulk {
+
+// Frames de uma mensagem do DBC, em ordem de chegada (estrutura de arrays)
+struct FrameColumns {
+    std::vector<uint64_t> timeNs;
+    std::vector<uint64_t> payload;  // data[0..7] lido como uint64 little-endian
+};
+
+struct Capture {
+    std::vector<FrameColumns> groups;  // Um por mensagem, mesmo índice de Database::messages()
+    uint64_t frames = 0;               // Total de frames lidos
+    uint64_t unknown = 0;              // IDs ausentes do DBC
+    uint64_t remote = 0;               // RTR (sem dados)
+};
+
+// Detecta o formato pelo header ("CANLOG1" ou texto do candump, com ou sem -L)
+// e carrega usando até `threads` threads. Lança std::runtime_error/system_error.
+Capture loadCapture(const std::string &path, const dbc::Database &db, unsigned threads);
+
+struct DecodedMessage {
+    std::vector<double> time;                  // Segundos (epoch da captura)
+    std::vector<std::vector<double>> columns;  // Um vetor por sinal, na ordem do DBC
+};
+
+DecodedMessage decode(const dbc::Message &msg, const FrameColumns &frames);
+
+enum OutputFormat { OutputCsv = 1, OutputBinary = 2 };
+
+void writeCsv(const std::string &path, const dbc::Message &msg, const DecodedMessage &data);
+void writeColumns(const std::string &path, const dbc::Message &msg, const DecodedMessage &data);
+
+// Nome base dos arquivos de saída: <Mensagem>_<ID hex>
+std::string outputName(const dbc::Message &msg);
+
+// Decodifica e grava todas as mensagens com frames, em paralelo entre IDs.
+// Retorna o número de arquivos escritos.
+size_t decodeAll(const Capture &capture, const dbc::Database &db, const std::string &outDir, int formats,
+                 unsigned threads);
+
+}  // namespace bulk
+
+#endif
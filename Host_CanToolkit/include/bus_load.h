@@ -0,0 +1,44 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - CARGA DO BARRAMENTO
+//═══════════════════════════════════════════════════════════════════════════
+// Conta os bits reais de cada frame (com bit stuffing e CRC-15 calculados
+// sobre o frame montado) para medir a ocupação do barramento a partir de
+// uma captura. Usado pelo canlogcat -s para comparar "antes/depois"
+// (ex.: polling por RTR x ingestão em push, ver Firmware ingest.h).
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef BUS_LOAD_H
+#define BUS_LOAD_H
+
+#include <stdint.h>
+
+#include <map>
+
+#include "can_frame.h"
+
+namespace busload {
+
+// Bits no fio: SOF até o CRC com stuffing + delimitadores, ACK, EOF e IFS (3)
+unsigned frameBits(const CanFrame &frame);
+
+struct IdLoad {
+    uint64_t frames = 0;
+    uint64_t remotes = 0;
+    uint64_t bits = 0;
+};
+
+struct LoadStats {
+    uint64_t frames = 0;
+    uint64_t bits = 0;
+    uint64_t firstNs = 0, lastNs = 0;
+    std::map<uint32_t, IdLoad> perId;  // Chave: ID | 0x80000000 se extended
+
+    void add(const CanFrame &frame);
+    double seconds() const { return lastNs > firstNs ? (lastNs - firstNs) / 1e9 : 0.0; }
+    // Fração do tempo de barramento ocupada (0-1) no bitrate dado
+    double load(uint32_t bitrate) const;
+    double load(const IdLoad &id, uint32_t bitrate) const;
+};
+
+}  // namespace busload
+
+#endif
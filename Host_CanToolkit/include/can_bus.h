@@ -0,0 +1,108 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - CONEXÃO SOCKETCAN PERSISTENTE
+//═══════════════════════════════════════════════════════════════════════════
+// Um único socket CAN_RAW por interface, aberto uma vez e reutilizado por
+// todos os envios. A recepção roda numa thread própria que lê em lote
+// (recvmmsg) e despacha cada frame para os callbacks inscritos.
+//
+// Erros de sistema são reportados com std::system_error.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef CAN_BUS_H
+#define CAN_BUS_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "can_frame.h"
+
+class CanBus {
+public:
+    using Handler = std::function<void(const CanFrame &)>;
+
+    // Flags no filterId/mask do subscribe (mesma convenção do mcp_can e do firmware)
+    static constexpr uint32_t kExtendedFlag = 0x80000000;
+    static constexpr uint32_t kRemoteFlag = 0x40000000;
+
+    // Abre e faz bind em ifname (ex: "can0", "vcan0")
+    explicit CanBus(const std::string &ifname);
+    ~CanBus();
+
+    CanBus(const CanBus &) = delete;
+    CanBus &operator=(const CanBus &) = delete;
+
+    // Envio de um frame (bloqueia se a fila de TX do kernel estiver cheia)
+    void send(const CanFrame &frame);
+
+    // Envio em lote com uma única syscall (sendmmsg); retorna frames enviados
+    size_t sendBatch(const CanFrame *frames, size_t count);
+    size_t sendBatch(const std::vector<CanFrame> &frames) { return sendBatch(frames.data(), frames.size()); }
+
+    // Inscreve um callback para frames cujo (id & mask) == (filterId & mask),
+    // com id = ID | kExtendedFlag (29 bits) | kRemoteFlag (RTR). Com mask != 0
+    // o tipo do ID sempre conta: 0x402/0x7FF não recebe um 29 bits terminado
+    // em 0x402 (para extended, kExtendedFlag no filterId). O RTR só conta se
+    // kRemoteFlag estiver na mask. mask = 0 recebe tudo. Os callbacks rodam
+    // na thread de recepção.
+    int subscribe(uint32_t filterId, uint32_t mask, Handler handler);
+    void unsubscribe(int handle);
+
+    // Thread de recepção (iniciada automaticamente no primeiro subscribe)
+    void start();
+    void stop();
+
+    // Sem a thread (laço de eventos próprio com epoll sobre fd()): lê o que
+    // já está no socket, até max frames, sem bloquear; 0 = nada pendente
+    size_t receiveBatch(CanFrame *frames, size_t max);
+
+    // Frames recebidos/enviados desde a abertura
+    uint64_t rxCount() const { return rxFrames_.load(std::memory_order_relaxed); }
+    uint64_t txCount() const { return txFrames_.load(std::memory_order_relaxed); }
+
+    // Último erro do socket visto pela thread de recepção (errno; 0 = nenhum),
+    // p.ex. ENETDOWN com a interface derrubada. A thread espera 100 ms e tenta de novo.
+    int rxError() const { return rxError_.load(std::memory_order_relaxed); }
+
+    // Aumenta o buffer de recepção do socket (captura em alta taxa)
+    void setReceiveBuffer(int bytes);
+
+    // Recebe também os próprios frames (CAN_RAW_RECV_OWN_MSGS), marcados com
+    // CanFrame::echo. O timestamp do eco é o instante real de TX no kernel.
+    void setReceiveOwn(bool on);
+
+    const std::string &interfaceName() const { return ifname_; }
+    int fd() const { return fd_; }
+
+private:
+    struct Subscription {
+        int handle;
+        uint32_t id;
+        uint32_t mask;
+        Handler handler;
+    };
+    using SubscriptionList = std::vector<Subscription>;
+
+    void rxLoop();
+    void dispatch(const CanFrame &frame);
+
+    std::string ifname_;
+    int fd_ = -1;
+    int wakeFd_ = -1;
+
+    // Lista copy-on-write: a thread de RX só faz um load atômico do ponteiro
+    std::shared_ptr<const SubscriptionList> subs_;
+    std::mutex subsMutex_;
+    int nextHandle_ = 1;
+
+    std::thread rxThread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> rxFrames_{0};
+    std::atomic<uint64_t> txFrames_{0};
+    std::atomic<int> rxError_{0};
+};
+
+#endif
@@ -0,0 +1,37 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - FRAME CAN
+//═══════════════════════════════════════════════════════════════════════════
+// Representação única de um frame CAN no lado host. Todas as ferramentas
+// (bus, gravador, decodificador, supervisor) trocam CanFrame entre si.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef CAN_FRAME_H
+#define CAN_FRAME_H
+
+#include <stdint.h>
+#include <string.h>
+
+struct CanFrame {
+    uint32_t id = 0;            // ID sem flags (11 ou 29 bits)
+    bool extended = false;      // ID de 29 bits
+    bool remote = false;        // Remote Frame (RTR)
+    uint8_t dlc = 0;            // 0-8
+    uint8_t data[8] = {0};
+    uint64_t timestampNs = 0;   // Timestamp do kernel (CLOCK_REALTIME), 0 se não houver
+    bool echo = false;          // Confirmação de TX deste socket (CanBus::setReceiveOwn)
+
+    CanFrame() = default;
+    CanFrame(uint32_t id_, const uint8_t *payload, uint8_t len, bool ext = false)
+        : id(id_), extended(ext), dlc(len > 8 ? 8 : len) {
+        if (payload) memcpy(data, payload, dlc);
+    }
+
+    static CanFrame rtr(uint32_t id_, bool ext = false) {
+        CanFrame f;
+        f.id = id_;
+        f.extended = ext;
+        f.remote = true;
+        return f;
+    }
+};
+
+#endif
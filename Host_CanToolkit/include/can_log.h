@@ -0,0 +1,159 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - FORMATO BINÁRIO DE CAPTURA (.canlog + .canlog.idx)
+//═══════════════════════════════════════════════════════════════════════════
+// Arquivo de dados (append-only, mapeável com mmap):
+//   ┌──────────────────────────────┐
+//   │ Header 16 bytes              │ "CANLOG1\0" | recordSize=16 | reservado
+//   ├──────────────────────────────┤
+//   │ Registro 16 bytes            │ uint32 canId   (formato do kernel: EFF/RTR/ERR)
+//   │                              │ uint32 tsDlc   (offset_us << 4) | dlc
+//   │                              │ uint8  data[8]
+//   ├──────────────────────────────┤
+//   │ ...                          │
+//   └──────────────────────────────┘
+// O offset de 28 bits (µs) é relativo ao bloco corrente (~268 s). Cada
+// bloco tem uma entrada no índice:
+//
+// Arquivo de índice (<arquivo>.idx):
+//   Header 16 bytes "CANIDX1\0" + entradas de 16 bytes
+//   { uint64 baseTimeNs, uint64 firstRecord }
+//
+// Um bloco novo começa quando o offset estouraria, a cada kBlockRecords
+// registros (granularidade de busca por tempo) e a cada reabertura do
+// arquivo para append. Tudo little-endian (formato nativo do host).
+//
+// O tempo nunca volta: um frame mais antigo que o anterior (relógio
+// ajustado, fontes misturadas) é gravado com o instante do anterior, então
+// as bases do índice e os registros ficam em ordem para a busca binária.
+// Os registros pendentes vão para o disco antes de cada entrada de índice,
+// e ao reabrir as entradas além dos dados (gravação interrompida) são descartadas.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef CAN_LOG_H
+#define CAN_LOG_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "can_frame.h"
+
+namespace canlog {
+
+constexpr uint32_t kRecordSize = 16;
+constexpr uint32_t kBlockRecords = 65536;
+constexpr uint64_t kMaxOffsetUs = (1u << 28) - 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t recordSize;
+    uint32_t reserved;
+};
+
+struct Record {
+    uint32_t canId;
+    uint32_t tsDlc;
+    uint8_t data[8];
+};
+
+struct IndexEntry {
+    uint64_t baseTimeNs;
+    uint64_t firstRecord;
+};
+
+static_assert(sizeof(FileHeader) == 16, "header de 16 bytes");
+static_assert(sizeof(Record) == kRecordSize, "registro de 16 bytes");
+static_assert(sizeof(IndexEntry) == 16, "entrada de índice de 16 bytes");
+
+//───────────────────────────────────────────────────────────────────────────
+// GRAVAÇÃO
+//───────────────────────────────────────────────────────────────────────────
+class Writer {
+public:
+    // Abre para append (cria se não existir). Lança std::system_error.
+    explicit Writer(const std::string &path, size_t bufferRecords = 4096);
+    ~Writer();
+
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    // Frames com timestampNs == 0 recebem o relógio atual
+    void append(const CanFrame &frame);
+    void flush();
+
+    uint64_t records() const { return records_; }
+
+private:
+    void startBlock(uint64_t timeNs);
+
+    int fd_ = -1;
+    int idxFd_ = -1;
+    std::vector<Record> buffer_;
+    size_t bufferRecords_;
+    uint64_t records_ = 0;
+    uint64_t blockBaseNs_ = 0;
+    uint64_t blockFirst_ = 0;
+    uint64_t lastNs_ = 0;
+    bool haveBlock_ = false;
+};
+
+//───────────────────────────────────────────────────────────────────────────
+// LEITURA (mmap, sem cópia)
+//───────────────────────────────────────────────────────────────────────────
+class Reader {
+public:
+    explicit Reader(const std::string &path);
+    ~Reader();
+
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    uint64_t size() const { return count_; }
+    const Record *records() const { return records_; }
+
+    // Timestamp absoluto do registro i (ns)
+    uint64_t timeNs(uint64_t i) const;
+    CanFrame frame(uint64_t i) const;
+
+    // Primeiro registro com timestamp >= timeNs
+    uint64_t seek(uint64_t timeNs) const;
+
+    uint64_t firstTimeNs() const { return count_ ? timeNs(0) : 0; }
+    uint64_t lastTimeNs() const { return count_ ? timeNs(count_ - 1) : 0; }
+
+    // Percorre os registros [first, last) reconstruindo o timestamp de forma incremental
+    template <typename F>
+    void forRange(uint64_t first, uint64_t last, F &&fn) const {
+        if (last > count_) last = count_;
+        size_t block = blockOf(first);
+        for (uint64_t i = first; i < last; i++) {
+            while (block + 1 < index_.size() && index_[block + 1].firstRecord <= i) block++;
+            fn(i, records_[i], blockBase(block) + static_cast<uint64_t>(records_[i].tsDlc >> 4) * 1000u);
+        }
+    }
+
+    template <typename F>
+    void forEach(F &&fn) const {
+        forRange(0, count_, fn);
+    }
+
+private:
+    size_t blockOf(uint64_t i) const;
+    uint64_t blockBase(size_t block) const { return index_.empty() ? 0 : index_[block].baseTimeNs; }
+
+    void *map_ = nullptr;
+    size_t mapSize_ = 0;
+    const Record *records_ = nullptr;
+    uint64_t count_ = 0;
+    std::vector<IndexEntry> index_;
+};
+
+// Conversões entre o registro binário e CanFrame
+Record toRecord(const CanFrame &frame, uint64_t blockBaseNs);
+CanFrame fromRecord(const Record &rec, uint64_t timeNs);
+
+std::string indexPath(const std::string &path);
+
+}  // namespace canlog
+
+#endif
@@ -0,0 +1,64 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - API C (usada pelo binding Python via ctypes)
+//═══════════════════════════════════════════════════════════════════════════
+// Funções retornam 0 (ou o valor pedido) em sucesso e -errno em erro.
+// ctk_last_error() devolve a mensagem do último erro desta thread.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef CANTOOLKIT_C_H
+#define CANTOOLKIT_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CTK_FLAG_EXTENDED 0x01
+#define CTK_FLAG_REMOTE   0x02
+
+typedef struct {
+    uint32_t id;
+    uint8_t dlc;
+    uint8_t flags;
+    uint8_t data[8];
+    uint64_t timestamp_ns;
+} ctk_frame;
+
+typedef struct {
+    int cj_temp;
+    int status[4];  // TL, TR, BL, BR
+    int temp[4];
+} ctk_temp;
+
+typedef struct ctk_bus ctk_bus;
+typedef void (*ctk_rx_callback)(const ctk_frame *frame, void *user);
+
+ctk_bus *ctk_open(const char *ifname);
+void ctk_close(ctk_bus *bus);
+int ctk_send(ctk_bus *bus, const ctk_frame *frame);
+int ctk_send_batch(ctk_bus *bus, const ctk_frame *frames, size_t count);
+// id/mask como CanBus::subscribe: bit 31 = extended, bit 30 = RTR. Com mask != 0
+// só casa frames do mesmo tipo de ID
+int ctk_subscribe(ctk_bus *bus, uint32_t id, uint32_t mask, ctk_rx_callback cb, void *user);
+int ctk_unsubscribe(ctk_bus *bus, int handle);
+uint64_t ctk_rx_count(ctk_bus *bus);
+uint64_t ctk_tx_count(ctk_bus *bus);
+const char *ctk_last_error(void);
+
+// Codecs (mesma implementação do firmware, config.cpp)
+void ctk_encode_digital(const int relays[8], int pwm1, int pwm2, int enc, uint8_t out[8]);
+void ctk_decode_digital(const uint8_t in[8], int relays[8], int *pwm1, int *pwm2, int *enc);
+int ctk_read_pwm_enc(const uint8_t in[8], int index);
+void ctk_encode_safety_pair(int enable1, float max1, int timer1, int enable2, float max2, int timer2, uint8_t out[8]);
+void ctk_decode_safety_pair(const uint8_t in[8], int enable[2], float maxtemp[2], int timer[2]);
+void ctk_encode_aquisition(int timer, int analog, int continuous, uint8_t out[8]);
+void ctk_decode_aquisition(const uint8_t in[8], int *timer, int *analog, int *continuous);
+void ctk_encode_start_stop(int enable, uint8_t out[8]);
+void ctk_decode_temperature(const uint8_t in[8], ctk_temp *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - LEITOR DE ARQUIVOS DBC
+//═══════════════════════════════════════════════════════════════════════════
+// Lê as linhas BO_ (mensagens) e SG_ (sinais) dos DBC do projeto
+// (canmod-gen1.dbc, canmod_genmath.dbc). Multiplexação e atributos são
+// ignorados: os módulos CANmod só usam sinais simples.
+//
+// Cada sinal é pré-compilado em (shift, mask) sobre o payload de 64 bits,
+// de forma que a decodificação é um shift + and + mul + add por amostra.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef DBC_H
+#define DBC_H
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dbc {
+
+struct Signal {
+    std::string name;
+    std::string unit;
+    uint32_t startBit = 0;
+    uint32_t length = 0;
+    bool littleEndian = true;  // @1 = Intel, @0 = Motorola
+    bool isSigned = false;
+    double factor = 1;
+    double offset = 0;
+    double minimum = 0;
+    double maximum = 0;
+
+    // Pré-calculado em finalize(): raw = (payload >> shift) & mask, onde
+    // payload é little-endian (Intel) ou big-endian (Motorola)
+    uint32_t shift = 0;
+    uint64_t mask = 0;
+
+    void finalize();
+    int64_t raw(uint64_t payloadLE, uint64_t payloadBE) const;
+    double physical(uint64_t payloadLE, uint64_t payloadBE) const {
+        return static_cast<double>(raw(payloadLE, payloadBE)) * factor + offset;
+    }
+};
+
+struct Message {
+    uint32_t id = 0;  // Sem flags; extended indica ID de 29 bits
+    bool extended = false;
+    std::string name;
+    uint8_t dlc = 8;
+    std::vector<Signal> signals;
+};
+
+class Database {
+public:
+    // Carrega um arquivo DBC; IDs já carregados de outro arquivo são mantidos.
+    // Lança std::runtime_error com o número da linha em caso de erro de sintaxe.
+    void load(const std::string &path);
+
+    const Message *find(uint32_t id, bool extended) const;
+    const std::vector<Message> &messages() const { return messages_; }
+
+private:
+    static uint64_t key(uint32_t id, bool extended) { return (static_cast<uint64_t>(extended) << 32) | id; }
+
+    std::vector<Message> messages_;
+    std::unordered_map<uint64_t, size_t> byId_;
+};
+
+}  // namespace dbc
+
+#endif
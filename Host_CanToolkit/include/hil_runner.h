@@ -0,0 +1,139 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - RUNNER DE VETORES DE TESTE HIL COM ASSERÇÕES DE TEMPO
+//═══════════════════════════════════════════════════════════════════════════
+// Um arquivo de vetores (.vec) descreve, por vetor, os frames a enviar com
+// instante em µs e as respostas esperadas com janela de latência:
+//
+//   repeat 50                                   # repetições por vetor (padrão)
+//   gap 100000                                  # pausa entre execuções (µs)
+//
+//   vector rele_D1
+//     send 0 402#1555FFFF00000000 as cmd        # t = 0 µs
+//     expect 422#1555 after cmd within 20000    # eco em até 20 ms
+//   end
+//
+//   send <t_us> <ID>#<dados>|R [every <período_us> x <n>] [as <rótulo>]
+//   expect <ID>[#<dados>[/<máscara>]] after <rótulo>|start within [<min>..]<max> [as <rótulo>]
+//   duration <us>                               # tempo total de escuta do vetor
+//
+// A latência é medida entre o timestamp do kernel do frame enviado (eco
+// CAN_RAW_RECV_OWN_MSGS) e o da primeira resposta que casa com o padrão.
+// O rótulo de um expect pode servir de referência para outro (encadeamento).
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef HIL_RUNNER_H
+#define HIL_RUNNER_H
+
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "can_bus.h"
+
+namespace hil {
+
+struct FramePattern {
+    uint32_t id = 0;
+    bool extended = false;
+    uint8_t data[8] = {0};
+    uint8_t mask[8] = {0};  // 0 = byte indiferente
+
+    bool matches(const CanFrame &frame) const;
+};
+
+struct SendStep {
+    uint64_t atUs = 0;
+    CanFrame frame;
+    uint64_t periodUs = 0;
+    uint32_t count = 1;
+    std::string label;
+};
+
+struct ExpectStep {
+    FramePattern pattern;
+    std::string after;
+    uint64_t minUs = 0;
+    uint64_t maxUs = 0;
+    std::string label;
+    std::string text;  // Linha original (para o relatório)
+};
+
+struct TestVector {
+    std::string name;
+    std::vector<SendStep> sends;
+    std::vector<ExpectStep> expects;
+    uint64_t durationUs = 0;  // 0 = calculado (último envio + maior janela)
+    unsigned repeat = 0;      // 0 = valor da suíte
+};
+
+struct Suite {
+    unsigned repeat = 1;
+    uint64_t gapUs = 100000;
+    std::vector<TestVector> vectors;
+};
+
+// Lança std::runtime_error com arquivo:linha em caso de erro
+Suite parseSuite(const std::string &path);
+bool parseFrame(const std::string &text, CanFrame &frame);
+bool parsePattern(const std::string &text, FramePattern &pattern);
+
+// Resultado acumulado de um expect ao longo das repetições
+struct ExpectResult {
+    std::string key;                  // vetor/rótulo
+    std::vector<double> latenciesUs;  // Apenas respostas recebidas
+    unsigned runs = 0;
+    unsigned missing = 0;
+    unsigned outOfBounds = 0;
+    uint64_t minUs = 0, maxUs = 0;
+};
+
+struct RunnerOptions {
+    bool realtime = false;  // SCHED_FIFO + mlockall
+    uint64_t spinUs = 200;  // Espera ativa nos últimos µs antes de cada envio
+    bool verbose = false;
+};
+
+class Runner {
+public:
+    Runner(CanBus &bus, const RunnerOptions &options);
+    ~Runner();
+
+    std::vector<ExpectResult> run(const Suite &suite);
+
+private:
+    void runOnce(const TestVector &vec, std::vector<ExpectResult> &results, size_t first);
+
+    CanBus &bus_;
+    RunnerOptions options_;
+    int subscription_ = 0;
+
+    std::mutex logMutex_;
+    std::vector<CanFrame> log_;
+    bool recording_ = false;
+};
+
+//───────────────────────────────────────────────────────────────────────────
+// RELATÓRIO DE DISTRIBUIÇÃO DE LATÊNCIA
+//───────────────────────────────────────────────────────────────────────────
+struct LatencyStats {
+    unsigned n = 0, failures = 0;
+    double minUs = 0, p50Us = 0, p90Us = 0, p99Us = 0, maxUs = 0, meanUs = 0;
+    std::vector<unsigned> histogram;  // Contagem por faixa de kHistogramEdgesUs
+};
+
+extern const std::vector<double> kHistogramEdgesUs;
+
+LatencyStats summarize(const ExpectResult &result);
+
+// CSV: chave,n,falhas,min,p50,p90,p99,max,média,histograma(a;b;c...)
+void writeReport(const std::string &path, const std::string &firmware, const std::vector<ExpectResult> &results);
+std::map<std::string, LatencyStats> readReport(const std::string &path);
+
+// Versão "vX.Y.Z" lida do version.json da pasta firmwares/ ("" se ausente)
+std::string firmwareVersion(const std::string &firmwareDir);
+
+}  // namespace hil
+
+#endif
@@ -0,0 +1,50 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - ISO-TP (ISO 15765-2) PELO KERNEL
+//═══════════════════════════════════════════════════════════════════════════
+// Socket CAN_ISOTP (módulo can-isotp, Linux >= 5.10): o kernel faz a
+// segmentação, o controle de fluxo e os timeouts; aqui só se escolhe o par
+// de IDs e os parâmetros do FC. Par do IsoTp do firmware
+// (Firmware_CanInput/include/isotp.h): endereçamento normal, 11 bits.
+//
+// Erros de sistema são reportados com std::system_error.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef ISOTP_SOCKET_H
+#define ISOTP_SOCKET_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+struct IsoTpOptions {
+    uint8_t blockSize = 0;      // FC do host ao receber: CFs por bloco (0 = sem limite)
+    uint8_t stMin = 0;          // FC do host: codificação ISO (0-127 ms, 0xF1-0xF9 = 100-900 µs)
+    uint32_t forceTxStMinNs = 0;// Ignora o STmin do FC do nó e usa este (0 = respeita o FC)
+    bool padding = true;        // Frames de saída com DLC 8 (0xCC), como o nó
+};
+
+class IsoTpSocket {
+public:
+    // txId: para onde o host envia (0x400 no nó); rxId: de onde vêm as respostas (0x420)
+    IsoTpSocket(const std::string &ifname, uint32_t txId, uint32_t rxId, const IsoTpOptions &options = IsoTpOptions());
+    ~IsoTpSocket();
+
+    IsoTpSocket(const IsoTpSocket &) = delete;
+    IsoTpSocket &operator=(const IsoTpSocket &) = delete;
+
+    // Mensagem inteira (1-4095 bytes); retorna quando o kernel a aceitou
+    void send(const std::vector<uint8_t> &message);
+
+    // Próxima mensagem completa; false = nada em timeoutMs
+    bool receive(std::vector<uint8_t> &message, int timeoutMs);
+
+    // send + receive; false = sem resposta
+    bool request(const std::vector<uint8_t> &message, std::vector<uint8_t> &response, int timeoutMs = 2000);
+
+    int fd() const { return fd_; }
+
+private:
+    int fd_ = -1;
+};
+
+#endif
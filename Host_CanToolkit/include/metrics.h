@@ -0,0 +1,126 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - MÉTRICAS NO FORMATO DO PROMETHEUS (SEM LOCK)
+//═══════════════════════════════════════════════════════════════════════════
+// Registro em memória alimentado pelo caminho de recepção: contador, gauge
+// e histograma são só atômicos (fetch_add / store / CAS no double), então
+// quem atualiza nunca espera quem lê. O registro é uma lista encadeada em
+// que só se insere na cabeça (CAS); as métricas vivem até o fim do
+// Registry, e render() percorre a lista sem travar ninguém.
+//
+// Crie as métricas antes do laço quente (a criação aloca) e guarde as
+// referências. Uma leitura concorrente pode ver um histograma no meio de
+// uma observação: _count é a soma das faixas lidas, sempre coerente com
+// elas, e a diferença some no scrape seguinte.
+//
+// Servidor HTTP (TCP e/ou socket Unix) em include/metrics_server.h.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace metrics {
+
+enum Type { TypeCounter, TypeGauge, TypeHistogram };
+
+class Metric {
+public:
+    Metric(Type type, const std::string &name, const std::string &help, const std::string &labels)
+        : type_(type), name_(name), help_(help), labels_(labels) {}
+    virtual ~Metric() = default;
+
+    Metric(const Metric &) = delete;
+    Metric &operator=(const Metric &) = delete;
+
+    Type type() const { return type_; }
+    const std::string &name() const { return name_; }
+    const std::string &help() const { return help_; }
+    const std::string &labels() const { return labels_; }
+
+    // Linhas de amostra (sem HELP/TYPE)
+    virtual void render(std::string &out) const = 0;
+
+private:
+    friend class Registry;
+    Type type_;
+    std::string name_, help_, labels_;
+    Metric *next_ = nullptr;
+};
+
+class Counter : public Metric {
+public:
+    using Metric::Metric;
+    void inc(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+    void render(std::string &out) const override;
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+class Gauge : public Metric {
+public:
+    using Metric::Metric;
+    void set(double v);
+    void add(double v);
+    double value() const;
+    void render(std::string &out) const override;
+
+private:
+    std::atomic<uint64_t> bits_{0};   // Bits do double (0 = 0.0)
+};
+
+class Histogram : public Metric {
+public:
+    // edges: limites superiores crescentes (o +Inf é implícito)
+    Histogram(const std::string &name, const std::string &help, const std::string &labels,
+              const std::vector<double> &edges);
+    void observe(double v);
+    void render(std::string &out) const override;
+
+private:
+    std::vector<double> edges_;
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;   // edges_.size() + 1 (+Inf)
+    std::atomic<uint64_t> sumBits_{0};
+};
+
+// Faixas de latência em segundos, de 50 µs a 1 s
+extern const std::vector<double> kLatencyEdges;
+
+class Registry {
+public:
+    Registry() = default;
+    ~Registry();
+
+    Registry(const Registry &) = delete;
+    Registry &operator=(const Registry &) = delete;
+
+    // labels já no formato 'a="x",b="y"' (ver label()); mesmo nome = mesma família
+    Counter &counter(const std::string &name, const std::string &help, const std::string &labels = "");
+    Gauge &gauge(const std::string &name, const std::string &help, const std::string &labels = "");
+    Histogram &histogram(const std::string &name, const std::string &help, const std::string &labels = "",
+                         const std::vector<double> &edges = kLatencyEdges);
+
+    // Formato de exposição em texto 0.0.4, famílias na ordem de criação
+    std::string render() const;
+
+private:
+    template <class T>
+    T &add(T *metric);
+
+    std::atomic<Metric *> head_{nullptr};
+};
+
+// 'chave="valor"' com \, " e quebra de linha escapados
+std::string label(const std::string &key, const std::string &value);
+// Junta pares já formatados com vírgula, ignorando vazios
+std::string labels(std::initializer_list<std::string> parts);
+
+}  // namespace metrics
+
+#endif
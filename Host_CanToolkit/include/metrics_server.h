@@ -0,0 +1,64 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - ENDPOINT HTTP DAS MÉTRICAS (TCP E/OU SOCKET UNIX)
+//═══════════════════════════════════════════════════════════════════════════
+// Uma thread própria com poll() nos sockets de escuta; cada conexão é
+// atendida e fechada (HTTP/1.0, Connection: close). O scrape só lê o
+// Registry (include/metrics.h), então um cliente lento atrasa os outros
+// scrapes, nunca a recepção CAN.
+//
+//   GET /metrics   formato de texto do Prometheus (0.0.4)
+//   GET /healthz   200 "ok" ou 503 com o motivo (setHealth)
+//
+// Endereços: "127.0.0.1:9108", ":9108" (todas as interfaces) ou
+// "unix:/run/cansupd.sock" (curl --unix-socket /run/cansupd.sock http://x/metrics).
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics.h"
+
+namespace metrics {
+
+class Server {
+public:
+    explicit Server(const Registry &registry);
+    ~Server();
+
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+
+    // Antes de start(); std::system_error / std::invalid_argument
+    void listen(const std::string &address);
+
+    // Roda na thread do servidor: true = saudável; reason vai no corpo
+    void setHealth(std::function<bool(std::string &reason)> check);
+
+    void start();
+    void stop();
+
+    uint64_t requests() const { return requests_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void serve(int fd);
+
+    const Registry &registry_;
+    std::vector<int> listeners_;
+    std::vector<std::string> unixPaths_;   // Removidos no stop()
+    std::function<bool(std::string &)> health_;
+    int wake_ = -1;                        // eventfd do stop()
+    std::thread thread_;
+    std::atomic<uint64_t> requests_{0};
+};
+
+}  // namespace metrics
+
+#endif
@@ -0,0 +1,235 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - PROTOCOLO DA PLACA (0x40x / 0x42x / 0x5x0)
+//═══════════════════════════════════════════════════════════════════════════
+// Codecs compartilhados com o firmware: as funções de config.cpp são
+// compiladas diretamente no host, então o empacotamento aqui é sempre o
+// mesmo que roda no ATmega2560.
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "can_frame.h"
+#include "config.h"
+#include "objdict.h"
+
+namespace proto {
+
+//───────────────────────────────────────────────────────────────────────────
+// IDs DAS MENSAGENS
+//───────────────────────────────────────────────────────────────────────────
+constexpr uint32_t kResetId        = 0x042;  // Reset para o bootloader
+constexpr uint32_t kTimeSyncId     = 0x080;  // SYNC do mestre [seq] (timesync.h)
+constexpr uint32_t kTimeFollowUpId = 0x081;  // FOLLOW-UP: t1 do SYNC de mesmo seq
+constexpr uint32_t kIsoTpRequestId = 0x400;  // ISO-TP host → nó (IsoTpSocket tx)
+constexpr uint32_t kHeartbeatId    = 0x401;
+constexpr uint32_t kDigitalCmdId   = 0x402;  // Relés + PWM
+constexpr uint32_t kSafety12CmdId  = 0x403;  // Limiares sensores 1/2
+constexpr uint32_t kAquisCmdId     = 0x404;  // Taxa de aquisição
+constexpr uint32_t kStartStopCmdId = 0x405;
+constexpr uint32_t kSafety34CmdId  = 0x406;  // Limiares sensores 3/4
+constexpr uint32_t kIngestCmdId    = 0x407;  // Modo de ingestão (polling/push)
+constexpr uint32_t kFreshnessCmdId = 0x408;  // Idade máxima das temperaturas + fail-safe
+constexpr uint32_t kSamplingCmdId  = 0x409;  // Aquisição adaptativa
+constexpr uint32_t kReportCmdId    = 0x40A;  // Relatório por mudança; RTR = snapshot completo
+constexpr uint32_t kBusHealthCmdId = 0x40B;  // RTR pede o 0x42B na hora
+constexpr uint32_t kBitrateCmdId   = 0x40C;  // Migração de bitrate (broadcast)
+constexpr uint32_t kPulseCmdId     = 0x40D;  // Contagem de pulsos: canais, janelas, ppr
+constexpr uint32_t kAdcCmdId       = 0x40E;  // ADC interno: canais e oversampling
+constexpr uint32_t kHistoryCmdId   = 0x40F;  // Histórico: status/download/cancela/limpa
+constexpr uint32_t kIsoTpResponseId = 0x420; // ISO-TP nó → host (IsoTpSocket rx)
+constexpr uint32_t kDigitalEchoId  = 0x422;
+constexpr uint32_t kSafety12EchoId = 0x423;
+constexpr uint32_t kAquisEchoId    = 0x424;
+constexpr uint32_t kStartStopEchoId = 0x425;
+constexpr uint32_t kSafety34EchoId = 0x426;  // Também usado pelo frame de aquisição
+constexpr uint32_t kIngestStatusId = 0x427;  // Push/fresh por ID e carga do barramento
+constexpr uint32_t kFreshnessStatusId = 0x428;  // Idade de T1..T4 (também espontâneo)
+constexpr uint32_t kSamplingStatusId = 0x429;  // Política e período atual por módulo
+constexpr uint32_t kHeartbeatStatusId = 0x42A;  // Heartbeat do relatório por mudança
+constexpr uint32_t kBusHealthId    = 0x42B;  // TEC/REC/EFLG, carga e frames/s (1 s)
+constexpr uint32_t kBitrateStatusId = 0x42C;  // Bitrate atual, estado da migração
+constexpr uint32_t kPulseStatusId  = 0x42D;  // RPM e Hz do motor/bomba (ritmo da aquisição)
+constexpr uint32_t kAdcStatusId    = 0x42E;  // Lista de canais, taxa medida/nominal, perdas
+constexpr uint32_t kHistoryStatusId = 0x42F;  // Estado do download, tamanho, período, millis
+constexpr uint32_t kHistoryDataId  = 0x430;  // [seq][até 7 bytes] do histórico
+constexpr uint32_t kTimeSyncStatusId = 0x431;  // Erro/drift do relógio do nó a cada par
+constexpr uint32_t kStampedSampleId = 0x432;  // Amostra com tempo sincronizado (sync.stamp)
+constexpr uint32_t kTemp1Id        = 0x510;  // CANTemp1TC
+constexpr uint32_t kTemp2Id        = 0x520;
+constexpr uint32_t kTemp3Id        = 0x530;
+
+// Bootloader (mcp-can-boot, flash_can.sh / firmware_can.py), IDs estendidos:
+// [MCU id 16 bits][comando][tamanho << 5 | endereço & 0x1F][até 4 bytes]
+constexpr uint32_t kBootMcuToHostId = 0x1FFFFF01;
+constexpr uint32_t kBootHostToMcuId = 0x1FFFFF02;
+constexpr uint16_t kBootMcuId       = 0x0042;
+constexpr uint8_t kBootStart        = 0x02;  // MCU: bootloader no ar (assinatura)
+constexpr uint8_t kBootFlashReady   = 0x04;  // MCU: próximo endereço (big-endian, bytes 4..7)
+constexpr uint8_t kBootFlashInit    = 0x06;
+constexpr uint8_t kBootFlashData    = 0x08;
+constexpr uint8_t kBootFlashAddressError = 0x0B;
+constexpr uint8_t kBootFlashDataError    = 0x0D;
+constexpr uint8_t kBootFlashDone    = 0x10;
+constexpr uint8_t kBootStartApp     = 0x80;
+
+//───────────────────────────────────────────────────────────────────────────
+// ESTADO DE UM RELÉ NO 0x402 (2 bits por saída)
+//───────────────────────────────────────────────────────────────────────────
+// Lógica inversa da placa: 0 = nível LOW = relé LIGADO, 1 = DESLIGADO,
+// 2/3 = mantém o estado atual
+//───────────────────────────────────────────────────────────────────────────
+enum RelayCommand : uint8_t { RelayOn = 0, RelayOff = 1, RelayKeep = 2 };
+
+struct DigitalState {
+    int relays[8] = {RelayKeep, RelayKeep, RelayKeep, RelayKeep,
+                     RelayKeep, RelayKeep, RelayKeep, RelayKeep};
+    int pwm1 = 0;
+    int pwm2 = 0;
+    int enc = 0;
+};
+
+CanFrame encodeDigital(const DigitalState &state);
+DigitalState decodeDigital(const CanFrame &frame);
+
+CanFrame encodeSafetyPair(uint32_t id, const safetyConfigStructure &first, const safetyConfigStructure &second);
+void decodeSafetyPair(const CanFrame &frame, safetyConfigStructure &first, safetyConfigStructure &second);
+
+CanFrame encodeAquisition(const aquisitionConfigStructure &aquisc);
+aquisitionConfigStructure decodeAquisition(const CanFrame &frame);
+
+CanFrame encodeStartStop(bool enable);
+bool decodeStartStop(const CanFrame &frame);
+
+tempReadStructure decodeTemperature(const CanFrame &frame);
+// Frame do CANmod.Temp (0x510/0x520/0x530) como o módulo manda; inverso do
+// tempRead do firmware (°C inteiros de -2048 a 2047, saturados)
+CanFrame encodeTemperature(uint32_t id, const tempReadStructure &temp);
+
+// 0x407 com dados troca o modo; RTR (ou dlc 0) só pede o 0x427
+CanFrame encodeIngestMode(bool push);
+ingestStatusStructure decodeIngestStatus(const CanFrame &frame);
+
+// 0x408 com dados grava idade máxima/ação na EEPROM; RTR só pede o 0x428
+CanFrame encodeFreshnessConfig(const freshnessConfigStructure &config);
+freshnessStatusStructure decodeFreshnessStatus(const CanFrame &frame);
+
+// 0x409 com dados troca a política de aquisição (não persiste); RTR só pede o 0x429
+CanFrame encodeSamplingConfig(const samplingConfigStructure &config);
+samplingStatusStructure decodeSamplingStatus(const CanFrame &frame);
+
+// 0x40A com dados troca modo/heartbeat; com ou sem dados o nó responde com
+// todos os frames de estado (snapshot) e o 0x42A
+CanFrame encodeReportConfig(const reportConfigStructure &config);
+heartbeatStructure decodeHeartbeat(const CanFrame &frame);
+
+// 0x42B: EFLG com os bits do MCP2515 (bushealth.h), 0x20 = bus-off
+busHealthStructure decodeBusHealth(const CanFrame &frame);
+
+// 0x40C com dados agenda a troca (target 0 = 500 kbps, 1 = 1 Mbps) depois de
+// delayMs; RTR só pede o 0x42C. state = MigrationState do firmware (bitrate.h)
+CanFrame encodeBitrateCommand(const bitrateCommandStructure &cmd);
+bitrateStatusStructure decodeBitrateStatus(const CanFrame &frame);
+
+// 0x40D com dados configura e grava na EEPROM (janela em passos de 10 ms;
+// 0 em janela/ppr mantém o atual); RTR só pede o 0x42D
+CanFrame encodePulseConfig(const pulseConfigStructure &cfg);
+pulseStatusStructure decodePulseStatus(const CanFrame &frame);
+
+// 0x40E com dados troca a lista de canais (bit N = ADCN) e o oversampling
+// (10 + k bits) e grava na EEPROM; RTR só pede o 0x42E. O ADC só roda com
+// o analog do 0x404 ligado
+CanFrame encodeAdcConfig(const adcConfigStructure &cfg);
+adcStatusStructure decodeAdcStatus(const CanFrame &frame);
+
+// 0x40F: HistoryCommand (config.h); o stream do 0x430 decodifica com
+// historyDecode (Firmware_CanInput/include/history.h)
+CanFrame encodeHistoryCommand(uint8_t command);
+historyStatusStructure decodeHistoryStatus(const CanFrame &frame);
+
+// 0x080/0x081: o mestre manda o SYNC, lê o instante real de saída (eco do
+// kernel) e manda t1 (µs, 48 bits) no FOLLOW-UP; o nó responde com o 0x431
+CanFrame encodeTimeSync(uint8_t seq);
+CanFrame encodeTimeFollowUp(uint8_t seq, uint64_t masterUs);
+timeSyncStatusStructure decodeTimeSyncStatus(const CanFrame &frame);
+// 0x432: timeUs só tem os 40 bits de baixo; expandStampedTime completa com
+// os de cima de um instante próximo (ex.: o timestamp de recepção)
+stampedSampleStructure decodeStampedSample(const CanFrame &frame);
+uint64_t expandStampedTime(uint64_t low40, uint64_t nearUs);
+
+//───────────────────────────────────────────────────────────────────────────
+// SERVIÇOS ISO-TP (0x400/0x420, IsoTpService em config.h)
+//───────────────────────────────────────────────────────────────────────────
+// Mensagens inteiras para IsoTpSocket (isotp_socket.h). Os decode* devolvem
+// false para resposta negativa ou curta; isoTpNegative dá o código.
+//───────────────────────────────────────────────────────────────────────────
+std::vector<uint8_t> encodeSafetyTableRequest();
+bool decodeSafetyTable(const std::vector<uint8_t> &response, safetyConfigStructure table[4]);
+
+// Limite e timer com resolução completa; save = grava na EEPROM
+std::vector<uint8_t> encodeSafetyWrite(uint8_t channel, const safetyConfigStructure &config, bool save);
+bool decodeSafetyWrite(const std::vector<uint8_t> &response, uint8_t &channel, safetyConfigStructure &config);
+
+// Stream do histórico (historyDecode), sem o protocolo do 0x430
+std::vector<uint8_t> encodeHistoryRequest();
+bool decodeHistory(const std::vector<uint8_t> &response, std::vector<uint8_t> &stream);
+
+// BS/STmin do FC que o nó manda quando recebe (não persiste)
+std::vector<uint8_t> encodeTransport(uint8_t blockSize, uint8_t stMin);
+bool decodeTransport(const std::vector<uint8_t> &response, uint8_t &blockSize, uint8_t &stMin);
+
+// Dicionário de parâmetros (objdict.h, índices ObjectIndex): leitura e
+// escrita de um índice; wire = inteiro estendido ou bits do float
+std::vector<uint8_t> encodeParamRead(uint8_t index);
+std::vector<uint8_t> encodeParamWrite(uint8_t index, uint32_t wire);
+bool decodeParam(const std::vector<uint8_t> &response, paramValueStructure &value);
+
+// Leitura em massa de first..first+count-1 (count 0 = até o fim); índices
+// sem variável no container voltam com type PARAM_ABSENT
+std::vector<uint8_t> encodeParamBulkRead(uint8_t first = 0, uint8_t count = 0);
+bool decodeParamBulk(const std::vector<uint8_t> &response, std::vector<paramValueStructure> &values);
+
+struct ParamInfo {
+    uint8_t index = 0;
+    uint8_t type = 0;           // ParamType; PARAM_ABSENT = não existe no container
+    uint8_t flags = 0;          // ParamFlags
+    float min = 0, max = 0;
+    std::string name;
+};
+
+// Tabela do nó (nome, tipo, direitos, faixa): o host não precisa de cópia
+std::vector<uint8_t> encodeParamDescribe(uint8_t first = 0, uint8_t count = 0);
+bool decodeParamDescribe(const std::vector<uint8_t> &response, std::vector<ParamInfo> &table);
+
+// Texto ↔ fio conforme o tipo ("1500", "-3", "87.5"); false = não é número
+std::string formatParam(uint8_t type, uint32_t wire);
+bool parseParam(uint8_t type, const std::string &text, uint32_t &wire);
+
+// Resposta [0x7F][serviço][código]: true e o IsoTpNrc
+bool isoTpNegative(const std::vector<uint8_t> &response, uint8_t &nrc);
+
+//───────────────────────────────────────────────────────────────────────────
+// ENVIO DO 0x402 SÓ QUANDO A MÁSCARA MUDA
+//───────────────────────────────────────────────────────────────────────────
+// Par do relatório por mudança do nó: laços de controle que recalculam os
+// relés a cada ciclo usam next() e só transmitem quando o frame difere do
+// último enviado. next() já conta o frame como enviado: se o envio falhar,
+// chame invalidate() para o próximo next() repetir (também após reconectar).
+//───────────────────────────────────────────────────────────────────────────
+class DigitalDelta {
+public:
+    bool next(const DigitalState &state, CanFrame &frame);
+    void invalidate() { valid_ = false; }
+
+private:
+    CanFrame last_;
+    bool valid_ = false;
+};
+
+}  // namespace proto
+
+#endif
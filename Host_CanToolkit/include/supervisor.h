@@ -0,0 +1,221 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - SUPERVISÃO DE VÁRIOS CONTAINERS (FILTRAGEM/CIRCULAÇÃO/DESCARTE)
+//═══════════════════════════════════════════════════════════════════════════
+// A máquina de estados do Controle_NMOG.m (executarControle) e os modos
+// fixos do menu (filtragem, arrefecimento, descarte), um objeto por
+// container, sem E/S: o laço de eventos (tools/cansupd.cpp) entrega cada
+// frame recebido e envia o 0x402 que onFrame() devolver.
+//
+//   S1 repouso     tudo desligado           → S2 com motor > 0 °C
+//   S2 filtragem   bomba                    → S3 com motor >= limite
+//   S3 circulação  bomba + NA1              → S4 com água >= limite
+//                                           → S2 com motor < limite - histerese
+//   S4 descarte    bomba + NA1 + NA2        → S3 com motor e água abaixo da histerese
+//   motor > limite + emergência: D1 e D2 ligados em qualquer estado
+//
+// Todo frame conhecido pelo DBC é decodificado e guardado (último valor de
+// cada sinal) para o status. A latência de decisão é medida do timestamp
+// do kernel do frame de temperatura até o fim da avaliação (e até o 0x402
+// sair, quando a decisão muda os relés).
+//
+// Arquivo de configuração (um bloco por container; # comenta):
+//
+//   container 17 can0
+//     mode auto                   # auto | filtragem | arrefecimento | descarte | desligado
+//     limits 90 45                # motor, água (°C)
+//     hysteresis 3 5              # motor, água (°C)
+//     emergency 15                # D1/D2 acima de limite do motor + isto
+//     temps 510 TRTemp BRTemp     # ID (hex) e sinais do DBC: motor, água
+//     stale 500 200               # sem temperatura por ms → RTR a cada ms
+//     firmware app.hex            # opcional: imagem gravada (progresso do flash)
+//     mcu 0042                    # ID do MCU no bootloader (hex)
+//   end
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "can_frame.h"
+#include "dbc.h"
+#include "protocol.h"
+
+namespace sup {
+
+enum Mode : uint8_t { ModeAuto, ModeFiltration, ModeCooling, ModeDiscard, ModeOff };
+
+enum State : uint8_t { StateIdle = 1, StateFiltration, StateCirculation, StateDiscard };
+
+struct ContainerConfig {
+    std::string name;
+    std::string ifname;
+    Mode mode = ModeAuto;
+    double motorLimit = 90, waterLimit = 45;
+    double motorHysteresis = 3, waterHysteresis = 5;
+    double emergencyMargin = 15;
+    uint32_t tempId = proto::kTemp1Id;
+    std::string motorSignal = "TRTemp", waterSignal = "BRTemp";
+    uint32_t staleMs = 500, rtrMs = 200;
+    std::string firmware;           // .hex para o progresso da gravação ("" = sem)
+    uint16_t mcuId = proto::kBootMcuId;
+};
+
+// Lança std::runtime_error com arquivo:linha em caso de erro
+std::vector<ContainerConfig> parseConfig(const std::string &path);
+
+const char *modeName(Mode mode);
+const char *stateName(State state);
+
+//───────────────────────────────────────────────────────────────────────────
+// HISTOGRAMA DE LATÊNCIA (log-linear, ~6% de resolução, sem alocação)
+//───────────────────────────────────────────────────────────────────────────
+class LatencyHistogram {
+public:
+    void add(uint64_t us);
+    void clear();
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0; }
+    uint64_t percentile(double p) const;   // Limite superior da faixa (µs)
+
+private:
+    static constexpr unsigned kLinear = 32;
+    static constexpr unsigned kSub = 16;
+    static constexpr unsigned kBuckets = kLinear + 59 * kSub;
+    static unsigned bucket(uint64_t us);
+    static uint64_t upper(unsigned bucket);
+
+    uint64_t buckets_[kBuckets] = {0};
+    uint64_t count_ = 0, sum_ = 0, max_ = 0;
+};
+
+//───────────────────────────────────────────────────────────────────────────
+// GRAVAÇÃO PELO BOOTLOADER (observada no barramento)
+//───────────────────────────────────────────────────────────────────────────
+// O flash_can.sh / firmware_can.py conversa com o mcp-can-boot no mesmo
+// barramento (0x1FFFFF01/0x1FFFFF02, protocol.h); o supervisor só escuta.
+// O FLASH_READY do MCU traz o próximo endereço pedido, então o progresso é
+// endereço / tamanho da imagem quando o .hex é conhecido (firmware no
+// arquivo de configuração), como o "Progress:" do firmware_can.py.
+//───────────────────────────────────────────────────────────────────────────
+enum FlashPhase : uint8_t { FlashIdle, FlashBootloader, FlashWriting, FlashDone, FlashError };
+
+const char *flashPhaseName(FlashPhase phase);
+
+// Maior endereço + 1 dos registros de dados de um Intel HEX (tamanho que o
+// firmware_can.py grava). std::runtime_error com arquivo:linha
+uint32_t hexImageSize(const std::string &path);
+
+class FlashMonitor {
+public:
+    void configure(uint16_t mcuId, uint32_t imageBytes);
+    // true = frame do bootloader deste MCU
+    bool onFrame(const CanFrame &frame, uint64_t nowNs);
+
+    FlashPhase phase() const { return phase_; }
+    uint32_t address() const { return address_; }
+    uint32_t imageBytes() const { return imageBytes_; }
+    double progress() const;        // 0..1; < 0 sem imagem configurada
+    uint64_t frames() const { return frames_; }
+    uint64_t sessions() const { return sessions_; }
+    uint64_t lastNs() const { return lastNs_; }
+
+private:
+    uint16_t mcuId_ = proto::kBootMcuId;
+    uint32_t imageBytes_ = 0;
+    FlashPhase phase_ = FlashIdle;
+    uint32_t address_ = 0;
+    uint64_t frames_ = 0, sessions_ = 0, lastNs_ = 0;
+};
+
+//───────────────────────────────────────────────────────────────────────────
+// UM CONTAINER
+//───────────────────────────────────────────────────────────────────────────
+struct Telemetry {
+    const dbc::Message *message = nullptr;
+    std::vector<double> values;     // Na ordem de message->signals
+    uint64_t timeNs = 0;            // Timestamp do último frame
+    uint64_t frames = 0;
+};
+
+struct Decision {
+    bool pump = false, circulation = false, discard = false, emergency = false;
+};
+
+class ContainerSupervisor {
+public:
+    // Os sinais de temperatura precisam existir no DBC (std::runtime_error)
+    ContainerSupervisor(const ContainerConfig &config, const dbc::Database &db);
+
+    // Frame recebido; true = mandar out (0x402). nowNs = CLOCK_REALTIME
+    // do laço, para a latência contra o timestamp do kernel
+    bool onFrame(const CanFrame &frame, uint64_t nowNs, CanFrame &out);
+
+    // Chamado depois que o 0x402 de onFrame saiu (latência de atuação)
+    void onSent(const CanFrame &cause, uint64_t nowNs);
+
+    // O 0x402 de onFrame não saiu (erro do socket): o próximo onFrame manda
+    // de novo mesmo que a máscara não mude
+    void invalidateOutputs() { delta_.invalidate(); }
+
+    // Periódico: true = mandar out (RTR das temperaturas paradas)
+    bool tick(uint64_t nowNs, CanFrame &out);
+
+    // Modo, limites e sinais novos (SIGHUP no cansupd) sem perder estado nem
+    // telemetria; o próximo frame de temperatura aplica. std::runtime_error
+    // se os sinais ou o .hex não existirem (a configuração anterior continua)
+    void reconfigure(const ContainerConfig &config);
+
+    // 0x402 com todos os relés desligados (saída do daemon, desligarSeguro)
+    static CanFrame allOff();
+
+    const ContainerConfig &config() const { return config_; }
+    State state() const { return state_; }
+    const Decision &decision() const { return decision_; }
+    double motor() const { return motor_; }
+    double water() const { return water_; }
+    bool hasTemperature() const { return lastTempNs_ != 0; }
+    uint64_t lastTemperatureNs() const { return lastTempNs_; }
+
+    const std::vector<Telemetry> &telemetry() const { return telemetry_; }
+    const FlashMonitor &flash() const { return flash_; }
+
+    uint64_t frames() const { return frames_; }
+    uint64_t unknown() const { return unknown_; }
+    uint64_t transitions() const { return transitions_; }
+    uint64_t commands() const { return commands_; }
+    uint64_t requests() const { return requests_; }
+
+    LatencyHistogram &decisionLatency() { return decisionLatency_; }
+    LatencyHistogram &actuationLatency() { return actuationLatency_; }
+
+    // Só a máquina de estados (S1-S4 + emergência), sem DBC nem frames
+    static State step(const ContainerConfig &config, State state, double motor, double water, Decision &decision);
+
+private:
+    void resolveSignals(const ContainerConfig &config);
+    static uint32_t flashImage(const ContainerConfig &config);
+
+    ContainerConfig config_;
+    const dbc::Database &db_;
+    const dbc::Signal *motorSignal_ = nullptr;
+    const dbc::Signal *waterSignal_ = nullptr;
+
+    State state_ = StateFiltration;     // Como o executarControle: começa em S2
+    Decision decision_;
+    double motor_ = 0, water_ = 0;
+    proto::DigitalDelta delta_;
+
+    std::vector<Telemetry> telemetry_;  // Mesmo índice de db.messages()
+    FlashMonitor flash_;
+    uint64_t lastTempNs_ = 0, lastRtrNs_ = 0;
+    uint64_t frames_ = 0, unknown_ = 0, transitions_ = 0, commands_ = 0, requests_ = 0;
+    LatencyHistogram decisionLatency_, actuationLatency_;
+};
+
+}  // namespace sup
+
+#endif
@@ -0,0 +1,170 @@
+//═══════════════════════════════════════════════════════════════════════════
+// Host_CanToolkit - PLANTA TÉRMICA SIMULADA (MOTOR, INTERCOOLER, STARTER, ÁGUA)
+//═══════════════════════════════════════════════════════════════════════════
+// Modelo concentrado (um nó térmico por parte, Euler explícito) para ajustar
+// limM/limA, histerese e os limites de segurança sem esperar a água esquentar
+// de verdade. As saídas são os relés da placa no layout do 0x402 do
+// supervisor (container 17: D8 bomba, D6 NA1, D5 NA2, D1/D2 emergência):
+//
+//   motor        calor do motor (load kW); troca com a água só com a bomba
+//   intercooler  fração do calor (icLoad kW); também resfriado pela água
+//   starter      segue o motor devagar (acoplamento fraco)
+//   água         tanque (tank L); NA1 = passa pelo radiador (cooler kW/K),
+//                NA2 = descarta e repõe água fria (fresh kg/s a freshT °C)
+//   D1/D2        parada de emergência: corta o calor do motor (stopCutsLoad)
+//
+// Os termopares saem como o CANmod.Temp manda (°C inteiros, ruído gaussiano
+// opcional): 0x510 TL = starter, TR = motor, BL = intercooler, BR = água
+// (o "Starter = TL1, Engine = TR1, Intercooler = BL1, Water = BR1" do .m) e
+// 0x520 TL = ambiente, TR = água de reposição.
+//
+// Laço fechado (simulate): cada 0x510 passa pelo ContainerSupervisor real
+// (include/supervisor.h) e por uma réplica dos canais de segurança do
+// firmware (SafetyChannel em main.cpp: EMA com alpha, dispara em maxtemp
+// ligando tripRelays, normaliza desligando releaseRelays, perfil do
+// container 17). Os dois escrevem nos mesmos relés, como na placa: quem
+// escreve por último vale. O timer do canal só conta alarmes e não mexe em
+// relé, por isso não entra no modelo.
+//
+// Parâmetros por nome (setParam), para varreduras (tools/canplant.cpp):
+//   controle  limM limA histM histA emerg
+//   firmware  alpha maxT1 maxT2 maxT3 maxT4 (<= 0 desliga o canal)
+//   planta    load icLoad ambient tank cooler fresh freshT noise stopCutsLoad
+//   execução  hours frameMs seed
+//═══════════════════════════════════════════════════════════════════════════
+#ifndef THERMAL_PLANT_H
+#define THERMAL_PLANT_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "can_frame.h"
+#include "dbc.h"
+#include "supervisor.h"
+
+namespace plant {
+
+// Relés (bit 0 = D1 ... bit 7 = D8), layout do 0x402 do supervisor
+constexpr uint8_t kPump = 0x80;       // D8
+constexpr uint8_t kNa1 = 0x20;        // D6 (circulação pelo radiador)
+constexpr uint8_t kNa2 = 0x10;        // D5 (descarte)
+constexpr uint8_t kStop = 0x03;       // D1/D2
+
+struct PlantParams {
+    double load = 40;            // kW do motor para o bloco
+    double icLoad = 6;           // kW para o intercooler
+    double ambient = 25;         // °C
+    double tank = 3000;          // L de água no tanque
+    double cooler = 2;           // kW/K do radiador com NA1
+    double fresh = 0.5;          // kg/s de reposição com NA2
+    double freshT = 20;          // °C da água de reposição
+    double noise = 0;            // Desvio padrão do termopar (°C)
+    double stopCutsLoad = 1;     // D1/D2 cortam o calor do motor?
+
+    // Constantes da instalação (não varridas)
+    double engineC = 200;        // kJ/K do bloco
+    double intercoolerC = 20;
+    double starterC = 10;
+    double engineToWater = 0.8;  // kW/K com a bomba (0.1 sem)
+    double icToWater = 0.3;
+    double engineToStarter = 0.02;
+    double engineLoss = 0.15;    // kW/K para o ambiente
+    double icLoss = 0.05;
+    double starterLoss = 0.02;
+    double tankLoss = 0.05;
+};
+
+class ThermalPlant {
+public:
+    explicit ThermalPlant(const PlantParams &params, uint32_t seed = 1);
+
+    // Avança dtS segundos com os relés ligados em mask
+    void step(double dtS, uint8_t mask);
+
+    double engine() const { return engine_; }
+    double intercooler() const { return intercooler_; }
+    double starter() const { return starter_; }
+    double water() const { return water_; }
+    double discardedLiters() const { return discardedL_; }
+
+    // Leituras com ruído e quantização do módulo
+    CanFrame frame510();
+    CanFrame frame520();
+
+private:
+    int16_t sensor(double t);
+
+    PlantParams p_;
+    double engine_, intercooler_, starter_, water_;
+    double discardedL_ = 0;
+    uint64_t rng_;
+};
+
+//───────────────────────────────────────────────────────────────────────────
+// RÉPLICA DOS CANAIS DE SEGURANÇA DO FIRMWARE (perfil do container 17)
+//───────────────────────────────────────────────────────────────────────────
+class FirmwareSafety {
+public:
+    FirmwareSafety(double alpha, const double maxTemp[4]);
+
+    // Um 0x510: filtra T1..T4 e aplica disparo/normalização em mask
+    void onFrame(const CanFrame &frame, uint8_t &mask);
+
+    uint64_t trips() const { return trips_; }
+    double filtered(int ch) const { return filtered_[ch]; }
+
+private:
+    double alpha_;
+    double maxTemp_[4];
+    double filtered_[4] = {0, 0, 0, 0};   // Como no firmware, começa em 0
+    bool tripped_[4] = {false, false, false, false};
+    uint64_t trips_ = 0;
+};
+
+//───────────────────────────────────────────────────────────────────────────
+// SIMULAÇÃO EM LAÇO FECHADO
+//───────────────────────────────────────────────────────────────────────────
+struct SimParams {
+    sup::ContainerConfig control;
+    double alpha = 0.1;
+    double maxTemp[4] = {80, 105, 70, 50};   // Starter, motor, intercooler, água
+    PlantParams plant;
+    double hours = 4;
+    double frameMs = 100;                    // Período do 0x510 (passo do modelo)
+    double seed = 1;
+};
+
+struct SimResult {
+    double peakEngine = 0, peakWater = 0;
+    double overshootEngine = 0, overshootWater = 0;   // Pico acima de limM/limA
+    double aboveLimitS = 0;                          // Motor acima de limM
+    uint64_t emergencies = 0;                        // Entradas em D1/D2 do supervisor
+    uint64_t trips = 0;                              // Disparos do firmware
+    uint64_t transitions = 0;                        // S1-S4
+    uint64_t commands = 0;                           // 0x402 enviados
+    uint64_t pumpCycles = 0, na1Cycles = 0, na2Cycles = 0;   // Desligado → ligado
+    double shortestOnS = 0;                          // Menor tempo ligado (bomba/NA1/NA2)
+    double discardedL = 0;
+    double finalEngine = 0, finalWater = 0;
+    uint8_t finalRelays = 0;
+};
+
+// Campo de SimParams pelo nome do cabeçalho; false = nome desconhecido
+bool setParam(SimParams &params, const std::string &name, double value);
+const std::vector<std::string> &paramNames();
+
+// Uma execução; db precisa ter o 0x510 do ContainerConfig (std::runtime_error)
+SimResult simulate(const SimParams &params, const dbc::Database &db);
+
+// Eixo de varredura: "nome=a:b:passo" ou "nome=v1,v2,..." (std::invalid_argument)
+struct SweepAxis {
+    std::string name;
+    std::vector<double> values;
+};
+SweepAxis parseAxis(const std::string &spec);
+
+}  // namespace plant
+
+#endif
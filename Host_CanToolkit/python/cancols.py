@@ -0,0 +1,50 @@
+"""Leitura dos arquivos .cols gerados pelo candecode (ver include/bulk_decode.h).
+
+    import cancols
+    d = cancols.load("saida/CANTemp1TC_510.cols")
+    plt.plot(d["time"], d["TLTemp"])
+
+Com numpy instalado cada coluna é um np.ndarray (sem cópia, via memmap);
+sem numpy, um array.array('d').
+"""
+
+import array
+import struct
+import sys
+
+_HEADER = struct.Struct("<8sIIQ")
+_DESCRIPTOR = 64
+
+
+def read_header(path):
+    """Retorna (linhas, [(nome, unidade), ...]) de um arquivo .cols."""
+    with open(path, "rb") as f:
+        magic, ncols, _, rows = _HEADER.unpack(f.read(_HEADER.size))
+        if magic != b"CANCOL1\0":
+            raise ValueError("%s: não é um arquivo CANCOL1" % path)
+        cols = []
+        for _ in range(ncols):
+            d = f.read(_DESCRIPTOR)
+            cols.append((d[:48].split(b"\0", 1)[0].decode(), d[48:].split(b"\0", 1)[0].decode()))
+    return rows, cols
+
+
+def load(path):
+    """Carrega todas as colunas em um dict {nome: vetor}."""
+    rows, cols = read_header(path)
+    offset = _HEADER.size + _DESCRIPTOR * len(cols)
+    try:
+        import numpy as np
+        data = np.memmap(path, dtype="<f8", mode="r", offset=offset, shape=(len(cols), rows))
+        return {name: data[i] for i, (name, _) in enumerate(cols)}
+    except ImportError:
+        out = {}
+        with open(path, "rb") as f:
+            f.seek(offset)
+            for name, _ in cols:
+                a = array.array("d")
+                a.fromfile(f, rows)
+                if sys.byteorder != "little":
+                    a.byteswap()
+                out[name] = a
+        return out
@@ -0,0 +1,271 @@
+"""Binding Python do Host_CanToolkit (ctypes, sem dependências extras).
+
+Uma única conexão SocketCAN persistente por interface: os GUIs abrem o
+barramento uma vez (CanToolkit("can0")) e reutilizam para todos os envios.
+Os codecs são os mesmos do firmware (config.cpp compilado em libcantoolkit.so).
+
+A biblioteca é procurada em $CANTOOLKIT_LIB e depois em ../build (o
+diretório do README) relativo a este arquivo.
+"""
+import ctypes
+import os
+from dataclasses import dataclass
+from typing import Callable, Iterable, List, Optional, Tuple
+
+CTK_FLAG_EXTENDED = 0x01
+CTK_FLAG_REMOTE = 0x02
+
+
+class _Frame(ctypes.Structure):
+    _fields_ = [
+        ("id", ctypes.c_uint32),
+        ("dlc", ctypes.c_uint8),
+        ("flags", ctypes.c_uint8),
+        ("data", ctypes.c_uint8 * 8),
+        ("timestamp_ns", ctypes.c_uint64),
+    ]
+
+
+class _Temp(ctypes.Structure):
+    _fields_ = [
+        ("cj_temp", ctypes.c_int),
+        ("status", ctypes.c_int * 4),
+        ("temp", ctypes.c_int * 4),
+    ]
+
+
+_RX_CALLBACK = ctypes.CFUNCTYPE(None, ctypes.POINTER(_Frame), ctypes.c_void_p)
+
+
+def _load_library():
+    here = os.path.dirname(os.path.abspath(__file__))
+    candidates = [os.environ.get("CANTOOLKIT_LIB", ""), os.path.join(here, "..", "build", "libcantoolkit.so")]
+    for path in candidates:
+        if path and os.path.exists(path):
+            return ctypes.CDLL(path)
+    raise OSError("libcantoolkit.so não encontrada (compile Host_CanToolkit ou defina CANTOOLKIT_LIB)")
+
+
+_lib = _load_library()
+_lib.ctk_open.restype = ctypes.c_void_p
+_lib.ctk_open.argtypes = [ctypes.c_char_p]
+_lib.ctk_close.argtypes = [ctypes.c_void_p]
+_lib.ctk_send.argtypes = [ctypes.c_void_p, ctypes.POINTER(_Frame)]
+_lib.ctk_send_batch.argtypes = [ctypes.c_void_p, ctypes.POINTER(_Frame), ctypes.c_size_t]
+_lib.ctk_subscribe.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32, _RX_CALLBACK, ctypes.c_void_p]
+_lib.ctk_unsubscribe.argtypes = [ctypes.c_void_p, ctypes.c_int]
+_lib.ctk_rx_count.restype = ctypes.c_uint64
+_lib.ctk_rx_count.argtypes = [ctypes.c_void_p]
+_lib.ctk_tx_count.restype = ctypes.c_uint64
+_lib.ctk_tx_count.argtypes = [ctypes.c_void_p]
+_lib.ctk_last_error.restype = ctypes.c_char_p
+_lib.ctk_read_pwm_enc.argtypes = [ctypes.c_char_p, ctypes.c_int]
+_lib.ctk_encode_safety_pair.argtypes = [ctypes.c_int, ctypes.c_float, ctypes.c_int,
+                                        ctypes.c_int, ctypes.c_float, ctypes.c_int, ctypes.c_char_p]
+
+
+class CanError(Exception):
+    pass
+
+
+@dataclass
+class Message:
+    arbitration_id: int
+    data: bytes
+    is_extended_id: bool = False
+    is_remote_frame: bool = False
+    timestamp: float = 0.0
+
+    @property
+    def dlc(self) -> int:
+        return len(self.data)
+
+
+def _to_frame(arbitration_id: int, data: Iterable[int], extended: bool, remote: bool) -> _Frame:
+    payload = bytes(data)[:8]
+    frame = _Frame()
+    frame.id = arbitration_id
+    frame.dlc = len(payload)
+    frame.flags = (CTK_FLAG_EXTENDED if extended else 0) | (CTK_FLAG_REMOTE if remote else 0)
+    ctypes.memmove(frame.data, payload, len(payload))
+    return frame
+
+
+def _check(ret: int) -> int:
+    if ret < 0:
+        raise CanError(_lib.ctk_last_error().decode(errors="replace"))
+    return ret
+
+
+class CanToolkit:
+    """Conexão SocketCAN persistente com recepção por callback."""
+
+    def __init__(self, channel: str = "can0"):
+        self._bus = _lib.ctk_open(channel.encode())
+        if not self._bus:
+            raise CanError(_lib.ctk_last_error().decode(errors="replace"))
+        self._callbacks = {}
+
+    def send(self, arbitration_id: int, data: Iterable[int] = (), extended: bool = False,
+             remote: bool = False) -> None:
+        frame = _to_frame(arbitration_id, data, extended, remote)
+        _check(_lib.ctk_send(self._bus, ctypes.byref(frame)))
+
+    def send_batch(self, messages: List[Tuple[int, Iterable[int]]]) -> int:
+        """Envia [(id, data), ...] numa única chamada ao kernel."""
+        frames = (_Frame * len(messages))()
+        for i, (arb_id, data) in enumerate(messages):
+            frames[i] = _to_frame(arb_id, data, False, False)
+        return _check(_lib.ctk_send_batch(self._bus, frames, len(messages)))
+
+    def subscribe(self, callback: Callable[[Message], None], arbitration_id: int = 0,
+                  mask: int = 0, is_extended_id: bool = False) -> int:
+        """Callback chamado na thread de recepção para (id & mask) == (arbitration_id & mask).
+
+        Com mask != 0 só casa frames do mesmo tipo de ID (is_extended_id)."""
+        def trampoline(frame_ptr, _user):
+            f = frame_ptr.contents
+            callback(Message(
+                arbitration_id=f.id,
+                data=bytes(f.data[:f.dlc]),
+                is_extended_id=bool(f.flags & CTK_FLAG_EXTENDED),
+                is_remote_frame=bool(f.flags & CTK_FLAG_REMOTE),
+                timestamp=f.timestamp_ns / 1e9,
+            ))
+
+        c_cb = _RX_CALLBACK(trampoline)
+        handle = _check(_lib.ctk_subscribe(self._bus, arbitration_id | (0x80000000 if is_extended_id else 0),
+                                           mask, c_cb, None))
+        self._callbacks[handle] = c_cb  # Mantém a referência viva
+        return handle
+
+    def unsubscribe(self, handle: int) -> None:
+        _lib.ctk_unsubscribe(self._bus, handle)
+        self._callbacks.pop(handle, None)
+
+    @property
+    def rx_count(self) -> int:
+        return _lib.ctk_rx_count(self._bus)
+
+    @property
+    def tx_count(self) -> int:
+        return _lib.ctk_tx_count(self._bus)
+
+    def shutdown(self) -> None:
+        if self._bus:
+            _lib.ctk_close(self._bus)
+            self._bus = None
+            self._callbacks.clear()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.shutdown()
+
+    def __del__(self):
+        self.shutdown()
+
+
+# ==== Codecs (mesmos nomes usados pelos scripts de teste) ====
+
+def read_digital(buf: bytes) -> List[int]:
+    relays = (ctypes.c_int * 8)()
+    pwm1, pwm2, enc = ctypes.c_int(), ctypes.c_int(), ctypes.c_int()
+    _lib.ctk_decode_digital(bytes(buf).ljust(8, b"\0"), relays, ctypes.byref(pwm1),
+                            ctypes.byref(pwm2), ctypes.byref(enc))
+    return list(relays)
+
+
+def read_pwm_enc(buf: bytes, index: int) -> int:
+    return _lib.ctk_read_pwm_enc(bytes(buf).ljust(8, b"\0"), index)
+
+
+def send_digital(digital_command: List[int], pwm1: int, pwm2: int, enc: int) -> bytearray:
+    out = ctypes.create_string_buffer(8)
+    _lib.ctk_encode_digital((ctypes.c_int * 8)(*digital_command), pwm1, pwm2, enc, out)
+    return bytearray(out.raw)
+
+
+class DigitalDelta:
+    """Envia o 0x402 só quando o frame calculado muda (par do relatório por mudança do nó)."""
+
+    def __init__(self, bus: "CanToolkit"):
+        self._bus = bus
+        self._last: Optional[bytearray] = None
+
+    def update(self, digital_command: List[int], pwm1: int = 0, pwm2: int = 0, enc: int = 0) -> bool:
+        data = send_digital(digital_command, pwm1, pwm2, enc)
+        if data == self._last:
+            return False
+        self._bus.send(0x402, data)
+        self._last = data  # Só depois do send: com CanError o próximo update repete
+        return True
+
+    def invalidate(self) -> None:
+        self._last = None
+
+
+def send_safety_pair(enable1: int, max1: float, timer1: int,
+                     enable2: int, max2: float, timer2: int) -> bytearray:
+    """0x403/0x406: dois canais (maxtemp em degC, timer em ms limitado a 1 byte)."""
+    out = ctypes.create_string_buffer(8)
+    _lib.ctk_encode_safety_pair(enable1, max1, timer1, enable2, max2, timer2, out)
+    return bytearray(out.raw)
+
+
+def read_safety_pair(buf: bytes):
+    enable = (ctypes.c_int * 2)()
+    maxtemp = (ctypes.c_float * 2)()
+    timer = (ctypes.c_int * 2)()
+    _lib.ctk_decode_safety_pair(bytes(buf).ljust(8, b"\0"), enable, maxtemp, timer)
+    return [(enable[i], maxtemp[i], timer[i]) for i in range(2)]
+
+
+def send_aquisition_config(timer: int, analog: bool, continuous: int) -> bytearray:
+    out = ctypes.create_string_buffer(8)
+    _lib.ctk_encode_aquisition(timer, int(analog), continuous, out)
+    return bytearray(out.raw)
+
+
+def aquisition_config(buf: bytes):
+    timer, analog, continuous = ctypes.c_int(), ctypes.c_int(), ctypes.c_int()
+    _lib.ctk_decode_aquisition(bytes(buf).ljust(8, b"\0"), ctypes.byref(timer),
+                               ctypes.byref(analog), ctypes.byref(continuous))
+    return timer.value, bool(analog.value), continuous.value
+
+
+def send_start_stop(enable: bool) -> bytearray:
+    out = ctypes.create_string_buffer(8)
+    _lib.ctk_encode_start_stop(int(enable), out)
+    return bytearray(out.raw)
+
+
+@dataclass
+class TempReadStructure:
+    CJtemp: int
+    TLstatus: int
+    TRstatus: int
+    BLstatus: int
+    BRstatus: int
+    TLtemp: int
+    TRtemp: int
+    BLtemp: int
+    BRtemp: int
+
+
+def temp_read(buf: bytes) -> TempReadStructure:
+    t = _Temp()
+    _lib.ctk_decode_temperature(bytes(buf).ljust(8, b"\0"), ctypes.byref(t))
+    return TempReadStructure(t.cj_temp, *t.status, *t.temp)
+
+
+_default_bus: Optional[CanToolkit] = None
+
+
+def shared_bus(channel: str = "can0") -> CanToolkit:
+    """Conexão única compartilhada pelo processo (aberta no primeiro uso)."""
+    global _default_bus
+    if _default_bus is None:
+        _default_bus = CanToolkit(channel)
+    return _default_bus
@@ -0,0 +1,499 @@
+#include "bulk_decode.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <linux/can.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+
+#include "can_log.h"
+
+namespace bulk {
+
+namespace {
+
+[[noreturn]] void throwErrno(const std::string &what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Executa fn(i) para i em [0, n) distribuindo os índices entre as threads
+template <typename F>
+void parallelFor(size_t n, unsigned threads, F &&fn) {
+    if (threads <= 1 || n <= 1) {
+        for (size_t i = 0; i < n; i++) fn(i);
+        return;
+    }
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < std::min<size_t>(threads, n); t++) {
+        pool.emplace_back([&] {
+            for (size_t i; (i = next.fetch_add(1)) < n;) {
+                try {
+                    fn(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) error = std::current_exception();
+                }
+            }
+        });
+    }
+    for (auto &th : pool) th.join();
+    if (error) std::rethrow_exception(error);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// Tabela ID → mensagem (ID padrão: acesso direto; estendido: hash)
+//───────────────────────────────────────────────────────────────────────────
+class IdLookup {
+public:
+    explicit IdLookup(const dbc::Database &db) : std_(2048, -1) {
+        const auto &msgs = db.messages();
+        for (size_t i = 0; i < msgs.size(); i++) {
+            if (msgs[i].extended) ext_[msgs[i].id] = static_cast<int>(i);
+            else if (msgs[i].id < 2048) std_[msgs[i].id] = static_cast<int>(i);
+        }
+    }
+
+    // canId no formato do kernel (flags EFF/RTR); -1 = ID fora do DBC
+    int find(uint32_t canId) const {
+        if (canId & CAN_EFF_FLAG) {
+            auto it = ext_.find(canId & CAN_EFF_MASK);
+            return it == ext_.end() ? -1 : it->second;
+        }
+        return std_[canId & CAN_SFF_MASK];
+    }
+
+private:
+    std::vector<int> std_;
+    std::unordered_map<uint32_t, int> ext_;
+};
+
+// Resultado parcial de uma fatia da captura
+struct Partial {
+    std::vector<FrameColumns> groups;
+    uint64_t frames = 0, unknown = 0, remote = 0;
+};
+
+void addFrame(Partial &part, const IdLookup &lut, uint32_t canId, uint64_t tNs, uint64_t payload) {
+    part.frames++;
+    if (canId & CAN_RTR_FLAG) {
+        part.remote++;
+        return;
+    }
+    int g = lut.find(canId);
+    if (g < 0) {
+        part.unknown++;
+        return;
+    }
+    part.groups[g].timeNs.push_back(tNs);
+    part.groups[g].payload.push_back(payload);
+}
+
+// Junta as fatias mantendo a ordem temporal (fatia 0 antes da 1, ...)
+Capture merge(std::vector<Partial> &parts, size_t groups) {
+    Capture cap;
+    cap.groups.resize(groups);
+    for (size_t g = 0; g < groups; g++) {
+        size_t total = 0;
+        for (const auto &p : parts) total += p.groups[g].timeNs.size();
+        cap.groups[g].timeNs.reserve(total);
+        cap.groups[g].payload.reserve(total);
+        for (auto &p : parts) {
+            auto &src = p.groups[g];
+            cap.groups[g].timeNs.insert(cap.groups[g].timeNs.end(), src.timeNs.begin(), src.timeNs.end());
+            cap.groups[g].payload.insert(cap.groups[g].payload.end(), src.payload.begin(), src.payload.end());
+            src = FrameColumns();
+        }
+    }
+    for (const auto &p : parts) {
+        cap.frames += p.frames;
+        cap.unknown += p.unknown;
+        cap.remote += p.remote;
+    }
+    return cap;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// candump (texto)
+//   -L:   (1697041234.123456) can0 510#0102030405060708
+//   tela: (1697041234.123456)  can0  510   [8]  01 02 03 04 05 06 07 08
+//         (timestamp opcional; "remote request" marca RTR)
+//───────────────────────────────────────────────────────────────────────────
+inline int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+inline const char *skipBlank(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+// Retorna false para linhas que não são frames CAN clássicos
+bool parseCandumpLine(const char *p, const char *end, uint32_t &canId, uint64_t &tNs, uint64_t &payload) {
+    p = skipBlank(p, end);
+    tNs = 0;
+    if (p < end && *p == '(') {
+        uint64_t sec = 0, frac = 0;
+        int fracDigits = 0;
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++) sec = sec * 10 + (*p - '0');
+        if (p < end && *p == '.') {
+            for (p++; p < end && *p >= '0' && *p <= '9'; p++) {
+                if (fracDigits < 9) {
+                    frac = frac * 10 + (*p - '0');
+                    fracDigits++;
+                }
+            }
+        }
+        while (fracDigits < 9) {
+            frac *= 10;
+            fracDigits++;
+        }
+        tNs = sec * 1000000000ull + frac;
+        if (p >= end || *p != ')') return false;
+        p = skipBlank(p + 1, end);
+    }
+
+    // Interface
+    while (p < end && *p != ' ' && *p != '\t') p++;
+    p = skipBlank(p, end);
+
+    // ID: 3 dígitos = padrão, 8 dígitos = estendido
+    const char *idStart = p;
+    uint32_t id = 0;
+    int d;
+    while (p < end && (d = hexDigit(*p)) >= 0) {
+        id = (id << 4) | static_cast<uint32_t>(d);
+        p++;
+    }
+    if (p == idStart) return false;
+    canId = (p - idStart) > 3 ? ((id & CAN_EFF_MASK) | CAN_EFF_FLAG) : (id & CAN_SFF_MASK);
+
+    uint8_t data[8] = {0};
+    if (p < end && *p == '#') {
+        p++;
+        if (p < end && *p == '#') return false;  // CAN FD
+        if (p < end && (*p == 'R' || *p == 'r')) {
+            canId |= CAN_RTR_FLAG;
+            payload = 0;
+            return true;
+        }
+        for (int i = 0; i < 8 && p + 1 < end; i++) {
+            int hi = hexDigit(p[0]), lo = hexDigit(p[1]);
+            if (hi < 0 || lo < 0) break;
+            data[i] = static_cast<uint8_t>((hi << 4) | lo);
+            p += 2;
+        }
+    } else {
+        p = skipBlank(p, end);
+        if (p >= end || *p != '[') return false;
+        int dlc = 0;
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++) dlc = dlc * 10 + (*p - '0');
+        if (p < end && *p == ']') p++;
+        p = skipBlank(p, end);
+        if (p < end && *p == 'r') {
+            canId |= CAN_RTR_FLAG;
+            payload = 0;
+            return true;
+        }
+        for (int i = 0; i < dlc && i < 8; i++) {
+            p = skipBlank(p, end);
+            if (p + 1 >= end) break;
+            int hi = hexDigit(p[0]), lo = hexDigit(p[1]);
+            if (hi < 0 || lo < 0) break;
+            data[i] = static_cast<uint8_t>((hi << 4) | lo);
+            p += 2;
+        }
+    }
+    memcpy(&payload, data, 8);
+    return true;
+}
+
+Capture loadCandump(const char *text, size_t size, const dbc::Database &db, unsigned threads) {
+    IdLookup lut(db);
+    size_t groups = db.messages().size();
+
+    // Fatias de ~8 MB alinhadas em fim de linha
+    size_t slices = std::max<size_t>(1, std::min<size_t>(threads * 4, size / (8u << 20) + 1));
+    std::vector<size_t> bounds(slices + 1, size);
+    bounds[0] = 0;
+    for (size_t s = 1; s < slices; s++) {
+        size_t b = std::max(size * s / slices, bounds[s - 1]);
+        const void *nl = b < size ? memchr(text + b, '\n', size - b) : nullptr;
+        bounds[s] = nl ? static_cast<size_t>(static_cast<const char *>(nl) - text) + 1 : size;
+    }
+
+    std::vector<Partial> parts(slices);
+    parallelFor(slices, threads, [&](size_t s) {
+        Partial &part = parts[s];
+        part.groups.resize(groups);
+        const char *p = text + bounds[s];
+        const char *end = text + bounds[s + 1];
+        while (p < end) {
+            const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+            if (!eol) eol = end;
+            uint32_t canId;
+            uint64_t tNs, payload;
+            if (parseCandumpLine(p, eol, canId, tNs, payload)) addFrame(part, lut, canId, tNs, payload);
+            p = eol + 1;
+        }
+    });
+    return merge(parts, groups);
+}
+
+Capture loadCanlog(const std::string &path, const dbc::Database &db, unsigned threads) {
+    canlog::Reader log(path);
+    IdLookup lut(db);
+    size_t groups = db.messages().size();
+
+    size_t slices = std::max<size_t>(1, std::min<uint64_t>(threads * 4, log.size() / 65536 + 1));
+    std::vector<Partial> parts(slices);
+    parallelFor(slices, threads, [&](size_t s) {
+        Partial &part = parts[s];
+        part.groups.resize(groups);
+        uint64_t first = log.size() * s / slices, last = log.size() * (s + 1) / slices;
+        log.forRange(first, last, [&](uint64_t, const canlog::Record &rec, uint64_t tNs) {
+            uint64_t payload;
+            memcpy(&payload, rec.data, 8);
+            addFrame(part, lut, rec.canId, tNs, payload);
+        });
+    });
+    return merge(parts, groups);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// Saída
+//───────────────────────────────────────────────────────────────────────────
+class BufferedFile {
+public:
+    explicit BufferedFile(const std::string &path) : path_(path) {
+        f_ = fopen(path.c_str(), "wb");
+        if (!f_) throwErrno(path);
+        buf_.resize(1 << 20);
+    }
+    ~BufferedFile() {
+        if (f_) fclose(f_);
+    }
+
+    // Garante espaço para pelo menos n bytes e devolve o cursor
+    char *reserve(size_t n) {
+        if (used_ + n > buf_.size()) flush();
+        return buf_.data() + used_;
+    }
+    void commit(char *to) { used_ = static_cast<size_t>(to - buf_.data()); }
+    void write(const void *data, size_t n) {
+        flush();
+        if (fwrite(data, 1, n, f_) != n) throwErrno(path_);
+    }
+    void flush() {
+        if (used_ && fwrite(buf_.data(), 1, used_, f_) != used_) throwErrno(path_);
+        used_ = 0;
+    }
+    void close() {
+        flush();
+        if (fclose(f_) != 0) {
+            f_ = nullptr;
+            throwErrno(path_);
+        }
+        f_ = nullptr;
+    }
+
+private:
+    std::string path_;
+    FILE *f_ = nullptr;
+    std::vector<char> buf_;
+    size_t used_ = 0;
+};
+
+}  // namespace
+
+Capture loadCapture(const std::string &path, const dbc::Database &db, unsigned threads) {
+    if (threads == 0) threads = 1;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throwErrno(path);
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throwErrno(path);
+    }
+    char magic[8] = {0};
+    ssize_t n = pread(fd, magic, sizeof(magic), 0);
+    if (n == static_cast<ssize_t>(sizeof(magic)) && memcmp(magic, "CANLOG1", 8) == 0) {
+        close(fd);
+        return loadCanlog(path, db, threads);
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size == 0) {
+        close(fd);
+        Capture empty;
+        empty.groups.resize(db.messages().size());
+        return empty;
+    }
+    void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) throwErrno(path + ": mmap");
+    madvise(map, size, MADV_SEQUENTIAL);
+    try {
+        Capture cap = loadCandump(static_cast<const char *>(map), size, db, threads);
+        munmap(map, size);
+        return cap;
+    } catch (...) {
+        munmap(map, size);
+        throw;
+    }
+}
+
+DecodedMessage decode(const dbc::Message &msg, const FrameColumns &frames) {
+    const size_t n = frames.payload.size();
+    const uint64_t *payload = frames.payload.data();
+    DecodedMessage out;
+
+    out.time.resize(n);
+    double *time = out.time.data();
+    for (size_t i = 0; i < n; i++) time[i] = static_cast<double>(frames.timeNs[i]) * 1e-9;
+
+    // Sinais Motorola leem do payload com os bytes invertidos
+    std::vector<uint64_t> swapped;
+    for (const auto &sig : msg.signals) {
+        if (!sig.littleEndian) {
+            swapped.resize(n);
+            for (size_t i = 0; i < n; i++) swapped[i] = __builtin_bswap64(payload[i]);
+            break;
+        }
+    }
+
+    out.columns.resize(msg.signals.size());
+    for (size_t s = 0; s < msg.signals.size(); s++) {
+        const dbc::Signal &sig = msg.signals[s];
+        const uint64_t *src = sig.littleEndian ? payload : swapped.data();
+        const uint32_t shift = sig.shift;
+        const uint64_t mask = sig.mask;
+        const double factor = sig.factor, offset = sig.offset;
+        out.columns[s].resize(n);
+        double *dst = out.columns[s].data();
+
+        // Laços separados e sem desvios para o compilador vetorizar
+        if (!sig.isSigned) {
+            for (size_t i = 0; i < n; i++)
+                dst[i] = static_cast<double>(static_cast<int64_t>((src[i] >> shift) & mask)) * factor + offset;
+        } else {
+            const uint32_t up = 64 - sig.length;
+            for (size_t i = 0; i < n; i++) {
+                int64_t v = static_cast<int64_t>(((src[i] >> shift) & mask) << up) >> up;
+                dst[i] = static_cast<double>(v) * factor + offset;
+            }
+        }
+    }
+    return out;
+}
+
+std::string outputName(const dbc::Message &msg) {
+    char id[16];
+    snprintf(id, sizeof(id), msg.extended ? "%08X" : "%03X", msg.id);
+    return msg.name + "_" + id;
+}
+
+void writeCsv(const std::string &path, const dbc::Message &msg, const DecodedMessage &data) {
+    BufferedFile out(path);
+
+    std::string header = "time_s";
+    for (const auto &sig : msg.signals) {
+        header += "," + sig.name;
+        if (!sig.unit.empty()) header += "[" + sig.unit + "]";
+    }
+    header += "\n";
+    out.write(header.data(), header.size());
+
+    const size_t cols = data.columns.size();
+    const size_t lineMax = 32 + cols * 32;
+    for (size_t i = 0; i < data.time.size(); i++) {
+        char *p = out.reserve(lineMax);
+        char *end = p + lineMax;
+        p = std::to_chars(p, end, data.time[i], std::chars_format::fixed, 6).ptr;
+        for (size_t c = 0; c < cols; c++) {
+            *p++ = ',';
+            p = std::to_chars(p, end, data.columns[c][i]).ptr;
+        }
+        *p++ = '\n';
+        out.commit(p);
+    }
+    out.close();
+}
+
+void writeColumns(const std::string &path, const dbc::Message &msg, const DecodedMessage &data) {
+    BufferedFile out(path);
+
+    struct {
+        char magic[8];
+        uint32_t ncols;
+        uint32_t reserved;
+        uint64_t rows;
+    } header = {{'C', 'A', 'N', 'C', 'O', 'L', '1', '\0'}, static_cast<uint32_t>(1 + msg.signals.size()), 0,
+                data.time.size()};
+    static_assert(sizeof(header) == 24, "header de 24 bytes");
+    out.write(&header, sizeof(header));
+
+    auto descriptor = [&](const std::string &name, const std::string &unit) {
+        char d[64] = {0};
+        memcpy(d, name.data(), std::min<size_t>(name.size(), 47));
+        memcpy(d + 48, unit.data(), std::min<size_t>(unit.size(), 15));
+        out.write(d, sizeof(d));
+    };
+    descriptor("time", "s");
+    for (const auto &sig : msg.signals) descriptor(sig.name, sig.unit);
+
+    out.write(data.time.data(), data.time.size() * sizeof(double));
+    for (const auto &col : data.columns) out.write(col.data(), col.size() * sizeof(double));
+    out.close();
+}
+
+size_t decodeAll(const Capture &capture, const dbc::Database &db, const std::string &outDir, int formats,
+                 unsigned threads) {
+    std::filesystem::create_directories(outDir);
+
+    // Maiores mensagens primeiro para equilibrar as threads
+    std::vector<size_t> order;
+    for (size_t g = 0; g < capture.groups.size(); g++) {
+        if (!capture.groups[g].payload.empty()) order.push_back(g);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return capture.groups[a].payload.size() > capture.groups[b].payload.size();
+    });
+
+    std::atomic<size_t> written{0};
+    parallelFor(order.size(), threads, [&](size_t k) {
+        const dbc::Message &msg = db.messages()[order[k]];
+        DecodedMessage data = decode(msg, capture.groups[order[k]]);
+        std::string base = outDir + "/" + outputName(msg);
+        if (formats & OutputCsv) {
+            writeCsv(base + ".csv", msg, data);
+            written++;
+        }
+        if (formats & OutputBinary) {
+            writeColumns(base + ".cols", msg, data);
+            written++;
+        }
+    });
+    return written;
+}
+
+}  // namespace bulk
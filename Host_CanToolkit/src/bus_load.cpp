@@ -0,0 +1,91 @@
+#include "bus_load.h"
+
+namespace busload {
+
+namespace {
+
+// Monta os bits do SOF até o fim do campo de dados e calcula o CRC-15 (0x4599)
+struct BitWriter {
+    uint8_t bits[128];
+    unsigned n = 0;
+    uint16_t crc = 0;
+
+    void put(uint32_t value, unsigned width) {
+        for (unsigned i = width; i-- > 0;) {
+            uint8_t b = (value >> i) & 1;
+            bits[n++] = b;
+            uint8_t next = b ^ ((crc >> 14) & 1);
+            crc = (crc << 1) & 0x7FFF;
+            if (next) crc ^= 0x4599;
+        }
+    }
+};
+
+}  // namespace
+
+unsigned frameBits(const CanFrame &frame) {
+    BitWriter w;
+    uint8_t dlc = frame.dlc > 8 ? 8 : frame.dlc;
+    w.put(0, 1);  // SOF
+    if (frame.extended) {
+        w.put(frame.id >> 18, 11);
+        w.put(1, 1);  // SRR
+        w.put(1, 1);  // IDE
+        w.put(frame.id & 0x3FFFF, 18);
+        w.put(frame.remote ? 1 : 0, 1);
+        w.put(0, 2);  // r1, r0
+    } else {
+        w.put(frame.id & 0x7FF, 11);
+        w.put(frame.remote ? 1 : 0, 1);
+        w.put(0, 2);  // IDE, r0
+    }
+    w.put(dlc, 4);
+    if (!frame.remote) {
+        for (uint8_t i = 0; i < dlc; i++) w.put(frame.data[i], 8);
+    }
+    uint16_t crc = w.crc;
+    for (unsigned i = 15; i-- > 0;) w.bits[w.n++] = (crc >> i) & 1;
+
+    // Bit stuffing: após 5 bits iguais entra um bit complementar (que também conta na sequência)
+    unsigned stuffed = 0, run = 0;
+    uint8_t last = 2;
+    for (unsigned i = 0; i < w.n; i++) {
+        if (w.bits[i] == last) {
+            run++;
+        } else {
+            last = w.bits[i];
+            run = 1;
+        }
+        if (run == 5) {
+            stuffed++;
+            last ^= 1;
+            run = 1;
+        }
+    }
+    // Delimitador CRC + ACK + delimitador ACK + EOF (7) + IFS (3)
+    return w.n + stuffed + 13;
+}
+
+void LoadStats::add(const CanFrame &frame) {
+    unsigned bitsOnWire = frameBits(frame);
+    if (frames == 0 || frame.timestampNs < firstNs) firstNs = frame.timestampNs;
+    if (frame.timestampNs > lastNs) lastNs = frame.timestampNs;
+    frames++;
+    bits += bitsOnWire;
+    IdLoad &id = perId[frame.id | (frame.extended ? 0x80000000u : 0)];
+    id.frames++;
+    if (frame.remote) id.remotes++;
+    id.bits += bitsOnWire;
+}
+
+double LoadStats::load(uint32_t bitrate) const {
+    double s = seconds();
+    return s > 0 && bitrate ? bits / (s * bitrate) : 0.0;
+}
+
+double LoadStats::load(const IdLoad &id, uint32_t bitrate) const {
+    double s = seconds();
+    return s > 0 && bitrate ? id.bits / (s * bitrate) : 0.0;
+}
+
+}  // namespace busload
@@ -0,0 +1,263 @@
+#include "can_bus.h"
+
+#include <errno.h>
+#include <net/if.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/can.h>
+#include <linux/can/raw.h>
+
+#include <system_error>
+
+namespace {
+
+constexpr size_t kBatch = 32;  // Frames por recvmmsg/sendmmsg
+constexpr int kErrorBackoffMs = 100;   // Espera depois de POLLERR/POLLHUP (interface caída)
+
+[[noreturn]] void throwErrno(const char *what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+void toKernel(const CanFrame &in, can_frame &out) {
+    memset(&out, 0, sizeof(out));
+    out.can_id = in.id & (in.extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+    if (in.extended) out.can_id |= CAN_EFF_FLAG;
+    if (in.remote) out.can_id |= CAN_RTR_FLAG;
+    out.can_dlc = in.dlc > 8 ? 8 : in.dlc;
+    memcpy(out.data, in.data, out.can_dlc);
+}
+
+void fromKernel(const can_frame &in, CanFrame &out) {
+    out.extended = (in.can_id & CAN_EFF_FLAG) != 0;
+    out.remote = (in.can_id & CAN_RTR_FLAG) != 0;
+    out.id = in.can_id & (out.extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+    out.dlc = in.can_dlc > 8 ? 8 : in.can_dlc;
+    memcpy(out.data, in.data, 8);
+}
+
+}  // namespace
+
+CanBus::CanBus(const std::string &ifname)
+    : ifname_(ifname), subs_(std::make_shared<const SubscriptionList>()) {
+    fd_ = socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW);
+    if (fd_ < 0) throwErrno("socket(PF_CAN)");
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname.c_str(), IFNAMSIZ - 1);
+    if (ioctl(fd_, SIOCGIFINDEX, &ifr) < 0) {
+        int err = errno;
+        close(fd_);
+        errno = err;
+        throwErrno(("interface " + ifname).c_str());
+    }
+
+    // Timestamps do kernel em cada frame recebido
+    int on = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+
+    struct sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (bind(fd_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        int err = errno;
+        close(fd_);
+        errno = err;
+        throwErrno("bind(can)");
+    }
+
+    wakeFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFd_ < 0) {
+        int err = errno;
+        close(fd_);
+        errno = err;
+        throwErrno("eventfd");
+    }
+}
+
+CanBus::~CanBus() {
+    stop();
+    if (wakeFd_ >= 0) close(wakeFd_);
+    if (fd_ >= 0) close(fd_);
+}
+
+void CanBus::setReceiveBuffer(int bytes) {
+    // SO_RCVBUFFORCE ignora rmem_max quando há CAP_NET_ADMIN
+    if (setsockopt(fd_, SOL_SOCKET, SO_RCVBUFFORCE, &bytes, sizeof(bytes)) < 0)
+        setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes));
+}
+
+void CanBus::setReceiveOwn(bool on) {
+    int v = on ? 1 : 0;
+    if (setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_RECV_OWN_MSGS, &v, sizeof(v)) < 0) throwErrno("CAN_RAW_RECV_OWN_MSGS");
+}
+
+void CanBus::send(const CanFrame &frame) {
+    sendBatch(&frame, 1);
+}
+
+size_t CanBus::sendBatch(const CanFrame *frames, size_t count) {
+    can_frame kframes[kBatch];
+    struct iovec iov[kBatch];
+    struct mmsghdr msgs[kBatch];
+
+    size_t sent = 0;
+    while (sent < count) {
+        size_t n = count - sent < kBatch ? count - sent : kBatch;
+        memset(msgs, 0, sizeof(mmsghdr) * n);
+        for (size_t i = 0; i < n; i++) {
+            toKernel(frames[sent + i], kframes[i]);
+            iov[i].iov_base = &kframes[i];
+            iov[i].iov_len = sizeof(can_frame);
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int r = sendmmsg(fd_, msgs, n, 0);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            // Fila de TX do driver cheia: espera liberar e tenta de novo
+            if (errno == ENOBUFS || errno == EAGAIN) {
+                struct pollfd pfd = {fd_, POLLOUT, 0};
+                poll(&pfd, 1, 10);
+                struct timespec ts = {0, 100000};
+                nanosleep(&ts, nullptr);
+                continue;
+            }
+            throwErrno("sendmmsg");
+        }
+        sent += static_cast<size_t>(r);
+        txFrames_.fetch_add(static_cast<uint64_t>(r), std::memory_order_relaxed);
+    }
+    return sent;
+}
+
+int CanBus::subscribe(uint32_t filterId, uint32_t mask, Handler handler) {
+    int handle;
+    {
+        std::lock_guard<std::mutex> lock(subsMutex_);
+        auto next = std::make_shared<SubscriptionList>(*std::atomic_load(&subs_));
+        handle = nextHandle_++;
+        if (mask) mask |= kExtendedFlag;   // Tipo do ID sempre confere (ver can_bus.h)
+        next->push_back({handle, filterId & mask, mask, std::move(handler)});
+        std::atomic_store(&subs_, std::shared_ptr<const SubscriptionList>(std::move(next)));
+    }
+    start();
+    return handle;
+}
+
+void CanBus::unsubscribe(int handle) {
+    std::lock_guard<std::mutex> lock(subsMutex_);
+    auto next = std::make_shared<SubscriptionList>(*std::atomic_load(&subs_));
+    for (auto it = next->begin(); it != next->end(); ++it) {
+        if (it->handle == handle) {
+            next->erase(it);
+            break;
+        }
+    }
+    std::atomic_store(&subs_, std::shared_ptr<const SubscriptionList>(std::move(next)));
+}
+
+void CanBus::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) return;
+    rxThread_ = std::thread(&CanBus::rxLoop, this);
+}
+
+void CanBus::stop() {
+    if (!running_.exchange(false)) return;
+    uint64_t one = 1;
+    if (write(wakeFd_, &one, sizeof(one)) < 0) {
+        // eventfd só falha se o contador saturar; a thread sai no próximo poll
+    }
+    if (rxThread_.joinable()) rxThread_.join();
+    // Zera o eventfd para permitir um novo start()
+    if (read(wakeFd_, &one, sizeof(one)) < 0) {
+    }
+}
+
+void CanBus::dispatch(const CanFrame &frame) {
+    auto subs = std::atomic_load(&subs_);
+    uint32_t key = frame.id | (frame.extended ? kExtendedFlag : 0) | (frame.remote ? kRemoteFlag : 0);
+    for (const Subscription &s : *subs) {
+        if ((key & s.mask) == s.id) s.handler(frame);
+    }
+}
+
+size_t CanBus::receiveBatch(CanFrame *frames, size_t max) {
+    can_frame kframes[kBatch];
+    struct iovec iov[kBatch];
+    struct mmsghdr msgs[kBatch];
+    char ctrl[kBatch][CMSG_SPACE(sizeof(struct timespec))];
+
+    size_t want = max < kBatch ? max : kBatch;
+    memset(msgs, 0, sizeof(mmsghdr) * want);
+    for (size_t i = 0; i < want; i++) {
+        iov[i].iov_base = &kframes[i];
+        iov[i].iov_len = sizeof(can_frame);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_control = ctrl[i];
+        msgs[i].msg_hdr.msg_controllen = sizeof(ctrl[i]);
+    }
+
+    int n = recvmmsg(fd_, msgs, want, MSG_DONTWAIT, nullptr);
+    if (n <= 0) return 0;
+    rxFrames_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+
+    size_t count = 0;
+    for (int i = 0; i < n; i++) {
+        if (msgs[i].msg_len < sizeof(can_frame)) continue;
+        CanFrame &frame = frames[count++];
+        frame = CanFrame();
+        fromKernel(kframes[i], frame);
+        frame.echo = (msgs[i].msg_hdr.msg_flags & MSG_CONFIRM) != 0;
+        for (struct cmsghdr *c = CMSG_FIRSTHDR(&msgs[i].msg_hdr); c; c = CMSG_NXTHDR(&msgs[i].msg_hdr, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_TIMESTAMPNS) {
+                struct timespec ts;
+                memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                frame.timestampNs = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+            }
+        }
+    }
+    return count;
+}
+
+void CanBus::rxLoop() {
+    CanFrame frames[kBatch];
+    struct pollfd pfds[2] = {{fd_, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+
+    while (running_.load(std::memory_order_acquire)) {
+        int pr = poll(pfds, 2, -1);
+        if (pr < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (pfds[1].revents & POLLIN) break;
+        if (pfds[0].revents & POLLNVAL) break;
+
+        if (pfds[0].revents & POLLIN) {
+            size_t n = receiveBatch(frames, kBatch);
+            for (size_t i = 0; i < n; i++) dispatch(frames[i]);
+        }
+
+        // Interface caída (ENETDOWN) ou erro pendente: sem POLLIN o poll voltaria na
+        // hora para sempre. Lê e limpa o erro e espera antes de tentar de novo.
+        if (pfds[0].revents & (POLLERR | POLLHUP)) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err) {
+                rxError_.store(err, std::memory_order_relaxed);
+            }
+            struct pollfd wake = {wakeFd_, POLLIN, 0};
+            if (poll(&wake, 1, kErrorBackoffMs) > 0) break;
+        }
+    }
+}
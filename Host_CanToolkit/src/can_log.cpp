@@ -0,0 +1,262 @@
+#include "can_log.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/can.h>
+
+#include <algorithm>
+#include <system_error>
+
+namespace canlog {
+
+namespace {
+
+const char kMagic[8] = {'C', 'A', 'N', 'L', 'O', 'G', '1', '\0'};
+const char kIdxMagic[8] = {'C', 'A', 'N', 'I', 'D', 'X', '1', '\0'};
+
+[[noreturn]] void throwErrno(const std::string &what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+void writeAll(int fd, const void *buf, size_t len, const std::string &what) {
+    const char *p = static_cast<const char *>(buf);
+    while (len > 0) {
+        ssize_t w = write(fd, p, len);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            throwErrno(what);
+        }
+        p += w;
+        len -= static_cast<size_t>(w);
+    }
+}
+
+uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+// Abre (ou cria) um arquivo com header de 16 bytes; devolve o tamanho útil
+off_t openWithHeader(const std::string &path, const char magic[8], int &fd) {
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) throwErrno(path);
+    struct stat st;
+    if (fstat(fd, &st) < 0) throwErrno(path);
+    if (st.st_size == 0) {
+        FileHeader h;
+        memcpy(h.magic, magic, 8);
+        h.recordSize = kRecordSize;
+        h.reserved = 0;
+        writeAll(fd, &h, sizeof(h), path);
+        return sizeof(h);
+    }
+    FileHeader h;
+    if (pread(fd, &h, sizeof(h), 0) != static_cast<ssize_t>(sizeof(h)) || memcmp(h.magic, magic, 8) != 0 ||
+        h.recordSize != kRecordSize) {
+        errno = EINVAL;
+        throwErrno(path + ": header inválido");
+    }
+    // Descarta um registro parcial deixado por uma gravação interrompida
+    off_t whole = sizeof(FileHeader) + ((st.st_size - sizeof(FileHeader)) / kRecordSize) * kRecordSize;
+    if (whole != st.st_size && ftruncate(fd, whole) < 0) throwErrno(path);
+    return whole;
+}
+
+}  // namespace
+
+std::string indexPath(const std::string &path) {
+    return path + ".idx";
+}
+
+Record toRecord(const CanFrame &frame, uint64_t blockBaseNs) {
+    Record r;
+    r.canId = frame.id & (frame.extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+    if (frame.extended) r.canId |= CAN_EFF_FLAG;
+    if (frame.remote) r.canId |= CAN_RTR_FLAG;
+    uint64_t offsetUs = (frame.timestampNs - blockBaseNs) / 1000u;
+    r.tsDlc = static_cast<uint32_t>(offsetUs << 4) | (frame.dlc & 0x0F);
+    memcpy(r.data, frame.data, 8);
+    return r;
+}
+
+CanFrame fromRecord(const Record &rec, uint64_t timeNs) {
+    CanFrame f;
+    f.extended = (rec.canId & CAN_EFF_FLAG) != 0;
+    f.remote = (rec.canId & CAN_RTR_FLAG) != 0;
+    f.id = rec.canId & (f.extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+    f.dlc = std::min<uint8_t>(rec.tsDlc & 0x0F, 8);
+    memcpy(f.data, rec.data, 8);
+    f.timestampNs = timeNs;
+    return f;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// Writer
+//───────────────────────────────────────────────────────────────────────────
+Writer::Writer(const std::string &path, size_t bufferRecords) : bufferRecords_(bufferRecords ? bufferRecords : 1) {
+    off_t size = openWithHeader(path, kMagic, fd_);
+    records_ = static_cast<uint64_t>(size - sizeof(FileHeader)) / kRecordSize;
+    try {
+        off_t idxSize = openWithHeader(indexPath(path), kIdxMagic, idxFd_);
+
+        // Entradas que apontam além dos dados (queda antes do flush) sairiam
+        // válidas quando o arquivo crescesse de novo: corta o índice nelas
+        off_t keep = sizeof(FileHeader);
+        IndexEntry e, last = {0, 0};
+        while (keep < idxSize && pread(idxFd_, &e, sizeof(e), keep) == static_cast<ssize_t>(sizeof(e)) &&
+               e.firstRecord < records_) {
+            last = e;
+            keep += sizeof(e);
+        }
+        if (keep != idxSize && ftruncate(idxFd_, keep) < 0) throwErrno(indexPath(path));
+
+        // Continua do último instante gravado (o tempo nunca volta no arquivo)
+        Record r;
+        if (keep > static_cast<off_t>(sizeof(FileHeader)) &&
+            pread(fd_, &r, sizeof(r), sizeof(FileHeader) + (records_ - 1) * kRecordSize) ==
+                static_cast<ssize_t>(sizeof(r))) {
+            lastNs_ = last.baseTimeNs + static_cast<uint64_t>(r.tsDlc >> 4) * 1000u;
+        }
+    } catch (...) {
+        if (idxFd_ >= 0) close(idxFd_);
+        close(fd_);
+        throw;
+    }
+    buffer_.reserve(bufferRecords_);
+}
+
+Writer::~Writer() {
+    try {
+        flush();
+    } catch (...) {
+    }
+    if (idxFd_ >= 0) close(idxFd_);
+    if (fd_ >= 0) close(fd_);
+}
+
+void Writer::startBlock(uint64_t timeNs) {
+    // Dados antes do índice: a entrada nunca aponta para registros que não estão no disco
+    flush();
+    blockBaseNs_ = timeNs;
+    blockFirst_ = records_;
+    haveBlock_ = true;
+    IndexEntry e = {blockBaseNs_, blockFirst_};
+    writeAll(idxFd_, &e, sizeof(e), "índice");
+}
+
+void Writer::append(const CanFrame &frame) {
+    CanFrame f = frame;
+    if (f.timestampNs == 0) f.timestampNs = nowNs();
+    if (f.timestampNs < lastNs_) f.timestampNs = lastNs_;
+    lastNs_ = f.timestampNs;
+
+    if (!haveBlock_ || (f.timestampNs - blockBaseNs_) / 1000u > kMaxOffsetUs ||
+        records_ - blockFirst_ >= kBlockRecords) {
+        startBlock(f.timestampNs);
+    }
+
+    buffer_.push_back(toRecord(f, blockBaseNs_));
+    records_++;
+    if (buffer_.size() >= bufferRecords_) flush();
+}
+
+void Writer::flush() {
+    if (buffer_.empty()) return;
+    writeAll(fd_, buffer_.data(), buffer_.size() * sizeof(Record), "captura");
+    buffer_.clear();
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// Reader
+//───────────────────────────────────────────────────────────────────────────
+Reader::Reader(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throwErrno(path);
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throwErrno(path);
+    }
+    if (st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+        close(fd);
+        errno = EINVAL;
+        throwErrno(path + ": arquivo truncado");
+    }
+    mapSize_ = static_cast<size_t>(st.st_size);
+    map_ = mmap(nullptr, mapSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        throwErrno(path + ": mmap");
+    }
+    madvise(map_, mapSize_, MADV_SEQUENTIAL);
+
+    const FileHeader *h = static_cast<const FileHeader *>(map_);
+    if (memcmp(h->magic, kMagic, 8) != 0 || h->recordSize != kRecordSize) {
+        munmap(map_, mapSize_);
+        map_ = nullptr;
+        errno = EINVAL;
+        throwErrno(path + ": header inválido");
+    }
+    records_ = reinterpret_cast<const Record *>(static_cast<const char *>(map_) + sizeof(FileHeader));
+    count_ = (mapSize_ - sizeof(FileHeader)) / kRecordSize;
+
+    // Índice é opcional: sem ele os timestamps ficam relativos a 0
+    int idx = open(indexPath(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (idx >= 0) {
+        FileHeader ih;
+        if (read(idx, &ih, sizeof(ih)) == static_cast<ssize_t>(sizeof(ih)) && memcmp(ih.magic, kIdxMagic, 8) == 0) {
+            IndexEntry e;
+            while (read(idx, &e, sizeof(e)) == static_cast<ssize_t>(sizeof(e))) {
+                if (e.firstRecord < count_) index_.push_back(e);
+            }
+        }
+        close(idx);
+    }
+}
+
+Reader::~Reader() {
+    if (map_) munmap(map_, mapSize_);
+}
+
+size_t Reader::blockOf(uint64_t i) const {
+    if (index_.empty()) return 0;
+    auto it = std::upper_bound(index_.begin(), index_.end(), i,
+                               [](uint64_t v, const IndexEntry &e) { return v < e.firstRecord; });
+    return it == index_.begin() ? 0 : static_cast<size_t>(it - index_.begin() - 1);
+}
+
+uint64_t Reader::timeNs(uint64_t i) const {
+    return blockBase(blockOf(i)) + static_cast<uint64_t>(records_[i].tsDlc >> 4) * 1000u;
+}
+
+CanFrame Reader::frame(uint64_t i) const {
+    return fromRecord(records_[i], timeNs(i));
+}
+
+uint64_t Reader::seek(uint64_t t) const {
+    if (count_ == 0) return 0;
+    uint64_t lo = 0, hi = count_;
+    if (!index_.empty()) {
+        // Último bloco com base <= t limita a busca
+        auto it = std::upper_bound(index_.begin(), index_.end(), t,
+                                   [](uint64_t v, const IndexEntry &e) { return v < e.baseTimeNs; });
+        if (it != index_.begin()) lo = (it - 1)->firstRecord;
+        if (it != index_.end()) hi = it->firstRecord;
+    }
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (timeNs(mid) < t) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+}  // namespace canlog
@@ -0,0 +1,178 @@
+#include "cantoolkit_c.h"
+
+#include <errno.h>
+
+#include <string>
+#include <system_error>
+
+#include "can_bus.h"
+#include "protocol.h"
+
+struct ctk_bus {
+    CanBus bus;
+    explicit ctk_bus(const char *ifname) : bus(ifname) {}
+};
+
+namespace {
+
+thread_local std::string lastError;
+
+int fail(const std::exception &e) {
+    lastError = e.what();
+    if (auto *se = dynamic_cast<const std::system_error *>(&e)) return -se->code().value();
+    return -EIO;
+}
+
+CanFrame toFrame(const ctk_frame &in) {
+    CanFrame f(in.id, in.data, in.dlc, (in.flags & CTK_FLAG_EXTENDED) != 0);
+    f.remote = (in.flags & CTK_FLAG_REMOTE) != 0;
+    return f;
+}
+
+void fromFrame(const CanFrame &in, ctk_frame &out) {
+    out.id = in.id;
+    out.dlc = in.dlc;
+    out.flags = (in.extended ? CTK_FLAG_EXTENDED : 0) | (in.remote ? CTK_FLAG_REMOTE : 0);
+    memcpy(out.data, in.data, 8);
+    out.timestamp_ns = in.timestampNs;
+}
+
+}  // namespace
+
+extern "C" {
+
+ctk_bus *ctk_open(const char *ifname) {
+    try {
+        return new ctk_bus(ifname);
+    } catch (const std::exception &e) {
+        fail(e);
+        return nullptr;
+    }
+}
+
+void ctk_close(ctk_bus *bus) {
+    delete bus;
+}
+
+int ctk_send(ctk_bus *bus, const ctk_frame *frame) {
+    try {
+        bus->bus.send(toFrame(*frame));
+        return 0;
+    } catch (const std::exception &e) {
+        return fail(e);
+    }
+}
+
+int ctk_send_batch(ctk_bus *bus, const ctk_frame *frames, size_t count) {
+    try {
+        std::vector<CanFrame> batch;
+        batch.reserve(count);
+        for (size_t i = 0; i < count; i++) batch.push_back(toFrame(frames[i]));
+        return static_cast<int>(bus->bus.sendBatch(batch));
+    } catch (const std::exception &e) {
+        return fail(e);
+    }
+}
+
+int ctk_subscribe(ctk_bus *bus, uint32_t id, uint32_t mask, ctk_rx_callback cb, void *user) {
+    try {
+        return bus->bus.subscribe(id, mask, [cb, user](const CanFrame &f) {
+            ctk_frame out;
+            fromFrame(f, out);
+            cb(&out, user);
+        });
+    } catch (const std::exception &e) {
+        return fail(e);
+    }
+}
+
+int ctk_unsubscribe(ctk_bus *bus, int handle) {
+    bus->bus.unsubscribe(handle);
+    return 0;
+}
+
+uint64_t ctk_rx_count(ctk_bus *bus) { return bus->bus.rxCount(); }
+uint64_t ctk_tx_count(ctk_bus *bus) { return bus->bus.txCount(); }
+
+const char *ctk_last_error(void) { return lastError.c_str(); }
+
+void ctk_encode_digital(const int relays[8], int pwm1, int pwm2, int enc, uint8_t out[8]) {
+    proto::DigitalState s;
+    for (int i = 0; i < 8; i++) s.relays[i] = relays[i];
+    s.pwm1 = pwm1;
+    s.pwm2 = pwm2;
+    s.enc = enc;
+    memcpy(out, proto::encodeDigital(s).data, 8);
+}
+
+void ctk_decode_digital(const uint8_t in[8], int relays[8], int *pwm1, int *pwm2, int *enc) {
+    CanFrame f(proto::kDigitalEchoId, in, 8);
+    proto::DigitalState s = proto::decodeDigital(f);
+    for (int i = 0; i < 8; i++) relays[i] = s.relays[i];
+    *pwm1 = s.pwm1;
+    *pwm2 = s.pwm2;
+    *enc = s.enc;
+}
+
+int ctk_read_pwm_enc(const uint8_t in[8], int index) {
+    byte buf[8];
+    memcpy(buf, in, 8);
+    return readPWMEnc(buf, index);
+}
+
+void ctk_encode_safety_pair(int enable1, float max1, int timer1, int enable2, float max2, int timer2, uint8_t out[8]) {
+    safetyConfigStructure a, b;
+    a.Monit_Enable = enable1;
+    a.maxtemp = max1;
+    a.timer = timer1;
+    b.Monit_Enable = enable2;
+    b.maxtemp = max2;
+    b.timer = timer2;
+    sendSafetyPair(a, b, out);
+}
+
+void ctk_decode_safety_pair(const uint8_t in[8], int enable[2], float maxtemp[2], int timer[2]) {
+    CanFrame f(proto::kSafety12EchoId, in, 8);
+    safetyConfigStructure a, b;
+    proto::decodeSafetyPair(f, a, b);
+    enable[0] = a.Monit_Enable;
+    enable[1] = b.Monit_Enable;
+    maxtemp[0] = a.maxtemp;
+    maxtemp[1] = b.maxtemp;
+    timer[0] = a.timer;
+    timer[1] = b.timer;
+}
+
+void ctk_encode_aquisition(int timer, int analog, int continuous, uint8_t out[8]) {
+    aquisitionConfigStructure a;
+    a.timer = timer;
+    a.analog = analog;
+    a.Aquics_Enable_Continuous = continuous;
+    sendAquisitionFrame(a, out);
+}
+
+void ctk_decode_aquisition(const uint8_t in[8], int *timer, int *analog, int *continuous) {
+    aquisitionConfigStructure a = proto::decodeAquisition(CanFrame(proto::kAquisEchoId, in, 8));
+    *timer = a.timer;
+    *analog = a.analog;
+    *continuous = a.Aquics_Enable_Continuous;
+}
+
+void ctk_encode_start_stop(int enable, uint8_t out[8]) {
+    sendStartStop(enable ? 1 : 0, out);
+}
+
+void ctk_decode_temperature(const uint8_t in[8], ctk_temp *out) {
+    tempReadStructure t = proto::decodeTemperature(CanFrame(proto::kTemp1Id, in, 8));
+    out->cj_temp = t.CJtemp;
+    out->status[0] = t.TLstatus;
+    out->status[1] = t.TRstatus;
+    out->status[2] = t.BLstatus;
+    out->status[3] = t.BRstatus;
+    out->temp[0] = t.TLtemp;
+    out->temp[1] = t.TRtemp;
+    out->temp[2] = t.BLtemp;
+    out->temp[3] = t.BRtemp;
+}
+
+}  // extern "C"
@@ -0,0 +1,138 @@
+#include "dbc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <stdexcept>
+
+namespace dbc {
+
+namespace {
+
+[[noreturn]] void syntaxError(const std::string &path, int line, const std::string &what) {
+    throw std::runtime_error(path + ":" + std::to_string(line) + ": " + what);
+}
+
+const char *skipSpaces(const char *p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+// Lê um identificador (nome de mensagem/sinal) e avança p
+std::string readWord(const char *&p) {
+    p = skipSpaces(p);
+    const char *s = p;
+    while (*p && *p != ' ' && *p != '\t' && *p != ':') p++;
+    return std::string(s, p);
+}
+
+}  // namespace
+
+void Signal::finalize() {
+    mask = length >= 64 ? ~0ull : ((1ull << length) - 1);
+    if (littleEndian) {
+        shift = startBit;
+    } else {
+        // Motorola: startBit aponta o MSB na numeração "dente de serra" do DBC.
+        // No payload big-endian (byte 0 nos bits 63..56) o MSB fica em:
+        uint32_t msb = (7 - startBit / 8) * 8 + (startBit % 8);
+        shift = msb + 1 - length;
+    }
+}
+
+int64_t Signal::raw(uint64_t payloadLE, uint64_t payloadBE) const {
+    uint64_t v = ((littleEndian ? payloadLE : payloadBE) >> shift) & mask;
+    if (isSigned && length < 64 && (v >> (length - 1)) & 1) v |= ~mask;
+    return static_cast<int64_t>(v);
+}
+
+void Database::load(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("não foi possível abrir " + path);
+
+    std::string line;
+    int lineNo = 0;
+    Message *current = nullptr;
+    bool skipCurrent = false;
+
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        const char *p = skipSpaces(line.c_str());
+
+        if (strncmp(p, "BO_ ", 4) == 0) {
+            // BO_ 1296 CANTemp1TC: 8 Vector__XXX
+            char *end;
+            unsigned long rawId = strtoul(p + 4, &end, 10);
+            if (end == p + 4) syntaxError(path, lineNo, "ID de mensagem inválido");
+            p = end;
+            Message msg;
+            msg.extended = (rawId & 0x80000000ul) != 0;
+            msg.id = static_cast<uint32_t>(rawId & 0x1FFFFFFFul);
+            msg.name = readWord(p);
+            p = skipSpaces(p);
+            if (*p != ':') syntaxError(path, lineNo, "':' esperado após o nome da mensagem");
+            msg.dlc = static_cast<uint8_t>(strtoul(p + 1, nullptr, 10));
+
+            // VECTOR__INDEPENDENT_SIG_MSG agrupa sinais sem mensagem: descartado
+            skipCurrent = byId_.count(key(msg.id, msg.extended)) != 0 || msg.name == "VECTOR__INDEPENDENT_SIG_MSG";
+            if (skipCurrent) {
+                current = nullptr;
+                continue;
+            }
+            byId_[key(msg.id, msg.extended)] = messages_.size();
+            messages_.push_back(std::move(msg));
+            current = &messages_.back();
+        } else if (strncmp(p, "SG_ ", 4) == 0) {
+            if (skipCurrent) continue;
+            if (!current) syntaxError(path, lineNo, "SG_ fora de uma mensagem");
+
+            // SG_ TLTemp : 10|12@1+ (1,-2048) [-210|1800] "degC" Vector__XXX
+            p += 4;
+            Signal sig;
+            sig.name = readWord(p);
+            p = skipSpaces(p);
+            if (*p != ':') readWord(p);  // indicador de multiplexação (M / mN)
+            p = strchr(p, ':');
+            if (!p) syntaxError(path, lineNo, "':' esperado no sinal " + sig.name);
+
+            unsigned start, len;
+            char order, sign;
+            double factor, offset, minimum, maximum;
+            int n = sscanf(p + 1, " %u|%u@%c%c (%lf,%lf) [%lf|%lf]", &start, &len, &order, &sign, &factor,
+                           &offset, &minimum, &maximum);
+            if (n != 8 || len == 0 || len > 64 || (order != '0' && order != '1'))
+                syntaxError(path, lineNo, "formato inválido no sinal " + sig.name);
+            sig.startBit = start;
+            sig.length = len;
+            sig.littleEndian = order == '1';
+            sig.isSigned = sign == '-';
+            sig.factor = factor;
+            sig.offset = offset;
+            sig.minimum = minimum;
+            sig.maximum = maximum;
+
+            const char *q = strchr(p, '"');
+            if (q) {
+                const char *e = strchr(q + 1, '"');
+                if (e) sig.unit.assign(q + 1, e);
+            }
+            sig.finalize();
+            current->signals.push_back(std::move(sig));
+        } else if (*p == '\0' || strncmp(p, "BO_TX_BU_", 9) == 0) {
+            // Linha em branco encerra o bloco da mensagem
+            if (*p == '\0') current = nullptr;
+        } else {
+            current = nullptr;
+        }
+    }
+}
+
+const Message *Database::find(uint32_t id, bool extended) const {
+    auto it = byId_.find(key(id, extended));
+    return it == byId_.end() ? nullptr : &messages_[it->second];
+}
+
+}  // namespace dbc
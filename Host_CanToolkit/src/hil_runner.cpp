@@ -0,0 +1,472 @@
+#include "hil_runner.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace hil {
+
+const std::vector<double> kHistogramEdgesUs = {100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000,
+                                               200000, 500000, 1000000};
+
+namespace {
+
+uint64_t clockNs(clockid_t clk) {
+    struct timespec ts;
+    clock_gettime(clk, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+// Dorme até `deadline` (CLOCK_MONOTONIC) e faz espera ativa nos últimos spinNs
+void waitUntil(uint64_t deadline, uint64_t spinNs) {
+    if (deadline > spinNs) {
+        uint64_t wake = deadline - spinNs;
+        struct timespec ts = {static_cast<time_t>(wake / 1000000000ull), static_cast<long>(wake % 1000000000ull)};
+        if (clockNs(CLOCK_MONOTONIC) < wake) {
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+            }
+        }
+    }
+    while (clockNs(CLOCK_MONOTONIC) < deadline) {
+    }
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// Lê pares hexadecimais; retorna o número de bytes ou -1
+int parseHexBytes(const std::string &s, uint8_t *out) {
+    if (s.size() % 2 != 0 || s.size() > 16) return -1;
+    for (size_t i = 0; i < s.size(); i += 2) {
+        int hi = hexValue(s[i]), lo = hexValue(s[i + 1]);
+        if (hi < 0 || lo < 0) return -1;
+        out[i / 2] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return static_cast<int>(s.size() / 2);
+}
+
+bool parseId(const std::string &s, uint32_t &id, bool &extended) {
+    if (s.empty() || s.size() > 8) return false;
+    char *end;
+    unsigned long v = strtoul(s.c_str(), &end, 16);
+    if (*end) return false;
+    extended = s.size() > 3;
+    id = static_cast<uint32_t>(v);
+    return true;
+}
+
+bool parseUs(const std::string &s, uint64_t &v) {
+    if (s.empty()) return false;
+    char *end;
+    v = strtoull(s.c_str(), &end, 10);
+    return *end == '\0';
+}
+
+double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) return 0;
+    double pos = p * (sorted.size() - 1);
+    size_t i = static_cast<size_t>(pos);
+    if (i + 1 >= sorted.size()) return sorted.back();
+    return sorted[i] + (pos - i) * (sorted[i + 1] - sorted[i]);
+}
+
+}  // namespace
+
+//───────────────────────────────────────────────────────────────────────────
+// Frames e padrões
+//───────────────────────────────────────────────────────────────────────────
+bool FramePattern::matches(const CanFrame &frame) const {
+    if (frame.id != id || frame.extended != extended || frame.remote) return false;
+    for (int i = 0; i < 8; i++) {
+        if ((frame.data[i] & mask[i]) != (data[i] & mask[i])) return false;
+    }
+    return true;
+}
+
+bool parseFrame(const std::string &text, CanFrame &frame) {
+    size_t hash = text.find('#');
+    if (hash == std::string::npos) return false;
+    frame = CanFrame();
+    if (!parseId(text.substr(0, hash), frame.id, frame.extended)) return false;
+    std::string data = text.substr(hash + 1);
+    if (data == "R" || data == "r") {
+        frame.remote = true;
+        return true;
+    }
+    int n = parseHexBytes(data, frame.data);
+    if (n < 0) return false;
+    frame.dlc = static_cast<uint8_t>(n);
+    return true;
+}
+
+bool parsePattern(const std::string &text, FramePattern &pattern) {
+    pattern = FramePattern();
+    size_t hash = text.find('#');
+    if (!parseId(text.substr(0, hash), pattern.id, pattern.extended)) return false;
+    if (hash == std::string::npos) return true;
+
+    std::string rest = text.substr(hash + 1);
+    size_t slash = rest.find('/');
+    int n = parseHexBytes(rest.substr(0, slash), pattern.data);
+    if (n < 0) return false;
+    if (slash == std::string::npos) {
+        memset(pattern.mask, 0xFF, static_cast<size_t>(n));
+    } else if (parseHexBytes(rest.substr(slash + 1), pattern.mask) < 0) {
+        return false;
+    }
+    return true;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// Arquivo .vec
+//───────────────────────────────────────────────────────────────────────────
+Suite parseSuite(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("não foi possível abrir " + path);
+
+    Suite suite;
+    TestVector *vec = nullptr;
+    std::string line;
+    int lineNo = 0;
+
+    auto fail = [&](const std::string &what) -> void {
+        throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": " + what);
+    };
+
+    while (std::getline(in, line)) {
+        lineNo++;
+        size_t hashComment = line.find(" #");
+        if (!line.empty() && line[0] == '#') continue;
+        if (hashComment != std::string::npos) line.erase(hashComment);
+
+        std::istringstream ss(line);
+        std::vector<std::string> tok;
+        for (std::string t; ss >> t;) tok.push_back(t);
+        if (tok.empty()) continue;
+
+        const std::string &cmd = tok[0];
+        if (cmd == "vector") {
+            if (vec) fail("'end' esperado antes de um novo vetor");
+            if (tok.size() != 2) fail("uso: vector <nome>");
+            suite.vectors.emplace_back();
+            vec = &suite.vectors.back();
+            vec->name = tok[1];
+        } else if (cmd == "end") {
+            if (!vec) fail("'end' sem 'vector'");
+            if (vec->sends.empty()) fail("vetor sem 'send'");
+            vec = nullptr;
+        } else if (cmd == "repeat") {
+            uint64_t n;
+            if (tok.size() != 2 || !parseUs(tok[1], n) || n == 0) fail("uso: repeat <n>");
+            if (vec) vec->repeat = static_cast<unsigned>(n);
+            else suite.repeat = static_cast<unsigned>(n);
+        } else if (cmd == "gap") {
+            if (vec || tok.size() != 2 || !parseUs(tok[1], suite.gapUs)) fail("uso: gap <us> (fora dos vetores)");
+        } else if (cmd == "duration") {
+            if (!vec || tok.size() != 2 || !parseUs(tok[1], vec->durationUs)) fail("uso: duration <us>");
+        } else if (cmd == "send") {
+            if (!vec) fail("'send' fora de um vetor");
+            SendStep step;
+            if (tok.size() < 3 || !parseUs(tok[1], step.atUs) || !parseFrame(tok[2], step.frame))
+                fail("uso: send <t_us> <ID>#<dados> [every <us> x <n>] [as <rótulo>]");
+            for (size_t i = 3; i < tok.size(); i++) {
+                if (tok[i] == "every" && i + 3 < tok.size() && tok[i + 2] == "x") {
+                    uint64_t n;
+                    if (!parseUs(tok[i + 1], step.periodUs) || !parseUs(tok[i + 3], n) || n == 0)
+                        fail("uso: every <período_us> x <n>");
+                    step.count = static_cast<uint32_t>(n);
+                    i += 3;
+                } else if (tok[i] == "as" && i + 1 < tok.size()) {
+                    step.label = tok[++i];
+                } else {
+                    fail("argumento inesperado: " + tok[i]);
+                }
+            }
+            vec->sends.push_back(step);
+        } else if (cmd == "expect") {
+            if (!vec) fail("'expect' fora de um vetor");
+            ExpectStep step;
+            step.text = line.substr(line.find("expect"));
+            if (tok.size() < 6 || !parsePattern(tok[1], step.pattern) || tok[2] != "after" || tok[4] != "within")
+                fail("uso: expect <padrão> after <rótulo> within [<min>..]<max> [as <rótulo>]");
+            step.after = tok[3];
+            size_t dots = tok[5].find("..");
+            if (dots == std::string::npos) {
+                if (!parseUs(tok[5], step.maxUs)) fail("janela inválida");
+            } else if (!parseUs(tok[5].substr(0, dots), step.minUs) || !parseUs(tok[5].substr(dots + 2), step.maxUs)) {
+                fail("janela inválida");
+            }
+            if (tok.size() == 8 && tok[6] == "as") step.label = tok[7];
+            else if (tok.size() != 6) fail("argumento inesperado após a janela");
+
+            // A referência precisa existir antes (send ou expect anterior)
+            bool known = step.after == "start";
+            for (const auto &s : vec->sends) known = known || s.label == step.after;
+            for (const auto &e : vec->expects) known = known || e.label == step.after;
+            if (!known) fail("rótulo desconhecido: " + step.after);
+            if (step.label.empty()) step.label = "expect" + std::to_string(vec->expects.size() + 1);
+            vec->expects.push_back(step);
+        } else {
+            fail("comando desconhecido: " + cmd);
+        }
+    }
+    if (vec) throw std::runtime_error(path + ": vetor '" + vec->name + "' sem 'end'");
+    return suite;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// Execução
+//───────────────────────────────────────────────────────────────────────────
+Runner::Runner(CanBus &bus, const RunnerOptions &options) : bus_(bus), options_(options) {
+    if (options_.realtime) {
+        struct sched_param sp;
+        sp.sched_priority = 50;
+        if (sched_setscheduler(0, SCHED_FIFO, &sp) < 0 || mlockall(MCL_CURRENT | MCL_FUTURE) < 0)
+            fprintf(stderr, "aviso: prioridade de tempo real indisponível (%s)\n", strerror(errno));
+    }
+    bus_.setReceiveOwn(true);
+    subscription_ = bus_.subscribe(0, 0, [this](const CanFrame &f) {
+        std::lock_guard<std::mutex> lock(logMutex_);
+        if (recording_) log_.push_back(f);
+    });
+}
+
+Runner::~Runner() {
+    bus_.unsubscribe(subscription_);
+}
+
+std::vector<ExpectResult> Runner::run(const Suite &suite) {
+    std::vector<ExpectResult> results;
+    for (const auto &vec : suite.vectors) {
+        size_t first = results.size();
+        for (const auto &e : vec.expects) {
+            ExpectResult r;
+            r.key = vec.name + "/" + e.label;
+            r.minUs = e.minUs;
+            r.maxUs = e.maxUs;
+            results.push_back(r);
+        }
+        unsigned reps = vec.repeat ? vec.repeat : suite.repeat;
+        for (unsigned rep = 0; rep < reps; rep++) {
+            runOnce(vec, results, first);
+            waitUntil(clockNs(CLOCK_MONOTONIC) + suite.gapUs * 1000u, 0);
+        }
+    }
+    return results;
+}
+
+void Runner::runOnce(const TestVector &vec, std::vector<ExpectResult> &results, size_t first) {
+    struct Event {
+        uint64_t atUs;
+        size_t step;
+        const CanFrame *frame;
+    };
+    std::vector<Event> events;
+    uint64_t lastUs = 0;
+    for (size_t s = 0; s < vec.sends.size(); s++) {
+        const SendStep &st = vec.sends[s];
+        for (uint32_t k = 0; k < st.count; k++) {
+            events.push_back({st.atUs + k * st.periodUs, s, &st.frame});
+            lastUs = std::max(lastUs, events.back().atUs);
+        }
+    }
+    std::stable_sort(events.begin(), events.end(), [](const Event &a, const Event &b) { return a.atUs < b.atUs; });
+
+    uint64_t windowUs = 0;
+    for (const auto &e : vec.expects) windowUs = std::max(windowUs, e.maxUs);
+    uint64_t durationUs = vec.durationUs ? vec.durationUs : lastUs + windowUs + 1000;
+
+    {
+        std::lock_guard<std::mutex> lock(logMutex_);
+        log_.clear();
+        recording_ = true;
+    }
+
+    // Envio agendado: eventos com o mesmo instante saem num único sendmmsg
+    const uint64_t spinNs = options_.spinUs * 1000u;
+    const uint64_t t0 = clockNs(CLOCK_MONOTONIC) + 1000000;
+    const uint64_t startRealNs = clockNs(CLOCK_REALTIME) + 1000000;
+    std::vector<uint64_t> sentRealNs(events.size());
+    std::vector<CanFrame> batch;
+    for (size_t i = 0; i < events.size();) {
+        size_t j = i;
+        batch.clear();
+        while (j < events.size() && events[j].atUs == events[i].atUs) batch.push_back(*events[j++].frame);
+        waitUntil(t0 + events[i].atUs * 1000u, spinNs);
+        uint64_t now = clockNs(CLOCK_REALTIME);
+        bus_.sendBatch(batch);
+        for (size_t k = i; k < j; k++) sentRealNs[k] = now;
+        i = j;
+    }
+    waitUntil(t0 + durationUs * 1000u, 0);
+
+    std::vector<CanFrame> log;
+    {
+        std::lock_guard<std::mutex> lock(logMutex_);
+        recording_ = false;
+        log.swap(log_);
+    }
+
+    // Instante real de TX de cada evento: eco do kernel, na mesma ordem do envio
+    std::vector<uint64_t> txNs(events.size());
+    size_t cursor = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+        txNs[i] = sentRealNs[i];
+        const CanFrame &f = *events[i].frame;
+        for (size_t k = cursor; k < log.size(); k++) {
+            const CanFrame &r = log[k];
+            if (r.echo && r.id == f.id && r.remote == f.remote && r.dlc == f.dlc && memcmp(r.data, f.data, f.dlc) == 0) {
+                if (r.timestampNs) txNs[i] = r.timestampNs;
+                cursor = k + 1;
+                break;
+            }
+        }
+    }
+
+    // Referências: rótulo → instante (ns, CLOCK_REALTIME)
+    std::map<std::string, uint64_t> refs;
+    refs["start"] = startRealNs;
+    for (size_t i = events.size(); i-- > 0;) {
+        const std::string &label = vec.sends[events[i].step].label;
+        if (!label.empty()) refs[label] = txNs[i];  // Percorre de trás: fica o primeiro envio
+    }
+
+    for (size_t e = 0; e < vec.expects.size(); e++) {
+        const ExpectStep &ex = vec.expects[e];
+        ExpectResult &res = results[first + e];
+        res.runs++;
+
+        auto ref = refs.find(ex.after);
+        const CanFrame *match = nullptr;
+        if (ref != refs.end()) {
+            for (const CanFrame &r : log) {
+                if (!r.echo && r.timestampNs >= ref->second && ex.pattern.matches(r)) {
+                    match = &r;
+                    break;
+                }
+            }
+        }
+        if (!match) {
+            res.missing++;
+            if (options_.verbose) fprintf(stderr, "  %s: sem resposta (%s)\n", res.key.c_str(), ex.text.c_str());
+            continue;
+        }
+        double latUs = (match->timestampNs - ref->second) / 1000.0;
+        res.latenciesUs.push_back(latUs);
+        refs[ex.label] = match->timestampNs;
+        if (latUs < ex.minUs || latUs > ex.maxUs) {
+            res.outOfBounds++;
+            if (options_.verbose)
+                fprintf(stderr, "  %s: %.0f µs fora de [%llu, %llu]\n", res.key.c_str(), latUs,
+                        static_cast<unsigned long long>(ex.minUs), static_cast<unsigned long long>(ex.maxUs));
+        }
+    }
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// Relatório
+//───────────────────────────────────────────────────────────────────────────
+LatencyStats summarize(const ExpectResult &result) {
+    LatencyStats st;
+    st.n = result.runs;
+    st.failures = result.missing + result.outOfBounds;
+    st.histogram.assign(kHistogramEdgesUs.size() + 1, 0);
+
+    std::vector<double> v = result.latenciesUs;
+    if (v.empty()) return st;
+    std::sort(v.begin(), v.end());
+    st.minUs = v.front();
+    st.maxUs = v.back();
+    st.p50Us = percentile(v, 0.50);
+    st.p90Us = percentile(v, 0.90);
+    st.p99Us = percentile(v, 0.99);
+    st.meanUs = std::accumulate(v.begin(), v.end(), 0.0) / v.size();
+    for (double x : v) {
+        size_t b = std::upper_bound(kHistogramEdgesUs.begin(), kHistogramEdgesUs.end(), x) - kHistogramEdgesUs.begin();
+        st.histogram[b]++;
+    }
+    return st;
+}
+
+void writeReport(const std::string &path, const std::string &firmware, const std::vector<ExpectResult> &results) {
+    FILE *f = fopen(path.c_str(), "w");
+    if (!f) throw std::runtime_error("não foi possível criar " + path);
+
+    time_t now = time(nullptr);
+    char date[32];
+    strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    fprintf(f, "# firmware=%s data=%s\n", firmware.empty() ? "?" : firmware.c_str(), date);
+    fprintf(f, "# histograma (µs): faixas [0, %.0f)", kHistogramEdgesUs.front());
+    for (size_t b = 1; b < kHistogramEdgesUs.size(); b++)
+        fprintf(f, " [%.0f, %.0f)", kHistogramEdgesUs[b - 1], kHistogramEdgesUs[b]);
+    fprintf(f, " [%.0f, ...)\n", kHistogramEdgesUs.back());
+    fprintf(f, "chave,n,falhas,min_us,p50_us,p90_us,p99_us,max_us,media_us,histograma\n");
+    for (const auto &r : results) {
+        LatencyStats s = summarize(r);
+        fprintf(f, "%s,%u,%u,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,", r.key.c_str(), s.n, s.failures, s.minUs, s.p50Us, s.p90Us,
+                s.p99Us, s.maxUs, s.meanUs);
+        for (size_t b = 0; b < s.histogram.size(); b++) fprintf(f, b ? ";%u" : "%u", s.histogram[b]);
+        fprintf(f, "\n");
+    }
+    if (fclose(f) != 0) throw std::runtime_error("erro ao gravar " + path);
+}
+
+std::map<std::string, LatencyStats> readReport(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("não foi possível abrir " + path);
+    std::map<std::string, LatencyStats> out;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#' || line.compare(0, 6, "chave,") == 0) continue;
+        std::vector<std::string> cols;
+        std::istringstream ss(line);
+        for (std::string c; std::getline(ss, c, ',');) cols.push_back(c);
+        if (cols.size() < 9) continue;
+        LatencyStats s;
+        s.n = static_cast<unsigned>(atoi(cols[1].c_str()));
+        s.failures = static_cast<unsigned>(atoi(cols[2].c_str()));
+        s.minUs = atof(cols[3].c_str());
+        s.p50Us = atof(cols[4].c_str());
+        s.p90Us = atof(cols[5].c_str());
+        s.p99Us = atof(cols[6].c_str());
+        s.maxUs = atof(cols[7].c_str());
+        s.meanUs = atof(cols[8].c_str());
+        out[cols[0]] = s;
+    }
+    return out;
+}
+
+std::string firmwareVersion(const std::string &firmwareDir) {
+    std::ifstream in(firmwareDir + "/version.json");
+    if (!in) return "";
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string json = ss.str();
+
+    auto field = [&](const char *name) -> long {
+        size_t p = json.find(std::string("\"") + name + "\"");
+        if (p == std::string::npos) return -1;
+        p = json.find(':', p);
+        return p == std::string::npos ? -1 : strtol(json.c_str() + p + 1, nullptr, 10);
+    };
+    long major = field("major"), minor = field("minor"), patch = field("patch");
+    if (major < 0 || minor < 0 || patch < 0) return "";
+    return "v" + std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(patch);
+}
+
+}  // namespace hil
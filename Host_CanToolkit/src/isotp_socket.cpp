@@ -0,0 +1,115 @@
+#include "isotp_socket.h"
+
+#include <errno.h>
+#include <net/if.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <linux/can.h>
+#include <linux/can/isotp.h>
+
+#include <system_error>
+
+namespace {
+
+constexpr size_t kMaxMessage = 4095;   // FF com tamanho de 12 bits
+
+[[noreturn]] void throwErrno(const char *what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+}  // namespace
+
+IsoTpSocket::IsoTpSocket(const std::string &ifname, uint32_t txId, uint32_t rxId, const IsoTpOptions &options) {
+    fd_ = socket(PF_CAN, SOCK_DGRAM | SOCK_CLOEXEC, CAN_ISOTP);
+    if (fd_ < 0) throwErrno("socket(CAN_ISOTP) (modulo can-isotp carregado?)");
+
+    struct can_isotp_options opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.flags = options.padding ? CAN_ISOTP_TX_PADDING : 0;
+    if (options.forceTxStMinNs) opts.flags |= CAN_ISOTP_FORCE_TXSTMIN;
+    opts.txpad_content = CAN_ISOTP_DEFAULT_PAD_CONTENT;
+    opts.rxpad_content = CAN_ISOTP_DEFAULT_PAD_CONTENT;
+    opts.frame_txtime = CAN_ISOTP_DEFAULT_FRAME_TXTIME;
+
+    struct can_isotp_fc_options fc;
+    memset(&fc, 0, sizeof(fc));
+    fc.bs = options.blockSize;
+    fc.stmin = options.stMin;
+
+    uint32_t txStMin = options.forceTxStMinNs;
+    if (setsockopt(fd_, SOL_CAN_ISOTP, CAN_ISOTP_OPTS, &opts, sizeof(opts)) < 0 ||
+        setsockopt(fd_, SOL_CAN_ISOTP, CAN_ISOTP_RECV_FC, &fc, sizeof(fc)) < 0 ||
+        (txStMin && setsockopt(fd_, SOL_CAN_ISOTP, CAN_ISOTP_TX_STMIN, &txStMin, sizeof(txStMin)) < 0)) {
+        int err = errno;
+        close(fd_);
+        errno = err;
+        throwErrno("setsockopt(SOL_CAN_ISOTP)");
+    }
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname.c_str(), IFNAMSIZ - 1);
+    if (ioctl(fd_, SIOCGIFINDEX, &ifr) < 0) {
+        int err = errno;
+        close(fd_);
+        errno = err;
+        throwErrno(("interface " + ifname).c_str());
+    }
+
+    struct sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    addr.can_addr.tp.tx_id = txId & CAN_SFF_MASK;
+    addr.can_addr.tp.rx_id = rxId & CAN_SFF_MASK;
+    if (bind(fd_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        int err = errno;
+        close(fd_);
+        errno = err;
+        throwErrno("bind(isotp)");
+    }
+}
+
+IsoTpSocket::~IsoTpSocket() {
+    if (fd_ >= 0) close(fd_);
+}
+
+void IsoTpSocket::send(const std::vector<uint8_t> &message) {
+    if (message.empty() || message.size() > kMaxMessage) {
+        throw std::system_error(EMSGSIZE, std::generic_category(), "isotp: 1-4095 bytes");
+    }
+    ssize_t n;
+    do {
+        n = write(fd_, message.data(), message.size());
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) throwErrno("write(isotp)");
+}
+
+bool IsoTpSocket::receive(std::vector<uint8_t> &message, int timeoutMs) {
+    struct pollfd pfd = {fd_, POLLIN, 0};
+    int r;
+    do {
+        r = poll(&pfd, 1, timeoutMs);
+    } while (r < 0 && errno == EINTR);
+    if (r < 0) throwErrno("poll(isotp)");
+    if (r == 0) return false;
+
+    message.resize(kMaxMessage);
+    ssize_t n = read(fd_, message.data(), message.size());
+    if (n < 0) {
+        // Timeout/sequência errada na recepção aparecem aqui (ECOMM, EILSEQ...)
+        message.clear();
+        throwErrno("read(isotp)");
+    }
+    message.resize(static_cast<size_t>(n));
+    return true;
+}
+
+bool IsoTpSocket::request(const std::vector<uint8_t> &message, std::vector<uint8_t> &response, int timeoutMs) {
+    send(message);
+    return receive(response, timeoutMs);
+}
@@ -0,0 +1,187 @@
+#include "metrics.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace metrics {
+
+const std::vector<double> kLatencyEdges = {0.00005, 0.0001, 0.0002, 0.0005, 0.001, 0.002, 0.005,
+                                           0.01,    0.02,   0.05,   0.1,    0.2,   0.5,   1.0};
+
+namespace {
+
+uint64_t toBits(double v) {
+    uint64_t b;
+    memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+double fromBits(uint64_t b) {
+    double v;
+    memcpy(&v, &b, sizeof(v));
+    return v;
+}
+
+void addDouble(std::atomic<uint64_t> &bits, double v) {
+    uint64_t old = bits.load(std::memory_order_relaxed);
+    while (!bits.compare_exchange_weak(old, toBits(fromBits(old) + v), std::memory_order_relaxed)) {
+    }
+}
+
+std::string number(double v) {
+    if (std::isnan(v)) return "NaN";
+    if (std::isinf(v)) return v > 0 ? "+Inf" : "-Inf";
+    // Curto quando volta igual (le="0.1" e não 0.10000000000000001)
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.15g", v);
+    if (strtod(buf, nullptr) != v) snprintf(buf, sizeof(buf), "%.17g", v);
+    return buf;
+}
+
+void sample(std::string &out, const std::string &name, const std::string &labels, const std::string &value) {
+    out += name;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+}  // namespace
+
+std::string label(const std::string &key, const std::string &value) {
+    std::string out = key + "=\"";
+    for (char c : value) {
+        if (c == '\\' || c == '"') out += '\\';
+        if (c == '\n') {
+            out += "\\n";
+            continue;
+        }
+        out += c;
+    }
+    out += '"';
+    return out;
+}
+
+std::string labels(std::initializer_list<std::string> parts) {
+    std::string out;
+    for (const auto &p : parts) {
+        if (p.empty()) continue;
+        if (!out.empty()) out += ',';
+        out += p;
+    }
+    return out;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// TIPOS
+//───────────────────────────────────────────────────────────────────────────
+void Counter::render(std::string &out) const {
+    sample(out, name(), labels(), std::to_string(value()));
+}
+
+void Gauge::set(double v) {
+    bits_.store(toBits(v), std::memory_order_relaxed);
+}
+
+void Gauge::add(double v) {
+    addDouble(bits_, v);
+}
+
+double Gauge::value() const {
+    return fromBits(bits_.load(std::memory_order_relaxed));
+}
+
+void Gauge::render(std::string &out) const {
+    sample(out, name(), labels(), number(value()));
+}
+
+Histogram::Histogram(const std::string &name, const std::string &help, const std::string &labels,
+                     const std::vector<double> &edges)
+    : Metric(TypeHistogram, name, help, labels), edges_(edges), buckets_(new std::atomic<uint64_t>[edges.size() + 1]) {
+    std::sort(edges_.begin(), edges_.end());
+    for (size_t i = 0; i <= edges_.size(); i++) buckets_[i].store(0, std::memory_order_relaxed);
+}
+
+void Histogram::observe(double v) {
+    size_t i = std::lower_bound(edges_.begin(), edges_.end(), v) - edges_.begin();
+    buckets_[i].fetch_add(1, std::memory_order_relaxed);
+    addDouble(sumBits_, v);
+}
+
+void Histogram::render(std::string &out) const {
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i <= edges_.size(); i++) {
+        cumulative += buckets_[i].load(std::memory_order_relaxed);
+        std::string le = label("le", i < edges_.size() ? number(edges_[i]) : "+Inf");
+        sample(out, name() + "_bucket", metrics::labels({labels(), le}), std::to_string(cumulative));
+    }
+    sample(out, name() + "_sum", labels(), number(fromBits(sumBits_.load(std::memory_order_relaxed))));
+    sample(out, name() + "_count", labels(), std::to_string(cumulative));
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// REGISTRO
+//───────────────────────────────────────────────────────────────────────────
+Registry::~Registry() {
+    Metric *m = head_.load(std::memory_order_acquire);
+    while (m) {
+        Metric *next = m->next_;
+        delete m;
+        m = next;
+    }
+}
+
+template <class T>
+T &Registry::add(T *metric) {
+    Metric *old = head_.load(std::memory_order_relaxed);
+    do {
+        metric->next_ = old;
+    } while (!head_.compare_exchange_weak(old, metric, std::memory_order_release, std::memory_order_relaxed));
+    return *metric;
+}
+
+Counter &Registry::counter(const std::string &name, const std::string &help, const std::string &labels) {
+    return add(new Counter(TypeCounter, name, help, labels));
+}
+
+Gauge &Registry::gauge(const std::string &name, const std::string &help, const std::string &labels) {
+    return add(new Gauge(TypeGauge, name, help, labels));
+}
+
+Histogram &Registry::histogram(const std::string &name, const std::string &help, const std::string &labels,
+                               const std::vector<double> &edges) {
+    return add(new Histogram(name, help, labels, edges));
+}
+
+std::string Registry::render() const {
+    // A lista está do mais novo para o mais velho
+    std::vector<const Metric *> all;
+    for (const Metric *m = head_.load(std::memory_order_acquire); m; m = m->next_) all.push_back(m);
+    std::reverse(all.begin(), all.end());
+
+    static const char *const kTypes[] = {"counter", "gauge", "histogram"};
+    std::string out;
+    std::vector<bool> done(all.size(), false);
+    for (size_t i = 0; i < all.size(); i++) {
+        if (done[i]) continue;
+        const Metric &first = *all[i];
+        out += "# HELP " + first.name() + ' ' + first.help() + '\n';
+        out += "# TYPE " + first.name() + ' ' + kTypes[first.type()] + '\n';
+        for (size_t j = i; j < all.size(); j++) {
+            if (done[j] || all[j]->name() != first.name()) continue;
+            all[j]->render(out);
+            done[j] = true;
+        }
+    }
+    return out;
+}
+
+}  // namespace metrics
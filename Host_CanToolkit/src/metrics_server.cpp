@@ -0,0 +1,193 @@
+#include "metrics_server.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <system_error>
+
+namespace metrics {
+
+namespace {
+
+const size_t kMaxRequest = 4096;
+const int kClientTimeoutMs = 1000;
+
+[[noreturn]] void throwErrno(const std::string &what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+int bound(int fd, const struct sockaddr *addr, socklen_t len, const std::string &what) {
+    if (bind(fd, addr, len) < 0 || ::listen(fd, 16) < 0) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        throwErrno(what);
+    }
+    return fd;
+}
+
+bool sendAll(int fd, const std::string &data) {
+    size_t off = 0;
+    while (off < data.size()) {
+        ssize_t n = send(fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        off += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void respond(int fd, int code, const char *reason, const char *type, const std::string &body, bool head) {
+    std::string out = "HTTP/1.0 " + std::to_string(code) + " " + reason + "\r\nContent-Type: " + type +
+                      "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+    if (!head) out += body;
+    sendAll(fd, out);
+}
+
+}  // namespace
+
+Server::Server(const Registry &registry) : registry_(registry) {}
+
+Server::~Server() {
+    stop();
+    for (int fd : listeners_) close(fd);
+    for (const auto &path : unixPaths_) unlink(path.c_str());
+}
+
+void Server::listen(const std::string &address) {
+    if (address.compare(0, 5, "unix:") == 0) {
+        std::string path = address.substr(5);
+        struct sockaddr_un sa;
+        memset(&sa, 0, sizeof(sa));
+        if (path.empty() || path.size() >= sizeof(sa.sun_path))
+            throw std::invalid_argument("caminho de socket inválido: " + path);
+        sa.sun_family = AF_UNIX;
+        memcpy(sa.sun_path, path.c_str(), path.size());
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (fd < 0) throwErrno("socket(AF_UNIX)");
+        unlink(path.c_str());   // Socket de uma execução anterior
+        listeners_.push_back(bound(fd, reinterpret_cast<struct sockaddr *>(&sa), sizeof(sa), path));
+        unixPaths_.push_back(path);
+        return;
+    }
+
+    size_t colon = address.rfind(':');
+    char *end = nullptr;
+    unsigned long port = colon == std::string::npos ? 0 : strtoul(address.c_str() + colon + 1, &end, 10);
+    if (colon == std::string::npos || !end || *end || !port || port > 65535)
+        throw std::invalid_argument("endereço inválido (host:porta ou unix:caminho): " + address);
+    std::string host = address.substr(0, colon);
+
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(static_cast<uint16_t>(port));
+    sa.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (!host.empty() && inet_pton(AF_INET, host.c_str(), &sa.sin_addr) != 1)
+        throw std::invalid_argument("endereço IPv4 inválido: " + host);
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) throwErrno("socket(AF_INET)");
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    listeners_.push_back(bound(fd, reinterpret_cast<struct sockaddr *>(&sa), sizeof(sa), address));
+}
+
+void Server::setHealth(std::function<bool(std::string &)> check) {
+    health_ = std::move(check);
+}
+
+void Server::start() {
+    if (thread_.joinable()) return;
+    wake_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_ < 0) throwErrno("eventfd");
+    thread_ = std::thread(&Server::run, this);
+}
+
+void Server::stop() {
+    if (!thread_.joinable()) return;
+    uint64_t one = 1;
+    if (write(wake_, &one, sizeof(one)) < 0) {
+    }
+    thread_.join();
+    close(wake_);
+    wake_ = -1;
+}
+
+void Server::run() {
+    std::vector<struct pollfd> fds(listeners_.size() + 1);
+    for (size_t i = 0; i < listeners_.size(); i++) fds[i] = {listeners_[i], POLLIN, 0};
+    fds.back() = {wake_, POLLIN, 0};
+
+    for (;;) {
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds.back().revents) return;
+        for (size_t i = 0; i < listeners_.size(); i++) {
+            if (!(fds[i].revents & POLLIN)) continue;
+            int client;
+            while ((client = accept4(listeners_[i], nullptr, nullptr, SOCK_CLOEXEC)) >= 0) {
+                serve(client);
+                close(client);
+            }
+        }
+    }
+}
+
+void Server::serve(int fd) {
+    struct timeval tv = {kClientTimeoutMs / 1000, (kClientTimeoutMs % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    // Só a linha de requisição importa; o resto do cabeçalho é descartado
+    std::string req;
+    char buf[512];
+    while (req.find("\r\n") == std::string::npos && req.find('\n') == std::string::npos) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        req.append(buf, static_cast<size_t>(n));
+        if (req.size() > kMaxRequest) return;
+    }
+    requests_.fetch_add(1, std::memory_order_relaxed);
+
+    size_t sp1 = req.find(' ');
+    size_t sp2 = sp1 == std::string::npos ? sp1 : req.find_first_of(" \r\n", sp1 + 1);
+    if (sp2 == std::string::npos) {
+        respond(fd, 400, "Bad Request", "text/plain", "requisição inválida\n", false);
+        return;
+    }
+    std::string method = req.substr(0, sp1);
+    std::string path = req.substr(sp1 + 1, sp2 - sp1 - 1);
+    path = path.substr(0, path.find('?'));
+    bool head = method == "HEAD";
+    if (method != "GET" && !head) {
+        respond(fd, 405, "Method Not Allowed", "text/plain", "só GET\n", false);
+        return;
+    }
+
+    if (path == "/metrics") {
+        respond(fd, 200, "OK", "text/plain; version=0.0.4; charset=utf-8", registry_.render(), head);
+    } else if (path == "/healthz") {
+        std::string reason = "ok";
+        bool ok = !health_ || health_(reason);
+        respond(fd, ok ? 200 : 503, ok ? "OK" : "Service Unavailable", "text/plain", reason + "\n", head);
+    } else if (path == "/") {
+        respond(fd, 200, "OK", "text/plain", "/metrics\n/healthz\n", head);
+    } else {
+        respond(fd, 404, "Not Found", "text/plain", "não encontrado\n", head);
+    }
+}
+
+}  // namespace metrics
@@ -0,0 +1,406 @@
+#include "protocol.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace proto {
+
+CanFrame encodeDigital(const DigitalState &state) {
+    CanFrame f;
+    f.id = kDigitalCmdId;
+    f.dlc = 8;
+    int relays[8];
+    for (int i = 0; i < 8; i++) relays[i] = state.relays[i] & 0x03;
+    sendDigital(relays, state.pwm1, state.pwm2, state.enc, f.data);
+    return f;
+}
+
+DigitalState decodeDigital(const CanFrame &frame) {
+    DigitalState s;
+    byte buf[8];
+    memcpy(buf, frame.data, 8);
+    readDigital(buf, s.relays);
+    s.pwm1 = buf[2];
+    s.pwm2 = buf[3];
+    s.enc = buf[4];
+    return s;
+}
+
+CanFrame encodeSafetyPair(uint32_t id, const safetyConfigStructure &first, const safetyConfigStructure &second) {
+    CanFrame f;
+    f.id = id;
+    f.dlc = 8;
+    sendSafetyPair(first, second, f.data);
+    return f;
+}
+
+void decodeSafetyPair(const CanFrame &frame, safetyConfigStructure &first, safetyConfigStructure &second) {
+    byte buf[8];
+    memcpy(buf, frame.data, 8);
+    readSafetyPair(buf, first, second);
+}
+
+CanFrame encodeAquisition(const aquisitionConfigStructure &aquisc) {
+    CanFrame f;
+    f.id = kAquisCmdId;
+    f.dlc = 8;
+    sendAquisitionFrame(aquisc, f.data);
+    return f;
+}
+
+aquisitionConfigStructure decodeAquisition(const CanFrame &frame) {
+    byte buf[8];
+    memcpy(buf, frame.data, 8);
+    return readAquisitionFrame(buf, aquisitionConfigStructure());
+}
+
+CanFrame encodeStartStop(bool enable) {
+    CanFrame f;
+    f.id = kStartStopCmdId;
+    f.dlc = 8;
+    sendStartStop(enable ? 1 : 0, f.data);
+    return f;
+}
+
+bool decodeStartStop(const CanFrame &frame) {
+    byte buf[8];
+    memcpy(buf, frame.data, 8);
+    return readStartStop(buf) == 1;
+}
+
+tempReadStructure decodeTemperature(const CanFrame &frame) {
+    byte buf[8];
+    memcpy(buf, frame.data, 8);
+    return tempRead(buf);
+}
+
+CanFrame encodeTemperature(uint32_t id, const tempReadStructure &temp) {
+    auto raw = [](int16_t t) -> unsigned {
+        int v = t < -2048 ? -2048 : t > 2047 ? 2047 : t;
+        return static_cast<unsigned>(v + 2048);
+    };
+    unsigned tl = raw(temp.TLtemp), tr = raw(temp.TRtemp), bl = raw(temp.BLtemp), br = raw(temp.BRtemp);
+    CanFrame f;
+    f.id = id;
+    f.dlc = 8;
+    f.data[0] = static_cast<uint8_t>(temp.CJtemp + 128);
+    f.data[1] = static_cast<uint8_t>((temp.TLstatus & 0x03) | ((tl & 0x3F) << 2));
+    f.data[2] = static_cast<uint8_t>(((tl >> 6) & 0x3F) | ((temp.TRstatus & 0x03) << 6));
+    f.data[3] = static_cast<uint8_t>(tr & 0xFF);
+    f.data[4] = static_cast<uint8_t>(((tr >> 8) & 0x0F) | ((temp.BLstatus & 0x03) << 4) | ((bl & 0x03) << 6));
+    f.data[5] = static_cast<uint8_t>((bl >> 2) & 0xFF);
+    f.data[6] = static_cast<uint8_t>(((bl >> 10) & 0x03) | ((temp.BRstatus & 0x03) << 2) | ((br & 0x0F) << 4));
+    f.data[7] = static_cast<uint8_t>(br >> 4);
+    return f;
+}
+
+CanFrame encodeIngestMode(bool push) {
+    CanFrame f;
+    f.id = kIngestCmdId;
+    f.dlc = 1;
+    f.data[0] = push ? 1 : 0;  // IngestMode do firmware (ingest.h)
+    return f;
+}
+
+ingestStatusStructure decodeIngestStatus(const CanFrame &frame) {
+    return readIngestStatus(frame.data);
+}
+
+CanFrame encodeFreshnessConfig(const freshnessConfigStructure &config) {
+    CanFrame f;
+    f.id = kFreshnessCmdId;
+    f.dlc = 3;
+    f.data[0] = config.action;
+    f.data[1] = (config.maxAgeMs >> 8) & 0xFF;
+    f.data[2] = config.maxAgeMs & 0xFF;
+    return f;
+}
+
+freshnessStatusStructure decodeFreshnessStatus(const CanFrame &frame) {
+    return readFreshnessStatus(frame.data);
+}
+
+CanFrame encodeSamplingConfig(const samplingConfigStructure &config) {
+    CanFrame f;
+    f.id = kSamplingCmdId;
+    f.dlc = 5;
+    f.data[0] = config.enabled & 0x01;
+    f.data[1] = config.minMs / 10;
+    f.data[2] = config.maxMs / 20;
+    f.data[3] = config.marginC;
+    f.data[4] = config.budgetPermille;
+    return f;
+}
+
+samplingStatusStructure decodeSamplingStatus(const CanFrame &frame) {
+    return readSamplingStatus(frame.data);
+}
+
+CanFrame encodeReportConfig(const reportConfigStructure &config) {
+    CanFrame f;
+    f.id = kReportCmdId;
+    f.dlc = 2;
+    f.data[0] = config.mode;
+    f.data[1] = config.heartbeatS;
+    return f;
+}
+
+heartbeatStructure decodeHeartbeat(const CanFrame &frame) {
+    return readHeartbeat(frame.data);
+}
+
+busHealthStructure decodeBusHealth(const CanFrame &frame) {
+    return readBusHealth(frame.data);
+}
+
+CanFrame encodeBitrateCommand(const bitrateCommandStructure &cmd) {
+    CanFrame f;
+    f.id = kBitrateCmdId;
+    f.dlc = 3;
+    f.data[0] = cmd.target;
+    f.data[1] = (cmd.delayMs >> 8) & 0xFF;
+    f.data[2] = cmd.delayMs & 0xFF;
+    return f;
+}
+
+bitrateStatusStructure decodeBitrateStatus(const CanFrame &frame) {
+    return readBitrateStatus(frame.data);
+}
+
+CanFrame encodePulseConfig(const pulseConfigStructure &cfg) {
+    CanFrame f;
+    f.id = kPulseCmdId;
+    f.dlc = 7;
+    f.data[0] = cfg.enableMask;
+    for (int i = 0; i < 2; i++) {
+        unsigned gate = cfg.gateMs[i] / 10;
+        f.data[1 + i] = gate > 255 ? 255 : static_cast<uint8_t>(gate);
+        f.data[3 + 2 * i] = (cfg.ppr[i] >> 8) & 0xFF;
+        f.data[4 + 2 * i] = cfg.ppr[i] & 0xFF;
+    }
+    return f;
+}
+
+pulseStatusStructure decodePulseStatus(const CanFrame &frame) {
+    return readPulseStatus(frame.data);
+}
+
+CanFrame encodeAdcConfig(const adcConfigStructure &cfg) {
+    CanFrame f;
+    f.id = kAdcCmdId;
+    f.dlc = 3;
+    f.data[0] = (cfg.channelMask >> 8) & 0xFF;
+    f.data[1] = cfg.channelMask & 0xFF;
+    f.data[2] = cfg.oversampleBits;
+    return f;
+}
+
+adcStatusStructure decodeAdcStatus(const CanFrame &frame) {
+    return readAdcStatus(frame.data);
+}
+
+CanFrame encodeHistoryCommand(uint8_t command) {
+    CanFrame f;
+    f.id = kHistoryCmdId;
+    f.dlc = 1;
+    f.data[0] = command;
+    return f;
+}
+
+historyStatusStructure decodeHistoryStatus(const CanFrame &frame) {
+    return readHistoryStatus(frame.data);
+}
+
+CanFrame encodeTimeSync(uint8_t seq) {
+    CanFrame f;
+    f.id = kTimeSyncId;
+    f.dlc = 1;
+    f.data[0] = seq;
+    return f;
+}
+
+CanFrame encodeTimeFollowUp(uint8_t seq, uint64_t masterUs) {
+    CanFrame f;
+    f.id = kTimeFollowUpId;
+    f.dlc = 8;
+    sendTimeFollowUp(seq, masterUs, f.data);
+    return f;
+}
+
+timeSyncStatusStructure decodeTimeSyncStatus(const CanFrame &frame) {
+    return readTimeSyncStatus(frame.data);
+}
+
+stampedSampleStructure decodeStampedSample(const CanFrame &frame) {
+    return readStampedSample(frame.data);
+}
+
+uint64_t expandStampedTime(uint64_t low40, uint64_t nearUs) {
+    const uint64_t span = 1ULL << 40;
+    uint64_t t = (nearUs & ~(span - 1)) | (low40 & (span - 1));
+    if (t > nearUs + span / 2) t -= span;
+    else if (t + span / 2 < nearUs) t += span;
+    return t;
+}
+
+namespace {
+
+bool positive(const std::vector<uint8_t> &response, uint8_t service, size_t minLength) {
+    return response.size() >= minLength && response[0] == (service | ISOTP_POSITIVE);
+}
+
+uint32_t be32(const uint8_t *p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+}  // namespace
+
+std::vector<uint8_t> encodeSafetyTableRequest() {
+    return {ISOTP_SVC_READ_SAFETY};
+}
+
+bool decodeSafetyTable(const std::vector<uint8_t> &response, safetyConfigStructure table[4]) {
+    if (!positive(response, ISOTP_SVC_READ_SAFETY, 1 + 4 * SAFETY_RECORD_BYTES)) return false;
+    for (int ch = 0; ch < 4; ch++) table[ch] = readSafetyRecord(response.data() + 1 + ch * SAFETY_RECORD_BYTES);
+    return true;
+}
+
+std::vector<uint8_t> encodeSafetyWrite(uint8_t channel, const safetyConfigStructure &config, bool save) {
+    std::vector<uint8_t> m(3 + SAFETY_RECORD_BYTES);
+    m[0] = ISOTP_SVC_WRITE_SAFETY;
+    m[1] = channel;
+    sendSafetyRecord(config, m.data() + 2);
+    m[2 + SAFETY_RECORD_BYTES] = save ? 1 : 0;
+    return m;
+}
+
+bool decodeSafetyWrite(const std::vector<uint8_t> &response, uint8_t &channel, safetyConfigStructure &config) {
+    if (!positive(response, ISOTP_SVC_WRITE_SAFETY, 2 + SAFETY_RECORD_BYTES)) return false;
+    channel = response[1];
+    config = readSafetyRecord(response.data() + 2);
+    return true;
+}
+
+std::vector<uint8_t> encodeHistoryRequest() {
+    return {ISOTP_SVC_READ_HISTORY};
+}
+
+bool decodeHistory(const std::vector<uint8_t> &response, std::vector<uint8_t> &stream) {
+    if (!positive(response, ISOTP_SVC_READ_HISTORY, 1)) return false;
+    stream.assign(response.begin() + 1, response.end());
+    return true;
+}
+
+std::vector<uint8_t> encodeTransport(uint8_t blockSize, uint8_t stMin) {
+    return {ISOTP_SVC_TRANSPORT, blockSize, stMin};
+}
+
+bool decodeTransport(const std::vector<uint8_t> &response, uint8_t &blockSize, uint8_t &stMin) {
+    if (!positive(response, ISOTP_SVC_TRANSPORT, 3)) return false;
+    blockSize = response[1];
+    stMin = response[2];
+    return true;
+}
+
+std::vector<uint8_t> encodeParamRead(uint8_t index) {
+    return {ISOTP_SVC_READ_PARAM, index};
+}
+
+std::vector<uint8_t> encodeParamWrite(uint8_t index, uint32_t wire) {
+    return {ISOTP_SVC_WRITE_PARAM, index, static_cast<uint8_t>(wire >> 24), static_cast<uint8_t>(wire >> 16),
+            static_cast<uint8_t>(wire >> 8), static_cast<uint8_t>(wire)};
+}
+
+bool decodeParam(const std::vector<uint8_t> &response, paramValueStructure &value) {
+    if (!positive(response, ISOTP_SVC_READ_PARAM, 1 + PARAM_RECORD_BYTES) &&
+        !positive(response, ISOTP_SVC_WRITE_PARAM, 1 + PARAM_RECORD_BYTES)) {
+        return false;
+    }
+    value = readParamValue(response.data() + 1);
+    return true;
+}
+
+std::vector<uint8_t> encodeParamBulkRead(uint8_t first, uint8_t count) {
+    return {ISOTP_SVC_BULK_READ, first, count};
+}
+
+bool decodeParamBulk(const std::vector<uint8_t> &response, std::vector<paramValueStructure> &values) {
+    if (!positive(response, ISOTP_SVC_BULK_READ, 3)) return false;
+    size_t count = response[2];
+    if (response.size() < 3 + count * PARAM_VALUE_BYTES) return false;
+    values.clear();
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *r = response.data() + 3 + i * PARAM_VALUE_BYTES;
+        paramValueStructure v;
+        v.index = static_cast<uint8_t>(response[1] + i);
+        v.type = r[0];
+        v.wire = be32(r + 1);
+        values.push_back(v);
+    }
+    return true;
+}
+
+std::vector<uint8_t> encodeParamDescribe(uint8_t first, uint8_t count) {
+    return {ISOTP_SVC_DESCRIBE, first, count};
+}
+
+bool decodeParamDescribe(const std::vector<uint8_t> &response, std::vector<ParamInfo> &table) {
+    if (!positive(response, ISOTP_SVC_DESCRIBE, 3)) return false;
+    size_t count = response[2];
+    if (response.size() < 3 + count * PARAM_DESCRIBE_BYTES) return false;
+    table.clear();
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *r = response.data() + 3 + i * PARAM_DESCRIBE_BYTES;
+        ParamInfo p;
+        p.index = r[0];
+        p.type = r[1];
+        p.flags = r[2];
+        p.min = ObjectDictionary::asFloat(PARAM_F32, be32(r + 3));
+        p.max = ObjectDictionary::asFloat(PARAM_F32, be32(r + 7));
+        p.name.assign(reinterpret_cast<const char *>(r + 11), strnlen(reinterpret_cast<const char *>(r + 11), PARAM_NAME_LEN));
+        table.push_back(p);
+    }
+    return true;
+}
+
+std::string formatParam(uint8_t type, uint32_t wire) {
+    char buf[32];
+    switch (type) {
+        case PARAM_ABSENT: return "-";
+        case PARAM_I16: snprintf(buf, sizeof(buf), "%d", static_cast<int>(static_cast<int32_t>(wire))); break;
+        case PARAM_F32: snprintf(buf, sizeof(buf), "%g", ObjectDictionary::asFloat(type, wire)); break;
+        default: snprintf(buf, sizeof(buf), "%u", wire); break;
+    }
+    return buf;
+}
+
+bool parseParam(uint8_t type, const std::string &text, uint32_t &wire) {
+    char *end = nullptr;
+    if (type == PARAM_F32) {
+        float f = strtof(text.c_str(), &end);
+        memcpy(&wire, &f, 4);
+    } else if (type == PARAM_I16) {
+        wire = static_cast<uint32_t>(static_cast<int32_t>(strtol(text.c_str(), &end, 0)));
+    } else {
+        wire = static_cast<uint32_t>(strtoul(text.c_str(), &end, 0));
+    }
+    return !text.empty() && end && *end == '\0';
+}
+
+bool isoTpNegative(const std::vector<uint8_t> &response, uint8_t &nrc) {
+    if (response.size() < 3 || response[0] != ISOTP_SVC_NEGATIVE) return false;
+    nrc = response[2];
+    return true;
+}
+
+bool DigitalDelta::next(const DigitalState &state, CanFrame &frame) {
+    frame = encodeDigital(state);
+    if (valid_ && memcmp(frame.data, last_.data, 8) == 0) return false;
+    last_ = frame;
+    valid_ = true;
+    return true;
+}
+
+}  // namespace proto
@@ -0,0 +1,423 @@
+#include "supervisor.h"
+
+#include <stdlib.h>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace sup {
+
+namespace {
+
+bool parseNumber(const std::string &text, double &value) {
+    char *end = nullptr;
+    value = strtod(text.c_str(), &end);
+    return !text.empty() && end && *end == '\0';
+}
+
+bool parseUnsigned(const std::string &text, uint32_t &value, int base = 10) {
+    char *end = nullptr;
+    unsigned long v = strtoul(text.c_str(), &end, base);
+    value = static_cast<uint32_t>(v);
+    return !text.empty() && end && *end == '\0';
+}
+
+const char *const kModeNames[] = {"auto", "filtragem", "arrefecimento", "descarte", "desligado"};
+
+}  // namespace
+
+const char *modeName(Mode mode) {
+    return mode <= ModeOff ? kModeNames[mode] : "?";
+}
+
+const char *stateName(State state) {
+    switch (state) {
+        case StateIdle: return "S1 repouso";
+        case StateFiltration: return "S2 filtragem";
+        case StateCirculation: return "S3 circulação";
+        case StateDiscard: return "S4 descarte";
+    }
+    return "?";
+}
+
+std::vector<ContainerConfig> parseConfig(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("não foi possível abrir " + path);
+
+    std::vector<ContainerConfig> containers;
+    ContainerConfig *c = nullptr;
+    std::string line;
+    int lineNo = 0;
+
+    auto fail = [&](const std::string &what) -> void {
+        throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": " + what);
+    };
+
+    while (std::getline(in, line)) {
+        lineNo++;
+        size_t hashComment = line.find('#');
+        if (hashComment != std::string::npos) line.erase(hashComment);
+
+        std::istringstream ss(line);
+        std::vector<std::string> tok;
+        for (std::string t; ss >> t;) tok.push_back(t);
+        if (tok.empty()) continue;
+
+        const std::string &cmd = tok[0];
+        if (cmd == "container") {
+            if (c) fail("'end' esperado antes de um novo container");
+            if (tok.size() != 3) fail("uso: container <nome> <interface>");
+            for (const auto &other : containers) {
+                if (other.ifname == tok[2]) fail("interface " + tok[2] + " já usada por " + other.name);
+            }
+            containers.emplace_back();
+            c = &containers.back();
+            c->name = tok[1];
+            c->ifname = tok[2];
+        } else if (cmd == "end") {
+            if (!c) fail("'end' sem 'container'");
+            c = nullptr;
+        } else if (!c) {
+            fail("'" + cmd + "' fora de um container");
+        } else if (cmd == "mode") {
+            bool found = false;
+            for (unsigned m = 0; m <= ModeOff && tok.size() == 2; m++) {
+                if (tok[1] == kModeNames[m]) {
+                    c->mode = static_cast<Mode>(m);
+                    found = true;
+                }
+            }
+            if (!found) fail("uso: mode auto|filtragem|arrefecimento|descarte|desligado");
+        } else if (cmd == "limits") {
+            if (tok.size() != 3 || !parseNumber(tok[1], c->motorLimit) || !parseNumber(tok[2], c->waterLimit))
+                fail("uso: limits <motor °C> <água °C>");
+        } else if (cmd == "hysteresis") {
+            if (tok.size() != 3 || !parseNumber(tok[1], c->motorHysteresis) ||
+                !parseNumber(tok[2], c->waterHysteresis) || c->motorHysteresis < 0 || c->waterHysteresis < 0)
+                fail("uso: hysteresis <motor °C> <água °C>");
+        } else if (cmd == "emergency") {
+            if (tok.size() != 2 || !parseNumber(tok[1], c->emergencyMargin)) fail("uso: emergency <°C>");
+        } else if (cmd == "temps") {
+            if (tok.size() != 4 || !parseUnsigned(tok[1], c->tempId, 16) || c->tempId > 0x7FF)
+                fail("uso: temps <ID hex> <sinal motor> <sinal água>");
+            c->motorSignal = tok[2];
+            c->waterSignal = tok[3];
+        } else if (cmd == "stale") {
+            if (tok.size() != 3 || !parseUnsigned(tok[1], c->staleMs) || !parseUnsigned(tok[2], c->rtrMs) ||
+                c->rtrMs == 0)
+                fail("uso: stale <ms sem temperatura> <ms entre RTRs>");
+        } else if (cmd == "firmware") {
+            if (tok.size() != 2) fail("uso: firmware <arquivo.hex>");
+            c->firmware = tok[1];
+        } else if (cmd == "mcu") {
+            uint32_t id;
+            if (tok.size() != 2 || !parseUnsigned(tok[1], id, 16) || id > 0xFFFF) fail("uso: mcu <ID hex>");
+            c->mcuId = static_cast<uint16_t>(id);
+        } else {
+            fail("comando desconhecido: " + cmd);
+        }
+    }
+    if (c) throw std::runtime_error(path + ": container " + c->name + " sem 'end'");
+    if (containers.empty()) throw std::runtime_error(path + ": nenhum container");
+    return containers;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// HISTOGRAMA
+//───────────────────────────────────────────────────────────────────────────
+unsigned LatencyHistogram::bucket(uint64_t us) {
+    if (us < kLinear) return static_cast<unsigned>(us);
+    unsigned msb = 63 - __builtin_clzll(us);            // >= 5
+    unsigned sub = static_cast<unsigned>(us >> (msb - 4)) & (kSub - 1);
+    return kLinear + (msb - 5) * kSub + sub;
+}
+
+uint64_t LatencyHistogram::upper(unsigned b) {
+    if (b < kLinear) return b;
+    unsigned msb = (b - kLinear) / kSub + 5;
+    uint64_t sub = (b - kLinear) % kSub;
+    return (((kSub + sub + 1) << (msb - 4))) - 1;
+}
+
+void LatencyHistogram::add(uint64_t us) {
+    buckets_[bucket(us)]++;
+    count_++;
+    sum_ += us;
+    if (us > max_) max_ = us;
+}
+
+void LatencyHistogram::clear() {
+    *this = LatencyHistogram();
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (!count_) return 0;
+    uint64_t target = static_cast<uint64_t>(p * count_);
+    if (target >= count_) target = count_ - 1;
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < kBuckets; b++) {
+        seen += buckets_[b];
+        if (seen > target) return upper(b) < max_ ? upper(b) : max_;
+    }
+    return max_;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// BOOTLOADER
+//───────────────────────────────────────────────────────────────────────────
+const char *flashPhaseName(FlashPhase phase) {
+    switch (phase) {
+        case FlashIdle: return "parado";
+        case FlashBootloader: return "bootloader";
+        case FlashWriting: return "gravando";
+        case FlashDone: return "concluído";
+        case FlashError: return "erro";
+    }
+    return "?";
+}
+
+uint32_t hexImageSize(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("não foi possível abrir " + path);
+
+    uint32_t base = 0, end = 0;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        std::vector<uint8_t> rec;
+        bool ok = line[0] == ':' && line.size() % 2 == 1 && line.size() >= 11;
+        for (size_t i = 1; ok && i + 1 < line.size(); i += 2) {
+            uint32_t byte;
+            ok = parseUnsigned(line.substr(i, 2), byte, 16);
+            rec.push_back(static_cast<uint8_t>(byte));
+        }
+        uint8_t sum = 0;
+        for (uint8_t b : rec) sum += b;
+        if (!ok || rec.size() != rec[0] + 5u || sum != 0)
+            throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": registro Intel HEX inválido");
+
+        uint32_t addr = (rec[1] << 8) | rec[2];
+        switch (rec[3]) {
+            case 0x00:
+                if (rec[0] && base + addr + rec[0] > end) end = base + addr + rec[0];
+                break;
+            case 0x01: return end;
+            case 0x02: base = ((rec[4] << 8) | rec[5]) << 4; break;
+            case 0x04: base = static_cast<uint32_t>((rec[4] << 8) | rec[5]) << 16; break;
+            default: break;   // 03/05: endereço de início, não ocupa flash
+        }
+    }
+    return end;
+}
+
+void FlashMonitor::configure(uint16_t mcuId, uint32_t imageBytes) {
+    mcuId_ = mcuId;
+    imageBytes_ = imageBytes;
+}
+
+bool FlashMonitor::onFrame(const CanFrame &frame, uint64_t nowNs) {
+    if (!frame.extended || frame.dlc < 4) return false;
+    bool fromMcu = frame.id == proto::kBootMcuToHostId;
+    if (!fromMcu && frame.id != proto::kBootHostToMcuId) return false;
+    if (((frame.data[0] << 8) | frame.data[1]) != mcuId_) return false;
+
+    frames_++;
+    lastNs_ = nowNs;
+    uint8_t cmd = frame.data[2];
+    if (fromMcu) {
+        switch (cmd) {
+            case proto::kBootStart:
+                phase_ = FlashBootloader;
+                address_ = 0;
+                sessions_++;
+                break;
+            case proto::kBootFlashReady:
+                phase_ = FlashWriting;
+                if (frame.dlc >= 8)
+                    address_ = (static_cast<uint32_t>(frame.data[4]) << 24) | (frame.data[5] << 16) |
+                               (frame.data[6] << 8) | frame.data[7];
+                break;
+            case proto::kBootFlashAddressError:
+            case proto::kBootFlashDataError: phase_ = FlashError; break;
+            default: break;
+        }
+    } else {
+        switch (cmd) {
+            case proto::kBootFlashInit:
+            case proto::kBootFlashData:
+                // Monitor iniciado no meio de uma gravação: conta a sessão aqui
+                if (phase_ != FlashBootloader && phase_ != FlashWriting) sessions_++;
+                phase_ = FlashWriting;
+                break;
+            case proto::kBootFlashDone:
+            case proto::kBootStartApp:
+                if (phase_ != FlashError) phase_ = FlashDone;
+                break;
+            default: break;
+        }
+    }
+    return true;
+}
+
+double FlashMonitor::progress() const {
+    if (!imageBytes_) return -1;
+    if (phase_ == FlashDone) return 1;
+    return address_ >= imageBytes_ ? 1.0 : static_cast<double>(address_) / imageBytes_;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// CONTAINER
+//───────────────────────────────────────────────────────────────────────────
+ContainerSupervisor::ContainerSupervisor(const ContainerConfig &config, const dbc::Database &db)
+    : config_(config), db_(db), telemetry_(db.messages().size()) {
+    for (size_t i = 0; i < telemetry_.size(); i++) {
+        telemetry_[i].message = &db.messages()[i];
+        telemetry_[i].values.assign(db.messages()[i].signals.size(), 0.0);
+    }
+    resolveSignals(config);
+    flash_.configure(config.mcuId, flashImage(config));
+}
+
+uint32_t ContainerSupervisor::flashImage(const ContainerConfig &config) {
+    if (config.firmware.empty()) return 0;
+    uint32_t image = hexImageSize(config.firmware);
+    if (!image) throw std::runtime_error(config.name + ": " + config.firmware + " sem dados");
+    return image;
+}
+
+void ContainerSupervisor::resolveSignals(const ContainerConfig &config) {
+    const dbc::Message *msg = db_.find(config.tempId, false);
+    if (!msg) throw std::runtime_error(config.name + ": ID de temperatura ausente do DBC");
+    const dbc::Signal *motor = nullptr, *water = nullptr;
+    for (const auto &s : msg->signals) {
+        if (s.name == config.motorSignal) motor = &s;
+        if (s.name == config.waterSignal) water = &s;
+    }
+    if (!motor || !water)
+        throw std::runtime_error(config.name + ": sinais " + config.motorSignal + "/" + config.waterSignal +
+                                 " ausentes de " + msg->name);
+    motorSignal_ = motor;
+    waterSignal_ = water;
+}
+
+State ContainerSupervisor::step(const ContainerConfig &c, State state, double motor, double water,
+                                Decision &d) {
+    d = Decision();
+    switch (c.mode) {
+        case ModeFiltration: d.pump = true; return StateFiltration;
+        case ModeCooling: d.pump = d.circulation = true; return StateCirculation;
+        case ModeDiscard: d.pump = d.circulation = d.discard = true; return StateDiscard;
+        case ModeOff: return StateIdle;
+        case ModeAuto: break;
+    }
+
+    double motorLow = c.motorLimit - c.motorHysteresis;
+    double waterLow = c.waterLimit - c.waterHysteresis;
+    switch (state) {
+        case StateIdle:
+            if (motor > 0) state = StateFiltration;
+            break;
+        case StateFiltration:
+            if (motor >= c.motorLimit) state = StateCirculation;
+            break;
+        case StateCirculation:
+            if (water >= c.waterLimit) state = StateDiscard;
+            if (motor < motorLow) state = StateFiltration;
+            break;
+        case StateDiscard:
+            if (motor < motorLow && water < waterLow) state = StateCirculation;
+            break;
+    }
+    // Saídas do estado novo (o .m calculava as do estado anterior e só
+    // aplicava a transição no ciclo seguinte, 20 ms depois)
+    d.pump = state != StateIdle;
+    d.circulation = state == StateCirculation || state == StateDiscard;
+    d.discard = state == StateDiscard;
+    d.emergency = motor > c.motorLimit + c.emergencyMargin;
+    return state;
+}
+
+void ContainerSupervisor::reconfigure(const ContainerConfig &config) {
+    uint32_t image = flashImage(config);
+    resolveSignals(config);
+    flash_.configure(config.mcuId, image);
+    if (config.mode != config_.mode && config.mode == ModeAuto) state_ = StateFiltration;
+    config_ = config;
+}
+
+CanFrame ContainerSupervisor::allOff() {
+    proto::DigitalState s;
+    for (int &r : s.relays) r = proto::RelayOff;
+    return proto::encodeDigital(s);
+}
+
+bool ContainerSupervisor::onFrame(const CanFrame &frame, uint64_t nowNs, CanFrame &out) {
+    frames_++;
+    if (frame.remote || frame.echo) return false;
+    if (frame.extended && flash_.onFrame(frame, nowNs)) return false;
+    const dbc::Message *msg = db_.find(frame.id, frame.extended);
+    if (!msg) {
+        unknown_++;
+        return false;
+    }
+
+    uint64_t le = 0, be = 0;
+    for (int i = 0; i < 8; i++) {
+        le |= static_cast<uint64_t>(frame.data[i]) << (8 * i);
+        be = (be << 8) | frame.data[i];
+    }
+    Telemetry &t = telemetry_[msg - db_.messages().data()];
+    for (size_t i = 0; i < msg->signals.size(); i++) t.values[i] = msg->signals[i].physical(le, be);
+    t.timeNs = frame.timestampNs;
+    t.frames++;
+
+    if (frame.extended || frame.id != config_.tempId) return false;
+
+    lastTempNs_ = frame.timestampNs ? frame.timestampNs : nowNs;
+    motor_ = motorSignal_->physical(le, be);
+    water_ = waterSignal_->physical(le, be);
+
+    Decision d;
+    State next = step(config_, state_, motor_, water_, d);
+    if (next != state_) transitions_++;
+    state_ = next;
+    decision_ = d;
+
+    // Lógica inversa da placa: D1..D4 no byte 0, NA2/NA1/D7/bomba no byte 1
+    proto::DigitalState s;
+    s.relays[0] = d.emergency ? proto::RelayOn : proto::RelayOff;
+    s.relays[1] = d.emergency ? proto::RelayOn : proto::RelayOff;
+    s.relays[2] = proto::RelayOff;
+    s.relays[3] = proto::RelayOff;
+    s.relays[4] = d.discard ? proto::RelayOn : proto::RelayOff;
+    s.relays[5] = d.circulation ? proto::RelayOn : proto::RelayOff;
+    s.relays[6] = proto::RelayOff;
+    s.relays[7] = d.pump ? proto::RelayOn : proto::RelayOff;
+    bool send = delta_.next(s, out);
+
+    if (frame.timestampNs && nowNs > frame.timestampNs) decisionLatency_.add((nowNs - frame.timestampNs) / 1000);
+    if (send) commands_++;
+    return send;
+}
+
+void ContainerSupervisor::onSent(const CanFrame &cause, uint64_t nowNs) {
+    if (cause.timestampNs && nowNs > cause.timestampNs) actuationLatency_.add((nowNs - cause.timestampNs) / 1000);
+}
+
+bool ContainerSupervisor::tick(uint64_t nowNs, CanFrame &out) {
+    // Módulo em push: só pede por RTR se a temperatura não chegou sozinha
+    uint64_t staleNs = static_cast<uint64_t>(config_.staleMs) * 1000000ull;
+    uint64_t rtrNs = static_cast<uint64_t>(config_.rtrMs) * 1000000ull;
+    if (lastTempNs_ && nowNs - lastTempNs_ < staleNs) return false;
+    if (lastRtrNs_ && nowNs - lastRtrNs_ < rtrNs) return false;
+    lastRtrNs_ = nowNs;
+    requests_++;
+    out = CanFrame::rtr(config_.tempId);
+    return true;
+}
+
+}  // namespace sup
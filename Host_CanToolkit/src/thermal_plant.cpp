@@ -0,0 +1,296 @@
+#include "thermal_plant.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <functional>
+#include <stdexcept>
+
+#include "protocol.h"
+
+// Só as tabelas de perfil: o container da réplica é fixo (kContainer abaixo)
+#ifndef CONTAINER_ID
+#define CONTAINER_ID 17
+#endif
+#include "profile.h"
+
+namespace plant {
+
+namespace {
+
+const double kWaterCp = 4.186;   // kJ/(kg·K), 1 kg por litro
+
+// Relés de T1..T4 direto do perfil do firmware (include/profile.h)
+constexpr int kContainer = 17;
+const uint8_t kTripRelays[4] = {
+    ChannelProfile<kContainer, 0>::tripRelays, ChannelProfile<kContainer, 1>::tripRelays,
+    ChannelProfile<kContainer, 2>::tripRelays, ChannelProfile<kContainer, 3>::tripRelays};
+const uint8_t kReleaseRelays[4] = {
+    ChannelProfile<kContainer, 0>::releaseRelays, ChannelProfile<kContainer, 1>::releaseRelays,
+    ChannelProfile<kContainer, 2>::releaseRelays, ChannelProfile<kContainer, 3>::releaseRelays};
+
+// As saídas da planta (thermal_plant.h) têm que bater com o perfil
+static_assert(kPump == ContainerProfile<kContainer>::pumpRelays, "bomba do perfil mudou");
+static_assert(kNa2 == ChannelProfile<kContainer, 3>::tripRelays, "descarte (NA2) do perfil mudou");
+static_assert((kNa1 | kNa2 | kPump) == ChannelProfile<kContainer, 3>::releaseRelays, "saídas da água mudaram");
+
+}  // namespace
+
+//───────────────────────────────────────────────────────────────────────────
+// PLANTA
+//───────────────────────────────────────────────────────────────────────────
+ThermalPlant::ThermalPlant(const PlantParams &params, uint32_t seed)
+    : p_(params), engine_(params.ambient), intercooler_(params.ambient), starter_(params.ambient),
+      water_(params.ambient), rng_(seed ? seed : 1) {}
+
+void ThermalPlant::step(double dtS, uint8_t mask) {
+    bool pump = mask & kPump;
+    bool cooler = pump && (mask & kNa1);
+    bool discard = pump && (mask & kNa2);
+    bool stop = (mask & kStop) && p_.stopCutsLoad != 0;
+
+    double engineIn = stop ? 0 : p_.load;
+    double icIn = stop ? 0 : p_.icLoad;
+    double engineToWater = (pump ? p_.engineToWater : 0.1) * (engine_ - water_);
+    double icToWater = (pump ? p_.icToWater : 0.02) * (intercooler_ - water_);
+    double engineToStarter = p_.engineToStarter * (engine_ - starter_);
+    double toCooler = cooler ? p_.cooler * (water_ - p_.ambient) : 0;
+    double toDiscard = discard ? p_.fresh * kWaterCp * (water_ - p_.freshT) : 0;
+    double waterC = p_.tank * kWaterCp;
+
+    engine_ += dtS * (engineIn - engineToWater - engineToStarter - p_.engineLoss * (engine_ - p_.ambient)) /
+               p_.engineC;
+    intercooler_ += dtS * (icIn - icToWater - p_.icLoss * (intercooler_ - p_.ambient)) / p_.intercoolerC;
+    starter_ += dtS * (engineToStarter - p_.starterLoss * (starter_ - p_.ambient)) / p_.starterC;
+    water_ += dtS * (engineToWater + icToWater - toCooler - toDiscard - p_.tankLoss * (water_ - p_.ambient)) / waterC;
+    if (discard) discardedL_ += p_.fresh * dtS;
+}
+
+int16_t ThermalPlant::sensor(double t) {
+    if (p_.noise > 0) {
+        // Box-Muller sobre xorshift64 (determinístico pela semente)
+        auto uniform = [this] {
+            rng_ ^= rng_ << 13;
+            rng_ ^= rng_ >> 7;
+            rng_ ^= rng_ << 17;
+            return (static_cast<double>(rng_ >> 11) + 0.5) / 9007199254740992.0;
+        };
+        t += p_.noise * sqrt(-2 * log(uniform())) * cos(2 * M_PI * uniform());
+    }
+    return static_cast<int16_t>(lround(t));
+}
+
+CanFrame ThermalPlant::frame510() {
+    tempReadStructure t{};
+    t.CJtemp = 25;
+    t.TLtemp = sensor(starter_);
+    t.TRtemp = sensor(engine_);
+    t.BLtemp = sensor(intercooler_);
+    t.BRtemp = sensor(water_);
+    return proto::encodeTemperature(proto::kTemp1Id, t);
+}
+
+CanFrame ThermalPlant::frame520() {
+    tempReadStructure t{};
+    t.CJtemp = 25;
+    t.TLtemp = sensor(p_.ambient);
+    t.TRtemp = sensor(p_.freshT);
+    t.BLtemp = t.TLtemp;
+    t.BRtemp = t.TLtemp;
+    return proto::encodeTemperature(proto::kTemp2Id, t);
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// FIRMWARE
+//───────────────────────────────────────────────────────────────────────────
+FirmwareSafety::FirmwareSafety(double alpha, const double maxTemp[4]) : alpha_(alpha) {
+    for (int i = 0; i < 4; i++) maxTemp_[i] = maxTemp[i];
+}
+
+void FirmwareSafety::onFrame(const CanFrame &frame, uint8_t &mask) {
+    if (frame.extended || frame.remote || frame.id != proto::kTemp1Id) return;
+    tempReadStructure t = proto::decodeTemperature(frame);
+    const int16_t raw[4] = {t.TLtemp, t.TRtemp, t.BLtemp, t.BRtemp};
+    for (int ch = 0; ch < 4; ch++) {
+        // onTemperature: EMA em float, como no ATmega
+        filtered_[ch] = static_cast<float>(alpha_ * raw[ch] + (1 - alpha_) * filtered_[ch]);
+        if (maxTemp_[ch] <= 0) continue;   // Monit_Enable != 1
+        // monitor: LOW nos tripRelays ao atingir, HIGH nos releaseRelays ao voltar
+        if (filtered_[ch] >= maxTemp_[ch]) {
+            if (!tripped_[ch]) {
+                mask |= kTripRelays[ch];
+                tripped_[ch] = true;
+                trips_++;
+            }
+        } else if (tripped_[ch]) {
+            mask &= static_cast<uint8_t>(~kReleaseRelays[ch]);
+            tripped_[ch] = false;
+        }
+    }
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// PARÂMETROS
+//───────────────────────────────────────────────────────────────────────────
+namespace {
+
+struct Param {
+    const char *name;
+    std::function<double &(SimParams &)> field;
+};
+
+const std::vector<Param> &params() {
+    static const std::vector<Param> table = {
+        {"limM", [](SimParams &s) -> double & { return s.control.motorLimit; }},
+        {"limA", [](SimParams &s) -> double & { return s.control.waterLimit; }},
+        {"histM", [](SimParams &s) -> double & { return s.control.motorHysteresis; }},
+        {"histA", [](SimParams &s) -> double & { return s.control.waterHysteresis; }},
+        {"emerg", [](SimParams &s) -> double & { return s.control.emergencyMargin; }},
+        {"alpha", [](SimParams &s) -> double & { return s.alpha; }},
+        {"maxT1", [](SimParams &s) -> double & { return s.maxTemp[0]; }},
+        {"maxT2", [](SimParams &s) -> double & { return s.maxTemp[1]; }},
+        {"maxT3", [](SimParams &s) -> double & { return s.maxTemp[2]; }},
+        {"maxT4", [](SimParams &s) -> double & { return s.maxTemp[3]; }},
+        {"load", [](SimParams &s) -> double & { return s.plant.load; }},
+        {"icLoad", [](SimParams &s) -> double & { return s.plant.icLoad; }},
+        {"ambient", [](SimParams &s) -> double & { return s.plant.ambient; }},
+        {"tank", [](SimParams &s) -> double & { return s.plant.tank; }},
+        {"cooler", [](SimParams &s) -> double & { return s.plant.cooler; }},
+        {"fresh", [](SimParams &s) -> double & { return s.plant.fresh; }},
+        {"freshT", [](SimParams &s) -> double & { return s.plant.freshT; }},
+        {"noise", [](SimParams &s) -> double & { return s.plant.noise; }},
+        {"stopCutsLoad", [](SimParams &s) -> double & { return s.plant.stopCutsLoad; }},
+        {"hours", [](SimParams &s) -> double & { return s.hours; }},
+        {"frameMs", [](SimParams &s) -> double & { return s.frameMs; }},
+        {"seed", [](SimParams &s) -> double & { return s.seed; }},
+    };
+    return table;
+}
+
+}  // namespace
+
+bool setParam(SimParams &s, const std::string &name, double value) {
+    for (const Param &p : params()) {
+        if (name == p.name) {
+            p.field(s) = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<std::string> &paramNames() {
+    static const std::vector<std::string> names = [] {
+        std::vector<std::string> v;
+        for (const Param &p : params()) v.push_back(p.name);
+        return v;
+    }();
+    return names;
+}
+
+SweepAxis parseAxis(const std::string &spec) {
+    size_t eq = spec.find('=');
+    if (eq == std::string::npos || eq == 0) throw std::invalid_argument("esperado nome=valores: " + spec);
+    SweepAxis axis;
+    axis.name = spec.substr(0, eq);
+    SimParams probe;
+    if (!setParam(probe, axis.name, 0)) throw std::invalid_argument("parâmetro desconhecido: " + axis.name);
+
+    std::string values = spec.substr(eq + 1);
+    auto number = [&spec](const std::string &text) {
+        char *end = nullptr;
+        double v = strtod(text.c_str(), &end);
+        if (text.empty() || !end || *end) throw std::invalid_argument("número inválido em " + spec);
+        return v;
+    };
+    size_t c1 = values.find(':');
+    if (c1 != std::string::npos) {
+        size_t c2 = values.find(':', c1 + 1);
+        if (c2 == std::string::npos) throw std::invalid_argument("esperado a:b:passo em " + spec);
+        double a = number(values.substr(0, c1)), b = number(values.substr(c1 + 1, c2 - c1 - 1));
+        double step = number(values.substr(c2 + 1));
+        if (step <= 0 || b < a) throw std::invalid_argument("faixa vazia em " + spec);
+        for (unsigned i = 0; a + i * step <= b + step * 1e-9; i++) axis.values.push_back(a + i * step);
+    } else {
+        size_t start = 0;
+        for (;;) {
+            size_t comma = values.find(',', start);
+            axis.values.push_back(number(values.substr(start, comma - start)));
+            if (comma == std::string::npos) break;
+            start = comma + 1;
+        }
+    }
+    return axis;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// LAÇO FECHADO
+//───────────────────────────────────────────────────────────────────────────
+SimResult simulate(const SimParams &params, const dbc::Database &db) {
+    ThermalPlant pl(params.plant, static_cast<uint32_t>(params.seed));
+    FirmwareSafety fw(params.alpha, params.maxTemp);
+    sup::ContainerSupervisor sv(params.control, db);
+    SimResult r;
+
+    const double dt = params.frameMs / 1000.0;
+    const uint64_t dtNs = static_cast<uint64_t>(params.frameMs * 1e6);
+    const uint64_t steps = static_cast<uint64_t>(params.hours * 3600.0 / dt);
+    const uint8_t tracked[3] = {kPump, kNa1, kNa2};
+    uint64_t onSince[3] = {0, 0, 0};
+    uint64_t shortestOn = 0;
+    uint8_t mask = 0;   // Placa liga com tudo em HIGH (desligado)
+    bool emergency = false;
+
+    for (uint64_t i = 1; i <= steps; i++) {
+        pl.step(dt, mask);
+        uint64_t t = i * dtNs;
+        uint8_t before = mask;
+
+        // O nó reage no loop() antes do 0x402 do host chegar
+        CanFrame f = pl.frame510(), out;
+        f.timestampNs = t;
+        fw.onFrame(f, mask);
+        if (sv.onFrame(f, t, out)) {
+            proto::DigitalState s = proto::decodeDigital(out);
+            for (int k = 0; k < 8; k++) {
+                if (s.relays[k] == proto::RelayOn) mask |= 1 << k;
+                if (s.relays[k] == proto::RelayOff) mask &= static_cast<uint8_t>(~(1 << k));
+            }
+        }
+        if (i % 10 == 0) {
+            CanFrame g = pl.frame520();
+            g.timestampNs = t;
+            sv.onFrame(g, t, out);
+        }
+
+        for (int k = 0; k < 3; k++) {
+            bool was = before & tracked[k], now = mask & tracked[k];
+            if (!was && now) {
+                onSince[k] = i;
+                (k == 0 ? r.pumpCycles : k == 1 ? r.na1Cycles : r.na2Cycles)++;
+            } else if (was && !now && (!shortestOn || i - onSince[k] < shortestOn)) {
+                shortestOn = i - onSince[k];
+            }
+        }
+        if (sv.decision().emergency && !emergency) r.emergencies++;
+        emergency = sv.decision().emergency;
+
+        if (pl.engine() > r.peakEngine) r.peakEngine = pl.engine();
+        if (pl.water() > r.peakWater) r.peakWater = pl.water();
+        if (pl.engine() > params.control.motorLimit) r.aboveLimitS += dt;
+    }
+
+    r.overshootEngine = r.peakEngine > params.control.motorLimit ? r.peakEngine - params.control.motorLimit : 0;
+    r.overshootWater = r.peakWater > params.control.waterLimit ? r.peakWater - params.control.waterLimit : 0;
+    r.trips = fw.trips();
+    r.transitions = sv.transitions();
+    r.commands = sv.commands();
+    r.shortestOnS = shortestOn * dt;
+    r.discardedL = pl.discardedLiters();
+    r.finalEngine = pl.engine();
+    r.finalWater = pl.water();
+    r.finalRelays = mask;
+    return r;
+}
+
+}  // namespace plant
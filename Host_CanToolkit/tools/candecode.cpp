@@ -0,0 +1,89 @@
+//═══════════════════════════════════════════════════════════════════════════
+// candecode - DECODIFICA CAPTURAS INTEIRAS PELO DBC EM ARQUIVOS DE COLUNAS
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: candecode -d canmod-gen1.dbc [-d canmod_genmath.dbc] -o saida/ [-f csv|bin|both] [-j threads] captura...
+// Captura: .canlog (canrec) ou texto do candump (com -L ou formato de tela).
+// Gera <saida>/<Mensagem>_<ID>.csv e/ou .cols (ver include/bulk_decode.h).
+//═══════════════════════════════════════════════════════════════════════════
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bulk_decode.h"
+#include "dbc.h"
+
+static double monoSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void usage() {
+    fprintf(stderr,
+            "Uso: candecode -d <arquivo.dbc> [-d ...] -o <diretório> [-f csv|bin|both] [-j threads] <captura>...\n");
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> dbcFiles;
+    std::string outDir;
+    int formats = bulk::OutputCsv | bulk::OutputBinary;
+    unsigned threads = std::thread::hardware_concurrency();
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:o:f:j:h")) != -1) {
+        switch (opt) {
+            case 'd': dbcFiles.push_back(optarg); break;
+            case 'o': outDir = optarg; break;
+            case 'f':
+                if (strcmp(optarg, "csv") == 0) formats = bulk::OutputCsv;
+                else if (strcmp(optarg, "bin") == 0) formats = bulk::OutputBinary;
+                else if (strcmp(optarg, "both") == 0) formats = bulk::OutputCsv | bulk::OutputBinary;
+                else {
+                    usage();
+                    return 2;
+                }
+                break;
+            case 'j': threads = static_cast<unsigned>(atoi(optarg)); break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (dbcFiles.empty() || outDir.empty() || optind >= argc) {
+        usage();
+        return 2;
+    }
+    if (threads == 0) threads = 1;
+
+    try {
+        dbc::Database db;
+        for (const auto &f : dbcFiles) db.load(f);
+
+        for (int a = optind; a < argc; a++) {
+            std::string input = argv[a];
+            // Várias capturas: uma subpasta por arquivo
+            std::string dir = argc - optind > 1 ? outDir + "/" + input.substr(input.find_last_of('/') + 1) : outDir;
+
+            double t0 = monoSeconds();
+            bulk::Capture cap = bulk::loadCapture(input, db, threads);
+            double t1 = monoSeconds();
+            size_t files = bulk::decodeAll(cap, db, dir, formats, threads);
+            double t2 = monoSeconds();
+
+            fprintf(stderr, "%s: %llu frames (%llu fora do DBC, %llu RTR)\n", input.c_str(),
+                    static_cast<unsigned long long>(cap.frames), static_cast<unsigned long long>(cap.unknown),
+                    static_cast<unsigned long long>(cap.remote));
+            fprintf(stderr, "  leitura %.3f s (%.2f Mframes/s), decodificação+escrita %.3f s, %zu arquivos em %s\n",
+                    t1 - t0, t1 > t0 ? cap.frames / (t1 - t0) / 1e6 : 0.0, t2 - t1, files, dir.c_str());
+        }
+    } catch (const std::exception &e) {
+        fprintf(stderr, "candecode: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
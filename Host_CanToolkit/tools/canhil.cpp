@@ -0,0 +1,121 @@
+//═══════════════════════════════════════════════════════════════════════════
+// canhil - EXECUTA VETORES DE TESTE HIL E MEDE A LATÊNCIA DAS RESPOSTAS
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: canhil -i can0 [-n repetições] [-F pasta_firmwares] [-V versão] [-o relatório.csv]
+//             [-b base.csv] [-t tolerância] [-r] [-v] vetores.vec...
+//
+//   -F  lê a versão de <pasta>/version.json e grava <pasta>/latency_vX.Y.Z.csv
+//       ao lado de info_vX.Y.Z.txt
+//   -b  compara o p99 de cada expect com um relatório anterior; piora acima de
+//       -t (padrão 0.2 = 20%) mais 500 µs conta como regressão
+//   -r  SCHED_FIFO + mlockall para reduzir o jitter do agendamento
+//
+// Código de saída: 0 = tudo passou, 1 = falha de asserção ou regressão.
+//═══════════════════════════════════════════════════════════════════════════
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "can_bus.h"
+#include "hil_runner.h"
+
+static void usage() {
+    fprintf(stderr,
+            "Uso: canhil -i <interface> [-n rep] [-F pasta_firmwares] [-V versão] [-o relatório.csv]\n"
+            "            [-b base.csv] [-t tolerância] [-r] [-v] <vetores.vec>...\n");
+}
+
+int main(int argc, char **argv) {
+    std::string ifname = "can0";
+    std::string firmwareDir, version, reportPath, baselinePath;
+    unsigned repeat = 0;
+    double tolerance = 0.2;
+    hil::RunnerOptions options;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:n:F:V:o:b:t:rvh")) != -1) {
+        switch (opt) {
+            case 'i': ifname = optarg; break;
+            case 'n': repeat = static_cast<unsigned>(atoi(optarg)); break;
+            case 'F': firmwareDir = optarg; break;
+            case 'V': version = optarg; break;
+            case 'o': reportPath = optarg; break;
+            case 'b': baselinePath = optarg; break;
+            case 't': tolerance = atof(optarg); break;
+            case 'r': options.realtime = true; break;
+            case 'v': options.verbose = true; break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc) {
+        usage();
+        return 2;
+    }
+
+    try {
+        if (version.empty() && !firmwareDir.empty()) version = hil::firmwareVersion(firmwareDir);
+        if (reportPath.empty() && !firmwareDir.empty() && !version.empty())
+            reportPath = firmwareDir + "/latency_" + version + ".csv";
+
+        hil::Suite suite;
+        for (int a = optind; a < argc; a++) {
+            hil::Suite part = hil::parseSuite(argv[a]);
+            if (a == optind) {
+                suite.repeat = part.repeat;
+                suite.gapUs = part.gapUs;
+            }
+            for (auto &v : part.vectors) {
+                if (!v.repeat) v.repeat = part.repeat;
+                suite.vectors.push_back(std::move(v));
+            }
+        }
+        if (repeat) {
+            suite.repeat = repeat;
+            for (auto &v : suite.vectors) v.repeat = repeat;
+        }
+
+        CanBus bus(ifname);
+        hil::Runner runner(bus, options);
+        fprintf(stderr, "Firmware %s, %zu vetores em %s\n", version.empty() ? "?" : version.c_str(),
+                suite.vectors.size(), ifname.c_str());
+        std::vector<hil::ExpectResult> results = runner.run(suite);
+
+        bool ok = true;
+        printf("%-36s %5s %6s %9s %9s %9s %9s %9s  (µs)\n", "vetor/expect", "n", "falhas", "min", "p50", "p90", "p99",
+               "max");
+        for (const auto &r : results) {
+            hil::LatencyStats s = hil::summarize(r);
+            printf("%-36s %5u %6u %9.0f %9.0f %9.0f %9.0f %9.0f  %s\n", r.key.c_str(), s.n, s.failures, s.minUs,
+                   s.p50Us, s.p90Us, s.p99Us, s.maxUs, s.failures ? "FALHOU" : "ok");
+            if (s.failures) ok = false;
+        }
+
+        if (!baselinePath.empty()) {
+            auto base = hil::readReport(baselinePath);
+            for (const auto &r : results) {
+                auto it = base.find(r.key);
+                if (it == base.end() || it->second.n == 0) continue;
+                hil::LatencyStats s = hil::summarize(r);
+                double limit = it->second.p99Us * (1 + tolerance) + 500;
+                if (s.p99Us > limit) {
+                    printf("REGRESSÃO %s: p99 %.0f µs (base %.0f µs, limite %.0f µs)\n", r.key.c_str(), s.p99Us,
+                           it->second.p99Us, limit);
+                    ok = false;
+                }
+            }
+        }
+
+        if (!reportPath.empty()) {
+            hil::writeReport(reportPath, version, results);
+            fprintf(stderr, "Relatório: %s\n", reportPath.c_str());
+        }
+        return ok ? 0 : 1;
+    } catch (const std::exception &e) {
+        fprintf(stderr, "canhil: %s\n", e.what());
+        return 2;
+    }
+}
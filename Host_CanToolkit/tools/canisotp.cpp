@@ -0,0 +1,241 @@
+//═══════════════════════════════════════════════════════════════════════════
+// canisotp - SERVIÇOS ISO-TP DO NÓ (0x400 → nó, 0x420 ← nó)
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: canisotp -i can0 [-B bs] [-S stmin] [-T ns] [-w] [-o arquivo] <comando> [args]
+//
+//   safety                               limites de T1..T4 com resolução completa
+//   set <canal 1-4> <habilita> <°C> <ms>  grava um canal (-w também na EEPROM)
+//   history                              stream do histórico (-o salva o .bin
+//                                        para "can_history.py decode")
+//   transport <bs> <stmin>               BS/STmin do FC que o nó manda
+//   params                               dicionário inteiro: nome, valor, faixa
+//   get <índice|nome>                    um parâmetro
+//   put <índice|nome> <valor>            escreve (flag E = já fica na EEPROM)
+//   raw <byte hex>...                    pedido cru, resposta em hex
+//
+//   -B/-S  FC do host quando recebe (padrão 0/0: o nó manda sem pausa)
+//   -T     força o intervalo entre CFs do host (ns), ignorando o STmin do nó
+//
+// Precisa do módulo can-isotp (modprobe can-isotp, Linux >= 5.10).
+//═══════════════════════════════════════════════════════════════════════════
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "isotp_socket.h"
+#include "protocol.h"
+
+static void usage() {
+    fprintf(stderr,
+            "Uso: canisotp -i <interface> [-B bs] [-S stmin] [-T ns] [-w] [-o arquivo] <comando> [args]\n"
+            "  safety | set <canal> <habilita> <maxtemp> <timer_ms> | history | transport <bs> <stmin>\n"
+            "  params | get <indice|nome> | put <indice|nome> <valor> | raw <hex>...\n");
+}
+
+static double monoS() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void printRecord(int ch, const safetyConfigStructure &c) {
+    printf("T%d: habilita %u, max %.2f C, timer %u ms\n", ch + 1, c.Monit_Enable, c.maxtemp, c.timer);
+}
+
+// Resposta negativa ou inesperada: mensagem e código de saída 1
+static int fail(const std::vector<uint8_t> &response) {
+    uint8_t nrc;
+    if (proto::isoTpNegative(response, nrc)) {
+        fprintf(stderr, "canisotp: resposta negativa 0x%02X\n", nrc);
+    } else {
+        fprintf(stderr, "canisotp: resposta inesperada (%zu bytes)\n", response.size());
+    }
+    return 1;
+}
+
+static const char *typeName(uint8_t type) {
+    static const char *names[] = {"u8", "u16", "i16", "u32", "f32"};
+    return type < 5 ? names[type] : "-";
+}
+
+static void printParam(const proto::ParamInfo &info, const paramValueStructure &value) {
+    printf("%3u %-12s %-3s %c%c%c %12s  [%g, %g]\n", info.index, info.name.c_str(), typeName(info.type),
+           info.flags & PARAM_READ ? 'r' : '-', info.flags & PARAM_WRITE ? 'w' : '-',
+           info.flags & PARAM_EEPROM ? 'E' : '-', proto::formatParam(value.type, value.wire).c_str(), info.min,
+           info.max);
+}
+
+// Descrição de um índice ("12") ou nome ("t1.maxtemp") pedindo a tabela ao nó
+static bool lookup(IsoTpSocket &sock, const std::string &key, proto::ParamInfo &info) {
+    char *end = nullptr;
+    unsigned long index = strtoul(key.c_str(), &end, 0);
+    bool numeric = !key.empty() && *end == '\0' && index < 256;
+    std::vector<uint8_t> response;
+    std::vector<proto::ParamInfo> table;
+    if (!sock.request(proto::encodeParamDescribe(numeric ? static_cast<uint8_t>(index) : 0, numeric ? 1 : 0),
+                      response, 3000) ||
+        !proto::decodeParamDescribe(response, table)) {
+        return false;
+    }
+    for (const proto::ParamInfo &p : table) {
+        if ((numeric && p.index == index) || (!numeric && p.name == key)) {
+            info = p;
+            return info.type != PARAM_ABSENT;
+        }
+    }
+    return false;
+}
+
+// Comandos do dicionário: precisam da descrição antes do pedido principal
+static int paramCommand(IsoTpSocket &sock, const std::string &cmd, char **args) {
+    std::vector<uint8_t> response;
+    if (cmd == "params") {
+        std::vector<proto::ParamInfo> table;
+        std::vector<paramValueStructure> values;
+        if (!sock.request(proto::encodeParamDescribe(), response, 3000)) return -1;
+        if (!proto::decodeParamDescribe(response, table)) return fail(response);
+        if (!sock.request(proto::encodeParamBulkRead(), response, 3000)) return -1;
+        if (!proto::decodeParamBulk(response, values)) return fail(response);
+        for (size_t i = 0; i < table.size() && i < values.size(); i++) {
+            if (table[i].type != PARAM_ABSENT) printParam(table[i], values[i]);
+        }
+        return 0;
+    }
+
+    proto::ParamInfo info;
+    if (!lookup(sock, args[0], info)) {
+        fprintf(stderr, "canisotp: parametro '%s' nao existe neste no\n", args[0]);
+        return 1;
+    }
+    uint32_t wire = 0;
+    if (cmd == "put" && !proto::parseParam(info.type, args[1], wire)) {
+        fprintf(stderr, "canisotp: valor invalido '%s' para %s\n", args[1], typeName(info.type));
+        return 2;
+    }
+    if (!sock.request(cmd == "put" ? proto::encodeParamWrite(info.index, wire) : proto::encodeParamRead(info.index),
+                      response, 3000)) {
+        return -1;
+    }
+    paramValueStructure value;
+    if (!proto::decodeParam(response, value)) return fail(response);
+    printParam(info, value);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    std::string ifname = "can0";
+    std::string output;
+    bool save = false;
+    IsoTpOptions options;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:B:S:T:wo:h")) != -1) {
+        switch (opt) {
+            case 'i': ifname = optarg; break;
+            case 'B': options.blockSize = static_cast<uint8_t>(strtoul(optarg, nullptr, 0)); break;
+            case 'S': options.stMin = static_cast<uint8_t>(strtoul(optarg, nullptr, 0)); break;
+            case 'T': options.forceTxStMinNs = static_cast<uint32_t>(strtoul(optarg, nullptr, 0)); break;
+            case 'w': save = true; break;
+            case 'o': output = optarg; break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc) {
+        usage();
+        return 2;
+    }
+    std::string cmd = argv[optind];
+    int nargs = argc - optind - 1;
+    char **args = argv + optind + 1;
+
+    if (cmd == "params" || (cmd == "get" && nargs == 1) || (cmd == "put" && nargs == 2)) {
+        try {
+            IsoTpSocket sock(ifname, proto::kIsoTpRequestId, proto::kIsoTpResponseId, options);
+            int rc = paramCommand(sock, cmd, args);
+            if (rc < 0) fprintf(stderr, "canisotp: sem resposta do nó em %s\n", ifname.c_str());
+            return rc < 0 ? 1 : rc;
+        } catch (const std::exception &e) {
+            fprintf(stderr, "canisotp: %s\n", e.what());
+            return 1;
+        }
+    }
+
+    std::vector<uint8_t> request;
+    if (cmd == "safety") {
+        request = proto::encodeSafetyTableRequest();
+    } else if (cmd == "set" && nargs == 4) {
+        int ch = atoi(args[0]);
+        if (ch < 1 || ch > 4) {
+            usage();
+            return 2;
+        }
+        safetyConfigStructure c;
+        c.Monit_Enable = static_cast<uint8_t>(atoi(args[1]));
+        c.maxtemp = static_cast<float>(atof(args[2]));
+        c.timer = static_cast<uint16_t>(atoi(args[3]));
+        request = proto::encodeSafetyWrite(static_cast<uint8_t>(ch - 1), c, save);
+    } else if (cmd == "history") {
+        request = proto::encodeHistoryRequest();
+    } else if (cmd == "transport" && nargs == 2) {
+        request = proto::encodeTransport(static_cast<uint8_t>(strtoul(args[0], nullptr, 0)),
+                                         static_cast<uint8_t>(strtoul(args[1], nullptr, 0)));
+    } else if (cmd == "raw" && nargs > 0) {
+        for (int i = 0; i < nargs; i++) request.push_back(static_cast<uint8_t>(strtoul(args[i], nullptr, 16)));
+    } else {
+        usage();
+        return 2;
+    }
+
+    try {
+        IsoTpSocket sock(ifname, proto::kIsoTpRequestId, proto::kIsoTpResponseId, options);
+        std::vector<uint8_t> response;
+        double t0 = monoS();
+        if (!sock.request(request, response, 3000)) {
+            fprintf(stderr, "canisotp: sem resposta do nó em %s\n", ifname.c_str());
+            return 1;
+        }
+        double dt = monoS() - t0;
+
+        if (cmd == "safety") {
+            safetyConfigStructure table[4];
+            if (!proto::decodeSafetyTable(response, table)) return fail(response);
+            for (int ch = 0; ch < 4; ch++) printRecord(ch, table[ch]);
+        } else if (cmd == "set") {
+            uint8_t ch;
+            safetyConfigStructure c;
+            if (!proto::decodeSafetyWrite(response, ch, c)) return fail(response);
+            printRecord(ch, c);
+        } else if (cmd == "history") {
+            std::vector<uint8_t> stream;
+            if (!proto::decodeHistory(response, stream)) return fail(response);
+            if (!output.empty()) {
+                FILE *f = fopen(output.c_str(), "wb");
+                if (!f || fwrite(stream.data(), 1, stream.size(), f) != stream.size()) {
+                    perror(output.c_str());
+                    if (f) fclose(f);
+                    return 1;
+                }
+                fclose(f);
+            }
+            printf("%zu bytes em %.1f ms (%.1f kB/s)\n", stream.size(), dt * 1000,
+                   dt > 0 ? stream.size() / dt / 1000 : 0.0);
+        } else if (cmd == "transport") {
+            uint8_t bs, st;
+            if (!proto::decodeTransport(response, bs, st)) return fail(response);
+            printf("FC do no: BS %u, STmin 0x%02X\n", bs, st);
+        } else {
+            for (uint8_t b : response) printf("%02X ", b);
+            printf("\n");
+        }
+    } catch (const std::exception &e) {
+        fprintf(stderr, "canisotp: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+//═══════════════════════════════════════════════════════════════════════════
+// canlogcat - LISTA UMA CAPTURA .canlog NO FORMATO candump -L
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: canlogcat [-n interface] [-s] [-B bitrate] arquivo.canlog [depois.canlog]
+//   -s  → apenas estatísticas: frames por ID, período médio e carga do
+//         barramento (bits reais, com stuffing) no bitrate de -B (500000)
+//         Com duas capturas, compara a carga (ex.: polling x push)
+//═══════════════════════════════════════════════════════════════════════════
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "bus_load.h"
+#include "can_log.h"
+
+static void usage() {
+    fprintf(stderr, "Uso: canlogcat [-n interface] [-s] [-B bitrate] <arquivo.canlog> [depois.canlog]\n");
+}
+
+static busload::LoadStats printStats(const char *path, uint32_t bitrate) {
+    canlog::Reader log(path);
+    busload::LoadStats stats;
+    log.forEach([&](uint64_t, const canlog::Record &rec, uint64_t ts) { stats.add(canlog::fromRecord(rec, ts)); });
+
+    double span = stats.seconds();
+    printf("%s: %llu frames, %.3f s, carga %.2f%% @ %u bit/s\n", path, static_cast<unsigned long long>(stats.frames),
+           span, stats.load(bitrate) * 100, bitrate);
+    for (const auto &kv : stats.perId) {
+        const busload::IdLoad &id = kv.second;
+        bool ext = kv.first & 0x80000000u;
+        printf(ext ? "  0x%08X" : "  0x%03X", kv.first & 0x1FFFFFFF);
+        printf("  %10llu frames (%llu RTR)  %8.1f frames/s  %6.2f%%\n", static_cast<unsigned long long>(id.frames),
+               static_cast<unsigned long long>(id.remotes), span > 0 ? id.frames / span : 0.0,
+               stats.load(id, bitrate) * 100);
+    }
+    return stats;
+}
+
+int main(int argc, char **argv) {
+    std::string ifname = "can0";
+    bool statsOnly = false;
+    uint32_t bitrate = 500000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:sB:h")) != -1) {
+        switch (opt) {
+            case 'n': ifname = optarg; break;
+            case 's': statsOnly = true; break;
+            case 'B': bitrate = static_cast<uint32_t>(strtoul(optarg, nullptr, 0)); break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc || (!statsOnly && argc - optind > 1) || argc - optind > 2) {
+        usage();
+        return 2;
+    }
+
+    try {
+        if (statsOnly) {
+            std::vector<busload::LoadStats> runs;
+            for (int a = optind; a < argc; a++) runs.push_back(printStats(argv[a], bitrate));
+            if (runs.size() == 2) {
+                double before = runs[0].load(bitrate) * 100, after = runs[1].load(bitrate) * 100;
+                double rtrBefore = 0, rtrAfter = 0;
+                for (const auto &kv : runs[0].perId) rtrBefore += kv.second.remotes;
+                for (const auto &kv : runs[1].perId) rtrAfter += kv.second.remotes;
+                if (runs[0].seconds() > 0) rtrBefore /= runs[0].seconds();
+                if (runs[1].seconds() > 0) rtrAfter /= runs[1].seconds();
+                printf("carga: antes %.2f%%, depois %.2f%% (%+.2f pontos); RTR/s: %.1f -> %.1f\n", before, after,
+                       after - before, rtrBefore, rtrAfter);
+            }
+            return 0;
+        }
+
+        canlog::Reader log(argv[optind]);
+        log.forEach([&](uint64_t, const canlog::Record &rec, uint64_t ts) {
+            CanFrame f = canlog::fromRecord(rec, ts);
+            printf("(%llu.%06llu) %s ", static_cast<unsigned long long>(ts / 1000000000ull),
+                   static_cast<unsigned long long>((ts / 1000) % 1000000ull), ifname.c_str());
+            printf(f.extended ? "%08X#" : "%03X#", f.id);
+            if (f.remote) {
+                printf("R\n");
+                return;
+            }
+            for (int b = 0; b < f.dlc; b++) printf("%02X", f.data[b]);
+            printf("\n");
+        });
+    } catch (const std::exception &e) {
+        fprintf(stderr, "canlogcat: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
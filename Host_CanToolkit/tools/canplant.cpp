@@ -0,0 +1,274 @@
+//═══════════════════════════════════════════════════════════════════════════
+// canplant - PLANTA TÉRMICA SIMULADA: VARREDURAS EM PARALELO OU NO BARRAMENTO
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: canplant -d canmod-gen1.dbc [-p nome=valores ...] [-j threads] [-o saida.csv]
+//      canplant -d canmod-gen1.dbc -i vcan0 [-x fator] [-p nome=valor ...] [-f] [-e]
+//
+// Modelo e parâmetros em include/thermal_plant.h.
+//
+// Varredura (sem -i): o produto cartesiano dos -p ("limM=85:95:5",
+// "alpha=0.05,0.1,0.2"; um valor só = fixo) roda em laço fechado com o
+// ContainerSupervisor real e a réplica do firmware, uma simulação por vez
+// em cada thread (-j, padrão todos os núcleos), tão rápido quanto der.
+// Uma linha CSV por combinação (stdout ou -o): os parâmetros variados e
+//   pico/sobre-sinal do motor e da água, s acima de limM, emergências D1/D2
+//   do supervisor, disparos do firmware, transições, 0x402 enviados, ciclos
+//   de bomba/NA1/NA2, menor tempo ligado, litros descartados, relés no fim.
+//
+// No barramento (-i): a planta roda em tempo real × fator (-x, padrão 100)
+// e manda 0x510 (e 0x520 a cada 10) na interface; os relés vêm do 0x402 de
+// quem controla (cansupd) ou, com -e, do eco 0x422 de um nó de verdade.
+// -f aplica a réplica dos canais de segurança aqui (sem nó no barramento).
+// Uma linha por minuto simulado; -p hours=... encerra (padrão 4 h).
+//═══════════════════════════════════════════════════════════════════════════
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "can_bus.h"
+#include "dbc.h"
+#include "protocol.h"
+#include "thermal_plant.h"
+
+static std::atomic<bool> stopRequested{false};
+
+static void onSignal(int) {
+    stopRequested = true;
+}
+
+static uint64_t monoNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleepUntil(uint64_t ns) {
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000ull);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000ull);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR && !stopRequested) {
+    }
+}
+
+static void usage() {
+    fprintf(stderr,
+            "Uso: canplant -d <arquivo.dbc> [-p nome=valores ...] [-j threads] [-o saida.csv]\n"
+            "     canplant -d <arquivo.dbc> -i <interface> [-x fator] [-p nome=valor ...] [-f] [-e]\n"
+            "Parâmetros:");
+    for (const auto &n : plant::paramNames()) fprintf(stderr, " %s", n.c_str());
+    fprintf(stderr, "\n");
+}
+
+static void applyRelays(const CanFrame &frame, uint8_t &mask) {
+    proto::DigitalState s = proto::decodeDigital(frame);
+    for (int k = 0; k < 8; k++) {
+        if (s.relays[k] == proto::RelayOn) mask |= 1 << k;
+        if (s.relays[k] == proto::RelayOff) mask &= static_cast<uint8_t>(~(1 << k));
+    }
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// VARREDURA
+//───────────────────────────────────────────────────────────────────────────
+static int sweep(const dbc::Database &db, const std::vector<plant::SweepAxis> &axes, unsigned threads, FILE *out) {
+    size_t total = 1;
+    for (const auto &a : axes) total *= a.values.size();
+
+    // Combinação k: dígitos em base mista, o último eixo varia mais rápido
+    auto combination = [&axes](size_t k, plant::SimParams &p) {
+        for (size_t a = axes.size(); a-- > 0;) {
+            const plant::SweepAxis &axis = axes[a];
+            plant::setParam(p, axis.name, axis.values[k % axis.values.size()]);
+            k /= axis.values.size();
+        }
+    };
+
+    std::vector<plant::SimResult> results(total);
+    std::vector<std::string> errors(total);
+    std::atomic<size_t> next{0};
+
+    uint64_t start = monoNs();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            for (size_t k; (k = next++) < total && !stopRequested;) {
+                plant::SimParams p;
+                combination(k, p);
+                try {
+                    results[k] = plant::simulate(p, db);
+                } catch (const std::exception &e) {
+                    errors[k] = e.what();
+                }
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    double wallS = (monoNs() - start) / 1e9;
+
+    for (const auto &a : axes) fprintf(out, "%s,", a.name.c_str());
+    fprintf(out, "peak_engine,overshoot_engine,peak_water,overshoot_water,above_limit_s,emergencies,trips,"
+                 "transitions,commands,pump_cycles,na1_cycles,na2_cycles,shortest_on_s,discarded_l,relays\n");
+    size_t done = std::min<size_t>(next.load(), total), failed = 0;
+    double simHours = 0;
+    for (size_t k = 0; k < done; k++) {
+        if (!errors[k].empty()) {
+            if (failed++ == 0) fprintf(stderr, "canplant: %s\n", errors[k].c_str());
+            continue;
+        }
+        plant::SimParams p;
+        combination(k, p);
+        simHours += p.hours;
+        size_t idx = k;
+        std::vector<double> v(axes.size());
+        for (size_t a = axes.size(); a-- > 0;) {
+            v[a] = axes[a].values[idx % axes[a].values.size()];
+            idx /= axes[a].values.size();
+        }
+        for (double x : v) fprintf(out, "%g,", x);
+        const plant::SimResult &r = results[k];
+        fprintf(out, "%.1f,%.1f,%.1f,%.1f,%.0f,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%.1f,%.0f,0x%02X\n", r.peakEngine,
+                r.overshootEngine, r.peakWater, r.overshootWater, r.aboveLimitS,
+                static_cast<unsigned long>(r.emergencies), static_cast<unsigned long>(r.trips),
+                static_cast<unsigned long>(r.transitions), static_cast<unsigned long>(r.commands),
+                static_cast<unsigned long>(r.pumpCycles), static_cast<unsigned long>(r.na1Cycles),
+                static_cast<unsigned long>(r.na2Cycles), r.shortestOnS, r.discardedL, r.finalRelays);
+    }
+    fflush(out);
+
+    fprintf(stderr, "canplant: %zu simulações (%zu falharam), %.0f h simuladas em %.2f s com %u threads: %.0fx tempo real\n",
+            done, failed, simHours, wallS, threads, wallS > 0 ? simHours * 3600 / wallS : 0);
+    return failed || done < total ? 1 : 0;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// NO BARRAMENTO
+//───────────────────────────────────────────────────────────────────────────
+static int live(const std::string &ifname, const plant::SimParams &p, double factor, bool firmware, bool echo) {
+    CanBus bus(ifname);
+    plant::ThermalPlant pl(p.plant, static_cast<uint32_t>(p.seed));
+    plant::FirmwareSafety fw(p.alpha, p.maxTemp);
+
+    const double dt = p.frameMs / 1000.0;
+    const uint64_t periodNs = static_cast<uint64_t>(p.frameMs * 1e6 / factor);
+    const uint64_t steps = static_cast<uint64_t>(p.hours * 3600.0 / dt);
+    const uint64_t perMinute = static_cast<uint64_t>(60.0 / dt);
+    const uint32_t relayId = echo ? proto::kDigitalEchoId : proto::kDigitalCmdId;
+
+    printf("canplant: %s a %.0fx, 0x510 a cada %.0f ms simulados (%.2f ms reais), relés do 0x%03X%s\n",
+           ifname.c_str(), factor, p.frameMs, periodNs / 1e6, relayId, firmware ? ", firmware simulado" : "");
+    fflush(stdout);
+
+    CanFrame frames[32];
+    uint8_t mask = 0;
+    uint64_t sendErrors = 0, late = 0;
+    uint64_t next = monoNs();
+    for (uint64_t i = 1; i <= steps && !stopRequested; i++) {
+        size_t got;
+        while ((got = bus.receiveBatch(frames, 32)) > 0) {
+            for (size_t k = 0; k < got; k++) {
+                const CanFrame &f = frames[k];
+                if (!f.extended && !f.remote && f.id == relayId) applyRelays(f, mask);
+            }
+        }
+
+        pl.step(dt, mask);
+        CanFrame f = pl.frame510();
+        if (firmware) fw.onFrame(f, mask);
+        try {
+            bus.send(f);
+            if (i % 10 == 0) bus.send(pl.frame520());
+        } catch (const std::exception &e) {
+            if (sendErrors++ == 0) fprintf(stderr, "canplant: %s\n", e.what());
+        }
+
+        if (i % perMinute == 0) {
+            printf("%6.1f min  motor %6.1f  intercooler %6.1f  starter %6.1f  água %5.1f  | bomba %d NA1 %d NA2 %d "
+                   "D1/D2 %d | descarte %.0f L\n",
+                   i * dt / 60, pl.engine(), pl.intercooler(), pl.starter(), pl.water(), (mask & plant::kPump) != 0,
+                   (mask & plant::kNa1) != 0, (mask & plant::kNa2) != 0, (mask & plant::kStop) != 0,
+                   pl.discardedLiters());
+            fflush(stdout);
+        }
+
+        next += periodNs;
+        uint64_t now = monoNs();
+        if (now > next + periodNs) {
+            late++;
+            next = now;   // Atrasou mais de um período: não tenta recuperar em rajada
+        } else {
+            sleepUntil(next);
+        }
+    }
+    printf("canplant: fim (%lu períodos atrasados, %lu envios falharam)\n", static_cast<unsigned long>(late),
+           static_cast<unsigned long>(sendErrors));
+    if (firmware) printf("canplant: %lu disparos do firmware simulado\n", static_cast<unsigned long>(fw.trips()));
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> dbcFiles, specs;
+    std::string ifname, output;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    double factor = 100;
+    bool firmware = false, echo = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:p:j:o:i:x:feh")) != -1) {
+        switch (opt) {
+            case 'd': dbcFiles.push_back(optarg); break;
+            case 'p': specs.push_back(optarg); break;
+            case 'j': threads = static_cast<unsigned>(atoi(optarg)); break;
+            case 'o': output = optarg; break;
+            case 'i': ifname = optarg; break;
+            case 'x': factor = atof(optarg); break;
+            case 'f': firmware = true; break;
+            case 'e': echo = true; break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (dbcFiles.empty() || !threads || factor <= 0) {
+        usage();
+        return 2;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    try {
+        dbc::Database db;
+        for (const auto &f : dbcFiles) db.load(f);
+        std::vector<plant::SweepAxis> axes;
+        for (const auto &s : specs) axes.push_back(plant::parseAxis(s));
+
+        if (!ifname.empty()) {
+            plant::SimParams p;
+            for (const auto &a : axes) {
+                if (a.values.size() != 1) fprintf(stderr, "aviso: %s com vários valores, usando o primeiro\n", a.name.c_str());
+                plant::setParam(p, a.name, a.values[0]);
+            }
+            return live(ifname, p, factor, firmware, echo);
+        }
+
+        FILE *out = stdout;
+        if (!output.empty() && !(out = fopen(output.c_str(), "w"))) {
+            fprintf(stderr, "canplant: não foi possível criar %s\n", output.c_str());
+            return 1;
+        }
+        int rc = sweep(db, axes, threads, out);
+        if (out != stdout) fclose(out);
+        return rc;
+    } catch (const std::exception &e) {
+        fprintf(stderr, "canplant: %s\n", e.what());
+        return 1;
+    }
+}
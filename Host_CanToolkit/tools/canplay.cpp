@@ -0,0 +1,131 @@
+//═══════════════════════════════════════════════════════════════════════════
+// canplay - REPRODUZ UMA CAPTURA .canlog NUMA INTERFACE (ex: vcan0)
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: canplay -i vcan0 -f ensaio.canlog [-s velocidade] [-b inicio_s] [-e fim_s] [-l voltas]
+//   -s 1   → temporização original (padrão)
+//   -s 10  → 10x mais rápido
+//   -s 0   → o mais rápido possível (benchmark de throughput)
+// Frames com o mesmo instante alvo saem num único sendmmsg.
+//═══════════════════════════════════════════════════════════════════════════
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "can_bus.h"
+#include "can_log.h"
+
+static std::atomic<bool> stopRequested{false};
+
+static void onSignal(int) {
+    stopRequested = true;
+}
+
+static uint64_t monoNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleepUntil(uint64_t ns) {
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000ull);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000ull);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR && !stopRequested) {
+    }
+}
+
+static void usage() {
+    fprintf(stderr, "Uso: canplay -i <interface> -f <arquivo.canlog> [-s velocidade] [-b inicio_s] [-e fim_s] [-l voltas]\n");
+}
+
+int main(int argc, char **argv) {
+    std::string ifname = "vcan0";
+    std::string input;
+    double speed = 1.0;
+    double beginS = 0, endS = 0;
+    int loops = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:f:s:b:e:l:h")) != -1) {
+        switch (opt) {
+            case 'i': ifname = optarg; break;
+            case 'f': input = optarg; break;
+            case 's': speed = atof(optarg); break;
+            case 'b': beginS = atof(optarg); break;
+            case 'e': endS = atof(optarg); break;
+            case 'l': loops = atoi(optarg); break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (input.empty() || speed < 0) {
+        usage();
+        return 2;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    try {
+        canlog::Reader log(input);
+        if (log.size() == 0) {
+            fprintf(stderr, "canplay: captura vazia\n");
+            return 1;
+        }
+        uint64_t t0 = log.firstTimeNs() + static_cast<uint64_t>(beginS * 1e9);
+        uint64_t first = log.seek(t0);
+        uint64_t last = endS > 0 ? log.seek(log.firstTimeNs() + static_cast<uint64_t>(endS * 1e9)) : log.size();
+
+        CanBus bus(ifname);
+        std::vector<CanFrame> batch;
+        batch.reserve(64);
+
+        uint64_t sent = 0;
+        int64_t maxLateNs = 0;
+        uint64_t wallStart = monoNs();
+
+        for (int loop = 0; (loops <= 0 || loop < loops) && !stopRequested; loop++) {
+            uint64_t loopStart = monoNs();
+            // Com sinal e limitado em 0: um frame antes de t0 sai na hora, sem dar a volta no uint64
+            auto targetOf = [&](uint64_t ts) -> uint64_t {
+                if (speed <= 0) return 0;
+                int64_t rel = static_cast<int64_t>(ts - t0);
+                return loopStart + static_cast<uint64_t>((rel > 0 ? rel : 0) / speed);
+            };
+            uint64_t i = first;
+            while (i < last && !stopRequested) {
+                uint64_t target = targetOf(log.timeNs(i));
+
+                // Agrupa os frames que vencem no mesmo instante (±50 µs)
+                batch.clear();
+                while (i < last && batch.size() < 64) {
+                    if (targetOf(log.timeNs(i)) > target + 50000) break;
+                    batch.push_back(log.frame(i));
+                    i++;
+                }
+
+                if (speed > 0) {
+                    uint64_t now = monoNs();
+                    if (target > now) sleepUntil(target);
+                    else if (static_cast<int64_t>(now - target) > maxLateNs) maxLateNs = static_cast<int64_t>(now - target);
+                }
+                sent += bus.sendBatch(batch);
+            }
+        }
+
+        double wall = (monoNs() - wallStart) / 1e9;
+        fprintf(stderr, "%llu frames em %.3f s (%.0f frames/s), atraso máximo %.1f µs\n",
+                static_cast<unsigned long long>(sent), wall, wall > 0 ? sent / wall : 0.0, maxLateNs / 1000.0);
+    } catch (const std::exception &e) {
+        fprintf(stderr, "canplay: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+//═══════════════════════════════════════════════════════════════════════════
+// canrec - GRAVA TODOS OS FRAMES DE UMA INTERFACE EM .canlog
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: canrec -i can0 -o ensaio.canlog [-t segundos]
+// Ctrl+C encerra a gravação (o buffer é descarregado antes de sair).
+//═══════════════════════════════════════════════════════════════════════════
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <exception>
+#include <string>
+
+#include "can_bus.h"
+#include "can_log.h"
+
+static std::atomic<bool> stopRequested{false};
+
+static void onSignal(int) {
+    stopRequested = true;
+}
+
+static void usage() {
+    fprintf(stderr, "Uso: canrec -i <interface> -o <arquivo.canlog> [-t segundos]\n");
+}
+
+int main(int argc, char **argv) {
+    std::string ifname = "can0";
+    std::string output;
+    double duration = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:o:t:h")) != -1) {
+        switch (opt) {
+            case 'i': ifname = optarg; break;
+            case 'o': output = optarg; break;
+            case 't': duration = atof(optarg); break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (output.empty()) {
+        usage();
+        return 2;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    try {
+        canlog::Writer writer(output);
+        uint64_t before = writer.records();
+        CanBus bus(ifname);
+        bus.setReceiveBuffer(8 * 1024 * 1024);
+
+        // O callback roda na thread de RX: o writer só é tocado por ela até o stop().
+        // Erro de gravação (ENOSPC...) não pode escapar da thread (std::terminate):
+        // guarda a mensagem, para a gravação e main fecha o arquivo e sai com erro
+        std::string writeError;
+        bus.subscribe(0, 0, [&writer, &writeError](const CanFrame &f) {
+            if (!writeError.empty()) return;
+            try {
+                writer.append(f);
+            } catch (const std::exception &e) {
+                writeError = e.what();
+                stopRequested = true;
+            }
+        });
+
+        struct timespec t0, now;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        fprintf(stderr, "Gravando %s -> %s (Ctrl+C para parar)\n", ifname.c_str(), output.c_str());
+        double elapsed = 0;
+        while (!stopRequested && (duration <= 0 || elapsed < duration)) {
+            usleep(100000);
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            elapsed = (now.tv_sec - t0.tv_sec) + (now.tv_nsec - t0.tv_nsec) / 1e9;
+        }
+
+        bus.stop();
+        if (!writeError.empty()) {
+            fprintf(stderr, "canrec: %s\n", writeError.c_str());
+            try {
+                writer.flush();
+            } catch (const std::exception &) {
+            }
+            return 1;
+        }
+        writer.flush();
+        uint64_t n = writer.records() - before;
+        fprintf(stderr, "%llu frames em %.1f s (%.0f frames/s)\n", static_cast<unsigned long long>(n), elapsed,
+                elapsed > 0 ? n / elapsed : 0.0);
+    } catch (const std::exception &e) {
+        fprintf(stderr, "canrec: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
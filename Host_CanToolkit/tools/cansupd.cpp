@@ -0,0 +1,563 @@
+//═══════════════════════════════════════════════════════════════════════════
+// cansupd - SUPERVISOR DE VÁRIOS CONTAINERS (DAEMON, EPOLL EM UMA THREAD)
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: cansupd -c containers.conf -d canmod-gen1.dbc [-d ...] [-s status_s] [-m endereço ...]
+//              [-C cpu] [-r] [-v]
+//
+// O Controle_NMOG.m sem o menu: um container por interface (arquivo de
+// configuração em include/supervisor.h), todas num único epoll com os
+// sockets CAN_RAW, um timerfd (RTR das temperaturas paradas, status) e um
+// signalfd. Cada frame é decodificado pelo DBC e a decisão sai no mesmo
+// evento, sem pause() nem threads de recepção.
+//
+//   -s  status a cada s segundos (padrão 10; 0 = só no SIGUSR1): estado,
+//       temperaturas, relés, frames/s e latência frame → decisão / → 0x402
+//   -m  métricas do Prometheus em http://endereço/metrics (127.0.0.1:9108,
+//       :9108 ou unix:/run/cansupd.sock; pode repetir). O laço só escreve
+//       em atômicos (include/metrics.h) e o HTTP roda em outra thread:
+//       temperaturas de cada sinal °C do DBC, estado, relés pedidos e os do
+//       eco 0x422, frames rx/tx, erros de envio, TEC/REC/EFLG do 0x42B,
+//       latências e ida-e-volta 0x402 → 0x422 e RTR → 0x510, gravação pelo
+//       bootloader. /healthz: 503 se o laço parar por mais de 1 s
+//   -C  fixa a thread num núcleo
+//   -r  SCHED_FIFO + mlockall
+//   -v  uma linha por transição de estado
+//
+// Sinais: SIGUSR1 = status + último valor de cada sinal do DBC por container;
+// SIGHUP = relê o arquivo (modo, limites, sinais; interfaces não mudam);
+// SIGINT/SIGTERM = todos os relés desligados em cada container e sai.
+//═══════════════════════════════════════════════════════════════════════════
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <exception>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "can_bus.h"
+#include "dbc.h"
+#include "metrics.h"
+#include "metrics_server.h"
+#include "supervisor.h"
+
+namespace {
+
+const size_t kBatch = 32;
+const unsigned kMaxBatchesPerEvent = 8;   // Justiça entre interfaces num barramento cheio
+const unsigned kTickMs = 10;
+const uint64_t kReplyTimeoutNs = 1000000000ull;   // Ida-e-volta sem resposta
+
+// Ponteiros para o Registry (vivem até o fim do main); só o laço escreve
+struct PortMetrics {
+    metrics::Counter *rx, *tx, *sendErrors, *transitions;
+    metrics::Counter *commandTimeouts, *rtrTimeouts;
+    metrics::Gauge *state, *motor, *water, *temperatureAge;
+    metrics::Gauge *decision[4];          // bomba, NA1, NA2, D1/D2
+    metrics::Gauge *relay[8];             // Eco 0x422: 1 = ligado
+    metrics::Gauge *tec, *rec, *eflg, *recoveries, *busLoad, *nodeRx, *nodeTx;
+    metrics::Gauge *flashPhase, *flashAddress, *flashProgress;
+    metrics::Counter *flashSessions;
+    metrics::Histogram *decisionLatency, *actuationLatency, *commandRtt, *rtrRtt;
+    std::vector<std::vector<metrics::Gauge *>> temps;   // [mensagem][sinal] do DBC; só °C
+
+    uint64_t commandSentNs = 0, rtrSentNs = 0;          // Ida-e-volta pendente
+    uint8_t command[2] = {0, 0};
+    uint64_t flashSessionsSeen = 0;
+};
+
+struct Port {
+    std::unique_ptr<CanBus> bus;
+    std::unique_ptr<sup::ContainerSupervisor> sup;
+    std::unique_ptr<PortMetrics> m;  // Só com -m
+    uint64_t windowFrames = 0;       // Frames desde o último status
+    uint64_t sendErrors = 0;
+};
+
+uint64_t realtimeNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+uint64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+[[noreturn]] void throwErrno(const char *what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+void usage() {
+    fprintf(stderr,
+            "Uso: cansupd -c <containers.conf> -d <arquivo.dbc> [-d ...] [-s status_s] [-m endereço ...] "
+            "[-C cpu] [-r] [-v]\n");
+}
+
+bool sendFrame(Port &p, const CanFrame &frame) {
+    try {
+        p.bus->send(frame);
+        if (p.m) p.m->tx->inc();
+        return true;
+    } catch (const std::system_error &e) {
+        // Barramento fora (bus-off, interface down): conta e segue com as outras
+        if (p.m) p.m->sendErrors->inc();
+        if (p.sendErrors++ == 0) fprintf(stderr, "cansupd: %s: %s\n", p.bus->interfaceName().c_str(), e.what());
+        return false;
+    }
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// MÉTRICAS (-m)
+//───────────────────────────────────────────────────────────────────────────
+std::unique_ptr<PortMetrics> makeMetrics(metrics::Registry &r, const sup::ContainerConfig &c,
+                                         const dbc::Database &db) {
+    using metrics::label;
+    using metrics::labels;
+    std::string cl = labels({label("container", c.name), label("interface", c.ifname)});
+    std::string name = label("container", c.name);
+    std::unique_ptr<PortMetrics> m(new PortMetrics());
+
+    m->rx = &r.counter("cansupd_rx_frames_total", "Frames recebidos na interface do container", cl);
+    m->tx = &r.counter("cansupd_tx_frames_total", "Frames enviados (0x402 e RTR)", cl);
+    m->sendErrors = &r.counter("cansupd_send_errors_total", "Envios que falharam (bus-off, interface down)", cl);
+    m->transitions = &r.counter("cansupd_transitions_total", "Transições da máquina de estados", name);
+    m->commandTimeouts = &r.counter("cansupd_reply_timeouts_total", "Pedidos sem resposta em 1 s",
+                                    labels({name, label("command", "0x402")}));
+    m->rtrTimeouts = &r.counter("cansupd_reply_timeouts_total", "Pedidos sem resposta em 1 s",
+                                labels({name, label("command", "rtr")}));
+
+    m->state = &r.gauge("cansupd_state", "Estado do supervisor (1 repouso, 2 filtragem, 3 circulação, 4 descarte)",
+                        name);
+    m->motor = &r.gauge("cansupd_motor_celsius", "Temperatura do motor usada na decisão", name);
+    m->water = &r.gauge("cansupd_water_celsius", "Temperatura da água usada na decisão", name);
+    m->temperatureAge = &r.gauge("cansupd_temperature_age_seconds",
+                                 "Idade da última temperatura (-1 = nenhuma ainda)", name);
+    const char *const outputs[4] = {"bomba", "NA1", "NA2", "D1D2"};
+    for (int i = 0; i < 4; i++)
+        m->decision[i] = &r.gauge("cansupd_output_requested", "Saída pedida pela decisão (1 = ligada)",
+                                  labels({name, label("output", outputs[i])}));
+    for (int i = 0; i < 8; i++)
+        m->relay[i] = &r.gauge("cansupd_relay_on", "Relé no último eco 0x422 do nó (1 = ligado)",
+                               labels({name, label("relay", "D" + std::to_string(i + 1))}));
+
+    m->tec = &r.gauge("cansupd_node_tec", "TEC do MCP2515 do nó (0x42B)", name);
+    m->rec = &r.gauge("cansupd_node_rec", "REC do MCP2515 do nó (0x42B)", name);
+    m->eflg = &r.gauge("cansupd_node_eflg", "EFLG do MCP2515 no último segundo (0x42B)", name);
+    m->recoveries = &r.gauge("cansupd_node_busoff_recoveries", "Reinícios por bus-off desde o boot (0x42B)", name);
+    m->busLoad = &r.gauge("cansupd_node_bus_load_ratio", "Carga do barramento medida pelo nó (0x42B)", name);
+    m->nodeRx = &r.gauge("cansupd_node_rx_frames_per_second", "Frames/s recebidos pelo nó (0x42B)", name);
+    m->nodeTx = &r.gauge("cansupd_node_tx_frames_per_second", "Frames/s enviados pelo nó (0x42B)", name);
+
+    m->flashPhase = &r.gauge("cansupd_flash_phase",
+                             "Gravação pelo bootloader (0 parado, 1 bootloader, 2 gravando, 3 concluído, 4 erro)",
+                             name);
+    m->flashAddress = &r.gauge("cansupd_flash_address_bytes", "Próximo endereço pedido pelo bootloader", name);
+    m->flashProgress = &r.gauge("cansupd_flash_progress_ratio",
+                                "Endereço / tamanho do .hex configurado (-1 = sem firmware no .conf)", name);
+    m->flashSessions = &r.counter("cansupd_flash_sessions_total", "Gravações vistas no barramento", name);
+
+    m->decisionLatency = &r.histogram("cansupd_decision_latency_seconds",
+                                      "Timestamp do kernel da temperatura até a decisão", name);
+    m->actuationLatency = &r.histogram("cansupd_actuation_latency_seconds",
+                                       "Timestamp do kernel da temperatura até o 0x402 sair", name);
+    m->commandRtt = &r.histogram("cansupd_command_rtt_seconds", "Ida-e-volta de um pedido até a resposta do nó",
+                                 labels({name, label("command", "0x402")}));
+    m->rtrRtt = &r.histogram("cansupd_command_rtt_seconds", "Ida-e-volta de um pedido até a resposta do nó",
+                             labels({name, label("command", "rtr")}));
+
+    m->temps.resize(db.messages().size());
+    for (size_t i = 0; i < db.messages().size(); i++) {
+        const dbc::Message &msg = db.messages()[i];
+        for (const auto &sig : msg.signals) {
+            metrics::Gauge *g = nullptr;
+            if (sig.unit == "degC")
+                g = &r.gauge("cansupd_temperature_celsius", "Último valor de cada sinal em °C do DBC",
+                             labels({name, label("message", msg.name), label("signal", sig.name)}));
+            m->temps[i].push_back(g);
+        }
+    }
+    m->temperatureAge->set(-1);
+    m->flashProgress->set(-1);
+    return m;
+}
+
+// Depois de onFrame: telemetria, respostas às idas-e-voltas pendentes
+void observeFrame(Port &p, const dbc::Database &db, const CanFrame &f, uint64_t nowNs) {
+    PortMetrics &m = *p.m;
+    if (f.remote || f.echo) return;
+    uint64_t at = f.timestampNs ? f.timestampNs : nowNs;
+    const sup::ContainerConfig &c = p.sup->config();
+
+    if (f.extended) {
+        // Só o DBC pode ter estendidos com °C; 0x42x e temperaturas são padrão
+    } else if (f.id == c.tempId) {
+        if (f.timestampNs && nowNs > f.timestampNs) m.decisionLatency->observe((nowNs - f.timestampNs) / 1e9);
+        if (m.rtrSentNs) {
+            if (at > m.rtrSentNs) m.rtrRtt->observe((at - m.rtrSentNs) / 1e9);
+            m.rtrSentNs = 0;
+        }
+    } else if (f.id == proto::kDigitalEchoId) {
+        proto::DigitalState s = proto::decodeDigital(f);
+        for (int i = 0; i < 8; i++) m.relay[i]->set(s.relays[i] == proto::RelayOn ? 1 : 0);
+        if (m.commandSentNs && f.data[0] == m.command[0] && f.data[1] == m.command[1]) {
+            if (at > m.commandSentNs) m.commandRtt->observe((at - m.commandSentNs) / 1e9);
+            m.commandSentNs = 0;
+        }
+    } else if (f.id == proto::kBusHealthId) {
+        busHealthStructure h = proto::decodeBusHealth(f);
+        m.tec->set(h.tec);
+        m.rec->set(h.rec);
+        m.eflg->set(h.eflg);
+        m.recoveries->set(h.recoveries);
+        m.busLoad->set(h.loadPermille / 1000.0);
+        m.nodeRx->set(h.rxPerS);
+        m.nodeTx->set(h.txPerS);
+    }
+
+    const dbc::Message *msg = db.find(f.id, f.extended);
+    if (!msg) return;
+    size_t idx = msg - db.messages().data();
+    const std::vector<metrics::Gauge *> &gauges = m.temps[idx];
+    const sup::Telemetry &t = p.sup->telemetry()[idx];
+    for (size_t i = 0; i < gauges.size(); i++) {
+        if (gauges[i]) gauges[i]->set(t.values[i]);
+    }
+}
+
+void observeSent(PortMetrics &m, const CanFrame &cause, const CanFrame &out, uint64_t sentNs) {
+    if (cause.timestampNs && sentNs > cause.timestampNs)
+        m.actuationLatency->observe((sentNs - cause.timestampNs) / 1e9);
+    m.commandSentNs = sentNs;
+    m.command[0] = out.data[0];
+    m.command[1] = out.data[1];
+}
+
+// No timer: gauges do estado e prazos das idas-e-voltas
+void updateMetrics(Port &p, uint64_t nowNs) {
+    PortMetrics &m = *p.m;
+    const sup::ContainerSupervisor &s = *p.sup;
+    const sup::Decision &d = s.decision();
+    m.state->set(s.state());
+    m.motor->set(s.motor());
+    m.water->set(s.water());
+    if (s.hasTemperature() && nowNs >= s.lastTemperatureNs())
+        m.temperatureAge->set((nowNs - s.lastTemperatureNs()) / 1e9);
+    m.decision[0]->set(d.pump);
+    m.decision[1]->set(d.circulation);
+    m.decision[2]->set(d.discard);
+    m.decision[3]->set(d.emergency);
+
+    const sup::FlashMonitor &fm = s.flash();
+    m.flashPhase->set(fm.phase());
+    m.flashAddress->set(fm.address());
+    m.flashProgress->set(fm.progress());
+    if (fm.sessions() != m.flashSessionsSeen) {
+        m.flashSessions->inc(fm.sessions() - m.flashSessionsSeen);
+        m.flashSessionsSeen = fm.sessions();
+    }
+
+    if (m.commandSentNs && nowNs - m.commandSentNs > kReplyTimeoutNs) {
+        m.commandTimeouts->inc();
+        m.commandSentNs = 0;
+    }
+    if (m.rtrSentNs && nowNs - m.rtrSentNs > kReplyTimeoutNs) {
+        m.rtrTimeouts->inc();
+        m.rtrSentNs = 0;
+    }
+}
+
+void printStatus(std::vector<Port> &ports, double windowS, uint64_t nowNs) {
+    for (Port &p : ports) {
+        sup::ContainerSupervisor &s = *p.sup;
+        const sup::Decision &d = s.decision();
+        char temps[64];
+        if (s.hasTemperature()) {
+            snprintf(temps, sizeof(temps), "motor %6.1f água %6.1f (%.1f s)", s.motor(), s.water(),
+                     (nowNs - s.lastTemperatureNs()) / 1e9);
+        } else {
+            snprintf(temps, sizeof(temps), "sem temperatura");
+        }
+        sup::LatencyHistogram &dl = s.decisionLatency();
+        sup::LatencyHistogram &al = s.actuationLatency();
+        printf("[%s %s] %-14s %-13s %s | bomba %d NA1 %d NA2 %d D1/D2 %d | %.0f frames/s | "
+               "decisão p50 %lu p99 %lu máx %lu us | 0x402 %lu (p99 %lu us) | RTR %lu\n",
+               s.config().name.c_str(), s.config().ifname.c_str(), sup::modeName(s.config().mode),
+               sup::stateName(s.state()), temps, d.pump, d.circulation, d.discard, d.emergency,
+               windowS > 0 ? p.windowFrames / windowS : 0.0, static_cast<unsigned long>(dl.percentile(0.5)),
+               static_cast<unsigned long>(dl.percentile(0.99)), static_cast<unsigned long>(dl.max()),
+               static_cast<unsigned long>(s.commands()), static_cast<unsigned long>(al.percentile(0.99)),
+               static_cast<unsigned long>(s.requests()));
+        if (p.sendErrors) printf("[%s] %lu envios falharam\n", s.config().name.c_str(),
+                                 static_cast<unsigned long>(p.sendErrors));
+        p.windowFrames = 0;
+        dl.clear();
+        al.clear();
+    }
+    fflush(stdout);
+}
+
+void printTelemetry(const std::vector<Port> &ports) {
+    for (const Port &p : ports) {
+        const sup::ContainerSupervisor &s = *p.sup;
+        printf("[%s] %lu frames, %lu fora do DBC, %lu transições\n", s.config().name.c_str(),
+               static_cast<unsigned long>(s.frames()), static_cast<unsigned long>(s.unknown()),
+               static_cast<unsigned long>(s.transitions()));
+        for (const sup::Telemetry &t : s.telemetry()) {
+            if (!t.frames) continue;
+            printf("  0x%03X %-18s", t.message->id, t.message->name.c_str());
+            for (size_t i = 0; i < t.values.size(); i++)
+                printf(" %s=%g", t.message->signals[i].name.c_str(), t.values[i]);
+            printf("\n");
+        }
+    }
+    fflush(stdout);
+}
+
+void reload(const std::string &path, std::vector<Port> &ports) {
+    std::vector<sup::ContainerConfig> configs;
+    try {
+        configs = sup::parseConfig(path);
+    } catch (const std::exception &e) {
+        fprintf(stderr, "cansupd: recarga ignorada: %s\n", e.what());
+        return;
+    }
+    for (const auto &c : configs) {
+        bool found = false;
+        for (Port &p : ports) {
+            if (p.sup->config().ifname != c.ifname) continue;
+            found = true;
+            try {
+                p.sup->reconfigure(c);
+                printf("[%s] recarregado: %s, limites %.1f/%.1f\n", c.name.c_str(), sup::modeName(c.mode),
+                       c.motorLimit, c.waterLimit);
+            } catch (const std::exception &e) {
+                fprintf(stderr, "cansupd: %s\n", e.what());
+            }
+        }
+        if (!found) fprintf(stderr, "cansupd: %s (%s) é novo: reinicie para incluir\n", c.name.c_str(), c.ifname.c_str());
+    }
+    fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string configPath;
+    std::vector<std::string> dbcFiles, metricsAddrs;
+    unsigned statusS = 10;
+    int cpu = -1;
+    bool realtime = false, verbose = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:d:s:m:C:rvh")) != -1) {
+        switch (opt) {
+            case 'c': configPath = optarg; break;
+            case 'd': dbcFiles.push_back(optarg); break;
+            case 's': statusS = static_cast<unsigned>(atoi(optarg)); break;
+            case 'm': metricsAddrs.push_back(optarg); break;
+            case 'C': cpu = atoi(optarg); break;
+            case 'r': realtime = true; break;
+            case 'v': verbose = true; break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (configPath.empty() || dbcFiles.empty()) {
+        usage();
+        return 2;
+    }
+
+    try {
+        dbc::Database db;
+        for (const auto &f : dbcFiles) db.load(f);
+
+        // Registro antes do servidor (o servidor lê dele até o stop)
+        metrics::Registry registry;
+        metrics::Gauge &heartbeat =
+            registry.gauge("cansupd_heartbeat_seconds", "CLOCK_MONOTONIC da última volta do timer do laço");
+        std::vector<Port> ports;
+        for (const auto &c : sup::parseConfig(configPath)) {
+            Port p;
+            p.sup.reset(new sup::ContainerSupervisor(c, db));
+            p.bus.reset(new CanBus(c.ifname));
+            p.bus->setReceiveBuffer(1 << 20);
+            if (!metricsAddrs.empty()) p.m = makeMetrics(registry, c, db);
+            ports.push_back(std::move(p));
+        }
+
+        metrics::Server server(registry);
+        if (!metricsAddrs.empty()) {
+            for (const auto &a : metricsAddrs) server.listen(a);
+            // Thread do servidor: só atômicos, nada do estado do laço
+            server.setHealth([&heartbeat](std::string &reason) {
+                double idle = monotonicNs() / 1e9 - heartbeat.value();
+                if (idle < 1.0) return true;
+                char buf[64];
+                snprintf(buf, sizeof(buf), "laço parado há %.1f s", idle);
+                reason = buf;
+                return false;
+            });
+            heartbeat.set(monotonicNs() / 1e9);
+            server.start();
+        }
+
+        if (cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            if (sched_setaffinity(0, sizeof(set), &set) < 0)
+                fprintf(stderr, "aviso: núcleo %d indisponível (%s)\n", cpu, strerror(errno));
+        }
+        if (realtime) {
+            struct sched_param sp;
+            sp.sched_priority = 50;
+            if (sched_setscheduler(0, SCHED_FIFO, &sp) < 0 || mlockall(MCL_CURRENT | MCL_FUTURE) < 0)
+                fprintf(stderr, "aviso: prioridade de tempo real indisponível (%s)\n", strerror(errno));
+        }
+
+        // Sinais pelo epoll: nada roda em contexto de handler
+        sigset_t mask;
+        sigemptyset(&mask);
+        for (int sig : {SIGINT, SIGTERM, SIGHUP, SIGUSR1}) sigaddset(&mask, sig);
+        if (sigprocmask(SIG_BLOCK, &mask, nullptr) < 0) throwErrno("sigprocmask");
+        int sigFd = signalfd(-1, &mask, SFD_CLOEXEC | SFD_NONBLOCK);
+        if (sigFd < 0) throwErrno("signalfd");
+
+        int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        if (timerFd < 0) throwErrno("timerfd_create");
+        struct itimerspec its;
+        its.it_interval.tv_sec = 0;
+        its.it_interval.tv_nsec = kTickMs * 1000000L;
+        its.it_value = its.it_interval;
+        if (timerfd_settime(timerFd, 0, &its, nullptr) < 0) throwErrno("timerfd_settime");
+
+        int ep = epoll_create1(EPOLL_CLOEXEC);
+        if (ep < 0) throwErrno("epoll_create1");
+        // data.u32: índice da porta; sinais e timer depois das portas
+        const uint32_t kSignalTag = static_cast<uint32_t>(ports.size());
+        const uint32_t kTimerTag = kSignalTag + 1;
+        auto add = [ep](int fd, uint32_t tag) {
+            struct epoll_event ev;
+            memset(&ev, 0, sizeof(ev));
+            ev.events = EPOLLIN;
+            ev.data.u32 = tag;
+            if (epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev) < 0) throwErrno("epoll_ctl");
+        };
+        for (uint32_t i = 0; i < ports.size(); i++) add(ports[i].bus->fd(), i);
+        add(sigFd, kSignalTag);
+        add(timerFd, kTimerTag);
+
+        printf("cansupd: %zu containers, %zu mensagens no DBC\n", ports.size(), db.messages().size());
+        for (const Port &p : ports) {
+            const sup::ContainerConfig &c = p.sup->config();
+            printf("  %s em %s: %s, limites %.1f/%.1f °C, temperaturas 0x%03X %s/%s\n", c.name.c_str(),
+                   c.ifname.c_str(), sup::modeName(c.mode), c.motorLimit, c.waterLimit, c.tempId,
+                   c.motorSignal.c_str(), c.waterSignal.c_str());
+        }
+        for (const auto &a : metricsAddrs) printf("  métricas em %s\n", a.c_str());
+        fflush(stdout);
+
+        CanFrame frames[kBatch];
+        struct epoll_event events[16];
+        uint64_t lastStatus = monotonicNs();
+        bool running = true;
+
+        while (running) {
+            int n = epoll_wait(ep, events, 16, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throwErrno("epoll_wait");
+            }
+            for (int e = 0; e < n; e++) {
+                uint32_t tag = events[e].data.u32;
+                if (tag < kSignalTag) {
+                    Port &p = ports[tag];
+                    for (unsigned b = 0; b < kMaxBatchesPerEvent; b++) {
+                        size_t got = p.bus->receiveBatch(frames, kBatch);
+                        if (!got) break;
+                        p.windowFrames += got;
+                        if (p.m) p.m->rx->inc(got);
+                        for (size_t i = 0; i < got; i++) {
+                            CanFrame out;
+                            sup::State before = p.sup->state();
+                            uint64_t now = realtimeNs();
+                            bool send = p.sup->onFrame(frames[i], now, out);
+                            if (p.m) observeFrame(p, db, frames[i], now);
+                            if (send && sendFrame(p, out)) {
+                                uint64_t sent = realtimeNs();
+                                p.sup->onSent(frames[i], sent);
+                                if (p.m) observeSent(*p.m, frames[i], out, sent);
+                            } else if (send) {
+                                p.sup->invalidateOutputs();
+                            }
+                            if (p.m && p.sup->state() != before) p.m->transitions->inc();
+                            if (verbose && p.sup->state() != before) {
+                                printf("[%s] %s → %s (motor %.1f, água %.1f)\n", p.sup->config().name.c_str(),
+                                       sup::stateName(before), sup::stateName(p.sup->state()), p.sup->motor(),
+                                       p.sup->water());
+                                fflush(stdout);
+                            }
+                        }
+                        if (got < kBatch) break;
+                    }
+                } else if (tag == kTimerTag) {
+                    uint64_t expirations;
+                    if (read(timerFd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN)
+                        fprintf(stderr, "cansupd: timerfd: %s\n", strerror(errno));
+                    uint64_t now = realtimeNs();
+                    for (Port &p : ports) {
+                        CanFrame out;
+                        if (p.sup->tick(now, out) && sendFrame(p, out) && p.m && !p.m->rtrSentNs)
+                            p.m->rtrSentNs = now;
+                        if (p.m) updateMetrics(p, now);
+                    }
+                    uint64_t mono = monotonicNs();
+                    heartbeat.set(mono / 1e9);
+                    if (statusS && mono - lastStatus >= statusS * 1000000000ull) {
+                        printStatus(ports, (mono - lastStatus) / 1e9, now);
+                        lastStatus = mono;
+                    }
+                } else {
+                    struct signalfd_siginfo si;
+                    while (read(sigFd, &si, sizeof(si)) == sizeof(si)) {
+                        if (si.ssi_signo == SIGUSR1) {
+                            uint64_t mono = monotonicNs();
+                            printStatus(ports, (mono - lastStatus) / 1e9, realtimeNs());
+                            lastStatus = mono;
+                            printTelemetry(ports);
+                        } else if (si.ssi_signo == SIGHUP) {
+                            reload(configPath, ports);
+                        } else {
+                            running = false;
+                        }
+                    }
+                }
+            }
+        }
+
+        // desligarSeguro do .m, em todos os containers
+        for (Port &p : ports) sendFrame(p, sup::ContainerSupervisor::allOff());
+        server.stop();
+        printf("cansupd: relés desligados, saindo\n");
+        close(ep);
+        close(timerFd);
+        close(sigFd);
+    } catch (const std::exception &e) {
+        fprintf(stderr, "cansupd: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
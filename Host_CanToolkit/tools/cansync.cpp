@@ -0,0 +1,259 @@
+//═══════════════════════════════════════════════════════════════════════════
+// cansync - MESTRE DE TEMPO DO BARRAMENTO (SYNC 0x080 + FOLLOW-UP 0x081)
+//═══════════════════════════════════════════════════════════════════════════
+// Uso: cansync -i can0 [-i can1 ...] [-p período_ms] [-n SYNCs] [-S] [-v]
+//      cansync -N -i vcan0 [-d ppm] [-j µs]
+//
+// Mestre: a cada período manda o SYNC [seq] em todas as interfaces, pega o
+// instante real de saída pelo eco do kernel (CanBus::setReceiveOwn) e manda
+// esse t1 (µs Unix, CLOCK_REALTIME) no FOLLOW-UP. Os nós respondem com o
+// 0x431; a cada 10 s sai uma linha por interface com o erro medido antes
+// da correção (médio e máximo) e o drift. Com duas interfaces no mesmo
+// host a referência é a mesma: os dois containers ficam no mesmo relógio.
+//
+//   -p  período do SYNC (padrão 1000 ms)
+//   -n  para depois de n SYNCs (0 = até Ctrl+C)
+//   -S  mostra as amostras 0x432 (sync.stamp = 1 no nó) com o tempo completo
+//   -v  uma linha por 0x431
+//
+// -N: nó simulado para testar em vcan sem placa. Roda o TimeSync do
+// firmware (Firmware_CanInput/include/timesync.h) com um relógio local
+// adiantado em -d ppm (padrão 80) e -j µs de jitter no t2, e responde o
+// 0x431 como o nó faria.
+//═══════════════════════════════════════════════════════════════════════════
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "can_bus.h"
+#include "protocol.h"
+#include "timesync.h"
+
+static std::atomic<bool> stopFlag{false};
+
+static void onSignal(int) { stopFlag = true; }
+
+static void usage() {
+    fprintf(stderr,
+            "Uso: cansync -i <interface> [-i <interface>...] [-p período_ms] [-n SYNCs] [-S] [-v]\n"
+            "     cansync -N -i <interface> [-d ppm] [-j us]\n");
+}
+
+static uint64_t realtimeUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static uint64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static const char *stateName(uint8_t state) {
+    static const char *const names[] = {"sem sync", "adquirindo", "travado", "holdover"};
+    return state < 4 ? names[state] : "?";
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// MESTRE
+//───────────────────────────────────────────────────────────────────────────
+struct Port {
+    std::unique_ptr<CanBus> bus;
+    std::mutex mutex;           // Estatística do 0x431 (thread de RX)
+    uint64_t followUps = 0, missedEchoes = 0;
+    uint64_t reports = 0;
+    double sumAbs = 0;
+    int maxAbs = 0;
+    timeSyncStatusStructure last;
+};
+
+static int runMaster(const std::vector<std::string> &ifnames, unsigned periodMs, unsigned count,
+                     bool showStamped, bool verbose) {
+    std::vector<std::unique_ptr<Port>> ports;
+    for (const auto &name : ifnames) {
+        std::unique_ptr<Port> port(new Port);
+        port->bus.reset(new CanBus(name));
+        port->bus->setReceiveOwn(true);
+        Port *p = port.get();
+        const std::string ifname = name;
+
+        // Eco do SYNC: instante em que o frame saiu de verdade
+        p->bus->subscribe(proto::kTimeSyncId, 0x7FF, [p](const CanFrame &f) {
+            if (!f.echo || f.dlc < 1) return;
+            if (!f.timestampNs) {
+                p->missedEchoes++;
+                return;
+            }
+            p->bus->send(proto::encodeTimeFollowUp(f.data[0], f.timestampNs / 1000));
+            p->followUps++;
+        });
+        p->bus->subscribe(proto::kTimeSyncStatusId, 0x7FF, [p, ifname, verbose](const CanFrame &f) {
+            if (f.echo || f.dlc < 8) return;
+            timeSyncStatusStructure s = proto::decodeTimeSyncStatus(f);
+            std::lock_guard<std::mutex> lock(p->mutex);
+            p->last = s;
+            p->reports++;
+            p->sumAbs += abs(s.offsetUs);
+            if (abs(s.offsetUs) > p->maxAbs) p->maxAbs = abs(s.offsetUs);
+            if (verbose) {
+                printf("%s seq %3u %-10s erro %+6d us  drift %+8.1f ppm  rejeitados %u\n", ifname.c_str(), s.seq,
+                       stateName(s.state), s.offsetUs, s.drift01ppm / 10.0, s.rejected);
+                fflush(stdout);
+            }
+        });
+        if (showStamped) {
+            p->bus->subscribe(proto::kStampedSampleId, 0x7FF, [ifname](const CanFrame &f) {
+                if (f.echo || f.dlc < 8) return;
+                stampedSampleStructure s = proto::decodeStampedSample(f);
+                uint64_t near = f.timestampNs ? f.timestampNs / 1000 : realtimeUs();
+                uint64_t t = proto::expandStampedTime(s.timeUs, near);
+                time_t sec = static_cast<time_t>(t / 1000000);
+                struct tm tm;
+                localtime_r(&sec, &tm);
+                printf("%s %02d:%02d:%02d.%06u canal %u valor %d (recebido %+.3f ms depois)\n", ifname.c_str(),
+                       tm.tm_hour, tm.tm_min, tm.tm_sec, static_cast<unsigned>(t % 1000000), s.channel, s.value,
+                       (static_cast<int64_t>(near) - static_cast<int64_t>(t)) / 1000.0);
+                fflush(stdout);
+            });
+        }
+        ports.push_back(std::move(port));
+    }
+
+    uint8_t seq = 0;
+    unsigned sent = 0;
+    auto next = std::chrono::steady_clock::now();
+    auto nextReport = next + std::chrono::seconds(10);
+    while (!stopFlag && (!count || sent < count)) {
+        for (auto &p : ports) p->bus->send(proto::encodeTimeSync(seq));
+        seq++;
+        sent++;
+        next += std::chrono::milliseconds(periodMs);
+        std::this_thread::sleep_until(next);
+
+        if (std::chrono::steady_clock::now() >= nextReport || stopFlag || (count && sent >= count)) {
+            nextReport += std::chrono::seconds(10);
+            for (size_t i = 0; i < ports.size(); i++) {
+                Port &p = *ports[i];
+                std::lock_guard<std::mutex> lock(p.mutex);
+                if (!p.reports) {
+                    printf("%s: %lu FOLLOW-UPs, nenhum 0x431\n", ifnames[i].c_str(),
+                           static_cast<unsigned long>(p.followUps));
+                } else {
+                    printf("%s: %-10s erro médio %.1f us, máx %d us, drift %+.1f ppm (%lu pares, %u rejeitados)\n",
+                           ifnames[i].c_str(), stateName(p.last.state), p.sumAbs / p.reports, p.maxAbs,
+                           p.last.drift01ppm / 10.0, static_cast<unsigned long>(p.reports), p.last.rejected);
+                }
+                if (p.missedEchoes) printf("%s: %lu ecos sem timestamp do kernel\n", ifnames[i].c_str(),
+                                           static_cast<unsigned long>(p.missedEchoes));
+                p.reports = 0;
+                p.sumAbs = 0;
+                p.maxAbs = 0;
+            }
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
+
+//───────────────────────────────────────────────────────────────────────────
+// NÓ SIMULADO (-N)
+//───────────────────────────────────────────────────────────────────────────
+static int runNode(const std::string &ifname, double ppm, unsigned jitterUs) {
+    CanBus bus(ifname);
+    TimeSync sync;
+    std::mutex mutex;
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> jitter(0, static_cast<int>(jitterUs));
+    const uint64_t origin = monotonicUs();
+
+    // micros() de um nó com cristal fora de ppm
+    auto localUs = [&](uint64_t monoUs) {
+        return static_cast<uint32_t>(llround((monoUs - origin) * (1.0 + ppm * 1e-6)));
+    };
+
+    bus.subscribe(proto::kTimeSyncId, 0x7FF, [&](const CanFrame &f) {
+        if (f.dlc < 1) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        sync.onSync(f.data[0], localUs(monotonicUs()) + jitter(rng), true);
+    });
+    bus.subscribe(proto::kTimeFollowUpId, 0x7FF, [&](const CanFrame &f) {
+        if (f.dlc < 8) return;
+        uint8_t seq;
+        uint64_t t1 = readTimeFollowUp(f.data, seq);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!sync.onFollowUp(seq, t1)) return;
+        timeSyncStatusStructure s;
+        int32_t err = sync.lastErrorUs();
+        s.state = sync.state();
+        s.seq = sync.seq();
+        s.offsetUs = static_cast<int16_t>(err > 32767 ? 32767 : err < -32768 ? -32768 : err);
+        s.drift01ppm = static_cast<int16_t>(sync.driftPpb() / 100);
+        s.rejected = sync.rejected();
+        s.samples = sync.samples();
+        CanFrame out;
+        out.id = proto::kTimeSyncStatusId;
+        out.dlc = 8;
+        sendTimeSyncStatus(s, out.data);
+        bus.send(out);
+    });
+
+    printf("nó simulado em %s: relógio %+.1f ppm, jitter %u us\n", ifname.c_str(), ppm, jitterUs);
+    fflush(stdout);
+    while (!stopFlag) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::lock_guard<std::mutex> lock(mutex);
+        sync.poll(localUs(monotonicUs()));
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> ifnames;
+    unsigned periodMs = 1000, count = 0, jitterUs = 20;
+    double ppm = 80;
+    bool node = false, showStamped = false, verbose = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:p:n:d:j:NSvh")) != -1) {
+        switch (opt) {
+            case 'i': ifnames.push_back(optarg); break;
+            case 'p': periodMs = static_cast<unsigned>(atoi(optarg)); break;
+            case 'n': count = static_cast<unsigned>(atoi(optarg)); break;
+            case 'd': ppm = atof(optarg); break;
+            case 'j': jitterUs = static_cast<unsigned>(atoi(optarg)); break;
+            case 'N': node = true; break;
+            case 'S': showStamped = true; break;
+            case 'v': verbose = true; break;
+            default: usage(); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (ifnames.empty()) ifnames.push_back("can0");
+    if (!periodMs || (node && ifnames.size() != 1)) {
+        usage();
+        return 2;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    try {
+        return node ? runNode(ifnames[0], ppm, jitterUs) : runMaster(ifnames, periodMs, count, showStamped, verbose);
+    } catch (const std::exception &e) {
+        fprintf(stderr, "cansync: %s\n", e.what());
+        return 1;
+    }
+}
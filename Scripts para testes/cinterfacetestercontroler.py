@@ -1,38 +1,15 @@
 import tkinter as tk
 from tkinter import ttk
-from dataclasses import dataclass
-import can
-import threading
-
-# ==== CAN Structs ====
-@dataclass
-class AquisitionConfigStructure:
-    Aquics_Enable_Continuous: int = 0
-    Aquics_Enable: int = 0
-    analog: bool = False
-    timer: int = 1000  # milliseconds
-
-def send_aquisition_config(aquisc: AquisitionConfigStructure) -> bytearray:
-    tx_buf = bytearray(8)
-    tx_buf[0] = (aquisc.timer >> 8) & 0xFF
-    tx_buf[1] = aquisc.timer & 0xFF
-    tx_buf[2] = int(aquisc.analog) & 0x01
-    tx_buf[3] = aquisc.Aquics_Enable_Continuous & 0x03
-    for i in range(4, 8):   
-        tx_buf[i] = 0x00
-    return tx_buf
-
-def send_digital(digital_command, PWM1, PWM2, Enc):
-    tx_buf = bytearray(5)
-    tx_buf[0] = (digital_command[0] << 6) | (digital_command[1] << 4) | (digital_command[2] << 2) | digital_command[3]
-    tx_buf[1] = (digital_command[4] << 6) | (digital_command[5] << 4) | (digital_command[6] << 2) | digital_command[7]
-    tx_buf[2] = PWM1
-    tx_buf[3] = PWM2
-    tx_buf[4] = Enc
-    tx_buf[5] = 0
-    tx_buf[6] = 0
-    tx_buf[7] = 0
-    return tx_buf
+import os
+import sys
+
+# ==== CAN (Host_CanToolkit) ====
+# Conexão SocketCAN única e codecs do firmware (config.cpp) via libcantoolkit
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Host_CanToolkit", "python"))
+import cantoolkit
+from cantoolkit import send_aquisition_config, send_digital, send_start_stop
+
+CAN_CHANNEL = "can0"
 
 # ==== GUI App ====
 class CANConfigGUI:
@@ -49,6 +26,8 @@ class CANConfigGUI:
         self.enc_var = tk.IntVar(value=0)
         self.led_vars = [tk.IntVar(value=0) for _ in range(8)]
 
+        self.bus = cantoolkit.shared_bus(CAN_CHANNEL)
+
         self.build_gui()
         self.start_can_listener()
 
@@ -91,19 +70,16 @@ class CANConfigGUI:
         self.msg_box.configure(state='disabled')
 
     def send_can_config(self):
-        config = AquisitionConfigStructure(
-            Aquics_Enable_Continuous=self.enable_continuous_var.get(),
-            Aquics_Enable=self.enable_once_var.get(),
-            analog=self.analog_var.get(),
-            timer=self.timer_var.get()
-        )
-        data = send_aquisition_config(config)
+        data = send_aquisition_config(self.timer_var.get(), self.analog_var.get(),
+                                      self.enable_continuous_var.get())
         try:
-            bus = can.interface.Bus(channel='can0', bustype='socketcan')
-            msg = can.Message(arbitration_id=0x404, data=data, is_extended_id=False)
-            bus.send(msg)
+            # Config + Enable Once (0x405) saem juntos numa única chamada ao kernel
+            frames = [(0x404, data)]
+            if self.enable_once_var.get():
+                frames.append((0x405, send_start_stop(True)))
+            self.bus.send_batch(frames)
             self.status.config(text="Status: Configuração enviada", foreground="green")
-        except can.CanError as e:
+        except cantoolkit.CanError as e:
             self.status.config(text=f"Erro ao enviar: {e}", foreground="red")
 
     def send_digital_cmd(self):
@@ -113,24 +89,19 @@ class CANConfigGUI:
         enc = self.enc_var.get()
         data = send_digital(digital_command, pwm1, pwm2, enc)
         try:
-            bus = can.interface.Bus(channel='can0', bustype='socketcan')
-            msg = can.Message(arbitration_id=0x402, data=data, is_extended_id=False)
-            bus.send(msg)
+            self.bus.send(0x402, data)
             self.status.config(text="Status: LEDs + PWM enviados", foreground="green")
-        except can.CanError as e:
+        except cantoolkit.CanError as e:
             self.status.config(text=f"Erro ao enviar: {e}", foreground="red")
 
     def start_can_listener(self):
-        def listener():
-            bus = can.interface.Bus(channel='can0', bustype='socketcan')
-            for msg in bus:
-                self.msg_box.configure(state='normal')
-                self.msg_box.insert(tk.END, f"ID: {hex(msg.arbitration_id)} | Data: {msg.data.hex()}\n")
-                self.msg_box.see(tk.END)
-                self.msg_box.configure(state='disabled')
-
-        thread = threading.Thread(target=listener, daemon=True)
-        thread.start()
+        def listener(msg):
+            self.msg_box.configure(state='normal')
+            self.msg_box.insert(tk.END, f"ID: {hex(msg.arbitration_id)} | Data: {msg.data.hex()}\n")
+            self.msg_box.see(tk.END)
+            self.msg_box.configure(state='disabled')
+
+        self.bus.subscribe(listener)
 
 # ==== Run ====
 if __name__ == "__main__":
@@ -52,4 +52,18 @@ if [ -n "$RESPONSE" ]; then
     echo "$RESPONSE"
 else
     echo "✗ Sem resposta"
-fi
\ No newline at end of file
+fi
+
+# Saúde do barramento vista pelo nó (0x42B: TEC REC EFLG reinícios carga‰ RX/16 TX)
+echo
+echo "Saúde do barramento (nó)..."
+cansend can0 40B#R &
+HEALTH=$(timeout 2 candump can0 2>/dev/null | grep -m 1 " 42B ")
+if [ -n "$HEALTH" ]; then
+    read -r -a B <<< "$(echo "$HEALTH" | sed 's/.*\] *//')"
+    echo "  TEC=$((16#${B[0]})) REC=$((16#${B[1]})) EFLG=0x${B[2]} reinícios=$((16#${B[3]}))"
+    echo "  carga=$(( (16#${B[4]}${B[5]}) / 10 )).$(( (16#${B[4]}${B[5]}) % 10 ))% RX=$((16#${B[6]} * 16))/s TX=$((16#${B[7]}))/s"
+    if (( (16#${B[2]} & 0x20) != 0 )); then echo "✗ Nó em BUS-OFF"; fi
+else
+    echo "✗ Sem 0x42B"
+fi
@@ -1,90 +1,17 @@
 import tkinter as tk
 from tkinter import ttk
-from dataclasses import dataclass
-import can
-import threading
+import os
+import sys
 
-# ==== CAN Structs ====
-@dataclass
-class AquisitionConfigStructure:
-    Aquics_Enable_Continuous: int = 0
-    Aquics_Enable: int = 0
-    analog: bool = False
-    timer: int = 1000  # milliseconds
+# ==== CAN (Host_CanToolkit) ====
+# Conexão SocketCAN única e codecs do firmware (config.cpp) via libcantoolkit
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Host_CanToolkit", "python"))
+import cantoolkit
+from cantoolkit import (read_digital, read_pwm_enc as readPWMEnc, send_digital,
+                        send_safety_pair, read_safety_pair, send_aquisition_config,
+                        aquisition_config, send_start_stop)
 
-@dataclass
-class SafetyConfigStructure:
-    Monit_Enable: int = 0
-    maxtemp: float = 40.0
-    timer: int = 1000  # milliseconds
-
-def send_aquisition_config(aquisc: AquisitionConfigStructure) -> bytearray:
-    tx_buf = bytearray(8)
-    tx_buf[0] = (aquisc.timer >> 8) & 0xFF
-    tx_buf[1] = aquisc.timer & 0xFF
-    tx_buf[2] = int(aquisc.analog) & 0x01
-    tx_buf[3] = aquisc.Aquics_Enable_Continuous & 0x03
-    for i in range(4, 8):
-        tx_buf[i] = 0x00
-    return tx_buf
-
-def send_digital(digital_command, PWM1, PWM2, Enc):
-    tx_buf = bytearray(5)
-    tx_buf[0] = (digital_command[0] << 6) | (digital_command[1] << 4) | (digital_command[2] << 2) | digital_command[3]
-    tx_buf[1] = (digital_command[4] << 6) | (digital_command[5] << 4) | (digital_command[6] << 2) | digital_command[7]
-    tx_buf[2] = PWM1
-    tx_buf[3] = PWM2
-    tx_buf[4] = Enc
-    return tx_buf
-
-def send_safety_config(config: SafetyConfigStructure) -> bytearray:
-    tx_buf = bytearray(4)
-    tx_buf[0] = 0x12
-    tx_buf[1] = 0x30 | (config.Monit_Enable & 0x03)
-    tx_buf[2] = int((config.maxtemp * 255) / 120)
-    tx_buf[3] = int((config.timer * 255) / 10000)
-    return tx_buf
-
-def read_digital(buf: bytes) -> list[int]:
-    return [
-        (buf[0] >> 6) & 0x03,
-        (buf[0] >> 4) & 0x03,
-        (buf[0] >> 2) & 0x03,
-        buf[0] & 0x03,
-        (buf[1] >> 6) & 0x03,
-        (buf[1] >> 4) & 0x03,
-        (buf[1] >> 2) & 0x03,
-        buf[1] & 0x03
-    ]
-
-def readPWMEnc(buf: bytes, index: int) -> int:
-    value = buf[index]
-    if value <= 250:
-        return (value * 255) // 250
-    elif value == 255:
-        return -2
-    elif value >= 251:
-        return -1
-    else:
-        return 255
-
-def aquisition_config(buf: bytes) -> AquisitionConfigStructure:
-    timer = (buf[0] << 8) | buf[1]
-    analog = bool(buf[2] & 0x01)
-    enable = buf[3] & 0x03
-    return AquisitionConfigStructure(
-        Aquics_Enable_Continuous=buf[3] & 0x03,
-        Aquics_Enable=enable,
-        analog=analog,
-        timer=timer
-    )
-
-def safety_config(buf: bytes) -> SafetyConfigStructure:
-    check_id = (buf[0] << 4) | (buf[1] >> 4)
-    monit = buf[1] & 0x03
-    maxtemp = (buf[2] * 120) / 255
-    timer = (buf[3] * 10000) // 255
-    return SafetyConfigStructure(Monit_Enable=monit, maxtemp=maxtemp, timer=timer)
+CAN_CHANNEL = "can0"
 
 
 # ==== GUI App ====
@@ -115,6 +42,8 @@ class CANConfigGUI:
         self.save_to_eeprom1 = tk.BooleanVar(value=False)
         self.save_to_eeprom2 = tk.BooleanVar(value=False)
 
+        self.bus = cantoolkit.shared_bus(CAN_CHANNEL)
+
         self.build_gui()
         self.start_can_listener()
 
@@ -180,30 +109,20 @@ class CANConfigGUI:
         self.msg_box.configure(state='disabled')
 
     def send_can_config(self):
-        config = AquisitionConfigStructure(
-            Aquics_Enable_Continuous=self.enable_continuous_var.get(),
-            Aquics_Enable=0,
-            analog=self.analog_var.get(),
-            timer=self.timer_var.get()
-        )
-        data = send_aquisition_config(config)
+        data = send_aquisition_config(self.timer_var.get(), self.analog_var.get(),
+                                      self.enable_continuous_var.get())
         try:
-            bus = can.interface.Bus(channel='can0', bustype='socketcan')
-            msg = can.Message(arbitration_id=0x404, data=data, is_extended_id=False)
-            bus.send(msg)
+            self.bus.send(0x404, data)
             self.status.config(text="Status: Configuração enviada", foreground="green")
-        except can.CanError as e:
+        except cantoolkit.CanError as e:
             self.status.config(text=f"Erro ao enviar: {e}", foreground="red")
 
     def send_enable_once(self):
-        value = 0x40 if self.enable_once_state.get() else 0x00
-        data = bytearray([value])
+        data = send_start_stop(self.enable_once_state.get())
         try:
-            bus = can.interface.Bus(channel='can0', bustype='socketcan')
-            msg = can.Message(arbitration_id=0x405, data=data, is_extended_id=False)
-            bus.send(msg)
-            self.status.config(text=f"Status: Enable Once enviado ({hex(value)})", foreground="green")
-        except can.CanError as e:
+            self.bus.send(0x405, data)
+            self.status.config(text=f"Status: Enable Once enviado ({hex(data[0])})", foreground="green")
+        except cantoolkit.CanError as e:
             self.status.config(text=f"Erro ao enviar Enable Once: {e}", foreground="red")
 
     def send_digital_cmd(self):
@@ -213,82 +132,58 @@ class CANConfigGUI:
         enc = self.enc_var.get()
         data = send_digital(digital_command, pwm1, pwm2, enc)
         try:
-            bus = can.interface.Bus(channel='can0', bustype='socketcan')
-            msg = can.Message(arbitration_id=0x402, data=data, is_extended_id=False)
-            bus.send(msg)
+            self.bus.send(0x402, data)
             self.status.config(text="Status: LEDs + PWM enviados", foreground="green")
-        except can.CanError as e:
+        except cantoolkit.CanError as e:
             self.status.config(text=f"Erro ao enviar: {e}", foreground="red")
 
     def send_safety_config_cmd(self):
-        cfg1 = SafetyConfigStructure(
-            Monit_Enable=self.monit_enable_var1.get(),
-            maxtemp=self.safety_maxtemp_var1.get(),
-            timer=self.safety_timer_var1.get()
-        )
-        cfg2 = SafetyConfigStructure(
-            Monit_Enable=self.monit_enable_var2.get(),
-            maxtemp=self.safety_maxtemp_var2.get(),
-            timer=self.safety_timer_var2.get()
-        )
-        data = bytearray(8)
-        data[0:4] = send_safety_config(cfg1)
-        data[4:8] = send_safety_config(cfg2)
-
-        # Adjust internal ID if EEPROM save selected
-        if self.save_to_eeprom1.get():
-            data[0] = 0x12
-            data[1] = (cfg1.Monit_Enable & 0x03)
-        if self.save_to_eeprom2.get():
-            data[4] = 0x12
-            data[5] = (cfg2.Monit_Enable & 0x03)
+        # O firmware grava na EEPROM todo 0x403 recebido com Monit_Enable != 2
+        data = send_safety_pair(
+            self.monit_enable_var1.get(), self.safety_maxtemp_var1.get(), self.safety_timer_var1.get(),
+            self.monit_enable_var2.get(), self.safety_maxtemp_var2.get(), self.safety_timer_var2.get())
 
         try:
-            bus = can.interface.Bus(channel='can0', bustype='socketcan')
-            msg = can.Message(arbitration_id=0x403, data=data, is_extended_id=False)
-            bus.send(msg)
+            self.bus.send(0x403, data)
             self.status.config(text="Status: Safety Config 1+2 enviada", foreground="green")
-        except can.CanError as e:
+        except cantoolkit.CanError as e:
             self.status.config(text=f"Erro ao enviar: {e}", foreground="red")
 
     def start_can_listener(self):
-        def listener():
-            bus = can.interface.Bus(channel='can0', bustype='socketcan')
-            for msg in bus:
-                self.msg_box.configure(state='normal')
-                self.msg_box.insert(tk.END, f"ID: {hex(msg.arbitration_id)} | Data: {msg.data.hex()}\n")
-                self.msg_box.see(tk.END)
-                try:
-                    parsed = ""
-                    if msg.arbitration_id == 0x424:
-                        cfg = aquisition_config(msg.data)
-                        parsed = f"Aquisição → Timer: {cfg.timer}ms, Analog: {cfg.analog}, Enable: {cfg.Aquics_Enable}, Continuous: {cfg.Aquics_Enable_Continuous}"
-                    elif msg.arbitration_id == 0x423:
-                        cfg1 = safety_config(msg.data[:4])
-                        cfg2 = safety_config(msg.data[4:])
-                        parsed = (
-                            f"Safety1 → Enable: {cfg1.Monit_Enable}, MaxTemp: {cfg1.maxtemp:.1f}°C, Timer: {cfg1.timer}ms\n"
-                            f"Safety2 → Enable: {cfg2.Monit_Enable}, MaxTemp: {cfg2.maxtemp:.1f}°C, Timer: {cfg2.timer}ms"
-                        )
-                    elif msg.arbitration_id == 0x422:
-                        digital = read_digital(msg.data[:2])
-                        pwm1 = readPWMEnc(msg.data, 2)
-                        pwm2 = readPWMEnc(msg.data, 3)
-                        enc = readPWMEnc(msg.data, 4)
-                        parsed = f"Digital: {digital}, PWM1: {pwm1}, PWM2: {pwm2}, Encoder: {enc}"
-                    elif msg.arbitration_id == 0x425:
-                        state = "Ativado" if msg.data[0] & 0x40 else "Desativado"
-                        parsed = f"Enable Once Estado → {state}"
-                    else:
-                        parsed = msg.data.hex()
-                    self.msg_box.insert(tk.END, f"ID: {hex(msg.arbitration_id)} | {parsed}\n")
-                except Exception as e:
-                    self.msg_box.insert(tk.END, f"Erro ao interpretar {hex(msg.arbitration_id)}: {e}\n")
-                self.msg_box.see(tk.END)
-                self.msg_box.configure(state='disabled')
-
-        thread = threading.Thread(target=listener, daemon=True)
-        thread.start()
+        def listener(msg):
+            self.msg_box.configure(state='normal')
+            self.msg_box.insert(tk.END, f"ID: {hex(msg.arbitration_id)} | Data: {msg.data.hex()}\n")
+            self.msg_box.see(tk.END)
+            try:
+                parsed = ""
+                if msg.arbitration_id == 0x424:
+                    timer, analog, continuous = aquisition_config(msg.data)
+                    parsed = f"Aquisição → Timer: {timer}ms, Analog: {analog}, Continuous: {continuous}"
+                elif msg.arbitration_id in (0x423, 0x426) and len(msg.data) == 8:
+                    (en1, max1, t1), (en2, max2, t2) = read_safety_pair(msg.data)
+                    parsed = (
+                        f"Safety1 → Enable: {en1}, MaxTemp: {max1:.1f}°C, Timer: {t1}ms\n"
+                        f"Safety2 → Enable: {en2}, MaxTemp: {max2:.1f}°C, Timer: {t2}ms"
+                    )
+                elif msg.arbitration_id == 0x422:
+                    digital = read_digital(msg.data[:2])
+                    pwm1 = readPWMEnc(msg.data, 2)
+                    pwm2 = readPWMEnc(msg.data, 3)
+                    enc = readPWMEnc(msg.data, 4)
+                    parsed = f"Digital: {digital}, PWM1: {pwm1}, PWM2: {pwm2}, Encoder: {enc}"
+                elif msg.arbitration_id == 0x425:
+                    state = "Ativado" if msg.data[0] & 0x40 else "Desativado"
+                    parsed = f"Enable Once Estado → {state}"
+                else:
+                    parsed = msg.data.hex()
+                self.msg_box.insert(tk.END, f"ID: {hex(msg.arbitration_id)} | {parsed}\n")
+            except Exception as e:
+                self.msg_box.insert(tk.END, f"Erro ao interpretar {hex(msg.arbitration_id)}: {e}\n")
+            self.msg_box.see(tk.END)
+            self.msg_box.configure(state='disabled')
+
+        # Callback roda na thread de recepção do toolkit (mesmo modelo da thread anterior)
+        self.bus.subscribe(listener)
 
 # ==== Run ====
 if __name__ == "__main__":
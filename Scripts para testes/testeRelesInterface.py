@@ -1,20 +1,22 @@
 import tkinter as tk
 from tkinter import ttk
-import subprocess
 import os
+import sys
+
+# --- CAN (Host_CanToolkit) ---
+# Uma conexão SocketCAN para a janela inteira e codec do 0x402 do firmware
+# (config.cpp) via libcantoolkit
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Host_CanToolkit", "python"))
+import cantoolkit
+from cantoolkit import send_digital
+
+CAN_CHANNEL = "can0"
+RELE_KEEP = 2        # 2 bits no 0x402: 2/3 = mantém o estado atual
+PWM_KEEP = 255       # PWM1/PWM2/Enc = 255 não altera o valor atual
 
 # --- Mapeamento dos Comandos CAN ---
-# Estrutura: {Número_Rele: {'ON': 'comando cansend', 'OFF': 'comando cansend'}}
-COMANDOS_CAN = {
-    1: {'ON': 'cansend can0 402#7F', 'OFF': 'cansend can0 402#3F'},
-    2: {'ON': 'cansend can0 402#DF', 'OFF': 'cansend can0 402#CF'},
-    3: {'ON': 'cansend can0 402#F7', 'OFF': 'cansend can0 402#F3'},
-    4: {'ON': 'cansend can0 402#FD', 'OFF': 'cansend can0 402#FC'},
-    5: {'ON': 'cansend can0 402#FF7F', 'OFF': 'cansend can0 402#FF3F'},
-    6: {'ON': 'cansend can0 402#FFDF', 'OFF': 'cansend can0 402#FFCF'},
-    7: {'ON': 'cansend can0 402#FFF7', 'OFF': 'cansend can0 402#FFF3'},
-    8: {'ON': 'cansend can0 402#FFFD', 'OFF': 'cansend can0 402#FFFC'},
-}
+# Valor dos 2 bits do relé no 0x402 (ON = 01, OFF = 00)
+COMANDOS_CAN = {'ON': 1, 'OFF': 0}
 
 # --- Configurações da GUI ---
 NUM_RELES = 8
@@ -33,6 +35,8 @@ class ControleRelesApp:
         # Referências aos Textos de status (Labels)
         self.textos_status = {}
 
+        self.bus = cantoolkit.shared_bus(CAN_CHANNEL)
+
         self.criar_widgets()
 
     def criar_widgets(self):
@@ -67,19 +71,20 @@ class ControleRelesApp:
             self.textos_status[rele_num] = texto_status # Armazena a referência
 
     def alternar_rele(self, rele_num):
-        """Alterna o estado do relé, muda a GUI e executa o comando cansend."""
+        """Alterna o estado do relé, muda a GUI e envia o 0x402."""
         
         novo_estado = not self.estados[rele_num] # Inverte o estado atual
         self.estados[rele_num] = novo_estado
         
         comando_tipo = 'ON' if novo_estado else 'OFF'
-        comando = COMANDOS_CAN[rele_num][comando_tipo]
+        comandos = [RELE_KEEP] * NUM_RELES
+        comandos[rele_num - 1] = COMANDOS_CAN[comando_tipo]
         
         # Atualiza a GUI
         self.atualizar_gui(rele_num, novo_estado)
         
-        # Executa o comando cansend
-        self.executar_cansend(comando)
+        # Envia só o relé alterado; os demais ficam em RELE_KEEP
+        self.enviar_comando(comandos)
 
     def atualizar_gui(self, rele_num, estado):
         """Muda a cor do LED e o texto de status."""
@@ -90,36 +95,18 @@ class ControleRelesApp:
         self.leds[rele_num].config(background=cor)
         self.textos_status[rele_num].config(text=f"{texto}")
 
-    def executar_cansend(self, comando):
-        """Executa o comando cansend no sistema."""
-        
-        # Executa o comando em um shell. O 'shell=True' é necessário para comandos simples como este.
+    def enviar_comando(self, comandos):
+        """Envia o 0x402 pela conexão aberta no início."""
+        data = send_digital(comandos, PWM_KEEP, PWM_KEEP, PWM_KEEP)
         try:
-            # O 'sudo' pode ser necessário, dependendo da sua configuração do CAN/SocketCAN
-            # Se for usar sudo, descomente a linha abaixo e comente a linha 'subprocess.run'
-            # comando_com_sudo = "sudo " + comando 
-            # subprocess.run(comando_com_sudo, shell=True, check=True, text=True) 
-
-            subprocess.run(comando, shell=True, check=True, text=True) 
-            print(f"Comando executado com sucesso: {comando}")
-            
-        except subprocess.CalledProcessError as e:
-            # Captura erro se o comando 'cansend' falhar
-            print(f"Erro ao executar o comando '{comando}': {e}")
-            print("Verifique se o 'cansend' está instalado e se a interface CAN 'can0' está ativa.")
-        except FileNotFoundError:
-            # Captura erro se o executável 'cansend' não for encontrado
-            print(f"Erro: O comando 'cansend' não foi encontrado. Instale o 'can-utils'.")
-            
-        # Opcional: Você pode querer exibir o comando executado em algum lugar da GUI
+            self.bus.send(0x402, data)
+            print(f"Comando enviado com sucesso: 402#{data.hex().upper()}")
+        except cantoolkit.CanError as e:
+            print(f"Erro ao enviar 402#{data.hex().upper()}: {e}")
+            print("Verifique se a interface CAN 'can0' está ativa.")
 
 # --- Inicialização da Aplicação ---
 if __name__ == "__main__":
-    # Verifica se estamos em um sistema baseado em Linux (onde cansend é comum)
-    if os.name != 'posix':
-        print("Aviso: O comando 'cansend' é tipicamente usado em sistemas Linux (com SocketCAN).")
-        print("A aplicação GUI irá funcionar, mas os comandos 'cansend' provavelmente falharão em outros sistemas (e.g., Windows).")
-        
     root = tk.Tk()
     app = ControleRelesApp(root)
-    root.mainloop()
\ No newline at end of file
+    root.mainloop()
@@ -4,11 +4,29 @@
 
 import tkinter as tk
 from tkinter import ttk, scrolledtext, messagebox
-import can
+import os
+import sys
 import threading
 import time
 from datetime import datetime
 
+# ==== CAN (Host_CanToolkit) ====
+# Conexão SocketCAN e codec do 0x402 do firmware (config.cpp) via libcantoolkit
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Host_CanToolkit", "python"))
+import cantoolkit
+from cantoolkit import send_digital
+
+CAN_CHANNEL = "can0"
+RELE_KEEP = 2        # 2 bits no 0x402: 2/3 = mantém o estado atual
+PWM_KEEP = 255       # PWM1/PWM2/Enc = 255 não altera o valor atual
+MONITOR_IDS = (0x422, 0x423, 0x424, 0x425, 0x426)
+
+
+def frame_reles(comandos):
+    """0x402 com os 2 bits de cada relé (RELE_KEEP nos que não mudam) e PWM/Enc mantidos."""
+    return send_digital(comandos, PWM_KEEP, PWM_KEEP, PWM_KEEP)
+
+
 class PlacaARCGUI:
     def __init__(self, root):
         self.root = root
@@ -22,8 +40,7 @@ class PlacaARCGUI:
         # Estado da conexão
         self.connected = False
         self.bus = None
-        self.monitor_thread = None
-        self.monitor_running = False
+        self.monitor_handle = None
         
         # Cores
         self.color_on = "#4CAF50"   # Verde
@@ -263,27 +280,27 @@ class PlacaARCGUI:
         """Conecta ao barramento CAN"""
         try:
             self.log("Tentando conectar ao CAN0...", "INFO")
-            self.bus = can.interface.Bus(
-                channel='can0',
-                bustype='socketcan',
-                bitrate=500000
-            )
-            test = [0xDD]
-            # Testa heartbeat
+            # Bitrate (500 kbps) é configurado na interface: ip link set can0 type can bitrate 500000
+            self.bus = cantoolkit.CanToolkit(CAN_CHANNEL)
+
+            # Testa heartbeat: a resposta chega pela thread de recepção do toolkit
+            respostas = []
+            recebido = threading.Event()
+
+            def on_heartbeat(msg):
+                respostas.append(msg)
+                recebido.set()
+
+            handle = self.bus.subscribe(on_heartbeat, 0x401, 0x7FF)
             self.log("Enviando heartbeat...", "INFO")
-            msg = can.Message(
-                arbitration_id=0x401,
-                is_remote_frame=False,
-                is_extended_id=False,
-                data = test
-                
-            )
-            self.bus.send(msg)
-            
+            self.bus.send(0x401, [0xDD])
+
             # Aguarda resposta
-            response = self.bus.recv(timeout=2.0)
-            
-            if response and response.arbitration_id == 0x401:
+            recebido.wait(timeout=2.0)
+            self.bus.unsubscribe(handle)
+
+            if respostas:
+                response = respostas[0]
                 self.connected = True
                 self.log("✓ Placa ARC conectada com sucesso!", "SUCCESS")
                 self.log(f"  ID: 0x{response.arbitration_id:03X}", "SUCCESS")
@@ -364,48 +381,27 @@ class PlacaARCGUI:
         self.set_rele(rele_idx, new_state)
     
     def set_rele(self, rele_idx, state):
-    """Define estado de um relé (0=OFF, 1=ON)"""
-    if not self.connected:
-        return
+        """Define estado de um relé (0=OFF, 1=ON)"""
+        if not self.connected:
+            return
 
-    try:
-        # Lê o estado atual em um byte
-        # Cada bit representa um relé
-        mask = 1 << rele_idx
-        data = [0x00] * 8
-        
-        # Monta o byte 0 com os estados
-        current_state = 0
-        for i in range(8):
-            if self.rele_states[i]:
-                current_state |= (1 << i)
-        
-        if state:
-            current_state |= mask   # Liga bit
-        else:
-            current_state &= ~mask  # Desliga bit
-        
-        data[0] = current_state
-        
-        # Envia mensagem CAN
-        msg = can.Message(
-            arbitration_id=0x402,
-            data=data,
-            is_extended_id=False
-        )
-        self.bus.send(msg)
+        try:
+            # Só o relé alterado recebe comando; os demais ficam em RELE_KEEP
+            comandos = [RELE_KEEP] * 8
+            comandos[rele_idx] = state
+            self.bus.send(0x402, frame_reles(comandos))
 
-        # Atualiza estado local
-        self.rele_states[rele_idx] = state
-        self.update_rele_ui(rele_idx, state)
+            # Atualiza estado local
+            self.rele_states[rele_idx] = state
+            self.update_rele_ui(rele_idx, state)
 
-        # Log
-        action = "LIGADO" if state else "DESLIGADO"
-        self.log(f"D{rele_idx+1} {action}", "SUCCESS")
+            # Log
+            action = "LIGADO" if state else "DESLIGADO"
+            self.log(f"D{rele_idx+1} {action}", "SUCCESS")
+
+        except Exception as e:
+            self.log(f"✗ Erro ao controlar D{rele_idx+1}: {e}", "ERROR")
 
-    except Exception as e:
-        self.log(f"✗ Erro ao controlar D{rele_idx+1}: {e}", "ERROR")
-    
     def update_rele_ui(self, rele_idx, state):
         """Atualiza interface visual do relé"""
         btn, status_label = self.rele_buttons[rele_idx]
@@ -430,17 +426,8 @@ class PlacaARCGUI:
         try:
             self.log("Ligando todos os relés...", "INFO")
             
-            # Mensagem: todos em 01 (ligado)
-            # Byte 0: D1-D4 = 01 01 01 01 = 0x55
-            # Byte 1: D5-D8 = 01 01 01 01 = 0x55
-            data = [0x55, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00]
-            
-            msg = can.Message(
-                arbitration_id=0x402,
-                data=data,
-                is_extended_id=False
-            )
-            self.bus.send(msg)
+            # Mensagem: todos em 01 (ligado) -> bytes 0/1 = 0x55 0x55
+            self.bus.send(0x402, frame_reles([1] * 8))
             
             # Atualiza estados
             for i in range(8):
@@ -461,14 +448,7 @@ class PlacaARCGUI:
             self.log("Desligando todos os relés...", "INFO")
             
             # Mensagem: todos em 00 (desligado)
-            data = [0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00]
-            
-            msg = can.Message(
-                arbitration_id=0x402,
-                data=data,
-                is_extended_id=False
-            )
-            self.bus.send(msg)
+            self.bus.send(0x402, frame_reles([0] * 8))
             
             # Atualiza estados
             for i in range(8):
@@ -520,37 +500,24 @@ class PlacaARCGUI:
     # =======================================================================
     
     def start_monitor(self):
-        """Inicia thread de monitoramento CAN"""
-        self.monitor_running = True
-        self.monitor_thread = threading.Thread(target=self.monitor_can, daemon=True)
-        self.monitor_thread.start()
+        """Inscreve o monitor na thread de recepção do toolkit"""
+        self.monitor_handle = self.bus.subscribe(self.monitor_can)
         self.log("Monitor CAN iniciado", "INFO")
-    
+
     def stop_monitor(self):
-        """Para thread de monitoramento"""
-        self.monitor_running = False
-        if self.monitor_thread:
-            self.monitor_thread.join(timeout=1.0)
+        """Cancela a inscrição do monitor"""
+        if self.bus and self.monitor_handle is not None:
+            self.bus.unsubscribe(self.monitor_handle)
+        self.monitor_handle = None
         self.log("Monitor CAN parado", "INFO")
-    
-    def monitor_can(self):
-        """Thread que monitora mensagens CAN"""
-        while self.monitor_running and self.bus:
-            try:
-                msg = self.bus.recv(timeout=0.1)
-                if msg:
-                    # Formata dados
-                    data_str = ' '.join(f'{b:02X}' for b in msg.data)
-                    
-                    # Log apenas mensagens relevantes
-                    if msg.arbitration_id in [0x422, 0x423, 0x424, 0x425, 0x426]:
-                        self.log(
-                            f"RX: 0x{msg.arbitration_id:03X} [{msg.dlc}] {data_str}",
-                            "CAN"
-                        )
-            except Exception:
-                pass
-    
+
+    def monitor_can(self, msg):
+        """Callback de recepção (roda na thread do toolkit)"""
+        # Log apenas mensagens relevantes
+        if msg.arbitration_id in MONITOR_IDS:
+            data_str = ' '.join(f'{b:02X}' for b in msg.data)
+            self.log(f"RX: 0x{msg.arbitration_id:03X} [{msg.dlc}] {data_str}", "CAN")
+
     # =======================================================================
     # CLEANUP
     # =======================================================================